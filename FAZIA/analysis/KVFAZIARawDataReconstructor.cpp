@@ -80,6 +80,8 @@ void KVFAZIARawDataReconstructor::InitRun()
    KVEvent::MakeEventBranch(tree, "FAZIAReconEvent", "KVReconstructedEvent", &recev);
 
    Info("InitRun", "Created reconstructed data tree %s : %s", tree->GetName(), tree->GetTitle());
+   tree_output.Reset();
+   tree_output.AddTree(tree);
    nb_recon = 0;
 
 }
@@ -102,7 +104,7 @@ Bool_t KVFAZIARawDataReconstructor::Analysis()
    ExtraProcessing();
 
    nb_recon++;
-   tree->Fill();
+   tree_output.FillTree(tree);
 
    recev->Clear();
 
@@ -166,7 +168,8 @@ void KVFAZIARawDataReconstructor::EndRun()
              << nb_recon << " ***" << std::endl << std::endl;
    file->cd();
    gDataAnalyser->WriteBatchInfo(tree);
-   tree->Write();//write tree to file
+   tree_output.WriteTree(tree);//write tree to file
+   tree_output.PrintReport();
 
    // get dataset to which we must associate new run
    KVDataSet* OutputDataset =
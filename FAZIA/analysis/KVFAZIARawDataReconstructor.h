@@ -9,12 +9,14 @@
 #include "TFile.h"
 #include "TTree.h"
 #include "TString.h"
+#include "KVTreeOutput.h"
 
 class KVFAZIARawDataReconstructor : public KVFAZIAReader {
 protected:
 
    TFile* file;
    TTree* tree;
+   KVTreeOutput tree_output;//! fills & writes tree, compression & I/O timing
 
    KVReconstructedEvent* recev;
 
@@ -207,7 +207,7 @@ void KVFAZIA::GetDetectorEvent(KVDetectorEvent* detev, TSeqCollection* signals)
          det = GetDetector(par->GetDetectorName());
          if (det) {
             ((KVFAZIADetector*)det)->SetSignal(par, par->GetType());
-            if ((!(((KVFAZIADetector*)det)->GetSignal(par->GetType())->GetN() > 0)))
+            if ((!(((KVFAZIADetector*)det)->GetSignal(par->GetType())->GetNPoints() > 0)))
                Warning("Error", "%s %s empty signal is returned", det->GetName(), par->GetType());
             if ((grp = det->GetGroup())  && !detev->GetGroups()->FindObject(grp)) {
                detev->AddGroup(grp);
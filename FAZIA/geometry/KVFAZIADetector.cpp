@@ -41,6 +41,7 @@ void KVFAZIADetector::init()
    fTelescope = -1;
    fIndex = -1;
    fIsRutherford = kFALSE;
+   fCompactSignals = gEnv->GetValue("FAZIADetector.CompactSignals", kFALSE);
 
    fSignals = 0;
    fChannelToEnergy = 0;
@@ -369,7 +370,7 @@ Bool_t KVFAZIADetector::Fired(Option_t*)
    if (fSignals) {
       TIter next(fSignals);
       while ((sig = (KVSignal*)next())) {
-         if (sig->GetN() > 0) {
+         if (sig->GetNPoints() > 0) {
             if (sig->IsCharge()) {
 
                //pre process to use the test method KVSignal::IsFired()
@@ -396,13 +397,21 @@ Bool_t KVFAZIADetector::Fired(Option_t*)
 //_________________________________________________________________________________
 void KVFAZIADetector::SetSignal(KVSignal* signal, const Char_t* type)
 {
+   // Copy signal into the signal of given type of this detector.
+   // If FAZIADetector.CompactSignals is 'yes', the signal is copied in compact form
+   // (samples only, see KVSignal::SetSamples): in this case the TGraph points of
+   // the signal are only filled by KVSignal::FillGraph().
+
    if (!fSignals) {
       Error("SetSignal", "%s List of signals not defined", GetName());
       return;
    }
    KVSignal* sig = GetSignal(type);
    if (sig) {
-      sig->SetData(signal->GetN(), signal->GetX(), signal->GetY());
+      if (fCompactSignals)
+         sig->SetSamples(signal->GetN(), signal->GetY(), signal->GetN() ? signal->GetX()[0] : 0.);
+      else
+         sig->SetData(signal->GetN(), signal->GetX(), signal->GetY());
    } else {
       Warning("SetSignal", "%s : No signal of type #%s# is available", GetName(), type);
    }
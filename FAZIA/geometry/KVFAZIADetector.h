@@ -18,6 +18,7 @@ protected:
    Int_t fIdentifier;   //to difference SI1 SI2 CSI detectors
    Int_t fIndex;   //!100*block+10*quartet+telescope
    Bool_t fIsRutherford;   //!
+   Bool_t fCompactSignals;   //!kTRUE if signals are stored in compact form (see SetSignal)
 
    Double_t fChannel;
    Double_t fVolt;
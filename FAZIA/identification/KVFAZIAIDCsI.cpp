@@ -43,7 +43,8 @@ Bool_t KVFAZIAIDCsI::Identify(KVIdentificationResult* IDR, Double_t x, Double_t
    //perform identification
    Double_t csir = (y < 0. ? GetIDMapY() : y);
    Double_t csil = (x < 0. ? GetIDMapX() : x);
-   CsIGrid->Identify(csil, csir, IDR);
+   KVIDZAGrid::IdentContext ctx;
+   CsIGrid->IdentifyWithContext(csil, csir, IDR, ctx);
 
    // set general ID code
    IDR->IDcode = GetIDCode();
@@ -78,7 +78,8 @@ Bool_t KVFAZIAIDSiCsI::Identify(KVIdentificationResult* idr, Double_t x, Double_
    }
 
    if (TheGrid->IsIdentifiable(csi, si2)) {
-      TheGrid->Identify(csi, si2, idr);
+      KVIDZAGrid::IdentContext ctx;
+      TheGrid->IdentifyWithContext(csi, si2, idr, ctx);
    } else {
       idr->IDOK = kFALSE;
       idr->IDquality = KVIDZAGrid::kICODE8;
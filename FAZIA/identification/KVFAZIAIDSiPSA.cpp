@@ -65,7 +65,8 @@ Bool_t KVFAZIAIDSiPSA::Identify(KVIdentificationResult* idr, Double_t x, Double_
    Double_t ima = (x < 0. ? GetIDMapX() : x);
 
    if (IGrid->IsIdentifiable(ima, esi)) {
-      IGrid->Identify(ima, esi, idr);
+      KVIDZAGrid::IdentContext ctx;
+      IGrid->IdentifyWithContext(ima, esi, idr, ctx);
    } else {
       idr->IDOK = kFALSE;
       idr->IDquality = KVIDZAGrid::kICODE8;
@@ -65,7 +65,8 @@ Bool_t KVFAZIAIDSiSi::Identify(KVIdentificationResult* idr, Double_t x, Double_t
    Double_t si2 = (x < 0. ? GetIDMapX() : x);
 
    if (fSiSiGrid->IsIdentifiable(si2, si1)) {
-      fSiSiGrid->Identify(si2, si1, idr);
+      KVIDZAGrid::IdentContext ctx;
+      fSiSiGrid->IdentifyWithContext(si2, si1, idr, ctx);
    } else {
       idr->IDOK = kFALSE;
       idr->IDquality = KVIDZAGrid::kICODE8;
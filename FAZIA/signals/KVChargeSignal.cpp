@@ -337,6 +337,7 @@ void KVChargeSignal::Copy(TObject& obj) const
 Double_t KVChargeSignal::GetMaxFluctuationsWindow(Double_t* window, Int_t width)
 {
    if (!window) return 0;
+   FillGraph();
    TH1F* h2 = new TH1F("windows", "windows", (TMath::Nint(GetAmplitude()) + 1), GetYmin() - 0.5, GetYmax() + 0.5);
    TGraph* gmoy = new TGraph();
    TGraph* grms = new TGraph();
@@ -76,6 +76,9 @@
 //                                                                      //
 //////////////////////////////////////////////////////////////////////////
 #include "KVDigitalFilter.h"
+#include <vector>
+#include <map>
+#include <algorithm>
 #define DUEPI 6.28318530717958623
 #define    PI (DUEPI/2.)
 
@@ -908,6 +911,28 @@ KVDigitalFilter KVDigitalFilter::BuildInverse(KVDigitalFilter* filter)
    }
    return inv_filter;
 }
+/**************************************/
+KVDigitalFilter KVDigitalFilter::BuildSemiGaussian(const double& tau_usec, const double& tau_clk)
+{
+   // Single filter equivalent to KVSignal::FIR_ApplySemigaus: 4 RC low-pass
+   // stages followed by 1 RC high-pass stage, with the same normalisation.
+   KVDigitalFilter lp = BuildRCLowPass(tau_usec, tau_clk);
+   KVDigitalFilter hp = BuildRCHighPass(tau_usec, tau_clk);
+   KVDigitalFilter semigaus = CombineStagesMany(&lp, &lp, &lp, &lp, &hp);
+   semigaus.Multiply(1. / (32. / 3.*exp(-4.)));
+   return semigaus;
+}
+/**************************************/
+KVDigitalFilter KVDigitalFilter::BuildPoleZeroSuppression(const double& tauRC_usec, const double& tau_clk)
+{
+   // Single filter equivalent to KVSignal::PoleZeroSuppression: deconvolution
+   // of the preamplifier decay followed by an integrator, with the same normalisation.
+   KVDigitalFilter deconv = BuildRCLowPassDeconv(tauRC_usec, tau_clk);
+   KVDigitalFilter integ = BuildIntegrator(tau_clk);
+   KVDigitalFilter pz = CombineStagesMany(&deconv, &integ);
+   pz.Multiply(tau_clk / tauRC_usec / 1000.);
+   return pz;
+}
 
 
 /********************************************/
@@ -1053,3 +1078,114 @@ void KVDigitalFilter::FIRApplyTo(double* datax, const int NSamples, int reverse)
    delete [] datay;
 
 }
+
+// =========================== ApplyTo per molti segnali insieme:
+//  the recursion is sequential in time, so the signals are filtered together
+//  in blocks of kBatchWidth signals: samples of the signals of a block are
+//  interleaved so that the innermost loop is over signals, and can be
+//  vectorised by the compiler.
+namespace {
+   template<typename T, int W>
+   void batch_filter(const double* a, const double* b, const int Ncoeff, T** data,
+                     const int nsignals, const int NSamples, int reverse, bool fir)
+   {
+      std::vector<double> x(NSamples * W), y(NSamples * W);
+      for (int first = 0; first < nsignals; first += W) {
+         int nsig = std::min(W, nsignals - first);
+         if (nsig < W) std::fill(x.begin(), x.end(), 0.);
+         // interleave samples: for reverse filtering, samples are read backwards
+         for (int s = 0; s < nsig; s++) {
+            const T* d = data[first + s];
+            if (reverse) for (int i = 0; i < NSamples; i++) x[i * W + s] = d[NSamples - 1 - i];
+            else for (int i = 0; i < NSamples; i++) x[i * W + s] = d[i];
+         }
+         for (int i = 0; i < NSamples; i++) {
+            double* yi = &y[i * W];
+            const double* xi = &x[i * W];
+            for (int s = 0; s < W; s++) yi[s] = a[0] * xi[s];
+            int kmax = std::min(i, Ncoeff - 1);
+            for (int k = 1; k <= kmax; k++) {
+               const double ak = a[k], bk = b[k];
+               const double* xk = &x[(i - k) * W];
+               const double* yk = &y[(i - k) * W];
+               if (fir) for (int s = 0; s < W; s++) yi[s] += ak * xk[s];
+               else for (int s = 0; s < W; s++) yi[s] += ak * xk[s] + bk * yk[s];
+            }
+         }
+         for (int s = 0; s < nsig; s++) {
+            T* d = data[first + s];
+            if (reverse) for (int i = 0; i < NSamples; i++) d[NSamples - 1 - i] = (T)y[i * W + s];
+            else for (int i = 0; i < NSamples; i++) d[i] = (T)y[i * W + s];
+         }
+      }
+   }
+
+   template<typename T, int W>
+   void batch_apply(const double* a, const double* b, const int Ncoeff, T** data,
+                    const int nsignals, const int NSamples, int reverse, bool fir)
+   {
+      switch (reverse) {
+         case 0:
+         case 1:
+            batch_filter<T, W>(a, b, Ncoeff, data, nsignals, NSamples, reverse, fir);
+            break;
+         case -1: // bidirectional
+            batch_filter<T, W>(a, b, Ncoeff, data, nsignals, NSamples, 0, fir);
+            batch_filter<T, W>(a, b, Ncoeff, data, nsignals, NSamples, 1, fir);
+            break;
+         default:
+            printf("ERROR in %s: reverse=%d not supported\n", __PRETTY_FUNCTION__, reverse);
+      }
+   }
+}
+//=============================================
+void KVDigitalFilter::ApplyTo(double** data, const int nsignals, const int NSamples, int reverse) const
+{
+   // Apply filter to nsignals signals with NSamples samples each, data[i]
+   // being the array of samples of the i-th signal.
+   // Same result as ApplyTo(data[i], NSamples, reverse) for each signal, but
+   // intermediate results are "double" (instead of "long double").
+   batch_apply<double, kBatchWidth>(a, b, Ncoeff, data, nsignals, NSamples, reverse, false);
+}
+//=============================================
+void KVDigitalFilter::ApplyTo(float** data, const int nsignals, const int NSamples, int reverse) const
+{
+   // Apply filter to nsignals signals with NSamples samples each, data[i]
+   // being the array of samples of the i-th signal.
+   // Same result as ApplyTo(data[i], NSamples, reverse) for each signal, but
+   // intermediate results are "double" (instead of "long double").
+   batch_apply<float, kBatchWidth>(a, b, Ncoeff, data, nsignals, NSamples, reverse, false);
+}
+//=============================================
+void KVDigitalFilter::FIRApplyTo(double** data, const int nsignals, const int NSamples, int reverse) const
+{
+   // Apply FIR filter (b coefficients are ignored) to nsignals signals with
+   // NSamples samples each: see ApplyTo(double**,...)
+   batch_apply<double, kBatchWidth>(a, b, Ncoeff, data, nsignals, NSamples, reverse, true);
+}
+//=============================================
+void KVDigitalFilter::FIRApplyTo(float** data, const int nsignals, const int NSamples, int reverse) const
+{
+   // Apply FIR filter (b coefficients are ignored) to nsignals signals with
+   // NSamples samples each: see ApplyTo(float**,...)
+   batch_apply<float, kBatchWidth>(a, b, Ncoeff, data, nsignals, NSamples, reverse, true);
+}
+//=============================================
+void KVDigitalFilter::ApplyTo(KVSignal** signals, const int nsignals, int reverse) const
+{
+   // Apply filter to all signals in the array: signals with the same number
+   // of samples are filtered together (see ApplyTo(float**,...)).
+   // Signals whose channel width is different from tau_clk are not filtered.
+   std::map<int, std::vector<float*> > same_length;
+   for (int i = 0; i < nsignals; i++) {
+      KVSignal* s = signals[i];
+      if (fabs(s->GetChannelWidth() - tau_clk) > 1e-6) {
+         printf("ERROR in %s: different tau_clk! %e != %e\n",
+                __PRETTY_FUNCTION__, s->GetChannelWidth(),  tau_clk);
+         continue;
+      }
+      if (s->GetNSamples() > 0) same_length[s->GetNSamples()].push_back(s->GetArray()->GetArray());
+   }
+   for (std::map<int, std::vector<float*> >::iterator it = same_length.begin(); it != same_length.end(); ++it)
+      ApplyTo(&(it->second[0]), (int)it->second.size(), it->first, reverse);
+}
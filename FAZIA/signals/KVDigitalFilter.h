@@ -46,6 +46,9 @@ public:
    static    KVDigitalFilter BuildIntegrator(const double& tau_clk);
 
    static    KVDigitalFilter BuildInverse(KVDigitalFilter* filter);
+   // fused multi-stage filters (single filter made with CombineStages)
+   static    KVDigitalFilter BuildSemiGaussian(const double& tau_usec, const double& tau_clk);
+   static    KVDigitalFilter BuildPoleZeroSuppression(const double& tauRC_usec, const double& tau_clk);
    /************************** UTILS ***********************************/
    //-- conversion to/from DSP 1.15? notation
    static int Double2DSP(const double& val)
@@ -134,6 +137,12 @@ public:
    void ApplyTo(int*    data, const int N, int reverse = 0) const;
    void FIRApplyTo(double* datax, const int NSamples, int reverse) const;
    void FIRApplyTo(float* datax, const int NSamples, int reverse) const;
+   // batched filtering of many signals with the same number of samples
+   void ApplyTo(double** data, const int nsignals, const int NSamples, int reverse = 0) const;
+   void ApplyTo(float** data, const int nsignals, const int NSamples, int reverse = 0) const;
+   void FIRApplyTo(double** data, const int nsignals, const int NSamples, int reverse = 0) const;
+   void FIRApplyTo(float** data, const int nsignals, const int NSamples, int reverse = 0) const;
+   void ApplyTo(KVSignal** signals, const int nsignals, int reverse = 0) const;
    inline void ApplyTo(KVSignal* s, int reverse = 0) const
    {
       if (fabs(s->GetChannelWidth() - tau_clk) > 1e-6) {
@@ -170,6 +179,8 @@ protected:
 
 
 
+   enum { kBatchWidth = 8 }; // number of signals filtered together by batched ApplyTo
+
    /***************************** VARIABILI ********************/
    double* a; //coefficients.
    double* b;
@@ -0,0 +1,523 @@
+#include "KVFFTEngine.h"
+#include "KVSignal.h"
+#include "TVirtualFFT.h"
+#include "TPluginManager.h"
+#include "TROOT.h"
+#include "TEnv.h"
+#include "TMath.h"
+#include <algorithm>
+#include <cstring>
+
+ClassImp(KVFFTEngine)
+
+////////////////////////////////////////////////////////////////////////////////
+// BEGIN_HTML <!--
+/* -->
+<h2>KVFFTEngine</h2>
+<h4>Fast Fourier transforms of real signals with cached plans</h4>
+<!-- */
+// --> END_HTML
+//
+// Forward & inverse discrete Fourier transforms of real signals, as used by
+// KVSignal::FFT and KVSignal::FFT2Histo. Signals of n samples are zero-padded
+// to N = GetTransformLength(n) (the smallest power of 2 >= n); the forward
+// transform gives the N/2+1 complex coefficients
+//
+//     X[k] = sum_{j<N} x[j] exp(-2i*pi*j*k/N),   k = 0, ..., N/2
+//
+// corresponding to frequencies k/(N*tau_clk), and the inverse transform is
+// normalised so that Inverse(Forward(x)) = x.
+//
+// Two backends are available:
+//    - kFFTW: the FFTW library, through ROOT's TVirtualFFT plugin (only if
+//      ROOT was built with FFTW support, see IsFFTWAvailable());
+//    - kBuiltin: a real-input radix-2 transform (the N real values are treated
+//      as N/2 complex values) which is always available.
+// The default backend is given by the configuration variable
+//
+//     KVFFTEngine.Backend:   FFTW
+//
+// ("FFTW" or "builtin"). If FFTW is not available, the built-in transform is used.
+//
+// For each transform length, a plan (FFTW plan or tables of bit-reversed indices
+// and twiddle factors) and the work buffers are created the first time the length
+// is used and kept until ClearPlans() is called or the engine is deleted: no memory
+// is allocated when signals of the same length are transformed one after the other,
+// for example with the batch methods which transform/filter all signals of an event
+// (Forward(Float_t**,...), Filter(Float_t**,...), LowPass(KVSignal**,...)).
+//
+// FREQUENCY-DOMAIN FILTERING
+// ==========================
+// Filter() multiplies the Fourier transform of the signal by a real gain for each
+// of the N/2+1 frequencies, then transforms back. LowPassGain() & HighPassGain()
+// give the gains of Butterworth filters of any order for a given cut-off frequency
+// in MHz: see also KVSignal::FFT_ApplyLowPass & KVSignal::FFT_ApplyHighPass.
+//
+// N.B. a KVFFTEngine object must not be used by several threads at the same time:
+// each thread should use its own engine. GetDefault() returns the engine used by
+// KVSignal.
+////////////////////////////////////////////////////////////////////////////////
+
+struct KVFFTEngine::plan {
+   // transform of length N: input & output buffers, tables for built-in
+   // transform, FFTW plans
+   Int_t fN;
+   std::vector<Double_t> fIn;         // N zero-padded real values
+   std::vector<Double_t> fRe, fIm;    // N/2+1 complex coefficients
+   std::vector<Int_t> fBitRev;        // bit-reversed indices for N/2-point transform
+   std::vector<Double_t> fTwRe, fTwIm;// exp(-2i*pi*j/(N/2)) for j<N/4
+   std::vector<Double_t> fWRe, fWIm;  // exp(-2i*pi*k/N) for k<=N/2
+   std::vector<Double_t> fZRe, fZIm;  // N/2-point work buffer
+   TVirtualFFT* fFFTWForward;
+   TVirtualFFT* fFFTWInverse;
+
+   plan(Int_t N, Bool_t fftw)
+      : fN(N), fIn(N), fRe(N / 2 + 1), fIm(N / 2 + 1), fFFTWForward(0), fFFTWInverse(0)
+   {
+      if (fftw) {
+         fFFTWForward = TVirtualFFT::FFT(1, &N, "R2C M K");
+         fFFTWInverse = TVirtualFFT::FFT(1, &N, "C2R M K");
+         if (fFFTWForward && fFFTWInverse) return;
+         delete fFFTWForward;
+         delete fFFTWInverse;
+         fFFTWForward = fFFTWInverse = 0;
+      }
+      Int_t M = N / 2;
+      Int_t nbits = 0;
+      while ((1 << nbits) < M) ++nbits;
+      fBitRev.resize(M);
+      for (Int_t i = 0; i < M; ++i) {
+         Int_t r = 0;
+         for (Int_t b = 0; b < nbits; ++b) if (i & (1 << b)) r |= 1 << (nbits - 1 - b);
+         fBitRev[i] = r;
+      }
+      fTwRe.resize(M / 2 + 1);
+      fTwIm.resize(M / 2 + 1);
+      for (Int_t j = 0; j < M / 2; ++j) {
+         fTwRe[j] = TMath::Cos(TMath::TwoPi() * j / M);
+         fTwIm[j] = -TMath::Sin(TMath::TwoPi() * j / M);
+      }
+      fWRe.resize(M + 1);
+      fWIm.resize(M + 1);
+      for (Int_t k = 0; k <= M; ++k) {
+         fWRe[k] = TMath::Cos(TMath::TwoPi() * k / N);
+         fWIm[k] = -TMath::Sin(TMath::TwoPi() * k / N);
+      }
+      fZRe.resize(M);
+      fZIm.resize(M);
+   }
+   ~plan()
+   {
+      delete fFFTWForward;
+      delete fFFTWInverse;
+   }
+   Bool_t IsFFTW() const
+   {
+      return fFFTWForward != 0;
+   }
+};
+
+namespace {
+   void complex_fft(Int_t M, Double_t* re, Double_t* im, const Int_t* bitrev,
+                    const Double_t* twr, const Double_t* twi, Bool_t inverse)
+   {
+      // in-place radix-2 transform of M complex values (M power of 2) using
+      // twiddle factors twr+i*twi = exp(-2i*pi*j/M) for j<M/2
+      // (inverse: conjugate twiddle factors, no normalisation)
+      for (Int_t i = 0; i < M; ++i) {
+         Int_t j = bitrev[i];
+         if (j > i) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+         }
+      }
+      Double_t sign = (inverse ? -1. : 1.);
+      for (Int_t half = 1, step = M / 2; half < M; half <<= 1, step >>= 1) {
+         for (Int_t i = 0; i < M; i += 2 * half) {
+            for (Int_t k = 0; k < half; ++k) {
+               Double_t wr = twr[k * step], wi = sign * twi[k * step];
+               Int_t a = i + k, b = a + half;
+               Double_t tr = wr * re[b] - wi * im[b];
+               Double_t ti = wr * im[b] + wi * re[b];
+               re[b] = re[a] - tr;
+               im[b] = im[a] - ti;
+               re[a] += tr;
+               im[a] += ti;
+            }
+         }
+      }
+   }
+}
+
+KVFFTEngine::KVFFTEngine()
+   : KVBase("KVFFTEngine", "FFT engine"), fBackend(kBuiltin), fLastPlan(0)
+{
+   // Default constructor: backend given by configuration variable
+   // KVFFTEngine.Backend ("FFTW" or "builtin")
+
+   TString backend = gEnv->GetValue("KVFFTEngine.Backend", "FFTW");
+   backend.ToLower();
+   SetBackend(backend == "fftw" ? kFFTW : kBuiltin);
+}
+
+//____________________________________________________________________________//
+
+KVFFTEngine::KVFFTEngine(EBackend backend)
+   : KVBase("KVFFTEngine", "FFT engine"), fBackend(kBuiltin), fLastPlan(0)
+{
+   // Engine using given backend (if available)
+   SetBackend(backend);
+}
+
+//____________________________________________________________________________//
+
+KVFFTEngine::~KVFFTEngine()
+{
+   // Destructor
+   ClearPlans();
+}
+
+//____________________________________________________________________________//
+
+KVFFTEngine* KVFFTEngine::GetDefault()
+{
+   // Engine used by KVSignal for Fourier transforms
+   static KVFFTEngine engine;
+   return &engine;
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVFFTEngine::IsFFTWAvailable()
+{
+   // kTRUE if ROOT's FFTW plugin for TVirtualFFT can be loaded
+   TPluginHandler* h = gROOT->GetPluginManager()->FindHandler("TVirtualFFT", "fftwr2c");
+   return (h && h->CheckPlugin() != -1);
+}
+
+//____________________________________________________________________________//
+
+Int_t KVFFTEngine::GetTransformLength(Int_t n)
+{
+   // Length of transform used for signals of n samples: smallest power of 2 >= n
+   // (minimum 2)
+   Int_t N = 2;
+   while (N < n) N <<= 1;
+   return N;
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVFFTEngine::SetBackend(EBackend backend)
+{
+   // Change backend used for transforms (existing plans are deleted).
+   // If FFTW is requested but not available, the built-in transform is used
+   // and kFALSE is returned.
+
+   Bool_t ok = kTRUE;
+   if (backend == kFFTW && !IsFFTWAvailable()) {
+      backend = kBuiltin;
+      ok = kFALSE;
+   }
+   if (backend != fBackend) ClearPlans();
+   fBackend = backend;
+   return ok;
+}
+
+//____________________________________________________________________________//
+
+void KVFFTEngine::ClearPlans()
+{
+   // Delete all plans & buffers
+   for (std::map<Int_t, plan*>::iterator it = fPlans.begin(); it != fPlans.end(); ++it) delete it->second;
+   fPlans.clear();
+   fLastPlan = 0;
+}
+
+//____________________________________________________________________________//
+
+KVFFTEngine::plan* KVFFTEngine::GetPlan(Int_t N)
+{
+   // Plan for transforms of length N (created if needed)
+   if (fLastPlan && fLastPlan->fN == N) return fLastPlan;
+   std::map<Int_t, plan*>::iterator it = fPlans.find(N);
+   if (it != fPlans.end()) return (fLastPlan = it->second);
+   plan* p = new plan(N, fBackend == kFFTW);
+   if (fBackend == kFFTW && !p->IsFFTW()) {
+      Warning("GetPlan", "FFTW plan for length %d could not be created: using built-in transform", N);
+   }
+   fPlans[N] = p;
+   return (fLastPlan = p);
+}
+
+//____________________________________________________________________________//
+
+void KVFFTEngine::ForwardPlan(plan* p, const Float_t* data, Int_t n)
+{
+   // Forward transform of n values (zero-padded to plan length) into
+   // plan's output buffers
+
+   Int_t N = p->fN;
+   if (n > N) n = N;
+   Double_t* in = &p->fIn[0];
+   for (Int_t i = 0; i < n; ++i) in[i] = data[i];
+   for (Int_t i = n; i < N; ++i) in[i] = 0.;
+   Double_t* re = &p->fRe[0];
+   Double_t* im = &p->fIm[0];
+
+   if (p->IsFFTW()) {
+      p->fFFTWForward->SetPoints(in);
+      p->fFFTWForward->Transform();
+      p->fFFTWForward->GetPointsComplex(re, im);
+      return;
+   }
+
+   // N real values = N/2 complex values z[m] = x[2m] + i*x[2m+1]
+   Int_t M = N / 2;
+   Double_t* zr = &p->fZRe[0];
+   Double_t* zi = &p->fZIm[0];
+   for (Int_t m = 0; m < M; ++m) {
+      zr[m] = in[2 * m];
+      zi[m] = in[2 * m + 1];
+   }
+   complex_fft(M, zr, zi, &p->fBitRev[0], &p->fTwRe[0], &p->fTwIm[0], kFALSE);
+   // separate transforms of even (E) & odd (O) samples: X[k] = E[k] + exp(-2i*pi*k/N)*O[k]
+   for (Int_t k = 0; k <= M; ++k) {
+      Int_t k1 = (k == M ? 0 : k), k2 = (k == 0 ? 0 : M - k);
+      Double_t er = 0.5 * (zr[k1] + zr[k2]), ei = 0.5 * (zi[k1] - zi[k2]);
+      Double_t orr = 0.5 * (zi[k1] + zi[k2]), oi = -0.5 * (zr[k1] - zr[k2]);
+      re[k] = er + p->fWRe[k] * orr - p->fWIm[k] * oi;
+      im[k] = ei + p->fWRe[k] * oi + p->fWIm[k] * orr;
+   }
+}
+
+//____________________________________________________________________________//
+
+void KVFFTEngine::InversePlan(plan* p)
+{
+   // Inverse transform of plan's N/2+1 complex coefficients into the N
+   // values of the plan's input buffer
+
+   Int_t N = p->fN;
+   Double_t* out = &p->fIn[0];
+   Double_t* re = &p->fRe[0];
+   Double_t* im = &p->fIm[0];
+
+   if (p->IsFFTW()) {
+      p->fFFTWInverse->SetPointsComplex(re, im);
+      p->fFFTWInverse->Transform();
+      p->fFFTWInverse->GetPoints(out);
+      for (Int_t i = 0; i < N; ++i) out[i] /= N;
+      return;
+   }
+
+   Int_t M = N / 2;
+   Double_t* zr = &p->fZRe[0];
+   Double_t* zi = &p->fZIm[0];
+   for (Int_t k = 0; k < M; ++k) {
+      Int_t k2 = M - k;
+      Double_t er = 0.5 * (re[k] + re[k2]), ei = 0.5 * (im[k] - im[k2]);
+      Double_t dr = 0.5 * (re[k] - re[k2]), di = 0.5 * (im[k] + im[k2]);
+      // O[k] = (X[k] - conj(X[N/2-k]))/2 * exp(+2i*pi*k/N)
+      Double_t orr = dr * p->fWRe[k] + di * p->fWIm[k], oi = di * p->fWRe[k] - dr * p->fWIm[k];
+      zr[k] = er - oi;
+      zi[k] = ei + orr;
+   }
+   complex_fft(M, zr, zi, &p->fBitRev[0], &p->fTwRe[0], &p->fTwIm[0], kTRUE);
+   for (Int_t m = 0; m < M; ++m) {
+      out[2 * m] = zr[m] / M;
+      out[2 * m + 1] = zi[m] / M;
+   }
+}
+
+//____________________________________________________________________________//
+
+Int_t KVFFTEngine::Forward(const Float_t* data, Int_t n)
+{
+   // Forward transform of n values: the N/2+1 complex coefficients can be
+   // read with GetReal() & GetImag() until the next transform.
+   // Returns N, the length of the transform (see GetTransformLength()).
+
+   plan* p = GetPlan(GetTransformLength(n));
+   ForwardPlan(p, data, n);
+   return p->fN;
+}
+
+//____________________________________________________________________________//
+
+Int_t KVFFTEngine::Forward(const Float_t* data, Int_t n, Double_t* re, Double_t* im)
+{
+   // Forward transform of n values: the N/2+1 complex coefficients are copied
+   // into re & im. Returns N, the length of the transform.
+
+   Int_t N = Forward(data, n);
+   memcpy(re, &fLastPlan->fRe[0], (N / 2 + 1) * sizeof(Double_t));
+   memcpy(im, &fLastPlan->fIm[0], (N / 2 + 1) * sizeof(Double_t));
+   return N;
+}
+
+//____________________________________________________________________________//
+
+Int_t KVFFTEngine::Forward(Float_t** data, Int_t nsignals, Int_t n, Double_t** re, Double_t** im)
+{
+   // Forward transform of nsignals signals of n values, data[i][0,...,n-1]:
+   // the N/2+1 complex coefficients of each signal are copied into re[i] & im[i].
+   // Returns N, the length of the transforms.
+
+   plan* p = GetPlan(GetTransformLength(n));
+   Int_t nc = p->fN / 2 + 1;
+   for (Int_t s = 0; s < nsignals; ++s) {
+      ForwardPlan(p, data[s], n);
+      memcpy(re[s], &p->fRe[0], nc * sizeof(Double_t));
+      memcpy(im[s], &p->fIm[0], nc * sizeof(Double_t));
+   }
+   return p->fN;
+}
+
+//____________________________________________________________________________//
+
+const Double_t* KVFFTEngine::GetReal() const
+{
+   // Real parts of the N/2+1 coefficients of last forward transform
+   return (fLastPlan ? &fLastPlan->fRe[0] : 0);
+}
+
+//____________________________________________________________________________//
+
+const Double_t* KVFFTEngine::GetImag() const
+{
+   // Imaginary parts of the N/2+1 coefficients of last forward transform
+   return (fLastPlan ? &fLastPlan->fIm[0] : 0);
+}
+
+//____________________________________________________________________________//
+
+void KVFFTEngine::Inverse(Int_t N, const Double_t* re, const Double_t* im, Double_t* data)
+{
+   // Inverse transform of N/2+1 complex coefficients (re[k],im[k]) into
+   // N real values data[0,...,N-1]. N must be a power of 2.
+
+   if (N < 2 || (N & (N - 1))) {
+      Error("Inverse", "%d is not a power of 2", N);
+      return;
+   }
+   plan* p = GetPlan(N);
+   memcpy(&p->fRe[0], re, (N / 2 + 1) * sizeof(Double_t));
+   memcpy(&p->fIm[0], im, (N / 2 + 1) * sizeof(Double_t));
+   InversePlan(p);
+   memcpy(data, &p->fIn[0], N * sizeof(Double_t));
+}
+
+//____________________________________________________________________________//
+
+void KVFFTEngine::LowPassGain(Int_t N, Double_t fcut_mhz, Double_t tau_clk, Int_t order, Double_t* gain)
+{
+   // Fill gain[0,...,N/2] with gains of Butterworth low-pass filter of given order
+   // and cut-off frequency (MHz) for transform of length N of signal with
+   // channel width tau_clk (ns)
+
+   for (Int_t k = 0; k <= N / 2; ++k) {
+      Double_t f = k * 1000. / (N * tau_clk);
+      gain[k] = 1. / TMath::Sqrt(1. + TMath::Power(f / fcut_mhz, 2 * order));
+   }
+}
+
+//____________________________________________________________________________//
+
+void KVFFTEngine::HighPassGain(Int_t N, Double_t fcut_mhz, Double_t tau_clk, Int_t order, Double_t* gain)
+{
+   // Fill gain[0,...,N/2] with gains of Butterworth high-pass filter of given order
+   // and cut-off frequency (MHz) for transform of length N of signal with
+   // channel width tau_clk (ns)
+
+   gain[0] = 0.;
+   for (Int_t k = 1; k <= N / 2; ++k) {
+      Double_t f = k * 1000. / (N * tau_clk);
+      gain[k] = 1. / TMath::Sqrt(1. + TMath::Power(fcut_mhz / f, 2 * order));
+   }
+}
+
+//____________________________________________________________________________//
+
+void KVFFTEngine::Filter(Float_t* data, Int_t n, const Double_t* gain)
+{
+   // Multiply Fourier transform of n values data[0,...,n-1] by the N/2+1 real
+   // gains (N=GetTransformLength(n)) and replace data with inverse transform
+
+   Filter(&data, 1, n, gain);
+}
+
+//____________________________________________________________________________//
+
+void KVFFTEngine::Filter(Float_t** data, Int_t nsignals, Int_t n, const Double_t* gain)
+{
+   // Filter nsignals signals of n values, data[i][0,...,n-1], with the same
+   // N/2+1 real gains (N=GetTransformLength(n)): see Filter(Float_t*,...)
+
+   plan* p = GetPlan(GetTransformLength(n));
+   Int_t nc = p->fN / 2 + 1;
+   for (Int_t s = 0; s < nsignals; ++s) {
+      ForwardPlan(p, data[s], n);
+      for (Int_t k = 0; k < nc; ++k) {
+         p->fRe[k] *= gain[k];
+         p->fIm[k] *= gain[k];
+      }
+      InversePlan(p);
+      for (Int_t i = 0; i < n; ++i) data[s][i] = p->fIn[i];
+   }
+}
+
+//____________________________________________________________________________//
+
+namespace {
+   typedef std::map<std::pair<Int_t, Double_t>, std::vector<Float_t*> > signal_groups;
+
+   void group_signals(KVSignal** signals, Int_t nsignals, signal_groups& groups)
+   {
+      // group signals (arrays used by PSA methods) with same number of samples
+      // & channel width
+      for (Int_t i = 0; i < nsignals; i++) {
+         KVSignal* s = signals[i];
+         if (s->GetNSamples() > 0)
+            groups[std::make_pair(s->GetNSamples(), s->GetChannelWidth())].push_back(s->GetArray()->GetArray());
+      }
+   }
+}
+
+void KVFFTEngine::LowPass(KVSignal** signals, Int_t nsignals, Double_t fcut_mhz, Int_t order)
+{
+   // Apply Butterworth low-pass filter of given order and cut-off frequency (MHz)
+   // to all signals in the array (modifies only the arrays used by PSA methods,
+   // see KVSignal::ApplyModifications). Signals with the same number of samples
+   // and channel width are filtered together.
+
+   signal_groups groups;
+   group_signals(signals, nsignals, groups);
+   std::vector<Double_t> gain;
+   for (signal_groups::iterator it = groups.begin(); it != groups.end(); ++it) {
+      Int_t N = GetTransformLength(it->first.first);
+      gain.resize(N / 2 + 1);
+      LowPassGain(N, fcut_mhz, it->first.second, order, &gain[0]);
+      Filter(&(it->second[0]), (Int_t)it->second.size(), it->first.first, &gain[0]);
+   }
+}
+
+//____________________________________________________________________________//
+
+void KVFFTEngine::HighPass(KVSignal** signals, Int_t nsignals, Double_t fcut_mhz, Int_t order)
+{
+   // Apply Butterworth high-pass filter of given order and cut-off frequency (MHz)
+   // to all signals in the array: see LowPass()
+
+   signal_groups groups;
+   group_signals(signals, nsignals, groups);
+   std::vector<Double_t> gain;
+   for (signal_groups::iterator it = groups.begin(); it != groups.end(); ++it) {
+      Int_t N = GetTransformLength(it->first.first);
+      gain.resize(N / 2 + 1);
+      HighPassGain(N, fcut_mhz, it->first.second, order, &gain[0]);
+      Filter(&(it->second[0]), (Int_t)it->second.size(), it->first.first, &gain[0]);
+   }
+}
+
+//____________________________________________________________________________//
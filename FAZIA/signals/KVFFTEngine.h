@@ -0,0 +1,73 @@
+#ifndef __KVFFTENGINE_H
+#define __KVFFTENGINE_H
+
+#include "KVBase.h"
+#include <map>
+#include <vector>
+
+class TVirtualFFT;
+class KVSignal;
+
+class KVFFTEngine : public KVBase {
+public:
+   enum EBackend {
+      kBuiltin,  // built-in real-input radix-2 transform
+      kFFTW      // FFTW library through ROOT's TVirtualFFT plugin
+   };
+
+private:
+   struct plan;
+   EBackend fBackend;//! backend used for transforms
+   std::map<Int_t, plan*> fPlans;//! plans & buffers for each transform length
+   plan* fLastPlan;//! plan used for last transform
+
+   KVFFTEngine(const KVFFTEngine&);
+   KVFFTEngine& operator=(const KVFFTEngine&);
+
+   plan* GetPlan(Int_t N);
+   void ForwardPlan(plan* p, const Float_t* data, Int_t n);
+   void InversePlan(plan* p);
+
+public:
+   KVFFTEngine();
+   KVFFTEngine(EBackend backend);
+   virtual ~KVFFTEngine();
+
+   static KVFFTEngine* GetDefault();
+   static Bool_t IsFFTWAvailable();
+   static Int_t GetTransformLength(Int_t n);
+
+   EBackend GetBackend() const
+   {
+      // Backend used for transforms
+      return fBackend;
+   }
+   Bool_t SetBackend(EBackend backend);
+   void ClearPlans();
+   Int_t GetNumberOfPlans() const
+   {
+      // Number of transform lengths for which plans are kept in memory
+      return fPlans.size();
+   }
+
+   // forward transform of n real values (zero-padded to GetTransformLength(n))
+   Int_t Forward(const Float_t* data, Int_t n);
+   Int_t Forward(const Float_t* data, Int_t n, Double_t* re, Double_t* im);
+   Int_t Forward(Float_t** data, Int_t nsignals, Int_t n, Double_t** re, Double_t** im);
+   const Double_t* GetReal() const;
+   const Double_t* GetImag() const;
+   // inverse transform of N/2+1 complex values into N real values
+   void Inverse(Int_t N, const Double_t* re, const Double_t* im, Double_t* data);
+
+   // frequency-domain filtering
+   static void LowPassGain(Int_t N, Double_t fcut_mhz, Double_t tau_clk, Int_t order, Double_t* gain);
+   static void HighPassGain(Int_t N, Double_t fcut_mhz, Double_t tau_clk, Int_t order, Double_t* gain);
+   void Filter(Float_t* data, Int_t n, const Double_t* gain);
+   void Filter(Float_t** data, Int_t nsignals, Int_t n, const Double_t* gain);
+   void LowPass(KVSignal** signals, Int_t nsignals, Double_t fcut_mhz, Int_t order = 4);
+   void HighPass(KVSignal** signals, Int_t nsignals, Double_t fcut_mhz, Int_t order = 4);
+
+   ClassDef(KVFFTEngine, 0) //Fast Fourier transforms of real signals with cached plans
+};
+
+#endif
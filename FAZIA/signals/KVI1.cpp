@@ -107,7 +107,7 @@ Double_t KVI1::ComputeBaseLine()
 
 void KVI1::TreateSignal()
 {
-   if (GetN() == 0) return;
+   if (GetNPoints() == 0) return;
    if (!TestWidth())
       ChangeChannelWidth(GetChannelWidth());
 
@@ -103,7 +103,7 @@ Double_t KVI2::ComputeBaseLine()
 
 void KVI2::TreateSignal()
 {
-   if (GetN() == 0) return;
+   if (GetNPoints() == 0) return;
    if (!TestWidth())
       ChangeChannelWidth(GetChannelWidth());
 
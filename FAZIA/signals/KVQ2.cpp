@@ -91,7 +91,7 @@ void KVQ2::LoadPSAParameters()
 //________________________________________________________________
 void KVQ2::TreateSignal()
 {
-   if (GetN() == 0) return;
+   if (GetNPoints() == 0) return;
    if (!TestWidth())
       ChangeChannelWidth(GetChannelWidth());
 
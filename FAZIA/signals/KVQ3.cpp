@@ -122,7 +122,7 @@ void KVQ3::UpdatePSAParameter(KVDBParameterList* par)
 
 void KVQ3::TreateSignal()
 {
-   if (GetN() == 0) return;
+   if (GetNPoints() == 0) return;
    if (!TestWidth())
       ChangeChannelWidth(GetChannelWidth());
 
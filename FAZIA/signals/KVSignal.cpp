@@ -5,6 +5,7 @@
 #include "KVString.h"
 #include "TMath.h"
 #include "KVDigitalFilter.h"
+#include "KVFFTEngine.h"
 #include "KVDataSet.h"
 #include "KVEnv.h"
 #include "KVDBParameterList.h"
@@ -34,11 +35,27 @@ ClassImp(KVSignal)
 // SIGNAL TYPE
 // ===========
 // KVSignal::GetType() returns one of: "QH1", "QL1", "Q2", "Q3", "I1", "I2"
+//
+// Signals can be stored either as TGraph points (SetData), or in compact form
+// (SetSamples) as an array of float samples plus the time of the first sample
+// and the channel width: no time values are stored, and the TGraph points are
+// only filled when the signal is drawn (or if FillGraph() is called).
+// All PSA methods work in the same way with both forms.
+// The sample arrays belong to the signal and are only reallocated if the
+// number of samples changes, so that signals of detectors which are filled
+// for each event reuse the same memory.
+// N.B. compact signals have no TGraph points (GetN() returns 0) until FillGraph()
+// is called: do so before using TGraph methods (GetX(), GetY(), Eval(), ...),
+// Clone() or Write(), otherwise the samples are lost. Signals of FAZIA detectors
+// are only stored in compact form if FAZIADetector.CompactSignals is 'yes'.
 ////////////////////////////////////////////////////////////////////////////////
 
 void KVSignal::init()
 {
    fPSAIsDone = kFALSE;
+   fCompact = kFALSE;
+   fT0 = 0;
+   fGraphIsUpToDate = kFALSE;
    fChannel = kUNKDT;
    fYmin = fYmax = 0;
    fAmplitude = 0;
@@ -59,6 +76,8 @@ void KVSignal::init()
    fWithPoleZeroCorrection = kFALSE;
    fWithInterpolation = kFALSE;
    fMinimumValueForAmplitude = 0;
+   fPoleZeroFilterTau = fPoleZeroFilterClk = -1;
+   fSemiGausFilterTau = fSemiGausFilterClk = -1;
 
    //DeduceFromName();
    ResetIndexes();
@@ -108,7 +127,8 @@ KVSignal* KVSignal::ConvertTo(const Char_t* type)
    TClass* cl = TClass::GetClass(Form("KV%s", type));
    if (cl) {
       sig = (KVSignal*)cl->New();
-      sig->SetData(this->GetN(), this->GetX(), this->GetY());
+      if (fCompact) sig->SetSamples(fSamples.GetSize(), fSamples.GetArray(), fT0);
+      else sig->SetData(this->GetN(), this->GetX(), this->GetY());
       sig->LoadPSAParameters();
    }
    return sig;
@@ -141,6 +161,8 @@ void KVSignal::Set(Int_t n)
 
 void KVSignal::SetData(Int_t nn, Double_t* xx, Double_t* yy)
 {
+   // Set signal from nn points (xx[i], yy[i]) stored as TGraph points
+   fCompact = kFALSE;
    Set(nn);
    if (nn == 0) {
       Info("SetData", "called with points number=%d", nn);
@@ -157,11 +179,98 @@ void KVSignal::SetData(Int_t nn, Double_t* xx, Double_t* yy)
    SetADCData();
 }
 
+//________________________________________________________________
+namespace {
+   template<typename T> void fill_samples(TArrayF& samples, Int_t nn, const T* yy, Double_t& ymin, Double_t& ymax)
+   {
+      // copy nn values into array of samples, find min & max values
+      samples.Set(nn);
+      if (nn == 0) return;
+      Float_t* data = samples.GetArray();
+      ymin = ymax = yy[0];
+      for (Int_t np = 0; np < nn; np += 1) {
+         data[np] = yy[np];
+         if (yy[np] < ymin) ymin = yy[np];
+         if (yy[np] > ymax) ymax = yy[np];
+      }
+   }
+}
+
+void KVSignal::UseSamples(Double_t t0)
+{
+   // Called by SetSamples once fSamples have been filled: from now on the
+   // signal is stored in compact form, without TGraph points.
+
+   fPSAIsDone = kFALSE;
+   fCompact = kTRUE;
+   fT0 = t0;
+   fGraphIsUpToDate = kFALSE;
+   if (GetN()) TGraph::Set(0);
+   if (fSamples.GetSize() == 0) {
+      Info("SetSamples", "called with points number=%d", 0);
+      fAdc.Set(0);
+      return;
+   }
+   SetADCData();
+}
+
+void KVSignal::SetSamples(Int_t nn, const Short_t* yy, Double_t t0)
+{
+   // Set signal from nn ADC samples yy[i] at times t0 + i*GetChannelWidth()
+   // (compact storage: no TGraph points are filled, see FillGraph())
+   fill_samples(fSamples, nn, yy, fYmin, fYmax);
+   UseSamples(t0);
+}
+
+void KVSignal::SetSamples(Int_t nn, const Float_t* yy, Double_t t0)
+{
+   // Set signal from nn samples yy[i] at times t0 + i*GetChannelWidth()
+   // (compact storage: no TGraph points are filled, see FillGraph())
+   fill_samples(fSamples, nn, yy, fYmin, fYmax);
+   UseSamples(t0);
+}
+
+void KVSignal::SetSamples(Int_t nn, const Double_t* yy, Double_t t0)
+{
+   // Set signal from nn samples yy[i] at times t0 + i*GetChannelWidth()
+   // (compact storage: no TGraph points are filled, see FillGraph())
+   fill_samples(fSamples, nn, yy, fYmin, fYmax);
+   UseSamples(t0);
+}
+
+//________________________________________________________________
+void KVSignal::FillGraph()
+{
+   // For signals with compact storage (see SetSamples), fill the TGraph
+   // points with the samples of the signal, if not already done.
+   // This is done automatically when the signal is drawn.
+
+   if (!fCompact || fGraphIsUpToDate) return;
+   Int_t nn = fSamples.GetSize();
+   TGraph::Set(nn);
+   for (Int_t ii = 0; ii < nn; ii++) SetPoint(ii, fT0 + ii * fChannelWidth, fSamples.At(ii));
+   fGraphIsUpToDate = kTRUE;
+}
+
+//________________________________________________________________
+void KVSignal::Paint(Option_t* chopt)
+{
+   // Fill TGraph points of signal with compact storage before drawing
+   FillGraph();
+   TGraph::Paint(chopt);
+}
+
 //________________________________________________________________
 void KVSignal::SetADCData()
 {
+   // Copy signal (TGraph points or compact samples) into the array
+   // used by PSA methods
 
    fChannelWidthInt = fChannelWidth;
+   if (fCompact) {
+      fAdc = fSamples;
+      return;
+   }
    fAdc.Set(GetN());
    for (int ii = 0; ii < GetN(); ii++) fAdc.AddAt(fY[ii], ii);
 
@@ -341,6 +450,16 @@ void KVSignal::Print(Option_t*) const
 
 void KVSignal::ComputeRawAmplitude(void)
 {
+   if (fCompact) {
+      Int_t nn = fSamples.GetSize();
+      if (!nn) return;
+      fYmin = fYmax = fSamples.At(0);
+      for (Int_t np = 1; np < nn; np += 1) {
+         if (fSamples.At(np) < fYmin) fYmin = fSamples.At(np);
+         if (fSamples.At(np) > fYmax) fYmax = fSamples.At(np);
+      }
+      return;
+   }
    Double_t xx, yy;
    Int_t np = 0;
    GetPoint(np++, xx, yy);
@@ -356,6 +475,9 @@ void KVSignal::ComputeRawAmplitude(void)
 
 Bool_t KVSignal::TestWidth() const
 {
+   // compact signals are always sampled with the channel width
+   if (fCompact) return kTRUE;
+
    Double_t x0, x1, y0, y1;
 
    GetPoint(0, x0, y0);
@@ -369,6 +491,12 @@ Bool_t KVSignal::TestWidth() const
 
 void KVSignal::ChangeChannelWidth(Double_t newwidth)
 {
+   if (fCompact) {
+      // times of samples are t0 + i*channel width: set t0=0 as for TGraph points
+      fT0 = 0;
+      fGraphIsUpToDate = kFALSE;
+      return;
+   }
    Double_t xx, yy;
    for (Int_t ii = 0; ii < GetN(); ii += 1) {
       GetPoint(ii, xx, yy);
@@ -408,7 +536,7 @@ Double_t KVSignal::ComputeDuration(Double_t th)
    if (qend < qstart || qstart <= 0 || qend <= 0)
       return -1;
    //Double_t deltat = GetN() * fChannelWidth - qstart - qend;
-   Double_t deltat = ((GetN() * fChannelWidth - qend) - qstart);
+   Double_t deltat = ((GetNPoints() * fChannelWidth - qend) - qstart);
    return deltat;
 }
 
@@ -435,7 +563,7 @@ Double_t KVSignal::ComputeEndLine()
 {
    //same as ComputeBaseLine method but made on the end of the signal
    //in the same length as for the base line
-   ComputeMeanAndSigma(GetN() - (fLastBL - fFirstBL), GetN(), fEndLine, fSigmaEnd);
+   ComputeMeanAndSigma(GetNPoints() - (fLastBL - fFirstBL), GetNPoints(), fEndLine, fSigmaEnd);
    return fEndLine;
 }
 
@@ -539,10 +667,10 @@ Bool_t KVSignal::ComputeMeanAndSigma(Int_t start, Int_t stop, Double_t& mean, Do
    Double_t xx;
    mean = 0;
    Double_t mean2 = 0;
-   if (stop > GetN()) {
+   if (stop > GetNPoints()) {
       Warning("ComputeMeanAndSigma",
-              "stop position greater than number of samples %d/%d, set stop to %d", GetN(), stop, GetN());
-      stop = GetN();
+              "stop position greater than number of samples %d/%d, set stop to %d", GetNPoints(), stop, GetNPoints());
+      stop = GetNPoints();
    }
    if (start < 0) {
       Warning("ComputeMeanAndSigma",
@@ -858,42 +986,40 @@ int KVSignal::FFT(unsigned int p_nSamples, bool p_bInverseTransform,
 int KVSignal::FFT(bool p_bInverseTransform, double* p_lpRealOut, double* p_lpImagOut)
 {
    // returns the lenght of FFT( power of 2)
-   static double* buffer = NULL;
-   static int bufflen = 0;
-   int NSA = fAdc.GetSize();
-   int ibits = (int)ceil(log((double)NSA) / LOG2);
-   NSA = 1 << ibits;
-
-   if (buffer != NULL && bufflen < NSA) {
-      delete [] buffer;
-      buffer = NULL;
+   // The signal (fAdc) is zero-padded to N = smallest power of 2 >= number of samples;
+   // the N coefficients are written in p_lpRealOut & p_lpImagOut (inverse transform:
+   // complex conjugate divided by N).
+   // The transform is performed by KVFFTEngine::GetDefault(), see KVFFTEngine.
+   KVFFTEngine* engine = KVFFTEngine::GetDefault();
+   int NSA = engine->Forward(fAdc.GetArray(), fAdc.GetSize());
+   const Double_t* re = engine->GetReal();
+   const Double_t* im = engine->GetImag();
+   double norm = (p_bInverseTransform ? 1. / NSA : 1.);
+   double sign = (p_bInverseTransform ? -norm : norm);
+   for (int i = 0; i <= NSA / 2; i++) {
+      p_lpRealOut[i] = re[i] * norm;
+      p_lpImagOut[i] = im[i] * sign;
    }
-
-
-   if (buffer == NULL) {
-      bufflen = NSA;
-      buffer = new double [NSA];
+   // real signal: X[N-k] = conj(X[k])
+   for (int i = NSA / 2 + 1; i < NSA; i++) {
+      p_lpRealOut[i] = p_lpRealOut[NSA - i];
+      p_lpImagOut[i] = -p_lpImagOut[NSA - i];
    }
-   unsigned int N = fAdc.GetSize();
-   float* data = fAdc.GetArray();
-   for (unsigned int i = 0; i < N; i++)
-      buffer[i] = data[i];
-   // 0 padding
-   memset(buffer + N, 0, (NSA - N)*sizeof(double));
-   int r = FFT(NSA, p_bInverseTransform, buffer, NULL, p_lpRealOut, p_lpImagOut);
-   if (r < 0) return r;
    return NSA;
 }
+
 TH1* KVSignal::FFT2Histo(int output, TH1* hh)  // 0 modulo, 1 modulo db (normalized), 2, re, 3 im
 {
-   unsigned int N = fAdc.GetSize();
-   double* re = new double [2 * N];
-   double* im = new double [2 * N];
-   int NFFT = FFT(0, re, im);
-   if (NFFT < 0) {
-      printf("ERROR in %s: FFT returned %d!\n", __PRETTY_FUNCTION__, NFFT);
+   if (fAdc.GetSize() == 0) {
+      printf("ERROR in %s: empty signal!\n", __PRETTY_FUNCTION__);
       return NULL;
    }
+   // only the first half of the coefficients is needed: they are read directly
+   // from the buffers of the FFT engine
+   KVFFTEngine* engine = KVFFTEngine::GetDefault();
+   int NFFT = engine->Forward(fAdc.GetArray(), fAdc.GetSize());
+   const Double_t* re = engine->GetReal();
+   const Double_t* im = engine->GetImag();
    int NF = NFFT / 2;
    TH1* h = 0;
    if (!hh) h = new TH1F("hfft", "FFT of FSignal", NF, 0, 1. / fChannelWidth * 1000 / 2);
@@ -920,8 +1046,6 @@ TH1* KVSignal::FFT2Histo(int output, TH1* hh)  // 0 modulo, 1 modulo db (normali
       }
    }
 //   h->GetXaxis()->SetTitle("Frequency");
-   delete [] re;
-   delete [] im;
 
    if (output != 1) return h;
    /*** normalizzazione a 0 db ****/
@@ -1307,14 +1431,16 @@ double KVSignal::FindTzeroCFDCubic_rev(double level, double tend, int Nrecurr)
 
 void KVSignal::FIR_ApplySemigaus(double tau_usec)
 {
-   FIR_ApplyRCLowPass(tau_usec);
-   FIR_ApplyRCLowPass(tau_usec);
-   FIR_ApplyRCLowPass(tau_usec);
-   FIR_ApplyRCLowPass(tau_usec);
-
-   FIR_ApplyRCHighPass(tau_usec);
+   // 4 RC low-pass stages + 1 RC high-pass stage, applied as a single
+   // filter (see KVDigitalFilter::BuildSemiGaussian) which is kept
+   // until tau_usec or the channel width change.
 
-   Multiply(1. / (32. / 3.*TMath::Exp(-4.))); // normalizzazione
+   if (!fSemiGausFilter || tau_usec != fSemiGausFilterTau || fChannelWidth != fSemiGausFilterClk) {
+      fSemiGausFilter.reset(new KVDigitalFilter(KVDigitalFilter::BuildSemiGaussian(tau_usec, fChannelWidth)));
+      fSemiGausFilterTau = tau_usec;
+      fSemiGausFilterClk = fChannelWidth;
+   }
+   fSemiGausFilter->ApplyTo(this);
 }
 
 
@@ -1415,14 +1541,32 @@ void KVSignal::FIR_ApplyMovingAverage(int npoints)  // causal moving average
 
 void KVSignal::PoleZeroSuppression(Double_t tauRC)
 {
+   // Deconvolution of preamplifier decay + integration, applied as a single
+   // filter (see KVDigitalFilter::BuildPoleZeroSuppression) which is kept
+   // until tauRC or the channel width change.
 
-   KVDigitalFilter deconv_pa1, lp1, int1;
-   lp1 = KVDigitalFilter::BuildRCLowPassDeconv(tauRC, fChannelWidth);
-   int1 = KVDigitalFilter::BuildIntegrator(fChannelWidth);
-   deconv_pa1 = KVDigitalFilter::CombineStagesMany(&lp1, &int1);
+   if (!fPoleZeroFilter || tauRC != fPoleZeroFilterTau || fChannelWidth != fPoleZeroFilterClk) {
+      fPoleZeroFilter.reset(new KVDigitalFilter(KVDigitalFilter::BuildPoleZeroSuppression(tauRC, fChannelWidth)));
+      fPoleZeroFilterTau = tauRC;
+      fPoleZeroFilterClk = fChannelWidth;
+   }
+   fPoleZeroFilter->ApplyTo(this);
+}
 
-   deconv_pa1.ApplyTo(this);
-   Multiply(fChannelWidth / tauRC / 1000.);
+void KVSignal::FFT_ApplyLowPass(double fcut_mhz, int order)
+{
+   // Butterworth low-pass filter of given order and cut-off frequency (MHz)
+   // applied in the frequency domain (see KVFFTEngine)
+   KVSignal* sig = this;
+   KVFFTEngine::GetDefault()->LowPass(&sig, 1, fcut_mhz, order);
+}
+
+void KVSignal::FFT_ApplyHighPass(double fcut_mhz, int order)
+{
+   // Butterworth high-pass filter of given order and cut-off frequency (MHz)
+   // applied in the frequency domain (see KVFFTEngine)
+   KVSignal* sig = this;
+   KVFFTEngine::GetDefault()->HighPass(&sig, 1, fcut_mhz, order);
 }
 
 void KVSignal::ApplyModifications(TGraph* newSignal, Int_t nsa)
@@ -1432,6 +1576,14 @@ void KVSignal::ApplyModifications(TGraph* newSignal, Int_t nsa)
 
    Int_t nn = fAdc.GetSize();
    if (nsa > 0 && nsa < nn) nn = nsa;
+   if (newSignal == this && fCompact) {
+      SetChannelWidth(fChannelWidthInt);
+      if (nn > fSamples.GetSize()) fSamples.Set(nn);
+      for (int ii = 0; ii < nn; ii++) fSamples.AddAt(fAdc.At(ii), ii);
+      fT0 = 0;
+      fGraphIsUpToDate = kFALSE;
+      return;
+   }
    if (newSignal->InheritsFrom("KVSignal"))((KVSignal*)newSignal)->SetChannelWidth(fChannelWidthInt);
    for (int ii = 0; ii < nn; ii++) newSignal->SetPoint(ii, ii * fChannelWidthInt, fAdc.At(ii));
 }
@@ -7,9 +7,11 @@
 #include "TGraph.h"
 #include "TArrayF.h"
 #include "TH1F.h"
+#include <memory>
 
 class KVPSAResult;
 class KVDBParameterList;
+class KVDigitalFilter;
 
 class KVSignal : public TGraph {
 public:
@@ -35,6 +37,11 @@ protected:
    Int_t fFPGAOutputNumbers;  //!ASsociated FPGA energy outputs
 
    TArrayF fAdc;                    //! needed to use the psa methods copied from FClasses of Firenze
+   // compact storage of signal samples (see SetSamples)
+   Bool_t fCompact;                 //! kTRUE if signal is stored in fSamples instead of TGraph points
+   TArrayF fSamples;                //! samples of signal (compact storage)
+   Double_t fT0;                    //! time of first sample in ns (compact storage)
+   Bool_t fGraphIsUpToDate;         //! kTRUE if TGraph points correspond to fSamples
    //results of signal treatement
    Double_t fAmplitude;             // amplitude of the signal
    Double_t fRiseTime;              // rise time of the signal
@@ -64,12 +71,21 @@ protected:
    //
    Bool_t   fPSAIsDone;             // indicate if PSA has been done
    Double_t fChannelWidthInt;       // internal parameter channel width of interpolated signal in ns
+
+   // fused filters, kept until their parameters change
+   std::unique_ptr<KVDigitalFilter> fPoleZeroFilter;//! filter used by PoleZeroSuppression
+   Double_t fPoleZeroFilterTau;     //! tauRC of fPoleZeroFilter
+   Double_t fPoleZeroFilterClk;     //! channel width of fPoleZeroFilter
+   std::unique_ptr<KVDigitalFilter> fSemiGausFilter;//! filter used by FIR_ApplySemigaus
+   Double_t fSemiGausFilterTau;     //! tau of fSemiGausFilter
+   Double_t fSemiGausFilterClk;     //! channel width of fSemiGausFilter
    void ResetIndexes();
    virtual void BuildCubicSignal(); //Interpolazione mediante cubic
    virtual void BuildCubicSplineSignal(); //Interpolazione mediante cubic spline
    virtual void BuildSmoothingSplineSignal(); //Interpolazione mediante cubic spline
    void init();
    void TreateOldSignalName();
+   void UseSamples(Double_t t0);
 
 public:
    KVSignal();
@@ -118,6 +134,27 @@ public:
 
    //operation on data arrays
    void SetData(Int_t nn, Double_t* xx, Double_t* yy);
+   void SetSamples(Int_t nn, const Short_t* yy, Double_t t0 = 0.);
+   void SetSamples(Int_t nn, const Float_t* yy, Double_t t0 = 0.);
+   void SetSamples(Int_t nn, const Double_t* yy, Double_t t0 = 0.);
+   Bool_t IsCompact() const
+   {
+      // kTRUE if signal samples were set with SetSamples (no TGraph points)
+      return fCompact;
+   }
+   Int_t GetNPoints() const
+   {
+      // Number of points of the signal, whether it is stored as TGraph points
+      // (SetData) or as compact samples (SetSamples)
+      return (fCompact ? fSamples.GetSize() : GetN());
+   }
+   Double_t GetT0() const
+   {
+      // Time of first sample in ns (compact storage)
+      return fT0;
+   }
+   void FillGraph();
+   virtual void Paint(Option_t* chopt = "");
    virtual void Set(Int_t n);
    void SetADCData();
    TArrayF* GetArray()
@@ -388,6 +425,9 @@ public:
    static int FFT(unsigned int p_nSamples, bool p_bInverseTransform, double* p_lpRealIn, double* p_lpImagIn, double* p_lpRealOut, double* p_lpImagOut); // nsamples: power of 2
    int FFT(bool p_bInverseTransform, double* p_lpRealOut, double* p_lpImagOut);
    TH1* FFT2Histo(int output, TH1* hh = 0); // 0 modulo, 1 modulo db (normalized), 2, re, 3 im
+   // frequency-domain filters (modify only fAdc, see KVFFTEngine)
+   void FFT_ApplyLowPass(double fcut_mhz, int order = 4);
+   void FFT_ApplyHighPass(double fcut_mhz, int order = 4);
 
    // apply modifications of fAdc to the original signal
    void ApplyModifications(TGraph* newSignal = 0, Int_t nsa = -1);
@@ -7,6 +7,7 @@
 #pragma link C++ class KVCurrentSignal+;
 #pragma link C++ class KVPSAResult+;
 #pragma link C++ class KVDigitalFilter+;
+#pragma link C++ class KVFFTEngine+;
 #pragma link C++ class KVQH1+;
 #pragma link C++ class KVQL1+;
 #pragma link C++ class KVQ2+;
@@ -149,6 +149,13 @@ void KVINDRARawDataReconstructor::InitRun()
 
    Info("InitRun", "Created pulser/laser data tree (%s : %s) for %d parameters",
         genetree->GetName(), genetree->GetTitle(), genetree->GetNbranches());
+
+   // set compression & start timing of output (see KVTreeOutput)
+   // the raw data tree is filled by the raw data reader for each event
+   tree_output.Reset();
+   tree_output.AddTree(rawtree);
+   tree_output.AddTree(tree);
+   tree_output.AddTree(genetree);
    //initialise number of reconstructed events
    nb_recon = 0;
 
@@ -173,13 +180,13 @@ Bool_t KVINDRARawDataReconstructor::Analysis()
          nb_recon++;
          ExtraProcessing();
       } else {
-         genetree->Fill();
+         tree_output.FillTree(genetree);
       }
    }
    // ReconstructedEvents tree must be filled for every event, even ones where
    // no event has been reconstructed. This is so that when reading back we can make
    // RawData a 'friend' TTree and keep everything in synch.
-   tree->Fill();
+   tree_output.FillTree(tree);
    recev->Clear();
 
    return kTRUE;
@@ -195,9 +202,8 @@ void KVINDRARawDataReconstructor::EndRun()
         << nb_recon << " ***" << endl << endl;
    file->cd();
    gDataAnalyser->WriteBatchInfo(tree);
-   tree->Write();//write tree to file
-   rawtree->Write();
-   genetree->Write();
+   tree_output.WriteTrees();//write trees to file
+   tree_output.PrintReport();
 
    // get dataset to which we must associate new run
    KVDataSet* OutputDataset =
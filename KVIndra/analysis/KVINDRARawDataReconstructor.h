@@ -15,6 +15,7 @@ $Date: 2008/10/17 10:58:07 $
 #include "TFile.h"
 #include "TTree.h"
 #include "TString.h"
+#include "KVTreeOutput.h"
 
 class KVINDRARawDataReconstructor : public KVINDRARawDataAnalyser {
 protected:
@@ -23,6 +24,7 @@ protected:
    TTree* tree;
    TTree* genetree;
    TTree* rawtree;
+   KVTreeOutput tree_output;//! fills & writes trees, compression & I/O timing
    KVINDRAReconEvent* recev;
    Int_t nb_recon;//number of reconstructed INDRA events
    TString taskname;
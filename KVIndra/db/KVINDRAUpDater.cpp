@@ -68,6 +68,33 @@ void KVINDRAUpDater::SetParameters(UInt_t run)
 
 //_______________________________________________________________//
 
+void KVINDRAUpDater::SetParametersNotInSnapshot(KVDBRun* kvrun)
+{
+   //Called when parameters of INDRA are set from a run parameter snapshot
+   //(see KVUpDater::SetRunParameters). This will:
+   //      set the multiplicity trigger of gIndra using the database value for the run
+   //      set the target corresponding to the run
+   //      set the CsI total light gain corrections for the run
+   //      set PHD parameters of silicon detectors, if not already done
+
+   SetTrigger(kvrun);
+   SetTarget(kvrun);
+   SetCsIGainCorrectionParameters(kvrun);
+   if (!gIndra->ArePHDSet()) SetPHDs(kvrun);
+}
+
+//_______________________________________________________________//
+
+Bool_t KVINDRAUpDater::CanUseRunParameterSnapshots() const
+{
+   // All parameters set by SetParameters are either stored in the snapshots or
+   // set by SetParametersNotInSnapshot: snapshots can be used.
+   // Child classes which set anything else for each run must override this method.
+   return kTRUE;
+}
+
+//_______________________________________________________________//
+
 void KVINDRAUpDater::SetCalibrationParameters(UInt_t run)
 {
    //Set calibration parameters for this run.
@@ -14,6 +14,9 @@ class KVDBRun;
 
 class KVINDRAUpDater: public KVUpDater {
 
+protected:
+   virtual Bool_t CanUseRunParameterSnapshots() const;
+
 public:
 
    KVINDRAUpDater();
@@ -22,6 +25,7 @@ public:
    };
 
    virtual void SetParameters(UInt_t run);
+   virtual void SetParametersNotInSnapshot(KVDBRun*);
    virtual void SetCalibrationParameters(UInt_t);
 
    virtual void SetTrigger(KVDBRun*);
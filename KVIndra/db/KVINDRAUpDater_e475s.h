@@ -14,6 +14,13 @@ $Date: 2007/09/21 07:44:09 $
 #include "KVDBRun.h"
 
 class KVINDRAUpDater_e475s : public KVINDRAUpDater {
+protected:
+   virtual Bool_t CanUseRunParameterSnapshots() const
+   {
+      // calibrators are replaced for each run
+      return kFALSE;
+   }
+
 public:
 
    KVINDRAUpDater_e475s();
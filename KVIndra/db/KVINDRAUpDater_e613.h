@@ -8,6 +8,13 @@
 
 class KVINDRAUpDater_e613 : public KVINDRAUpDater {
 
+protected:
+   virtual Bool_t CanUseRunParameterSnapshots() const
+   {
+      // acquisition parameter names & reference gains are set for each run
+      return kFALSE;
+   }
+
 public:
    KVINDRAUpDater_e613();
    virtual ~KVINDRAUpDater_e613();
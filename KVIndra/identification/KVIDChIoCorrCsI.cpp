@@ -90,10 +90,14 @@ Bool_t KVIDChIoCorrCsI::Identify(KVIdentificationResult* idr, Double_t x, Double
    Double_t chIoCorr = (y < 0. ? GetIDMapY() : y);
    Double_t csiLight = (x < 0. ? GetIDMapX() : x);
 
-   if (fGrid->IsIdentifiable(csiLight, chIoCorr))
+   Int_t quality;
+   if (fGrid->IsIdentifiable(csiLight, chIoCorr)) {
       fGrid->Identify(csiLight, chIoCorr, idr);
+      quality = idr->IDquality;
+   } else
+      quality = fGrid->GetQualityCode(); // set by IsIdentifiable
 
-   if (fGrid->GetQualityCode() == KVIDZAGrid::kICODE8) {
+   if (quality == KVIDZAGrid::kICODE8) {
       // only if the final quality code is kICODE8 do we consider that it is
       // worthwhile looking elsewhere. In all other cases, the particle has been
       // "identified", even if we still don't know its Z and/or A (in this case
@@ -102,20 +106,20 @@ Bool_t KVIDChIoCorrCsI::Identify(KVIdentificationResult* idr, Double_t x, Double
       return kFALSE;
    }
 
-   if (fGrid->GetQualityCode() == KVIDZAGrid::kICODE7) {
+   if (quality == KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE7 (above last line in grid) then the estimated
       // Z is only a minimum value (Zmin)
       idr->IDcode = kIDCode5;
       return kTRUE;
    }
 
-   if (fGrid->GetQualityCode() > KVIDZAGrid::kICODE3 && fGrid->GetQualityCode() < KVIDZAGrid::kICODE7) {
+   if (quality > KVIDZAGrid::kICODE3 && quality < KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE4, kICODE5 or kICODE6 then this "nucleus"
       // corresponds to a point which is inbetween the lines, i.e. noise
       idr->IDcode = kIDCode10;
       return kTRUE;
    }
-   if (fGrid->GetQualityCode() == KVIDGChIoSi_e494s::k_BelowSeuilChIo) {
+   if (quality == KVIDGChIoSi_e494s::k_BelowSeuilChIo) {
 
       idr->IDcode = kIDCode15;
       return kTRUE;
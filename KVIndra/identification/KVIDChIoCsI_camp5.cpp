@@ -109,6 +109,7 @@ Bool_t KVIDChIoCsI_camp5::Identify(KVIdentificationResult* idr, Double_t x, Doub
 
    fGGgrid->Identify(lumtot, cigg, idr);
    theIdentifyingGrid = (KVIDZAGrid*)fGGgrid;
+   Int_t quality = idr->IDquality; // quality code of identification with theIdentifyingGrid
 
    if (idr->IDOK && idr->Z == theIdentifyingGrid->GetZmax() && TMath::Nint(GetIDMapY("GG")) == 4095) {
       //Gestion des saturations GG
@@ -120,18 +121,20 @@ Bool_t KVIDChIoCsI_camp5::Identify(KVIdentificationResult* idr, Double_t x, Doub
          //de 0 a 4 ou 7
          if (idr->Zident) {
             theIdentifyingGrid = (KVIDZAGrid*)fPGgrid;
+            quality = idr->IDquality;
          }
       }
    }
    if (theIdentifyingGrid == fGGgrid) {
-      if (fGGgrid->GetQualityCode() > KVIDZAGrid::kICODE6 && fPGgrid) { //we have to try PG grid (if there is one)
+      if (quality > KVIDZAGrid::kICODE6 && fPGgrid) { //we have to try PG grid (if there is one)
          // try Z & A identification in ChIo(PG)-CsI(H) map
          Double_t cipg = (y < 0. ? GetIDMapY("PG") : y);
          fPGgrid->Identify(lumtot, cipg, idr);
          theIdentifyingGrid = (KVIDZAGrid*)fPGgrid;
+         quality = idr->IDquality;
       }
    }
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE8) {
+   if (quality == KVIDZAGrid::kICODE8) {
       // only if the final quality code is kICODE8 do we consider that it is
       // worthwhile looking elsewhere. In all other cases, the particle has been
       // "identified", even if we still don't know its Z and/or A (in this case
@@ -139,15 +142,15 @@ Bool_t KVIDChIoCsI_camp5::Identify(KVIdentificationResult* idr, Double_t x, Doub
       return kFALSE;
    }
 
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE7) {
+   if (quality == KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE7 (above last line in grid) then the estimated
       // Z is only a minimum value (Zmin)
       idr->IDcode = kIDCode5;
       return kTRUE;
    }
 
-   if (theIdentifyingGrid->GetQualityCode() > KVIDZAGrid::kICODE3 &&
-         theIdentifyingGrid->GetQualityCode() < KVIDZAGrid::kICODE7) {
+   if (quality > KVIDZAGrid::kICODE3 &&
+         quality < KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE4, kICODE5 or kICODE6 then this "nucleus"
       // corresponds to a point which is inbetween the lines, i.e. noise
       idr->IDcode = kIDCode10;
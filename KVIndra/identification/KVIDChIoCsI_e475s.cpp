@@ -84,10 +84,11 @@ Bool_t KVIDChIoCsI_e475s::Identify(KVIdentificationResult* IDR, Double_t x, Doub
    Double_t varX = (x < 0. ? GetIDMapX() : x);
    Double_t varY = (y < 0. ? GetIDMapY() : y);
 
-   if (fidgrid->IsIdentifiable(varX, varY))
+   Int_t quality = KVIDZAGrid::kICODE8;
+   if (fidgrid->IsIdentifiable(varX, varY)) {
       fidgrid->Identify(varX, varY, IDR);
-
-   Int_t quality = fidgrid->GetQualityCode();
+      quality = IDR->IDquality;
+   }
 
    if (quality == KVIDZAGrid::kICODE8) {
       // only if the final quality code is kICODE8 do we consider that it is
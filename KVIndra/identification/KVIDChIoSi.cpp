@@ -57,10 +57,15 @@ Bool_t KVIDChIoSi::Identify(KVIdentificationResult* IDR, Double_t x, Double_t y)
    Double_t chio = (y < 0. ? GetIDMapY() : y);
    Double_t si = (x < 0. ? GetIDMapX() : x);
 
-   if (ChIoSiGrid->IsIdentifiable(si, chio))
+   Int_t quality;
+   if (ChIoSiGrid->IsIdentifiable(si, chio)) {
       ChIoSiGrid->Identify(si, chio, IDR);
-   Int_t quality = ChIoSiGrid->GetQualityCode();
-   IDR->IDquality = quality;
+      quality = IDR->IDquality;
+   } else {
+      // quality code set by IsIdentifiable
+      quality = ChIoSiGrid->GetQualityCode();
+      IDR->IDquality = quality;
+   }
 
    // set general ID code
    IDR->IDcode = kIDCode4;
@@ -80,34 +80,31 @@ Bool_t KVIDChIoSi75_camp5::Identify(KVIdentificationResult* IDR, Double_t x, Dou
 
    IDR->SetIDType(GetType());
    IDR->IDattempted = kTRUE;
-   KVIDGrid* theIdentifyingGrid = 0;
 
    if (fGGgrid) {
       Double_t cigg = (y < 0. ?       GetIDMapY("GG")   : y);
       Double_t sigg = (x < 0. ?       GetIDMapX("GG")   : x);
       fGGgrid->Identify(sigg, cigg, IDR);
-      theIdentifyingGrid = (KVIDGrid*)fGGgrid;
 
    }
-   if ((fGGgrid && fGGgrid->GetQualityCode() > KVIDZAGrid::kICODE6) || !fGGgrid) { //we have to try PG grid (if there is one)
+   if ((fGGgrid && IDR->IDquality > KVIDZAGrid::kICODE6) || !fGGgrid) { //we have to try PG grid (if there is one)
 
       if (fPGgrid) {
          Double_t cipg = (y < 0. ?       GetIDMapY("PG")   : y);
          Double_t sipg = (x < 0. ?       GetIDMapX("PG")   : x);
          fPGgrid->Identify(sipg, cipg, IDR);
-         theIdentifyingGrid = (KVIDGrid*)fPGgrid;
       }
    }
 
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE7) {
+   if (IDR->IDquality == KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE7 (above last line in grid) then the estimated
       // Z is only a minimum value (Zmin)
       IDR->IDcode = kIDCode5;
       return kTRUE;
    }
 
-   if (theIdentifyingGrid->GetQualityCode() > KVIDZAGrid::kICODE3 &&
-         theIdentifyingGrid->GetQualityCode() < KVIDZAGrid::kICODE7) {
+   if (IDR->IDquality > KVIDZAGrid::kICODE3 &&
+         IDR->IDquality < KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE4, kICODE5 or kICODE6 then this "nucleus"
       // corresponds to a point which is inbetween the lines, i.e. noise
       IDR->IDcode = kIDCode10;
@@ -83,31 +83,30 @@ Bool_t KVIDChIoSi_e613::Identify(KVIdentificationResult* IDR, Double_t x, Double
    Double_t chio = (y < 0. ? GetIDMapY() : y);
    Double_t si = (x < 0. ? GetIDMapX() : x);
 
-   KVIDZAGrid* theIdentifyingGrid = 0;
-   theIdentifyingGrid = ChIoSiGrid;
+   Int_t quality; // quality code of identification with grid used
    if (ChIoSiGrid->IsIdentifiable(si, chio)) {
       ChIoSiGrid->Identify(si, chio, IDR);
+      quality = IDR->IDquality;
       if (IDR->IDOK) {  // < quality code 4
          /*
          Info("Identify","Cas0 identification OK avec grille std, IDRcode=%d IDRz=%d IDRq=%d Grilleq=%d",
             IDR->IDcode,
             IDR->Z,
             IDR->IDquality,
-            theIdentifyingGrid->GetQualityCode()
+            quality
          );
          */
-         //theIdentifyingGrid = ChIoSiGrid;
       } else {
          if (FromFitChIoSiGrid) {
             FromFitChIoSiGrid->Identify(si, chio, IDR);
             if (IDR->IDOK) {
-               theIdentifyingGrid = FromFitChIoSiGrid;
+               quality = IDR->IDquality;
                /*
                Info("Identify","Cas1 identification OK avec grille fitte, IDRcode=%d IDRz=%d IDRq=%d Grilleq=%d",
                   IDR->IDcode,
                   IDR->Z,
                   IDR->IDquality,
-                  theIdentifyingGrid->GetQualityCode()
+                  quality
                );
                */
             }
@@ -115,16 +114,15 @@ Bool_t KVIDChIoSi_e613::Identify(KVIdentificationResult* IDR, Double_t x, Double
       }
    } else if (FromFitChIoSiGrid->IsIdentifiable(si, chio)) {
       FromFitChIoSiGrid->Identify(si, chio, IDR);
-      theIdentifyingGrid = FromFitChIoSiGrid;
-      Info("Identify", "Cas2 identification avec grille fitte, IDRcode=%d IDRz=%d IDRq=%d Grilleq=%d",
+      quality = IDR->IDquality;
+      Info("Identify", "Cas2 identification avec grille fitte, IDRcode=%d IDRz=%d IDRq=%d",
            IDR->IDcode,
            IDR->Z,
-           IDR->IDquality,
-           theIdentifyingGrid->GetQualityCode()
+           IDR->IDquality
           );
-   }
+   } else
+      quality = ChIoSiGrid->GetQualityCode(); // set by IsIdentifiable
 
-   Int_t quality = theIdentifyingGrid->GetQualityCode();
    IDR->IDquality = quality;
 
    // set general ID code
@@ -27,8 +27,9 @@ ClassImp(KVIDGChIoSi)
 //            grid->Identify(x,y,nuc);
 //     }
 //
-// After attempting identification with method Identify, GetQualityCode() method returns
-// one of the following status codes:
+// After attempting identification with method Identify, KVIdentificationResult::IDquality
+// contains one of the following status codes (if IsIdentifiable returns kFALSE,
+// GetQualityCode() gives the reason):
 //
 // KVIDZAGrid::kICODE0,                   OK
 // KVIDZAGrid::kICODE1,                   slight ambiguity of Z, which could be larger
@@ -219,8 +220,8 @@ void KVIDGChIoSi::Streamer(TBuffer& R__b)
 void KVIDGChIoSi::Identify(Double_t x, Double_t y, KVIdentificationResult* idr) const
 {
    // After identification of the particle, we adjust the quality code
-   // (if the particle was well-identified by KVIDZAGrid::Identify, i.e. with
-   // fICode<KVIDZAGrid::kICODE4) if:
+   // idr->IDquality (if the particle was well-identified by KVIDZAGrid::Identify, i.e. with
+   // idr->IDquality<KVIDZAGrid::kICODE4) if:
    //    the particle is below the 'Bragg_line' => quality code KVIDGChIoSi::k_LeftOfBragg
    //           in this case the Z given is a minimum value
    //    the particle is below the 'Punch_through' line
@@ -231,26 +232,24 @@ void KVIDGChIoSi::Identify(Double_t x, Double_t y, KVIdentificationResult* idr)
 
    KVIDZAGrid::Identify(x, y, idr);
    // check Bragg & punch through for well identified particles
-   if (fICode < KVIDZAGrid::kICODE4) {
+   if (idr->IDquality < KVIDZAGrid::kICODE4) {
       //identified particles below (left of) Bragg line : Z is a Zmin
       if (fBragg && fBragg->WhereAmI(x, y, "left")) {
-         const_cast<KVIDGChIoSi*>(this)->fICode = k_LeftOfBragg;
+         idr->IDquality = k_LeftOfBragg;
          idr->SetComment("Point to identify below Bragg curve. Z given is a Zmin");
       }
       //if a particle is well-identified (i.e. not too far from the identification lines)
       //but it lies below the 'Punch_through' line, we give it a warning code
       if (fPunch && fPunch->WhereAmI(x, y, "below")) {
-         const_cast<KVIDGChIoSi*>(this)->fICode = k_BelowPunchThrough;
+         idr->IDquality = k_BelowPunchThrough;
          idr->SetComment("warning: point below punch-through line");
       }
-      idr->IDquality = fICode;
-   } else if (fICode == KVIDZAGrid::kICODE7) {
+   } else if (idr->IDquality == KVIDZAGrid::kICODE7) {
       // for particles above last line in grid, check if we are in fact in the Bragg zone
       if (fBragg && fBragg->WhereAmI(x, y, "left")) {
-         const_cast<KVIDGChIoSi*>(this)->fICode = k_LeftOfBragg;
+         idr->IDquality = k_LeftOfBragg;
          idr->SetComment("Point to identify below Bragg curve. Z given is a Zmin");
          idr->IDOK = kTRUE;
-         idr->IDquality = fICode;
       }
 
    }
@@ -19,8 +19,9 @@ ClassImp(KVIDGChIoSi_e494s)
 //            grid->Identify(x,y,nuc);
 //     }
 //
-// After attempting identification with method Identify, GetQualityCode() method returns
-// one of the following status codes:
+// After attempting identification with method Identify, KVIdentificationResult::IDquality
+// contains one of the following status codes (if IsIdentifiable returns kFALSE,
+// GetQualityCode() gives the reason):
 //
 // KVIDZAGrid::kICODE0,                   OK
 // KVIDZAGrid::kICODE1,                   slight ambiguity of Z, which could be larger
@@ -71,24 +72,23 @@ void KVIDGChIoSi_e494s::init()
 void KVIDGChIoSi_e494s::Identify(Double_t x, Double_t y, KVIdentificationResult* idr) const
 {
    // After identification of the particle, we adjust the quality code
-   // (if the particle was well-identified by KVIDGChIoSi::Identify, i.e. with
-   // fICode<KVIDZAGrid::kICODE4) if:
+   // idr->IDquality (if the particle was well-identified by KVIDGChIoSi::Identify, i.e. with
+   // idr->IDquality<KVIDZAGrid::kICODE4) if:
    //    the particle is below the 'ChIo threshold line' => quality code KVIDGChIoSi_e494s::k_BelowSeuilChIo
 
    KVIDGChIoSi::Identify(x, y, idr);
 
-   if (fICode < kICODE4) {
+   if (idr->IDquality < kICODE4) {
 
       if (fChIoSeuil && fChIoSeuil->WhereAmI(x, y, "below")) {
-         const_cast<KVIDGChIoSi_e494s*>(this)->fICode = k_BelowSeuilChIo;
+         idr->IDquality = k_BelowSeuilChIo;
          idr->SetComment("warning: point below ChIo threshold line");
       }
       Int_t ZValidityvalue = -1;
       ZValidityvalue = const_cast<KVIDGChIoSi_e494s*>(this)->GetParameters()->GetIntValue("ZValidity");
       if (ZValidityvalue > -1 && idr->Z > ZValidityvalue) {
-         const_cast<KVIDGChIoSi_e494s*>(this)->fICode = kICODE9;
+         idr->IDquality = kICODE9;
       }
-      idr->IDquality = fICode;
    }
 }
 //________________________________________________________________
@@ -16,13 +16,13 @@ private:
 
 protected:
 
-   virtual Bool_t AcceptIDForTest()
+   virtual Bool_t AcceptIDForTest(const KVIdentificationResult* idr) const
    {
       // Used by test Identification.
       // For a general (Z,A) grid we only include particles with
-      // GetQualityCode()<4 (i.e. well identified) or equal to kICODE9
+      // quality code <4 (i.e. well identified) or equal to kICODE9
       // (i.e. well identified from extrapolated ID lines).
-      return (KVIDGChIoSi::AcceptIDForTest() || (fICode == kICODE9));
+      return (KVIDGChIoSi::AcceptIDForTest(idr) || (idr->IDquality == kICODE9));
    };
 
 public:
@@ -30,7 +30,7 @@ ClassImp(KVIDINDRACsI)
 //Identification in CsI R-L matrices of INDRA
 //
 //Identification subcodes are written in bits 0-3 of KVIDSubCodeManager
-//(see KVINDRACodes). They correspond to the values of KVIDGCsI::GetQualityCode()
+//(see KVINDRACodes). They correspond to the quality codes of KVIDGCsI
 //(see KVIDGCsI class description).
 KVIDINDRACsI::KVIDINDRACsI()
 {
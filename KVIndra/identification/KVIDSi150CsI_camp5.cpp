@@ -87,23 +87,20 @@ Bool_t KVIDSi150CsI_camp5::Identify(KVIdentificationResult* IDR, Double_t x, Dou
 
    IDR->SetIDType(GetType());
    IDR->IDattempted = kTRUE;
-   KVIDGrid* theIdentifyingGrid = 0;
 
    // try full isotopic identification
    Double_t sili = (y < 0. ? GetIDMapY() : y);
    Double_t csi = (x < 0. ? GetIDMapX() : x);
    fZAGrid->Identify(csi, sili, IDR);
-   theIdentifyingGrid = fZAGrid;
 
-   if (fZAGrid->GetQualityCode() > KVIDZAGrid::kICODE6 && fZGrid) {
+   if (IDR->IDquality > KVIDZAGrid::kICODE6 && fZGrid) {
 
       // particle is above Z&A grid: try Z only ID
       fZGrid->Identify(csi, sili, IDR);
-      theIdentifyingGrid = fZGrid;
    }
 
 
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE8) {
+   if (IDR->IDquality == KVIDZAGrid::kICODE8) {
       // only if the final quality code is kICODE8 do we consider that it is
       // worthwhile looking elsewhere. In all other cases, the particle has been
       // "identified", even if we still don't know its Z and/or A (in this case
@@ -111,15 +108,15 @@ Bool_t KVIDSi150CsI_camp5::Identify(KVIdentificationResult* IDR, Double_t x, Dou
       return kFALSE;
    }
 
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE7) {
+   if (IDR->IDquality == KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE7 (above last line in grid) then the estimated
       // Z is only a minimum value (Zmin)
       IDR->IDcode = kIDCode5;
       return kTRUE;
    }
 
-   if (theIdentifyingGrid->GetQualityCode() > KVIDZAGrid::kICODE3 &&
-         theIdentifyingGrid->GetQualityCode() < KVIDZAGrid::kICODE7) {
+   if (IDR->IDquality > KVIDZAGrid::kICODE3 &&
+         IDR->IDquality < KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE4, kICODE5 or kICODE6 then this "nucleus"
       // corresponds to a point which is inbetween the lines, i.e. noise
       IDR->IDcode = kIDCode10;
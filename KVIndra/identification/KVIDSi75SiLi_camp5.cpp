@@ -95,26 +95,21 @@ Bool_t KVIDSi75SiLi_camp5::Identify(KVIdentificationResult* IDR, Double_t x, Dou
    Double_t si75 = (y < 0. ? GetIDMapY("GG") : y);
    Double_t sili = (x < 0. ? GetIDMapX() : x);
 
-   KVIDGrid* theIdentifyingGrid = 0;
-
    fGGgrid->Identify(sili, si75, IDR);
-   theIdentifyingGrid = (KVIDGrid*)fGGgrid;
 
-   if (fGGgrid->GetQualityCode() > KVIDZAGrid::kICODE6 && fPGgrid) { //we have to try PG grid (if there is one)
+   if (IDR->IDquality > KVIDZAGrid::kICODE6 && fPGgrid) { //we have to try PG grid (if there is one)
 
       // try Z & A identification in Si75(PG)-SiLi(PG) map
       si75 = (y < 0. ? GetIDMapY("PG") : y);
       fPGgrid->Identify(sili, si75, IDR);
-      theIdentifyingGrid = (KVIDGrid*)fPGgrid;
 
-      if (fPGgrid->GetQualityCode() > KVIDZAGrid::kICODE6 && fPGZgrid) { //we have to try PGZ grid (if there is one)
+      if (IDR->IDquality > KVIDZAGrid::kICODE6 && fPGZgrid) { //we have to try PGZ grid (if there is one)
 
          fPGZgrid->Identify(sili, si75, IDR);
-         theIdentifyingGrid = (KVIDGrid*)fPGZgrid;
       }
    }
 
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE8) {
+   if (IDR->IDquality == KVIDZAGrid::kICODE8) {
       // only if the final quality code is kICODE8 do we consider that it is
       // worthwhile looking elsewhere. In all other cases, the particle has been
       // "identified", even if we still don't know its Z and/or A (in this case
@@ -122,15 +117,15 @@ Bool_t KVIDSi75SiLi_camp5::Identify(KVIdentificationResult* IDR, Double_t x, Dou
       return kFALSE;
    }
 
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE7) {
+   if (IDR->IDquality == KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE7 (above last line in grid) then the estimated
       // Z is only a minimum value (Zmin)
       IDR->IDcode = kIDCode5;
       return kTRUE;
    }
 
-   if (theIdentifyingGrid->GetQualityCode() > KVIDZAGrid::kICODE3 &&
-         theIdentifyingGrid->GetQualityCode() < KVIDZAGrid::kICODE7) {
+   if (IDR->IDquality > KVIDZAGrid::kICODE3 &&
+         IDR->IDquality < KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE4, kICODE5 or kICODE6 then this "nucleus"
       // corresponds to a point which is inbetween the lines, i.e. noise
       IDR->IDcode = kIDCode10;
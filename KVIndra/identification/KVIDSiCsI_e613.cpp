@@ -106,6 +106,7 @@ Bool_t KVIDSiCsI_e613::Identify(KVIdentificationResult* idr, Double_t x, Double_
    KVIDZAGrid* TheGrid = 0;
 
    fGGgrid->Identify(lumtot, sigg, idr);
+   Int_t quality = idr->IDquality; // quality code of identification with TheGrid
    // check if silicon-GG is in pedestal region (possible neutron)
    if (fPIEDESTAL) {
       if (fPIEDESTAL->TestPoint(lumtot, sigg)) idr->deltaEpedestal = KVIdentificationResult::deltaEpedestal_NO;
@@ -128,18 +129,20 @@ Bool_t KVIDSiCsI_e613::Identify(KVIdentificationResult* idr, Double_t x, Double_
          if (idr->Zident) {
             //Info("Identify","On passe de %d a %d",Zgg,Zpg);
             TheGrid = (KVIDZAGrid*) fPGgrid;
+            quality = idr->IDquality;
          }
       }
    }
 
    if (TheGrid == fGGgrid) {
-      if (fGGgrid->GetQualityCode() > KVIDZAGrid::kICODE6 && fPGgrid) { //we have to try PG grid (if there is one)
+      if (quality > KVIDZAGrid::kICODE6 && fPGgrid) { //we have to try PG grid (if there is one)
          Double_t sipg = (y < 0. ? GetIDMapY("PG") : y);
          fPGgrid->Identify(lumtot, sipg, idr);
          TheGrid = (KVIDZAGrid*) fPGgrid;
+         quality = idr->IDquality;
       }
    }
-   if (TheGrid->GetQualityCode() == KVIDZAGrid::kICODE8) {
+   if (quality == KVIDZAGrid::kICODE8) {
       // only if the final quality code is kICODE8 do we consider that it is
       // worthwhile looking elsewhere. In all other cases, the particle has been
       // "identified", even if we still don't know its Z and/or A (in this case
@@ -148,7 +151,7 @@ Bool_t KVIDSiCsI_e613::Identify(KVIdentificationResult* idr, Double_t x, Double_
       return kFALSE;
    }
 
-   if (TheGrid->GetQualityCode() == KVIDZAGrid::kICODE7) {
+   if (quality == KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE7 (above last line in grid) then the estimated
       // Z is only a minimum value (Zmin)
       idr->IDcode = kIDCode5;
@@ -156,7 +159,7 @@ Bool_t KVIDSiCsI_e613::Identify(KVIdentificationResult* idr, Double_t x, Double_
       return kTRUE;
    }
 
-   if (TheGrid->GetQualityCode() > KVIDZAGrid::kICODE3 && TheGrid->GetQualityCode() < KVIDZAGrid::kICODE7) {
+   if (quality > KVIDZAGrid::kICODE3 && quality < KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE4, kICODE5 or kICODE6 then this "nucleus"
       // corresponds to a point which is inbetween the lines, i.e. noise
 
@@ -90,21 +90,17 @@ Bool_t KVIDSiLiCsI_camp5::Identify(KVIdentificationResult* IDR, Double_t x, Doub
    Double_t sili = (y < 0. ? GetIDMapY("GG") : y);
    Double_t csir = (x < 0. ? GetIDMapX() : x);
 
-   KVIDGrid* theIdentifyingGrid = 0;
-
    fGGgrid->Identify(csir, sili, IDR);
-   theIdentifyingGrid = (KVIDGrid*)fGGgrid;
 
-   if (fGGgrid->GetQualityCode() > KVIDZAGrid::kICODE6 && fPGgrid) { //we have to try PG grid (if there is one)
+   if (IDR->IDquality > KVIDZAGrid::kICODE6 && fPGgrid) { //we have to try PG grid (if there is one)
 
       // try Z & A identification in SiLi(PG)-CsI(R) map
       sili = (y < 0. ? GetIDMapY("PG") : y);
       fPGgrid->Identify(csir, sili, IDR);
-      theIdentifyingGrid = (KVIDGrid*)fPGgrid;
    }
 
 
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE8) {
+   if (IDR->IDquality == KVIDZAGrid::kICODE8) {
       // only if the final quality code is kICODE8 do we consider that it is
       // worthwhile looking elsewhere. In all other cases, the particle has been
       // "identified", even if we still don't know its Z and/or A (in this case
@@ -112,15 +108,15 @@ Bool_t KVIDSiLiCsI_camp5::Identify(KVIdentificationResult* IDR, Double_t x, Doub
       return kFALSE;
    }
 
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE7) {
+   if (IDR->IDquality == KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE7 (above last line in grid) then the estimated
       // Z is only a minimum value (Zmin)
       IDR->IDcode = kIDCode5;
       return kTRUE;
    }
 
-   if (theIdentifyingGrid->GetQualityCode() > KVIDZAGrid::kICODE3 &&
-         theIdentifyingGrid->GetQualityCode() < KVIDZAGrid::kICODE7) {
+   if (IDR->IDquality > KVIDZAGrid::kICODE3 &&
+         IDR->IDquality < KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE4, kICODE5 or kICODE6 then this "nucleus"
       // corresponds to a point which is inbetween the lines, i.e. noise
       IDR->IDcode = kIDCode10;
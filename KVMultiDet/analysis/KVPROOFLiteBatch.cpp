@@ -4,6 +4,7 @@
 #include "KVPROOFLiteBatch.h"
 
 #include <TProof.h>
+#include <TEnv.h>
 
 ClassImp(KVPROOFLiteBatch)
 
@@ -32,10 +33,14 @@ KVPROOFLiteBatch::~KVPROOFLiteBatch()
 void KVPROOFLiteBatch::SubmitTask(KVDataAnalyser* da)
 {
    // Run analysis on PROOFLite facility
+   //
+   // The number of workers is given by variable PROOFLite.BatchSystem.NumberOfWorkers
+   // (default 0: one worker per available core)
 
    // Open PROOFLite session and initialise KaliVeda package
    if (!gProof) {
-      TProof* p = TProof::Open("");
+      Int_t nworkers = gEnv->GetValue("PROOFLite.BatchSystem.NumberOfWorkers", 0);
+      TProof* p = TProof::Open(nworkers > 0 ? Form("workers=%d", nworkers) : "");
       p->ClearCache();//to avoid problems with compilation of KVParticleCondition
       // enable KaliVeda on PROOF cluster
       if (p->EnablePackage("KaliVeda") != 0) {
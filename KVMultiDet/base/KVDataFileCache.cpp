@@ -0,0 +1,350 @@
+#include "KVDataFileCache.h"
+#include "TSystem.h"
+#include "TEnv.h"
+#include "TError.h"
+#include "Riostream.h"
+#include <cstring>
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+ClassImp(KVDataFileCache)
+
+////////////////////////////////////////////////////////////////////////////////
+// BEGIN_HTML <!--
+/* -->
+<h2>KVDataFileCache</h2>
+<h4>Versioned binary memory-mapped cache of data read from text files</h4>
+<!-- */
+// --> END_HTML
+//Data read from text files at start-up (nuclear data tables, range tables...)
+//can be kept in a binary cache file, which is read instead of the text file by
+//all following processes. Typical use:
+//
+//    KVDataFileCache cache("MyTable", full_path_to_text_file, version);
+//    if (cache.Open()) {
+//       // read values with cache.ReadInt(), cache.ReadDouble(), ...
+//       if (cache.IsOK()) return;
+//    }
+//    // read text file...
+//    // write values with cache.WriteInt(), cache.WriteDouble(), ...
+//    cache.Save();
+//
+//The cache file is memory-mapped read-only: all processes running on the same
+//machine share the same physical copy. It is only used if its header matches the
+//current size & modification time of the text file, the version of the format
+//of the cached data given to the constructor, and the byte order of the machine:
+//if the text file is modified, the cache is automatically rebuilt by the next
+//process which reads it.
+//
+//Cache files are kept in the directory given by GetCacheDirectory(). Caches can
+//be built once and for all at installation time by pointing
+//KVDataFileCache.Directory to a directory shared by all users and reading the
+//data once (see example base_data_cache.C): if a process cannot write in this
+//directory, the text files are used instead.
+//
+//The time taken to read each data file (from cache or from text) is recorded
+//with AddTiming() and can be printed with PrintTimingReport(), or as soon as
+//each file is read by setting
+//
+//    KVDataFileCache.TimingReport:   yes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+   // header at beginning of each cache file
+   struct cache_header {
+      char magic[8];
+      UInt_t byte_order;
+      UInt_t format;
+      UInt_t version;
+      UInt_t reserved;
+      Long64_t source_size;
+      Long64_t source_time;
+      Long64_t data_size;
+   };
+   const char cache_magic[8] = {'K', 'V', 'D', 'C', 'A', 'C', 'H', 'E'};
+   const UInt_t cache_byte_order = 0x01020304;
+   const UInt_t cache_format = 1;
+
+   // start-up timing report
+   struct cache_timing {
+      TString what, source;
+      Bool_t from_cache;
+      Double_t seconds;
+   };
+   std::vector<cache_timing> timings;
+}
+
+KVDataFileCache::KVDataFileCache(const Char_t* name, const Char_t* source, UInt_t version)
+   : KVBase(name, "binary data cache"), fSource(source), fVersion(version),
+     fSourceSize(0), fSourceTime(0), fSourceOK(kFALSE),
+     fData(0), fDataSize(0), fMapped(kFALSE), fPos(0), fReadOK(kFALSE)
+{
+   // Cache for data read from text file 'source' (full path).
+   // The name is used to make the name of the cache file, which is different for
+   // each source file: several caches can be made from the same text file using
+   // different names.
+   // The version number must be changed whenever the format/order of the data
+   // written in the cache changes.
+   //
+   // The size & modification time of the source file are read here, so that a
+   // cache written after reading the text file is never considered up to date if
+   // the text file is changed while it is being read.
+
+   FileStat_t st;
+   if (!gSystem->GetPathInfo(fSource, st)) {
+      fSourceOK = kTRUE;
+      fSourceSize = st.fSize;
+      fSourceTime = st.fMtime;
+   }
+   fCacheFile.Form("%s_%s_%08x.bin", name, gSystem->BaseName(fSource), fSource.Hash());
+   fCacheFile.Prepend("/");
+   fCacheFile.Prepend(GetCacheDirectory());
+}
+
+KVDataFileCache::~KVDataFileCache()
+{
+   // Destructor
+   Close();
+}
+
+Bool_t KVDataFileCache::IsEnabled()
+{
+   // Binary caches are used unless
+   //
+   //    KVDataFileCache.Enabled:   no
+
+   return gEnv->GetValue("KVDataFileCache.Enabled", kTRUE);
+}
+
+TString KVDataFileCache::GetCacheDirectory()
+{
+   // Directory where binary cache files are kept, given by the value of
+   //
+   //    KVDataFileCache.Directory:
+   //
+   // (environment variables and '~' are expanded). By default, this is the
+   // 'DataCache' subdirectory of the user's KaliVeda working directory.
+
+   TString dir = gEnv->GetValue("KVDataFileCache.Directory", "");
+   if (dir == "") dir = GetWORKDIRFilePath("DataCache");
+   gSystem->ExpandPathName(dir);
+   return dir;
+}
+
+Bool_t KVDataFileCache::Open()
+{
+   // Open (memory-map) the cache file, if it exists and is up to date.
+   // Returns kFALSE if the cache cannot be used: in this case the data must be
+   // read from the source file (and can then be written with Save()).
+
+   Close();
+   if (!IsEnabled() || !fSourceOK || gSystem->AccessPathName(fCacheFile)) return kFALSE;
+
+#ifndef WIN32
+   int fd = open(fCacheFile.Data(), O_RDONLY);
+   if (fd < 0) return kFALSE;
+   struct stat cs;
+   if (fstat(fd, &cs) || cs.st_size < (off_t)sizeof(cache_header)) {
+      close(fd);
+      return kFALSE;
+   }
+   void* addr = mmap(0, cs.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if (addr == MAP_FAILED) return kFALSE;
+   fData = (const char*)addr;
+   fDataSize = cs.st_size;
+   fMapped = kTRUE;
+#else
+   std::ifstream f(fCacheFile.Data(), std::ios::in | std::ios::binary);
+   if (!f.good()) return kFALSE;
+   f.seekg(0, std::ios::end);
+   Long64_t size = f.tellg();
+   if (size < (Long64_t)sizeof(cache_header)) return kFALSE;
+   fFileBuffer.resize(size);
+   f.seekg(0, std::ios::beg);
+   if (!f.read(&fFileBuffer[0], size)) return kFALSE;
+   fData = &fFileBuffer[0];
+   fDataSize = size;
+#endif
+
+   if (!CheckHeader()) {
+      Close();
+      return kFALSE;
+   }
+   fPos = sizeof(cache_header);
+   fReadOK = kTRUE;
+   return kTRUE;
+}
+
+Bool_t KVDataFileCache::CheckHeader()
+{
+   // Returns kTRUE if cache file corresponds to current source file & version
+
+   cache_header h;
+   memcpy(&h, fData, sizeof(cache_header));
+   return (!memcmp(h.magic, cache_magic, sizeof(cache_magic))
+           && h.byte_order == cache_byte_order
+           && h.format == cache_format
+           && h.version == fVersion
+           && h.source_size == fSourceSize
+           && h.source_time == fSourceTime
+           && h.data_size == fDataSize - (Long64_t)sizeof(cache_header));
+}
+
+void KVDataFileCache::Close()
+{
+   // Unmap cache file
+
+#ifndef WIN32
+   if (fMapped) munmap(const_cast<char*>(fData), fDataSize);
+#endif
+   fFileBuffer.clear();
+   fData = 0;
+   fDataSize = 0;
+   fMapped = kFALSE;
+   fPos = 0;
+   fReadOK = kFALSE;
+}
+
+Bool_t KVDataFileCache::ReadBytes(void* dest, Long64_t n)
+{
+   // Copy next n bytes of cache to dest
+   if (!fReadOK || n < 0 || fPos + n > fDataSize) {
+      fReadOK = kFALSE;
+      return kFALSE;
+   }
+   memcpy(dest, fData + fPos, n);
+   fPos += n;
+   return kTRUE;
+}
+
+Int_t KVDataFileCache::ReadInt()
+{
+   Int_t i = 0;
+   ReadBytes(&i, sizeof(Int_t));
+   return i;
+}
+
+Double_t KVDataFileCache::ReadDouble()
+{
+   Double_t x = 0;
+   ReadBytes(&x, sizeof(Double_t));
+   return x;
+}
+
+TString KVDataFileCache::ReadString()
+{
+   Int_t n = ReadInt();
+   if (!fReadOK || n < 0 || fPos + n > fDataSize) {
+      fReadOK = kFALSE;
+      return "";
+   }
+   TString s(fData + fPos, n);
+   fPos += n;
+   return s;
+}
+
+void KVDataFileCache::ReadArray(Double_t* values, Int_t n)
+{
+   if (!ReadBytes(values, n * sizeof(Double_t))) memset(values, 0, n * sizeof(Double_t));
+}
+
+void KVDataFileCache::WriteBytes(const void* src, Long64_t n)
+{
+   const char* c = (const char*)src;
+   fWriteBuffer.insert(fWriteBuffer.end(), c, c + n);
+}
+
+void KVDataFileCache::WriteInt(Int_t i)
+{
+   WriteBytes(&i, sizeof(Int_t));
+}
+
+void KVDataFileCache::WriteDouble(Double_t x)
+{
+   WriteBytes(&x, sizeof(Double_t));
+}
+
+void KVDataFileCache::WriteString(const Char_t* s)
+{
+   Int_t n = (s ? strlen(s) : 0);
+   WriteInt(n);
+   WriteBytes(s, n);
+}
+
+void KVDataFileCache::WriteArray(const Double_t* values, Int_t n)
+{
+   WriteBytes(values, n * sizeof(Double_t));
+}
+
+Bool_t KVDataFileCache::Save()
+{
+   // Write cache file with all data given to Write...() methods.
+   // The file is first written with a temporary name then renamed, so that other
+   // processes never see an incomplete cache.
+   // Returns kFALSE if the cache could not be written (e.g. directory not writable).
+
+   if (!IsEnabled() || !fSourceOK) return kFALSE;
+
+   TString dir = GetCacheDirectory();
+   if (gSystem->AccessPathName(dir) && gSystem->mkdir(dir, kTRUE) == -1) return kFALSE;
+
+   cache_header h;
+   memset(&h, 0, sizeof(cache_header));
+   memcpy(h.magic, cache_magic, sizeof(cache_magic));
+   h.byte_order = cache_byte_order;
+   h.format = cache_format;
+   h.version = fVersion;
+   h.source_size = fSourceSize;
+   h.source_time = fSourceTime;
+   h.data_size = fWriteBuffer.size();
+
+   TString tmp;
+   tmp.Form("%s.%d.tmp", fCacheFile.Data(), gSystem->GetPid());
+   std::ofstream f(tmp.Data(), std::ios::out | std::ios::binary | std::ios::trunc);
+   if (!f.good()) return kFALSE;
+   f.write((const char*)&h, sizeof(cache_header));
+   if (fWriteBuffer.size()) f.write(&fWriteBuffer[0], fWriteBuffer.size());
+   f.close();
+   if (f.fail() || gSystem->Rename(tmp, fCacheFile)) {
+      gSystem->Unlink(tmp);
+      return kFALSE;
+   }
+   fWriteBuffer.clear();
+   return kTRUE;
+}
+
+void KVDataFileCache::AddTiming(const Char_t* what, const Char_t* source, Bool_t from_cache, Double_t seconds)
+{
+   // Record time taken to read data 'what' from file 'source' (from binary cache
+   // if from_cache=kTRUE, from text file if not), for PrintTimingReport().
+   // If KVDataFileCache.TimingReport=yes, the time is printed immediately.
+
+   cache_timing t;
+   t.what = what;
+   t.source = gSystem->BaseName(source);
+   t.from_cache = from_cache;
+   t.seconds = seconds;
+   timings.push_back(t);
+   if (gEnv->GetValue("KVDataFileCache.TimingReport", kFALSE))
+      ::Info("KVDataFileCache::AddTiming", "%s read from %s (%s) in %.1f ms",
+             what, t.source.Data(), from_cache ? "binary cache" : "text file", 1.e+03 * seconds);
+}
+
+void KVDataFileCache::PrintTimingReport()
+{
+   // Print time taken to read each data file since the start of the process
+
+   Double_t total = 0;
+   printf("\nData files read at start-up:\n\n");
+   for (std::vector<cache_timing>::iterator it = timings.begin(); it != timings.end(); ++it) {
+      printf("   %-20s %-32s %-12s %8.1f ms\n", it->what.Data(), it->source.Data(),
+             it->from_cache ? "binary cache" : "text file", 1.e+03 * it->seconds);
+      total += it->seconds;
+   }
+   printf("\n   %-66s %8.1f ms\n\n", "Total", 1.e+03 * total);
+}
@@ -0,0 +1,81 @@
+#ifndef __KVDATAFILECACHE_H
+#define __KVDATAFILECACHE_H
+
+#include "KVBase.h"
+#include <vector>
+
+class KVDataFileCache : public KVBase {
+
+   TString fSource;//full path to source (text) data file
+   TString fCacheFile;//full path to binary cache file
+   UInt_t fVersion;//version of format of cached data
+   Long64_t fSourceSize;//size of source file
+   Long64_t fSourceTime;//modification time of source file
+   Bool_t fSourceOK;//kTRUE if source file exists
+
+   const char* fData;//! start of cache file in memory
+   Long64_t fDataSize;//! size of cache file
+   Bool_t fMapped;//! kTRUE if fData is memory-mapped
+   std::vector<char> fFileBuffer;//! copy of cache file if memory-mapping not available
+   Long64_t fPos;//! current read position
+   Bool_t fReadOK;//! kFALSE after attempt to read beyond end of cache
+   std::vector<char> fWriteBuffer;//! data to write in cache
+
+   KVDataFileCache(const KVDataFileCache&);
+   KVDataFileCache& operator=(const KVDataFileCache&);
+
+   Bool_t CheckHeader();
+   Bool_t ReadBytes(void* dest, Long64_t n);
+   void WriteBytes(const void* src, Long64_t n);
+
+public:
+   KVDataFileCache(const Char_t* name, const Char_t* source, UInt_t version = 1);
+   virtual ~KVDataFileCache();
+
+   static Bool_t IsEnabled();
+   static TString GetCacheDirectory();
+
+   const Char_t* GetSourceFile() const
+   {
+      // Full path to source (text) data file
+      return fSource;
+   }
+   const Char_t* GetCacheFile() const
+   {
+      // Full path to binary cache file
+      return fCacheFile;
+   }
+
+   // reading from an existing cache
+   Bool_t Open();
+   void Close();
+   Bool_t IsOpen() const
+   {
+      // kTRUE if a valid cache was opened with Open()
+      return (fData != 0);
+   }
+   Bool_t IsOK() const
+   {
+      // kFALSE if an attempt was made to read beyond the end of the cache
+      return fReadOK;
+   }
+   Int_t ReadInt();
+   Double_t ReadDouble();
+   TString ReadString();
+   void ReadArray(Double_t* values, Int_t n);
+
+   // writing a new cache
+   void WriteInt(Int_t i);
+   void WriteDouble(Double_t x);
+   void WriteString(const Char_t* s);
+   void WriteArray(const Double_t* values, Int_t n);
+   Bool_t Save();
+
+   // start-up timing report
+   static void AddTiming(const Char_t* what, const Char_t* source, Bool_t from_cache, Double_t seconds);
+   static void PrintTimingReport();
+
+   ClassDef(KVDataFileCache, 0) //Versioned binary memory-mapped cache of data read from text files
+};
+
+#endif
@@ -2,6 +2,13 @@
 //Author: Eric Bonnet
 
 #include "KVFileReader.h"
+#include <cstring>
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 ClassImp(KVFileReader)
 
@@ -12,11 +19,25 @@ ClassImp(KVFileReader)
 <h4>Manage the reading of file</h4>
 <!-- */
 // --> END_HTML
+//
+//MEMORY-MAPPED READING
+//Calling UseMemoryMapping() before OpenFileToRead() makes the reader map the whole
+//file in memory instead of reading it through an ifstream. Lines and parameters are
+//then kept as pointers into the mapped file, without any allocation (no KVString
+//for each line, no TObjString for each parameter), and GetDoubleReadPar/GetIntReadPar
+//convert parameters directly from the mapped file. The results are the same as with
+//the default (ifstream) reading. This is much faster for very large files, e.g.
+//simulation outputs read by KVSimReader.
+//
+//Several readers can read different parts of the same mapped file at the same
+//time (e.g. in different threads) using OpenMappedRange() with the positions
+//given by GetPosition().
 ////////////////////////////////////////////////////////////////////////////////
 
 KVFileReader::KVFileReader()
 {
    // Default constructor
+   init_mapping();
    init();
 }
 
@@ -24,10 +45,22 @@ KVFileReader::KVFileReader()
 KVFileReader::KVFileReader(const KVFileReader& obj) : KVBase()
 {
    //copy ctor
+   init_mapping();
    init();
    obj.Copy(*this);
 }
 
+//______________________
+void KVFileReader::init_mapping()
+{
+   fMapped = kFALSE;
+   fMapStart = fPos = fEnd = 0;
+   fMapSize = 0;
+   fOwnMap = kFALSE;
+   fEOF = kTRUE;
+   memset(fDelim, 0, sizeof(fDelim));
+}
+
 //___________________________________________________________________________________
 
 void KVFileReader::Copy(TObject& obj) const
@@ -37,3 +70,199 @@ void KVFileReader::Copy(TObject& obj) const
 
    KVBase::Copy(obj);
 }
+
+//___________________________________________________________________________________
+
+Bool_t KVFileReader::MapFile(const KVString& filename)
+{
+   // Map whole file in memory for reading
+
+   UnmapFile();
+   status = kFALSE;
+#ifndef WIN32
+   int fd = open(filename.Data(), O_RDONLY);
+   if (fd >= 0) {
+      struct stat st;
+      if (!fstat(fd, &st)) {
+         if (st.st_size == 0) {
+            fMapStart = "";
+            status = kTRUE;
+         } else {
+            void* addr = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+               madvise(addr, st.st_size, MADV_SEQUENTIAL);
+               fMapStart = (const char*)addr;
+               fMapSize = st.st_size;
+               fOwnMap = kTRUE;
+               status = kTRUE;
+            }
+         }
+      }
+      close(fd);
+   }
+#else
+   std::ifstream f(filename.Data(), std::ios::in | std::ios::binary);
+   if (f.good()) {
+      f.seekg(0, std::ios::end);
+      fMapBuffer.resize(f.tellg());
+      f.seekg(0, std::ios::beg);
+      if (fMapBuffer.size()) f.read(&fMapBuffer[0], fMapBuffer.size());
+      fMapStart = (fMapBuffer.size() ? &fMapBuffer[0] : "");
+      fMapSize = fMapBuffer.size();
+      status = kTRUE;
+   }
+#endif
+   if (!status) {
+      Error("OpenFileToRead", "Echec dans l ouverture du fichier %s", filename.Data());
+      return kFALSE;
+   }
+   fPos = fMapStart;
+   fEnd = fMapStart + fMapSize;
+   fEOF = kFALSE;
+   return kTRUE;
+}
+
+//___________________________________________________________________________________
+
+void KVFileReader::UnmapFile()
+{
+   // Release mapped file (if it was mapped by this reader)
+
+#ifndef WIN32
+   if (fOwnMap) munmap(const_cast<char*>(fMapStart), fMapSize);
+#endif
+   fMapBuffer.clear();
+   fOwnMap = kFALSE;
+   fMapStart = fPos = fEnd = 0;
+   fMapSize = 0;
+   fEOF = kTRUE;
+   fLineBegin = fLineEnd = 0;
+   fTokens.clear();
+}
+
+//___________________________________________________________________________________
+
+Bool_t KVFileReader::OpenMappedRange(const KVFileReader& other, Long64_t begin, Long64_t end)
+{
+   // Read the part of the file mapped by 'other' between positions begin and end
+   // (see GetPosition). The file must remain mapped by 'other' (i.e. it must not
+   // be closed or deleted) as long as this reader is used.
+   // Positions must correspond to the beginning of lines.
+
+   if (!other.fMapped || !other.fMapStart || begin < 0 || end > other.fMapSize || begin > end) return kFALSE;
+   UnmapFile();
+   init();
+   fMapped = kTRUE;
+   file_name = other.file_name;
+   fMapStart = other.fMapStart;
+   fMapSize = other.fMapSize;
+   fPos = fMapStart + begin;
+   fEnd = fMapStart + end;
+   fEOF = kFALSE;
+   status = kTRUE;
+   return kTRUE;
+}
+
+//___________________________________________________________________________________
+
+void KVFileReader::ReadMappedLine()
+{
+   // Next line of mapped file. As with KVString::ReadLine, leading whitespace
+   // (including empty lines) is skipped, and an empty line is only returned
+   // at the end of the file.
+
+   while (fPos < fEnd && isspace(*fPos)) ++fPos;
+   fLineBegin = fPos;
+   const char* eol = (fPos < fEnd ? (const char*)memchr(fPos, '\n', fEnd - fPos) : 0);
+   if (eol) {
+      fLineEnd = eol;
+      fPos = eol + 1;
+   } else {
+      fLineEnd = fPos = fEnd;
+      fEOF = kTRUE;
+   }
+}
+
+//___________________________________________________________________________________
+
+void KVFileReader::TokenizeMappedLine(const Char_t* pattern, Bool_t add)
+{
+   // Store positions of parameters in current line separated by any of the
+   // characters in pattern (empty parameters are ignored, as for TString::Tokenize).
+
+   if (!add) fTokens.clear();
+   if (fPattern != pattern) {
+      fPattern = pattern;
+      memset(fDelim, 0, sizeof(fDelim));
+      for (const char* c = pattern; *c; ++c) fDelim[(UChar_t)*c] = kTRUE;
+   }
+   const char* p = fLineBegin;
+   while (p < fLineEnd) {
+      while (p < fLineEnd && fDelim[(UChar_t)*p]) ++p;
+      if (p == fLineEnd) break;
+      const char* b = p;
+      while (p < fLineEnd && !fDelim[(UChar_t)*p]) ++p;
+      fTokens.push_back(std::make_pair(b, p));
+   }
+}
+
+//___________________________________________________________________________________
+
+Double_t KVFileReader::ParseDouble(const char* begin, const char* end)
+{
+   // Convert parameter to floating-point value, same result as TString::Atof.
+   // Numbers written with at most 15 significant digits and a power of 10 less
+   // than 22 (in absolute value) are converted directly (the result is exact,
+   // i.e. correctly rounded); all others are converted by TString::Atof.
+
+   static const Double_t pow10[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+   };
+   const char* p = begin;
+   Bool_t neg = kFALSE;
+   if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+   ULong64_t m = 0;
+   Int_t ndig = 0, nd = 0, exp10 = 0;
+   for (; p < end && isdigit(*p); ++p, ++nd) {
+      m = 10 * m + (*p - '0');
+      if (m) ++ndig;
+   }
+   if (p < end && (*p == '.' || *p == ',')) {
+      for (++p; p < end && isdigit(*p); ++p, ++nd) {
+         m = 10 * m + (*p - '0');
+         if (m) ++ndig;
+         --exp10;
+      }
+   }
+   if (nd && p < end && (*p == 'e' || *p == 'E')) {
+      ++p;
+      Bool_t eneg = kFALSE;
+      if (p < end && (*p == '-' || *p == '+')) eneg = (*p++ == '-');
+      Int_t e = 0, ne = 0;
+      for (; p < end && isdigit(*p) && ne < 4; ++p, ++ne) e = 10 * e + (*p - '0');
+      if (!ne) p = begin; // not a valid exponent: use Atof
+      exp10 += (eneg ? -e : e);
+   }
+   if (!nd || p != end || ndig > 15 || exp10 > 22 || exp10 < -22)
+      return TString(begin, end - begin).Atof();
+   Double_t x = (Double_t)m;
+   x = (exp10 < 0 ? x / pow10[-exp10] : x * pow10[exp10]);
+   return (neg ? -x : x);
+}
+
+//___________________________________________________________________________________
+
+Int_t KVFileReader::ParseInt(const char* begin, const char* end)
+{
+   // Convert parameter to integer value, same result as TString::Atoi
+
+   const char* p = begin;
+   Bool_t neg = kFALSE;
+   if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+   if (p == end || end - p > 9) return TString(begin, end - begin).Atoi();
+   Int_t i = 0;
+   for (; p < end && isdigit(*p); ++p) i = 10 * i + (*p - '0');
+   if (p != end) return TString(begin, end - begin).Atoi();
+   return (neg ? -i : i);
+}
@@ -10,6 +10,8 @@
 #include "KVString.h"
 #include "TString.h"
 #include "TObjString.h"
+#include <vector>
+#include <string>
 
 class KVFileReader : public KVBase {
 private:
@@ -17,7 +19,32 @@ private:
    {
       reading_line = "";
       nline = 0;
-   }
+      fLineBegin = fLineEnd = 0;
+      fTokens.clear();
+   }
+   void init_mapping();
+
+   // memory-mapped reading (see UseMemoryMapping)
+   Bool_t fMapped;//! kTRUE to read files through memory mapping
+   const char* fMapStart;//! start of mapped file
+   Long64_t fMapSize;//! size of mapped file
+   Bool_t fOwnMap;//! kTRUE if file was mapped by this reader
+   std::vector<char> fMapBuffer;//! copy of file if memory-mapping not available
+   const char* fPos;//! start of next line to read in mapped file
+   const char* fEnd;//! end of region to read in mapped file
+   Bool_t fEOF;//! kTRUE when end of region to read has been reached
+   const char* fLineBegin;//! start of current line in mapped file
+   const char* fLineEnd;//! end of current line in mapped file
+   std::vector<std::pair<const char*, const char*> > fTokens;//! parameters of current line in mapped file
+   std::string fPattern;//! delimiters used for last tokenization of mapped line
+   Bool_t fDelim[256];//! fDelim[c]=kTRUE if c is in fPattern
+
+   Bool_t MapFile(const KVString& filename);
+   void UnmapFile();
+   void ReadMappedLine();
+   void TokenizeMappedLine(const Char_t* pattern, Bool_t add);
+   static Double_t ParseDouble(const char* begin, const char* end);
+   static Int_t ParseInt(const char* begin, const char* end);
 
 protected:
    unique_ptr<TObjArray> toks;//!
@@ -32,7 +59,10 @@ public:
    KVFileReader(const KVFileReader&);
    virtual void Copy(TObject&) const;
 
-   virtual ~KVFileReader() {}
+   virtual ~KVFileReader()
+   {
+      UnmapFile();
+   }
 
    KVString GetFileName()
    {
@@ -51,11 +81,32 @@ public:
       return OpenFileToRead(GetFileName());
    }
 
+   void UseMemoryMapping(Bool_t on = kTRUE)
+   {
+      // Call before OpenFileToRead in order to read the file through memory mapping,
+      // with an allocation-free tokenizer & fast conversion of numerical parameters
+      fMapped = on;
+   }
+   Bool_t IsMemoryMapped() const
+   {
+      // kTRUE if file is read through memory mapping
+      return fMapped;
+   }
+   Bool_t OpenMappedRange(const KVFileReader& other, Long64_t begin, Long64_t end);
+   Long64_t GetPosition() const
+   {
+      // Position (offset from beginning of file) of next line to read
+      // (memory-mapped reading only)
+      return (fMapped && fMapStart ? fPos - fMapStart : -1);
+   }
+
    Bool_t OpenFileToRead(KVString filename)
    {
 
       file_name = filename;
 
+      if (fMapped) return MapFile(filename);
+
       f_in.open(filename.Data());
       status = f_in.good();
 
@@ -68,17 +119,20 @@ public:
 
    Bool_t IsOK()
    {
+      if (fMapped) return !fEOF;
       return f_in.good();
    }
 
    void CloseFile()
    {
+      if (fMapped) UnmapFile();
       if (f_in.is_open()) f_in.close();
    }
 
    void ReadLine(const Char_t* pattern)
    {
-      reading_line.ReadLine(f_in);
+      if (fMapped) ReadMappedLine();
+      else reading_line.ReadLine(f_in);
       nline++;
       if (pattern)
          StoreParameters(pattern);
@@ -86,17 +140,35 @@ public:
 
    void ReadLineAndAdd(const Char_t* pattern)
    {
-      reading_line.ReadLine(f_in);
+      if (fMapped) ReadMappedLine();
+      else reading_line.ReadLine(f_in);
       nline++;
       if (pattern)
          AddParameters(pattern);
    }
 
+   Bool_t SkipLines(Int_t n)
+   {
+      // Read n lines without storing any parameters.
+      // Returns kFALSE if end of file is reached before.
+      for (Int_t i = 0; i < n; ++i) {
+         ReadLine(0);
+         if (IsCurrentLineEmpty()) return kFALSE;
+      }
+      return kTRUE;
+   }
+
+   Bool_t IsCurrentLineEmpty()
+   {
+      if (fMapped) return (fLineBegin == fLineEnd);
+      return reading_line.IsNull();
+   }
+
    Int_t ReadLineAndCheck(Int_t nexpect, const Char_t* pattern)
    {
 
       ReadLine(0);
-      if (GetCurrentLine().IsNull()) {
+      if (IsCurrentLineEmpty()) {
          return 0;
       }
       StoreParameters(pattern);
@@ -122,16 +194,25 @@ public:
 
    KVString GetCurrentLine()
    {
+      if (fMapped) return TString(fLineBegin, fLineEnd - fLineBegin);
       return reading_line;
    }
 
    void StoreParameters(const Char_t* pattern)
    {
+      if (fMapped) {
+         TokenizeMappedLine(pattern, kFALSE);
+         return;
+      }
       toks.reset(GetCurrentLine().Tokenize(pattern));
    }
 
    void AddParameters(const Char_t* pattern)
    {
+      if (fMapped) {
+         TokenizeMappedLine(pattern, kTRUE);
+         return;
+      }
       unique_ptr<TObjArray> tamp(GetCurrentLine().Tokenize(pattern));
       Int_t ne = tamp->GetEntries();
       // toks may be uninitialized
@@ -141,6 +222,7 @@ public:
 
    Int_t GetNparRead()
    {
+      if (fMapped) return fTokens.size();
       return toks->GetEntries();
    }
    Int_t GetNlineRead()
@@ -150,14 +232,17 @@ public:
 
    Double_t GetDoubleReadPar(Int_t pos)
    {
+      if (fMapped) return ParseDouble(fTokens[pos].first, fTokens[pos].second);
       return GetReadPar(pos).Atof();
    }
    Int_t GetIntReadPar(Int_t pos)
    {
+      if (fMapped) return ParseInt(fTokens[pos].first, fTokens[pos].second);
       return GetReadPar(pos).Atoi();
    }
    TString GetReadPar(Int_t pos)
    {
+      if (fMapped) return TString(fTokens[pos].first, fTokens[pos].second - fTokens[pos].first);
       return ((TObjString*)toks->At(pos))->GetString();
    }
 
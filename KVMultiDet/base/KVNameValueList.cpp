@@ -42,7 +42,7 @@ ClassImp(KVNameValueList)
 
 //______________________________________________
 KVNameValueList::KVNameValueList()
-   : fList(), fIgnoreBool(kFALSE)
+   : fList(), fIgnoreBool(kFALSE), fRecycle(kFALSE), fMaxSpare(0)
 {
    // Default constructor
    fList.SetOwner(kTRUE);
@@ -50,14 +50,14 @@ KVNameValueList::KVNameValueList()
 
 //______________________________________________
 KVNameValueList::KVNameValueList(const Char_t* name, const Char_t* title)
-   : TNamed(name, title), fList(), fIgnoreBool(kFALSE)
+   : TNamed(name, title), fList(), fIgnoreBool(kFALSE), fRecycle(kFALSE), fMaxSpare(0)
 {
    // Ctor with name & title
    fList.SetOwner(kTRUE);
 }
 
 //______________________________________________
-KVNameValueList::KVNameValueList(const KVNameValueList& NVL) : TNamed()
+KVNameValueList::KVNameValueList(const KVNameValueList& NVL) : TNamed(), fRecycle(kFALSE), fMaxSpare(0)
 {
    // Copy constructor
    NVL.Copy(*this);
@@ -69,6 +69,7 @@ KVNameValueList::~KVNameValueList()
 {
    // Destructor
    fList.Clear();// will delete objects in list if owner
+   DeleteSpareParameters();
 }
 
 KVNameValueList& KVNameValueList::operator=(const KVNameValueList& o)
@@ -102,7 +103,47 @@ void KVNameValueList::Clear(Option_t* opt)
 {
    //Clear all the stored parameters
    //Deletes the parameter objects if owner & opt!="nodelete"
-   fList.Clear(opt);
+   //
+   //If SetRecycleParameters() has been called, the parameter objects are not
+   //deleted but kept in order to be reused for the next parameters added to the list.
+   //The number of objects kept is never more than the largest number of parameters
+   //the list has contained when cleared.
+
+   if (fRecycle && IsOwner() && !TString(opt).Contains("nodelete")) {
+      if ((UInt_t)fList.GetEntries() > fMaxSpare) fMaxSpare = fList.GetEntries();
+      TIter next(&fList);
+      KVNamedParameter* par;
+      while ((par = (KVNamedParameter*)next())) {
+         if (fSpare.size() < fMaxSpare) fSpare.push_back(par);
+         else delete par;
+      }
+      fList.Clear("nodelete");
+   } else
+      fList.Clear(opt);
+}
+
+//______________________________________________
+void KVNameValueList::SetRecycleParameters(Bool_t on)
+{
+   //If on=kTRUE, parameter objects removed from the list by Clear() or RemoveParameter()
+   //are not deleted, but are reused for new parameters added to the list.
+   //This avoids allocating & deleting the same parameter objects over and over again
+   //when a list is cleared and filled for each event of an analysis, for example.
+   //(only for lists which own their parameters, the default)
+   //
+   //If on=kFALSE, any parameter objects kept for reuse are deleted.
+
+   fRecycle = on;
+   if (!on) DeleteSpareParameters();
+}
+
+//______________________________________________
+void KVNameValueList::DeleteSpareParameters()
+{
+   // Delete all parameter objects kept for reuse
+   for (std::vector<KVNamedParameter*>::iterator it = fSpare.begin(); it != fSpare.end(); ++it) delete *it;
+   fSpare.clear();
+   fMaxSpare = 0;
 }
 
 void KVNameValueList::ClearSelection(TRegexp& sel)
@@ -185,7 +226,7 @@ void KVNameValueList::SetValue(const KVNamedParameter& p)
    // add (or replace) a parameter with the same name, type & value as 'p'
 
    KVNamedParameter* par = FindParameter(p.GetName());
-   par ? par->Set(p.GetName(), p) : fList.Add(new KVNamedParameter(p));
+   par ? par->Set(p.GetName(), p) : fList.Add(NewParameter(p.GetName(), p));
 
 }
 
@@ -211,7 +252,8 @@ void KVNameValueList::RemoveParameter(const Char_t* name)
    KVNamedParameter* par = FindParameter(name);
    if (par) {
       fList.Remove(par);
-      delete par;
+      if (fRecycle && IsOwner() && fSpare.size() < fMaxSpare) fSpare.push_back(par);
+      else delete par;
    }
 }
 
@@ -8,12 +8,29 @@
 #include "TNamed.h"
 #include "TRegexp.h"
 #include "KVNamedParameter.h"
+#include <vector>
 class KVEnv;
 
 class KVNameValueList : public TNamed {
 protected:
    KVHashList fList;//list of KVNamedParameter objects
    Bool_t fIgnoreBool;//do not convert "yes", "false", "on", etc. in TEnv file to boolean
+   Bool_t fRecycle;//! kTRUE if parameter objects are kept for reuse after Clear()
+   std::vector<KVNamedParameter*> fSpare;//! parameter objects available for reuse
+   UInt_t fMaxSpare;//! largest number of parameters in list when Clear() was called
+
+   template<typename value_type>
+   KVNamedParameter* NewParameter(const Char_t* name, const value_type& value)
+   {
+      // Return new parameter with given name & value, reusing a
+      // parameter object from a previous Clear() if possible
+      if (fSpare.empty()) return new KVNamedParameter(name, value);
+      KVNamedParameter* par = fSpare.back();
+      fSpare.pop_back();
+      par->Set(name, value);
+      return par;
+   }
+   void DeleteSpareParameters();
 
 public:
 
@@ -35,6 +52,13 @@ public:
 
    void SetOwner(Bool_t enable = kTRUE);
    Bool_t IsOwner() const;
+   void SetRecycleParameters(Bool_t on = kTRUE);
+   Bool_t IsRecycleParameters() const
+   {
+      // Returns kTRUE if parameter objects are kept for reuse after Clear()
+      // (see SetRecycleParameters)
+      return fRecycle;
+   }
 
    void Copy(TObject& nvl) const;
    Int_t Compare(const TObject* nvl) const;
@@ -46,7 +70,7 @@ public:
       //if the parameter is not in the list, it is added
       //if it's in the list replace its value
       KVNamedParameter* par = FindParameter(name);
-      par ? par->Set(name, value) : fList.Add(new KVNamedParameter(name, value));
+      par ? par->Set(name, value) : fList.Add(NewParameter(name, value));
    }
    void SetValue(const KVNamedParameter&);
 
@@ -65,7 +89,7 @@ public:
             fList.GetCollection()->Remove(par);
             fList.AddAt(par, idx);
          }
-      } else fList.AddAt(new KVNamedParameter(name, value), idx);
+      } else fList.AddAt(NewParameter(name, value), idx);
    }
 
    template <typename value_type>
@@ -83,7 +107,7 @@ public:
             fList.GetCollection()->Remove(par);
             fList.AddFirst(par);
          }
-      } else fList.AddFirst(new KVNamedParameter(name, value));
+      } else fList.AddFirst(NewParameter(name, value));
    }
 
    template <typename value_type>
@@ -101,7 +125,7 @@ public:
             fList.GetCollection()->Remove(par);
             fList.AddLast(par);
          }
-      } else fList.AddLast(new KVNamedParameter(name, value));
+      } else fList.AddLast(NewParameter(name, value));
    }
 
    template <typename value_type>
@@ -112,7 +136,7 @@ public:
       //if it's in the list increment its value
       //the new value of the parameter is returned
       KVNamedParameter* par = FindParameter(name);
-      par ? par->Set(value += par->Get<value_type>()) : fList.Add(new KVNamedParameter(name, value));
+      par ? par->Set(value += par->Get<value_type>()) : fList.Add(NewParameter(name, value));
       return value;
    }
 
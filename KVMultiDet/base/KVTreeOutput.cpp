@@ -0,0 +1,278 @@
+#include "KVTreeOutput.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TEnv.h"
+#include "TROOT.h"
+#include "RVersion.h"
+
+ClassImp(KVTreeOutput)
+
+////////////////////////////////////////////////////////////////////////////////
+// BEGIN_HTML <!--
+/* -->
+<h2>KVTreeOutput</h2>
+<h4>Output stage for TTrees with configurable compression & I/O timing</h4>
+<!-- */
+// --> END_HTML
+//Used by the raw data reconstruction classes and by KVEventFiltering to fill &
+//write their output TTrees:
+//
+//    KVTreeOutput output;
+//    output.AddTree(tree);  // after creating all branches of the tree
+//    ...                    // (or call SetTreeCompression(tree) after adding more)
+//    ...
+//    output.FillTree(tree); // for each event
+//    ...
+//    output.WriteTree(tree);
+//    output.PrintReport();
+//
+//COMPRESSION
+//The compression algorithm & level used for each tree added with AddTree() can be
+//set for all trees and/or for trees with a given name:
+//
+//    KVTreeOutput.Compression:                      LZ4:4
+//    KVTreeOutput.ReconstructedEvents.Compression:  LZMA:6
+//
+//Possible algorithms are ZLIB, LZMA, LZ4 and ZSTD (depending on the version of ROOT);
+//the level can be given alone (the algorithm is then the default one of ROOT),
+//or the value can be the full ROOT compression settings, e.g. 404 for LZ4:4.
+//By default, the compression settings of the output file are used.
+//
+//PARALLEL COMPRESSION
+//With ROOT versions >= 6.10 compiled with implicit multi-threading, baskets of all
+//branches of the trees are compressed & written by a pool of threads, instead of
+//being compressed one after the other by the thread processing events, when
+//
+//    KVTreeOutput.NumberOfThreads:    4
+//
+//(0 = use all available cores; 1 = no thread pool). The thread pool is started when
+//the first tree is added with AddTree(), and stopped by Reset() or the destructor
+//(unless implicit multi-threading was already enabled before). See EnableParallelCompression().
+//
+//TIMING REPORT
+//The time spent filling & writing the trees is compared with the total time since
+//Reset() by PrintReport(), together with the size & compression factor of each tree.
+//With parallel compression, this is the time spent by the thread processing events:
+//it does not include the time spent compressing baskets in the pool threads.
+////////////////////////////////////////////////////////////////////////////////
+
+Int_t KVTreeOutput::fgIMTUsers = 0;
+Bool_t KVTreeOutput::fgIMTEnabled = kFALSE;
+
+KVTreeOutput::KVTreeOutput(const Char_t* name)
+   : KVBase(name, "TTree output stage"), fNFill(0), fParallelCompression(kFALSE), fUsesOwnIMT(kFALSE)
+{
+   // Default constructor
+
+   Reset();
+}
+
+KVTreeOutput::~KVTreeOutput()
+{
+   // Destructor
+   // Trees are not deleted. Implicit multi-threading is disabled if it was
+   // enabled by EnableParallelCompression() and no other KVTreeOutput uses it.
+
+   ReleaseParallelCompression();
+}
+
+void KVTreeOutput::EnableParallelCompression()
+{
+   // Enable ROOT implicit multi-threading in order to compress the baskets of
+   // the trees added with AddTree() with a pool of threads, according to the value of
+   //
+   //    KVTreeOutput.NumberOfThreads:    1
+   //
+   //  n = 1 : (default) baskets are compressed by the thread filling the trees
+   //  n > 1 : baskets are compressed by a pool of n threads
+   //  n = 0 : use as many threads as there are cores on the machine
+   //
+   // Called by AddTree(). This requires ROOT version >= 6.10 compiled with implicit multi-threading (imt).
+   //
+   // Implicit multi-threading is a global setting of ROOT: as long as it is enabled,
+   // other ROOT operations which support it (e.g. reading of TTrees, or filling of
+   // TTrees created in the meantime) can also use the thread pool. Trees which existed
+   // before are not affected, and only trees added with AddTree() are explicitly set
+   // to use it. If it was not already enabled, it is disabled again by Reset() or
+   // the destructor, when no other KVTreeOutput uses it.
+
+   if (fParallelCompression) return;
+   Int_t n = gEnv->GetValue("KVTreeOutput.NumberOfThreads", 1);
+   if (n == 1) return;
+#if defined(R__USE_IMT) && ROOT_VERSION_CODE >= ROOT_VERSION(6,10,0)
+   if (!ROOT::IsImplicitMTEnabled()) {
+      ROOT::EnableImplicitMT(n);
+      fgIMTEnabled = kTRUE;
+   }
+   if (fgIMTEnabled) {
+      fUsesOwnIMT = kTRUE;
+      ++fgIMTUsers;
+   }
+   fParallelCompression = kTRUE;
+#else
+   ::Warning("KVTreeOutput::EnableParallelCompression",
+             "Parallel compression of baskets requires ROOT >= 6.10 with imt: using 1 thread");
+#endif
+}
+
+void KVTreeOutput::ReleaseParallelCompression()
+{
+   // Called by Reset() and the destructor: implicit multi-threading is disabled
+   // if it was enabled by EnableParallelCompression() and no other KVTreeOutput uses it,
+   // i.e. the state of ROOT before the first call to EnableParallelCompression() is restored.
+
+   if (fUsesOwnIMT && !--fgIMTUsers && fgIMTEnabled) {
+#if defined(R__USE_IMT) && ROOT_VERSION_CODE >= ROOT_VERSION(6,10,0)
+      ROOT::DisableImplicitMT();
+#endif
+      fgIMTEnabled = kFALSE;
+   }
+   fUsesOwnIMT = kFALSE;
+   fParallelCompression = kFALSE;
+}
+
+Int_t KVTreeOutput::GetCompressionSettings(const Char_t* tree_name)
+{
+   // Returns compression settings (100*algorithm + level) for trees with given name,
+   // given by the value of
+   //
+   //    KVTreeOutput.[tree_name].Compression:
+   // or
+   //    KVTreeOutput.Compression:
+   //
+   // which can be "[algorithm]:[level]" (algorithm = ZLIB, LZMA, LZ4, ZSTD), or
+   // a number ("6" = level 6 with default algorithm, "404" = LZ4 level 4).
+   // Returns -1 if no value is set (i.e. use the settings of the output file).
+
+   TString value = gEnv->GetValue(Form("KVTreeOutput.%s.Compression", tree_name), "");
+   if (value == "") value = gEnv->GetValue("KVTreeOutput.Compression", "");
+   value.Remove(TString::kBoth, ' ');
+   if (value == "") return -1;
+
+   if (value.IsDigit()) return value.Atoi();
+
+   Int_t colon = value.Index(":");
+   TString algo = (colon < 0 ? value : value(0, colon));
+   Int_t level = (colon < 0 ? 1 : TString(value(colon + 1, value.Length())).Atoi());
+   algo.ToUpper();
+   Int_t ialgo = -1;
+   if (algo == "ZLIB") ialgo = 1;
+   else if (algo == "LZMA") ialgo = 2;
+   else if (algo == "LZ4") ialgo = 4;
+   else if (algo == "ZSTD") ialgo = 5;
+   if (ialgo < 0 || level < 0 || level > 99) {
+      ::Warning("KVTreeOutput::GetCompressionSettings", "Unknown compression for tree %s: %s", tree_name, value.Data());
+      return -1;
+   }
+   return 100 * ialgo + level;
+}
+
+void KVTreeOutput::SetCompressionSettings(TTree* tree, Int_t settings)
+{
+   // Set compression settings of all branches of tree.
+   // The new settings are used for all baskets written after this call.
+
+   TIter next(tree->GetListOfBranches());
+   TBranch* b;
+   while ((b = (TBranch*)next())) b->SetCompressionSettings(settings);
+}
+
+void KVTreeOutput::Reset()
+{
+   // Reset timers & list of trees.
+   // Implicit multi-threading is disabled if it was enabled for the trees of this
+   // object (see EnableParallelCompression), it will be enabled again when a tree is added.
+
+   ReleaseParallelCompression();
+   fTrees.Clear();
+   fNFill = 0;
+   fIOTime.Reset();
+   fTotalTime.Start(kTRUE);
+}
+
+void KVTreeOutput::AddTree(TTree* tree)
+{
+   // Add a tree to the output, and set its compression (see SetTreeCompression).
+   // Call this after creating all branches of the tree.
+
+   fTrees.Add(tree);
+   EnableParallelCompression();
+   Int_t settings = SetTreeCompression(tree);
+   if (settings >= 0)
+      Info("AddTree", "Compression settings for tree %s : %d", tree->GetName(), settings);
+}
+
+Int_t KVTreeOutput::SetTreeCompression(TTree* tree)
+{
+   // Set compression of all branches of tree (see GetCompressionSettings), and
+   // compression of its baskets by the thread pool if enabled (see EnableParallelCompression).
+   // Call this again for a tree already added with AddTree() if branches are added to it.
+   // Returns the compression settings (-1 = settings of output file).
+
+   Int_t settings = GetCompressionSettings(tree->GetName());
+   if (settings >= 0) SetCompressionSettings(tree, settings);
+#if defined(R__USE_IMT) && ROOT_VERSION_CODE >= ROOT_VERSION(6,10,0)
+   tree->SetImplicitMT(fParallelCompression);
+#endif
+   return settings;
+}
+
+Int_t KVTreeOutput::FillTree(TTree* tree)
+{
+   // Fill tree, adding the time taken to the I/O time
+
+   fIOTime.Start(kFALSE);
+   Int_t nbytes = tree->Fill();
+   fIOTime.Stop();
+   ++fNFill;
+   return nbytes;
+}
+
+void KVTreeOutput::FillTrees()
+{
+   // Fill all trees
+
+   TIter next(&fTrees);
+   TTree* t;
+   while ((t = (TTree*)next())) FillTree(t);
+}
+
+Int_t KVTreeOutput::WriteTree(TTree* tree)
+{
+   // Write tree in its current directory, adding the time taken to the I/O time
+
+   fIOTime.Start(kFALSE);
+   Int_t nbytes = tree->Write();
+   fIOTime.Stop();
+   return nbytes;
+}
+
+void KVTreeOutput::WriteTrees()
+{
+   // Write all trees
+
+   TIter next(&fTrees);
+   TTree* t;
+   while ((t = (TTree*)next())) WriteTree(t);
+}
+
+void KVTreeOutput::PrintReport()
+{
+   // Print time spent filling & writing trees compared to total time since Reset(),
+   // and size & compression factor of each tree.
+   // With parallel compression, the I/O time is the time spent in Fill() & Write() by the
+   // thread processing events: it does not include compression in the pool threads.
+
+   Double_t total = GetTotalTime();
+   Double_t io = GetIOTime();
+   Info("PrintReport", "Output trees (%s compression):", fParallelCompression ? "parallel" : "serial");
+   TIter next(&fTrees);
+   TTree* t;
+   while ((t = (TTree*)next())) {
+      Info("PrintReport", "   %-24s %10lld entries %10.2f MB  compression factor %5.2f",
+           t->GetName(), t->GetEntries(), t->GetZipBytes() / 1048576., t->GetZipBytes() > 0 ? (Double_t)t->GetTotBytes() / t->GetZipBytes() : 0.);
+   }
+   Info("PrintReport", "Time spent in I/O (%lld fills) : %.2f s (%.1f%%)%s", fNFill, io, total > 0 ? 100.*io / total : 0.,
+        fParallelCompression ? " [excluding compression by pool threads]" : "");
+   Info("PrintReport", "Time spent in processing          : %.2f s (%.1f%%)", total - io, total > 0 ? 100.*(total - io) / total : 0.);
+}
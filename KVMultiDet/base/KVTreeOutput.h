@@ -0,0 +1,61 @@
+#ifndef __KVTREEOUTPUT_H
+#define __KVTREEOUTPUT_H
+
+#include "KVBase.h"
+#include "TList.h"
+#include "TStopwatch.h"
+class TTree;
+
+class KVTreeOutput : public KVBase {
+
+   TList fTrees;//trees handled by this output stage
+   TStopwatch fTotalTime;//time since Reset()
+   TStopwatch fIOTime;//time spent filling/writing trees
+   Long64_t fNFill;//number of calls to Fill()
+   Bool_t fParallelCompression;//kTRUE when basket compression of trees is done by thread pool
+   Bool_t fUsesOwnIMT;//kTRUE if this object uses implicit multi-threading enabled by KVTreeOutput
+
+   static Int_t fgIMTUsers;//number of KVTreeOutput objects using implicit multi-threading enabled by KVTreeOutput
+   static Bool_t fgIMTEnabled;//kTRUE if implicit multi-threading was enabled by KVTreeOutput
+
+   void ReleaseParallelCompression();
+
+public:
+   KVTreeOutput(const Char_t* name = "KVTreeOutput");
+   virtual ~KVTreeOutput();
+
+   void EnableParallelCompression();
+   Bool_t IsParallelCompression() const
+   {
+      // kTRUE when baskets of trees added with AddTree() are compressed by a thread pool
+      return fParallelCompression;
+   }
+   static Int_t GetCompressionSettings(const Char_t* tree_name);
+   static void SetCompressionSettings(TTree* tree, Int_t settings);
+
+   void Reset();
+   void AddTree(TTree* tree);
+   Int_t SetTreeCompression(TTree* tree);
+   Int_t FillTree(TTree* tree);
+   void FillTrees();
+   Int_t WriteTree(TTree* tree);
+   void WriteTrees();
+
+   Double_t GetIOTime()
+   {
+      // Real time (s) spent filling & writing trees since Reset()
+      return fIOTime.RealTime();
+   }
+   Double_t GetTotalTime()
+   {
+      // Real time (s) since Reset()
+      Double_t t = fTotalTime.RealTime();
+      fTotalTime.Continue();
+      return t;
+   }
+   void PrintReport();
+
+   ClassDef(KVTreeOutput, 0) //Output stage for TTrees with configurable compression & I/O timing
+};
+
+#endif
@@ -41,6 +41,8 @@
 #pragma link C++ class KVMemoryPool+;
 #pragma link C++ class KVNumberList+;
 #pragma link C++ class KVFileReader;
+#pragma link C++ class KVDataFileCache;
+#pragma link C++ class KVTreeOutput;
 #pragma link C++ class KVValues;
 #pragma link C++ class KVRList+;
 #pragma link C++ class KVSortableDatedFile+;
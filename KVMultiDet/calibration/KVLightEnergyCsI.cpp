@@ -31,14 +31,24 @@ ClassImp(KVLightEnergyCsI);
 //relationship for all ions, two parameterizations have to be used: one for Z=1 and another for Z>1.
 //The parameter a3 normally has a fixed value (a3=6), but this is not "hard-coded" : it should be fixed
 //when fitting data.
+//
+//The energy corresponding to a given light output is found by Newton's method
+//using the analytical derivative of the light-energy function, starting from an
+//interpolation in a table of light outputs (see KVLightEnergyTable).
+//Compute() & Invert() use the Z & A set with SetZ() & SetA(); GetEnergy() & GetLight()
+//take Z & A as arguments, do not modify the calibrator, and can be used at the same
+//time by several threads (access to the tables of each calibrator is protected by
+//its own mutex, so that different detectors never wait for each other).
 
 //___________________________________________________________________________
 
-Double_t CalculLumiere(Double_t* x, Double_t* par)
+Double_t CalculLumiereAndDerivative(Double_t energie, const Double_t* par, Double_t* dLdE)
 {
    //Calcul de la lumiere totale a partir de Z, A d'une particule et son energie
+   //If dLdE is given, the derivative of the light with respect to energy is
+   //also calculated.
    //
-   // x[0] = energie (MeV)
+   // energie = energie (MeV)
    // par[0] = a1
    // par[1] = a2
    // par[2] = a3
@@ -49,24 +59,64 @@ Double_t CalculLumiere(Double_t* x, Double_t* par)
    Double_t Z = par[4];
    Double_t A = par[5];
 
-   Double_t energie = x[0];
    Double_t c1 = par[0];
    Double_t c2 = Z * Z * A * par[1];
    Double_t c3 = A * par[2];
    Double_t c4 = par[3];
    Double_t T = 8 * A;
-   Double_t c4_new = c4 / (1. + TMath::Exp((c3 - energie) / T));
+   Double_t expo = TMath::Exp((c3 - energie) / T);
+   Double_t c4_new = c4 / (1. + expo);
    Double_t c0 = c4 / (1. + TMath::Exp(c3 / T));
 
    Double_t lumcalc = c1 * energie;
+   if (dLdE) *dLdE = c1;
    if (c2 > 0.0) {
       Double_t xm = -c1 * c0 * c2 * TMath::Log(c2 / (c2 + c3));
-      lumcalc = lumcalc - c1 * c2 * TMath::Log(1. + energie / c2) + c1 * c2 * c4_new * TMath::Log((energie + c2) / (c3 + c2)) + xm;
+      Double_t logE = TMath::Log((energie + c2) / (c3 + c2));
+      lumcalc = lumcalc - c1 * c2 * TMath::Log(1. + energie / c2) + c1 * c2 * c4_new * logE + xm;
+      if (dLdE) {
+         Double_t dc4_new = c4 * expo / (T * (1. + expo) * (1. + expo));
+         *dLdE += c1 * c2 * (-1. / (energie + c2) + dc4_new * logE + c4_new / (energie + c2));
+      }
    }
 
    return lumcalc;
 }
 
+namespace {
+   class CsILightFunction : public KVLightEnergyTable::LightFunction {
+      // light-energy function for parameters par (see CalculLumiereAndDerivative)
+      const Double_t* fPar;
+   public:
+      CsILightFunction(const Double_t* par) : fPar(par) {}
+      Double_t GetLight(Double_t energy) const
+      {
+         return CalculLumiereAndDerivative(energy, fPar, 0);
+      }
+      Double_t GetDerivative(Double_t energy) const
+      {
+         Double_t dLdE;
+         CalculLumiereAndDerivative(energy, fPar, &dLdE);
+         return dLdE;
+      }
+   };
+}
+
+Double_t CalculLumiere(Double_t* x, Double_t* par)
+{
+   //Calcul de la lumiere totale a partir de Z, A d'une particule et son energie
+   //
+   // x[0] = energie (MeV)
+   // par[0] = a1
+   // par[1] = a2
+   // par[2] = a3
+   // par[3] = a4
+   // par[4] = Z
+   // par[5] = A
+
+   return CalculLumiereAndDerivative(x[0], par, 0);
+}
+
 TF1 KVLightEnergyCsI::fLight("fLight_CsI", CalculLumiere, 0., 10000., 6);
 
 //__________________________________________________________________________
@@ -92,6 +142,17 @@ KVLightEnergyCsI::KVLightEnergyCsI(KVDetector* kvd): KVCalibrator(4)
    SetDetector(kvd);
 }
 
+//___________________________________________________________________________
+KVLightEnergyCsI::KVLightEnergyCsI(const KVLightEnergyCsI& obj): KVCalibrator(obj)
+{
+   // Copy constructor
+   // Tables of light output are not copied: they are recalculated when needed
+
+   init();
+   SetZ(obj.GetZ());
+   SetA(obj.GetA());
+}
+
 //___________________________________________________________________________
 Double_t KVLightEnergyCsI::Compute(Double_t light) const
 {
@@ -99,27 +160,46 @@ Double_t KVLightEnergyCsI::Compute(Double_t light) const
    // The Z and A of the particle should be given first using SetZ, SetA.
    // By default, Z=A=1 (proton).
    //
-   // This is done by inversion of the light-energy function using TF1::GetX.
+   // This is done by inversion of the light-energy function, see GetEnergy().
 
-   SetParametersOfLightEnergyFunction();
+   return GetEnergy(light, fZ, fA);
+}
 
-   //invert light vs. energy function to find energy
-   Double_t xmin, xmax;
-   fLight.GetRange(xmin, xmax);
-   Double_t energy = fLight.GetX(light, xmin, xmax);
+//___________________________________________________________________________
+Double_t KVLightEnergyCsI::GetEnergy(Double_t light, UInt_t Z, UInt_t A) const
+{
+   // Calculate the calibrated energy (in MeV) for a given total light output
+   // of a nucleus (Z,A).
+   //
+   // The light-energy function is inverted using Newton's method (with bisection
+   // if a step goes outside the current interval), starting from linear interpolation
+   // between the two closest values in a table of light outputs for (Z,A).
+   // If the light is outside of the range of the function for energies between
+   // 0 and 10 GeV, the corresponding limit is returned.
+   //
+   // This method does not modify the calibrator and can be called at the same time
+   // by different threads (but not while calibration parameters are being changed).
 
-   return energy;
+   Double_t par[6];
+   SetParametersOfLightEnergyFunction(par, Z, A);
+   return fLightTable.GetEnergy(light, 1000 * Z + A, 4, par, CsILightFunction(par));
 }
 
 void KVLightEnergyCsI::SetParametersOfLightEnergyFunction() const
 {
    //set parameters of light-energy function
    Double_t par[6];
+   SetParametersOfLightEnergyFunction(par, fZ, fA);
+   fLight.SetParameters(par);
+}
+
+void KVLightEnergyCsI::SetParametersOfLightEnergyFunction(Double_t* par, UInt_t Z, UInt_t A) const
+{
+   //fill array with parameters of light-energy function for nucleus (Z,A)
    for (int i = 0; i < 4; i++)
       par[i] = GetParameter(i);
-   par[4] = (Double_t) fZ;
-   par[5] = (Double_t) fA;
-   fLight.SetParameters(par);
+   par[4] = (Double_t) Z;
+   par[5] = (Double_t) A;
 }
 
 //___________________________________________________________________________
@@ -136,10 +216,26 @@ Double_t KVLightEnergyCsI::Invert(Double_t energy)
    //Given the calibrated (or simulated) energy in MeV,
    //calculate the corresponding total light output according to the
    //calibration parameters (useful for filtering simulations).
+   //The Z and A of the particle should be given first using SetZ, SetA.
 
-   SetParametersOfLightEnergyFunction();
+   return GetLight(energy, fZ, fA);
+}
 
-   return fLight.Eval(energy);
+//___________________________________________________________________________
+Double_t KVLightEnergyCsI::GetLight(Double_t energy, UInt_t Z, UInt_t A, Double_t* dLdE) const
+{
+   //Given the calibrated (or simulated) energy in MeV of a nucleus (Z,A),
+   //calculate the corresponding total light output according to the
+   //calibration parameters.
+   //If dLdE is given, it is filled with the derivative of the light with
+   //respect to energy.
+   //
+   //This method does not modify the calibrator and can be called at the same time
+   //by different threads.
+
+   Double_t par[6];
+   SetParametersOfLightEnergyFunction(par, Z, A);
+   return CalculLumiereAndDerivative(energy, par, dLdE);
 }
 
 //___________________________________________________________________________
@@ -149,6 +245,7 @@ TF1* KVLightEnergyCsI::GetLightEnergyFunction(UInt_t Z, UInt_t A)
    // Return pointer to TF1 used to calculate light-energy relationship
    // for this detector, for given Z & A.
    // WARNING: the same STATIC TF1 object is used by ALL CsI detectors
+   // (it is not used by Compute() or Invert())
 
    SetZ(Z);
    SetA(A);
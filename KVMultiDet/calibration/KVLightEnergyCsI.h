@@ -19,6 +19,7 @@ $Id: KVLightEnergyCsI.h,v 1.3 2007/02/27 11:56:33 franklan Exp $
 #define KV_LIGHT_ENERGY_CSI_H
 
 #include "KVCalibrator.h"
+#include "KVLightEnergyTable.h"
 
 class KVLightEnergyCsI: public KVCalibrator {
 
@@ -28,11 +29,15 @@ protected:
 
    static TF1 fLight;           //function parameterising light output as function of (energy, Z, A)
 
+   KVLightEnergyTable fLightTable; //!tables of light output used to invert light-energy function
+
    void SetParametersOfLightEnergyFunction() const;
+   void SetParametersOfLightEnergyFunction(Double_t* par, UInt_t Z, UInt_t A) const;
 
 public:
    KVLightEnergyCsI();
    KVLightEnergyCsI(KVDetector* kvd);
+   KVLightEnergyCsI(const KVLightEnergyCsI&);
    virtual ~ KVLightEnergyCsI()
    {
    };
@@ -42,6 +47,9 @@ public:
    virtual Double_t operator()(Double_t chan);
    virtual Double_t Invert(Double_t);
 
+   Double_t GetEnergy(Double_t light, UInt_t Z, UInt_t A) const;
+   Double_t GetLight(Double_t energy, UInt_t Z, UInt_t A, Double_t* dLdE = 0) const;
+
    void SetZ(UInt_t z)
    {
       fZ = z;
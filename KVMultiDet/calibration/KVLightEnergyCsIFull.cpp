@@ -4,6 +4,24 @@
 #include "KVLightEnergyCsIFull.h"
 using namespace std;
 
+namespace {
+   class CsIFullLightFunction : public KVLightEnergyTable::LightFunction {
+      // light-energy function & its derivative for parameters par (see Compute)
+      const KVLightEnergyCsIFull* fCalib;
+      Double_t* fPar;
+   public:
+      CsIFullLightFunction(const KVLightEnergyCsIFull* calib, Double_t* par) : fCalib(calib), fPar(par) {}
+      Double_t GetLight(Double_t energy) const
+      {
+         return fCalib->fLight->EvalPar(&energy, fPar);
+      }
+      Double_t GetDerivative(Double_t energy) const
+      {
+         return fCalib->GetLightDerivative(energy, fPar);
+      }
+   };
+}
+
 ClassImp(KVLightEnergyCsIFull)
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -11,6 +29,12 @@ ClassImp(KVLightEnergyCsIFull)
 /* -->
 <h2>KVLightEnergyCsIFull</h2>
 <h4>Light-energy calibration for CsI detectors uding exact expression</h4>
+<p>
+The energy corresponding to a given light output (Compute()) is found by Newton's
+method, starting from an interpolation in a table of light outputs (see
+KVLightEnergyTable). For the integral formulas (kExact, kApproxIntegral) the
+derivative of the light with respect to energy is given by the integrand, fDlight.
+</p>
 <!-- */
 // --> END_HTML
 ////////////////////////////////////////////////////////////////////////////////
@@ -496,12 +520,21 @@ Double_t KVLightEnergyCsIFull::Compute(Double_t light) const
    par[1] = (Double_t) fA;
    fLight->SetParameters(par);
 //for(int i=0; i<7; i++)printf("P2  [%d]=%f  ", i, fLight->GetParameter(i)); printf("Z=%d  A=%d \n",fZ, fA);
-   //invert light vs. energy function to find energy
-   Double_t xmin, xmax;
-   fLight->GetRange(xmin, xmax);
-   Double_t energy = fLight->GetX(light, xmin, xmax);
+   //invert light vs. energy function to find energy (see KVLightEnergyTable)
+   return fLightTable.GetEnergy(light, 1000 * fZ + fA, 5, &par[2], CsIFullLightFunction(this, par));
+}
 
-   return energy;
+//___________________________________________________________________________
+Double_t KVLightEnergyCsIFull::GetLightDerivative(Double_t energy, Double_t* par) const
+{
+   // Derivative of light with respect to energy for parameters used by Compute().
+   // For the integral formulas this is the integrand fDlight, otherwise it is
+   // calculated numerically.
+
+   if (fDlight) return fDlight->EvalPar(&energy, par);
+   Double_t h = 1.e-04 * TMath::Max(energy, 1.);
+   Double_t e1 = TMath::Max(energy - h, KVLightEnergyTable::GetEmin()), e2 = energy + h;
+   return (fLight->EvalPar(&e2, par) - fLight->EvalPar(&e1, par)) / (e2 - e1);
 }
 
 
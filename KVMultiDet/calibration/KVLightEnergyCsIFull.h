@@ -6,6 +6,7 @@
 
 #include "KVCalibrator.h"
 #include "KVIonRangeTableMaterial.h"
+#include "KVLightEnergyTable.h"
 //#include "TF1.h"
 
 class KVLightEnergyCsIFull : public KVCalibrator {
@@ -28,6 +29,11 @@ protected:
 
    KVIonRangeTableMaterial* fMaterialTable; //! range table for CsI
 
+   KVLightEnergyTable fLightTable; //!tables of light output used to invert light-energy function
+
+public:
+   Double_t GetLightDerivative(Double_t energy, Double_t* par) const;
+
 public:
    TF1* fLight;           //function parameterising light output as function of (energy, Z, A) with the full expression
    TF1* fDlight;          //function to integrate to get fLight
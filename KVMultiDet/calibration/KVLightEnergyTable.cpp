@@ -0,0 +1,158 @@
+#include "KVLightEnergyTable.h"
+#include "TMath.h"
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+//KVLightEnergyTable
+//
+//Inversion of light-energy functions of CsI calibrators (KVLightEnergyCsI,
+//KVLightEnergyCsIFull): the energy corresponding to a given light output is found
+//by Newton's method (with bisection if a step goes outside the current interval),
+//starting from linear interpolation between the two closest values in a table of
+//light outputs calculated for each (Z,A) the first time it is needed. All tables
+//are recalculated if the calibration parameters change.
+//
+//Access to the tables is protected by a mutex belonging to each object, so that
+//GetEnergy() can be called at the same time by several threads. Copies of an object
+//have their own mutex and start with empty tables.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+   // energy range for inversion of light-energy function
+   const Double_t kLightEnergyEmin = 0.;
+   const Double_t kLightEnergyEmax = 10000.;
+   // number of energies in tables of light output used for inversion
+   const Int_t kLightTableSize = 128;
+   // relative precision & maximum number of iterations for inversion
+   const Double_t kLightEnergyPrecision = 1.e-10;
+   const Int_t kLightEnergyMaxIter = 100;
+
+   Double_t LightTableEnergy(Int_t i)
+   {
+      // Energies used to tabulate light output: E=0 then logarithmic
+      // steps from 0.1 MeV to kLightEnergyEmax
+      return i ? 0.1 * TMath::Power(kLightEnergyEmax / 0.1, (i - 1.) / (kLightTableSize - 2.)) : kLightEnergyEmin;
+   }
+}
+
+KVLightEnergyTable::KVLightEnergyTable()
+#ifdef WITH_CPP11
+   : fMutex(new std::mutex)
+#endif
+{
+   // Default constructor
+}
+
+KVLightEnergyTable::KVLightEnergyTable(const KVLightEnergyTable&)
+#ifdef WITH_CPP11
+   : fMutex(new std::mutex)
+#endif
+{
+   // Copy constructor
+   // Tables are not copied: they are recalculated when needed
+}
+
+KVLightEnergyTable& KVLightEnergyTable::operator=(const KVLightEnergyTable& other)
+{
+   // Assignment: tables are cleared (they are recalculated when needed),
+   // each object keeps its own mutex
+
+   if (&other != this) {
+#ifdef WITH_CPP11
+      std::lock_guard<std::mutex> lock(*fMutex);
+#endif
+      fLightTable.clear();
+      fTablePar.clear();
+   }
+   return *this;
+}
+
+KVLightEnergyTable::~KVLightEnergyTable()
+{
+   // Destructor
+#ifdef WITH_CPP11
+   delete fMutex;
+#endif
+}
+
+Double_t KVLightEnergyTable::GetEmin()
+{
+   // Lower limit of energies (MeV) returned by GetEnergy()
+   return kLightEnergyEmin;
+}
+
+Double_t KVLightEnergyTable::GetEmax()
+{
+   // Upper limit of energies (MeV) returned by GetEnergy()
+   return kLightEnergyEmax;
+}
+
+Double_t KVLightEnergyTable::GetEnergy(Double_t light, Int_t key, Int_t npar, const Double_t* calib_par,
+                                       const LightFunction& func) const
+{
+   // Calculate the energy (in MeV) corresponding to a given light output for the
+   // nucleus whose light-energy function is func. key identifies the nucleus
+   // (e.g. 1000*Z+A), calib_par are the npar parameters of the calibration used
+   // to calculate func: if they change, all tables are recalculated.
+   // If the light is outside of the range of the function for energies between
+   // GetEmin() and GetEmax(), the corresponding limit is returned.
+
+   Double_t emin, emax, lmin, lmax;
+   Int_t where = FindEnergyInterval(light, key, npar, calib_par, func, emin, emax, lmin, lmax);
+   if (where < 0) return kLightEnergyEmin;
+   if (where > 0) return kLightEnergyEmax;
+
+   // light(emin) <= light < light(emax)
+   Double_t energy = (lmax > lmin ? emin + (emax - emin) * (light - lmin) / (lmax - lmin) : emin);
+   for (Int_t iter = 0; iter < kLightEnergyMaxIter; ++iter) {
+      Double_t f = func.GetLight(energy) - light;
+      if (f == 0.) return energy;
+      if (f < 0.) emin = energy;
+      else emax = energy;
+      Double_t dLdE = func.GetDerivative(energy);
+      Double_t new_energy = (dLdE > 0. ? energy - f / dLdE : emin);
+      if (new_energy <= emin || new_energy >= emax) new_energy = 0.5 * (emin + emax);
+      Double_t tolerance = kLightEnergyPrecision * TMath::Max(TMath::Abs(new_energy), 1.);
+      if (TMath::Abs(new_energy - energy) < tolerance || emax - emin < tolerance) return new_energy;
+      energy = new_energy;
+   }
+   return energy;
+}
+
+Int_t KVLightEnergyTable::FindEnergyInterval(Double_t light, Int_t key, Int_t npar, const Double_t* calib_par,
+      const LightFunction& func, Double_t& emin, Double_t& emax, Double_t& lmin, Double_t& lmax) const
+{
+   // Find the interval [emin,emax] of the table of light outputs for nucleus 'key'
+   // such that light(emin)=lmin <= light < lmax=light(emax).
+   //
+   // Returns -1 if light < light(GetEmin()), +1 if light >= light(GetEmax()), 0 otherwise.
+
+#ifdef WITH_CPP11
+   std::lock_guard<std::mutex> lock(*fMutex);
+#endif
+
+   if (fTablePar.size() != (UInt_t)npar || !std::equal(fTablePar.begin(), fTablePar.end(), calib_par)) {
+      fTablePar.assign(calib_par, calib_par + npar);
+      fLightTable.clear();
+   }
+
+   std::vector<Double_t>& table = fLightTable[key];
+   if (table.empty()) {
+      table.resize(kLightTableSize);
+      for (Int_t i = 0; i < kLightTableSize; ++i) table[i] = func.GetLight(LightTableEnergy(i));
+   }
+   if (light < table[0]) return -1;
+   if (light >= table[kLightTableSize - 1]) return 1;
+
+   Int_t lo = 0, hi = kLightTableSize - 1;
+   while (hi - lo > 1) {
+      Int_t mid = (lo + hi) / 2;
+      if (table[mid] <= light) lo = mid;
+      else hi = mid;
+   }
+   emin = LightTableEnergy(lo);
+   emax = LightTableEnergy(hi);
+   lmin = table[lo];
+   lmax = table[hi];
+   return 0;
+}
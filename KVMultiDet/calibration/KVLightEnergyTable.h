@@ -0,0 +1,43 @@
+#ifndef __KVLIGHTENERGYTABLE_H
+#define __KVLIGHTENERGYTABLE_H
+
+#include "Rtypes.h"
+#include <map>
+#include <vector>
+#ifdef WITH_CPP11
+#include <mutex>
+#endif
+
+class KVLightEnergyTable {
+
+   mutable std::map<Int_t, std::vector<Double_t> > fLightTable; //tabulated light output for each (Z,A)
+   mutable std::vector<Double_t> fTablePar; //calibration parameters used to calculate fLightTable
+#ifdef WITH_CPP11
+   std::mutex* fMutex; //protects fLightTable & fTablePar
+#endif
+
+public:
+   class LightFunction {
+      // Light output as a function of energy for one nucleus, used by GetEnergy()
+   public:
+      virtual ~LightFunction() {}
+      virtual Double_t GetLight(Double_t energy) const = 0;
+      virtual Double_t GetDerivative(Double_t energy) const = 0;
+   };
+
+   KVLightEnergyTable();
+   KVLightEnergyTable(const KVLightEnergyTable&);
+   KVLightEnergyTable& operator=(const KVLightEnergyTable&);
+   virtual ~KVLightEnergyTable();
+
+   static Double_t GetEmin();
+   static Double_t GetEmax();
+
+   Double_t GetEnergy(Double_t light, Int_t key, Int_t npar, const Double_t* calib_par, const LightFunction& func) const;
+
+private:
+   Int_t FindEnergyInterval(Double_t light, Int_t key, Int_t npar, const Double_t* calib_par, const LightFunction& func,
+                            Double_t& emin, Double_t& emax, Double_t& lmin, Double_t& lmax) const;
+};
+
+#endif
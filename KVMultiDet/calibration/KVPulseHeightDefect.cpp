@@ -195,7 +195,22 @@ Double_t KVPulseHeightDefect::Invert(Double_t energy)
    //Given the PHD (in MeV) of a particle of charge Z
    //(set using SetZ() method), this method inverts the Moulton formula
    //in order to find the energy loss of the particle in the detector.
-
+   //
+   //For Z>2 the formula is inverted analytically:
+   //
+   //  E = (PHD / 10**b(Z))**(1/a(Z))
+   //
+   //(limited to the range of the Moulton function, [0,10 GeV]).
+
+   Int_t Z = GetZ();
+   if (Z > 2) {
+      Double_t a = GetParameter(0) * Z * Z / 1000. + GetParameter(1);
+      Double_t b = GetParameter(2) * 100. / Z + GetParameter(3);
+      if (a > 0.) {
+         if (energy <= 0.) return 0.;
+         return TMath::Min(TMath::Power(energy / TMath::Power(10, b), 1. / a), 1.e+04);
+      }
+   }
    const_cast<KVPulseHeightDefect*>(this)->GetMoultonPHDFunction(GetZ());
    Double_t xmin, xmax;
    fMoulton->GetRange(xmin, xmax);
@@ -69,6 +69,12 @@ ClassImp(GTGanilData)
 // Before reading a new event, every parameter is set to 65535
 // Casting back this value to a Short_t (-32768 to 32768) gives "-1" which is the signal that the parameter's coder
 // did not fire in the event that was read.
+//
+// The indices of the parameters present in each event are kept in a list
+// (see GetFiredParameterIndices() and GetNbFiredParameters()), so that only
+// these parameters need to be reset before reading the next event.
+// Therefore the values of parameters which did not fire must not be modified
+// using pointers obtained with Connect().
 //////////////////////////////////////////////////////////////////////////
 
 //______________________________________________________________________________
@@ -108,6 +114,7 @@ GTGanilData::~GTGanilData(void)
    if (fBuffer)delete   fBuffer;
    if (fStructEvent)delete[] fStructEvent;
    if (fDataArray) delete[] fDataArray;
+   if (fFiredIndex) delete[] fFiredIndex;
    if (fEventBrut) delete[] fEventBrut;
    if (fEventCtrl) delete[] fEventCtrl;
 }
@@ -134,6 +141,9 @@ void GTGanilData::InitDefault(const Int_t argc, char** argv)
    fIsCtrl         = false;
    fIsScalerBuffer = false;
    fDataArray      = 0;
+   fDataArraySize  = 0;
+   fFiredIndex     = 0;
+   fNbFired        = 0;
 
    fDevice         = new gan_tape_desc;
    fBuffer         = new in2p3_buffer_struct;
@@ -262,10 +272,40 @@ void GTGanilData::ReadParameters(void)
          fDataArraySize = fDataParameters->Fill(fBuffer->les_donnees.cas.Buf_param);
    } while (strcmp(fHeader, PARAM_Id) == 0);
 
+   InitDataArray();
+}
+
+//______________________________________________________________________________
+void GTGanilData::InitDataArray(void)
+{
+   // PRIVATE
+   // Allocate data array for fDataArraySize parameters, and the array used to
+   // store the indices of fired parameters in each event.
+   // All parameters have their value set to -1 (65535).
+
+   if (fDataArray) delete[] fDataArray;
+   if (fFiredIndex) delete[] fFiredIndex;
    fDataArray = new UShort_t[fDataArraySize + 1]; // Data buffer is allocated
    for (Int_t i = 1; i <= fDataArraySize; i++) {
       fDataArray[i] = (Short_t) - 1;
    }
+   fFiredIndex = new Int_t[fDataArraySize + 1];
+   fNbFired = 0;
+}
+
+//______________________________________________________________________________
+void GTGanilData::ClearDataArray(void)
+{
+   // PRIVATE
+   // Set value of all parameters fired in the previous event to -1 (65535),
+   // and clear the list of fired parameters.
+   // As all other parameters already have value -1, only the fired ones
+   // need to be reset.
+
+   for (Int_t i = 0; i < fNbFired; i++) {
+      fDataArray[fFiredIndex[i]] = (Short_t) - 1;
+   }
+   fNbFired = 0;
 }
 
 //______________________________________________________________________________
@@ -499,20 +539,20 @@ bool GTGanilData::EventUnravelling(CTRL_EVENT* pCtrlEvent)
    // WARNING: temporary the default: we dont check that it's really the case
    // Before reading event, all parameters have their value set to -1 (65535 - fDataArray is UShort_t)
    // Parameters which are not fired in the event will have value -1 (65535 - cast back to Short_t for real value)
+   // The indices of the fired parameters are stored in the order in which they appear
+   // in the event: see GetFiredParameterIndices().
 
    Short_t* brutData     = &(pCtrlEvent->ct_par);
 
    Int_t eventLength = pCtrlEvent->ct_len;
    //Info("EventUnravelling","eventLength=%d",eventLength);
 
-   for (Int_t i = 1; i <= fDataArraySize; i++) {
-      fDataArray[i] = (Short_t) - 1;
-   }
+   ClearDataArray();
 
    for (Int_t i = 0; i < eventLength; i += 2) {
       // cout << "Param index=" << brutData[i] << " Value=" << brutData[i+1]<<endl;
       if (brutData[i] <= fDataArraySize && brutData[i] >= 1) {
-         fDataArray[brutData[i]] = brutData[i + 1];
+         SetDataArrayValue(brutData[i], brutData[i + 1]);
       } else { // More on error handling would be cool
          /*      cout << "Index overflow : Parameter index "<<i<<" is "<<brutData[i]<<
                " but fDataArraySize is " << fDataArraySize<<endl;
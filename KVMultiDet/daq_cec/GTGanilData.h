@@ -86,6 +86,10 @@ public:
       return (fStatus);
    }
    void            SetScalerBuffersManagement(const ScalerWhat_t sc);
+   ScalerWhat_t    GetScalerBuffersManagement() const
+   {
+      return fWhatScaler;
+   }
    Int_t           GetRunNumber(void) const;
 
    Bool_t          IsOpen(void) const;
@@ -102,8 +106,36 @@ public:
    {
       return fEventCount;
    }
+   Int_t GetNbFiredParameters() const
+   {
+      // Number of different parameters present in the current event
+      return fNbFired;
+   }
+   const Int_t* GetFiredParameterIndices() const
+   {
+      // Indices of the parameters present in the current event, in the order
+      // in which they appear in the event (each index appears only once).
+      // Number of indices is given by GetNbFiredParameters().
+      return fFiredIndex;
+   }
+   const UShort_t* GetDataArray() const
+   {
+      // Values of all parameters in the current event, indexed by parameter index
+      // (1<=index<=GetDataArraySize()). Parameters which did not fire have value -1 (65535).
+      return fDataArray;
+   }
+   Int_t GetDataArraySize() const
+   {
+      return fDataArraySize;
+   }
 
    virtual void SetUserTree(TTree*);
+   virtual Bool_t HasUserTree() const
+   {
+      // kTRUE if SetUserTree was called to fill branches of a user tree with the
+      // data decoded by this object
+      return kFALSE;
+   }
 
 protected:
    void InitDefault(const Int_t argc = 0, char** argv = NULL);
@@ -112,6 +144,17 @@ protected:
    bool ReadNextEvent(void);
    bool ReadNextEvent_EBYEDAT(void);
    virtual bool EventUnravelling(CTRL_EVENT*);
+   void InitDataArray(void);
+   void ClearDataArray(void);
+   void SetDataArrayValue(Int_t index, UShort_t value)
+   {
+      // Set value of parameter with given index in current event.
+      // Index is added to list of fired parameters if it was not already present in the event.
+      // A value of -1 (65535) means the parameter did not fire, and is ignored.
+      if (value == (UShort_t) - 1) return;
+      if (fDataArray[index] == (UShort_t) - 1) fFiredIndex[fNbFired++] = index;
+      fDataArray[index] = value;
+   }
 
    TString        fFileName;      // Filename, can be a tape drive
    Int_t          fStatus;        // Status, 0 is OK, any other value suspect
@@ -131,6 +174,8 @@ protected:
    char           fHeader[9];     // Buffer header
    UShort_t*      fDataArray;     //! Physical data array
    Int_t          fDataArraySize; // Data array size
+   Int_t*         fFiredIndex;    //! Indices of parameters present in current event
+   Int_t          fNbFired;       //! Number of parameters present in current event
    Int_t          fEventNumber;   // Local event number in current buffer (should be renamed)
    Int_t          fEventCount;    // Our event counter
    bool           fIsCtrl;        // We are currently in a CTRL buffer
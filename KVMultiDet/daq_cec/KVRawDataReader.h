@@ -35,6 +35,21 @@ public:
       return 0;
    };
 
+   virtual Bool_t EnablePipeline(Int_t /* depth */)
+   {
+      // Decode events in a separate thread ahead of their analysis
+      // (not possible by default: see KVGANILDataReader::EnablePipeline)
+      return kFALSE;
+   }
+   virtual Bool_t IsPipelined() const
+   {
+      return kFALSE;
+   }
+   virtual void PrintPipelineStatistics() const
+   {
+      ;
+   }
+
    ClassDef(KVRawDataReader, 0) //Base class for reading raw data
 };
 
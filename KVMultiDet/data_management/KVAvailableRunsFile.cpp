@@ -16,6 +16,7 @@ $Date: 2009/03/12 14:01:02 $
 #include "KVList.h"
 #include "KVDataRepository.h"
 #include "KVRunFile.h"
+#include <vector>
 
 //macro converting octal filemode to decimal value
 //to convert e.g. 664 (=u+rw, g+rw, o+r) use CHMODE(6,6,4)
@@ -297,10 +298,25 @@ void KVAvailableRunsFile::Update(Bool_t no_existing_file)
    if (!dir_list)
       return;
 
+   // names & run numbers of all runfiles in directory
+   std::vector<TString> runfiles;
+   std::vector<Int_t> run_numbers;
    TIter next(dir_list);
    KVBase* objs;
+   while ((objs = (KVBase*) next())) {      // loop over all entries in directory
+      Int_t run_num;
+      //is this the correct name of a run in the repository ?
+      if ((run_num = IsRunFileName(objs->GetName()))) {
+         runfiles.push_back(objs->GetName());
+         run_numbers.push_back(run_num);
+      }
+   }
+   //get file modification dates (files are examined in parallel for local repositories)
+   std::vector<FileStat_t> infos;
+   repository->GetFileInfos(fDataSet, GetDataType(), runfiles, infos);
+
    //progress bar
-   Int_t ntot = dir_list->GetSize();
+   Int_t ntot = runfiles.size();
    Int_t n5pc = TMath::Max(ntot / 20, 1);
    Int_t ndone = 0;
    KVDBTable* run_table = 0;
@@ -310,52 +326,44 @@ void KVAvailableRunsFile::Update(Bool_t no_existing_file)
       db->AddTable("Runs", "List of Runs");
    }
    run_table = db->GetTable("Runs");
-   while ((objs = (KVBase*) next())) {      // loop over all entries in directory
-
-      Int_t run_num;
-      //is this the correct name of a run in the repository ?
-      if ((run_num = IsRunFileName(objs->GetName()))) {
-
-         KVDBRun* run = (KVDBRun*) run_table->GetRecord(run_num);
-         if (run) {
-            FileStat_t fs;
-            //get file modification date
-            if (repository->
-                  GetFileInfo(fDataSet, GetDataType(),
-                              objs->GetName(), fs)) {
-               //runfile exists in repository
-               TDatime modt(fs.fMtime);
-               if (!no_existing_file) {
-                  // was there already an entry for exactly the same file in the previous file ?
-                  Int_t occIdx = 0;
-                  KVNameValueList* prevEntry = RunHasFileWithDateAndName(run->GetNumber(), objs->GetName(), modt, occIdx);
-                  if (prevEntry) {
-                     // copy infos of previous entry
-                     tmp_file << run->GetNumber() << '|' << modt.AsSQLString() << '|' << objs->GetName();
-                     if (prevEntry->HasParameter(Form("KVVersion[%d]", occIdx))) {
-                        tmp_file << "|" << prevEntry->GetStringValue(Form("KVVersion[%d]", occIdx)) << "|" << prevEntry->GetStringValue(Form("Username[%d]", occIdx));
-                     }
-                     tmp_file << endl;
-                  } else {
-                     // New Entry - write in temporary runlist file '[run number]|[date of modification]|[name of file]
-                     tmp_file << run->GetNumber() << '|' << modt.AsSQLString() << '|' << objs->GetName() << endl;
+   for (Int_t i = 0; i < ntot; ++i) {      // loop over all runfiles in directory
+
+      Int_t run_num = run_numbers[i];
+      const Char_t* filename = runfiles[i].Data();
+      KVDBRun* run = (KVDBRun*) run_table->GetRecord(run_num);
+      if (run) {
+         if (infos[i].fSize > -1) {
+            //runfile exists in repository
+            TDatime modt(infos[i].fMtime);
+            if (!no_existing_file) {
+               // was there already an entry for exactly the same file in the previous file ?
+               Int_t occIdx = 0;
+               KVNameValueList* prevEntry = RunHasFileWithDateAndName(run->GetNumber(), filename, modt, occIdx);
+               if (prevEntry) {
+                  // copy infos of previous entry
+                  tmp_file << run->GetNumber() << '|' << modt.AsSQLString() << '|' << filename;
+                  if (prevEntry->HasParameter(Form("KVVersion[%d]", occIdx))) {
+                     tmp_file << "|" << prevEntry->GetStringValue(Form("KVVersion[%d]", occIdx)) << "|" << prevEntry->GetStringValue(Form("Username[%d]", occIdx));
                   }
-               } else { // no previous existing file
-                  // New Entry in a new file - write in temporary runlist file '[run number]|[date of modification]|[name of file]
-                  tmp_file << run->GetNumber() << '|' << modt.AsSQLString() << '|' << objs->GetName() << endl;
+                  tmp_file << endl;
+               } else {
+                  // New Entry - write in temporary runlist file '[run number]|[date of modification]|[name of file]
+                  tmp_file << run->GetNumber() << '|' << modt.AsSQLString() << '|' << filename << endl;
                }
-            }
-         } else {
-            Info("Update", "the current run [%s] is not in database", objs->GetName());
-            FileStat_t fs;
-            if (repository->GetFileInfo(fDataSet, GetDataType(), objs->GetName(), fs)) {
-               TDatime modt(fs.fMtime);
+            } else { // no previous existing file
                // New Entry in a new file - write in temporary runlist file '[run number]|[date of modification]|[name of file]
-               tmp_file << run_num  << '|' << modt.AsSQLString() << '|' << objs->GetName() << endl;
-            } else {
-               Warning("Update", "%s GetFileInfo return kFALSE", objs->GetName());
+               tmp_file << run->GetNumber() << '|' << modt.AsSQLString() << '|' << filename << endl;
             }
          }
+      } else {
+         Info("Update", "the current run [%s] is not in database", filename);
+         if (infos[i].fSize > -1) {
+            TDatime modt(infos[i].fMtime);
+            // New Entry in a new file - write in temporary runlist file '[run number]|[date of modification]|[name of file]
+            tmp_file << run_num  << '|' << modt.AsSQLString() << '|' << filename << endl;
+         } else {
+            Warning("Update", "%s GetFileInfo return kFALSE", filename);
+         }
       }
 
       ndone++;
@@ -56,7 +56,7 @@ public:
    KVAvailableRunsFile(const Char_t* type, const KVDataSet* parent);
    virtual ~ KVAvailableRunsFile();
 
-   Bool_t FileExists() const
+   virtual Bool_t FileExists() const
    {
       return !gSystem->AccessPathName(GetFullPathToAvailableRunsFile());
    }
@@ -98,7 +98,7 @@ public:
       return fDataSet->GetBaseFileName(GetDataType(), run);
    }
 
-   KVNumberList CheckMultiRunfiles();
+   virtual KVNumberList CheckMultiRunfiles();
    void RemoveDuplicateLines(KVNumberList lines_to_be_removed);
 
    ClassDef(KVAvailableRunsFile, 1)     //Handles text files containing list of available runs for different datasets and types of data
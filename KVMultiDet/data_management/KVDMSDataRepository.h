@@ -12,6 +12,11 @@ protected:
    KVDMS* fDMS;//! connection to Data Management System
 
    virtual int             Chmod(const char* file, UInt_t mode);
+   virtual Bool_t CanScanConcurrently() const
+   {
+      // files can only be examined through the DMS, one at a time
+      return kFALSE;
+   }
 public:
    KVDMSDataRepository();
    virtual ~KVDMSDataRepository();
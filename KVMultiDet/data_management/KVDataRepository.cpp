@@ -25,6 +25,15 @@ $Date: 2009/01/16 14:55:20 $
 
 #include <TClass.h>
 #include <TMethodCall.h>
+#include "TStopwatch.h"
+#include "RVersion.h"
+#include "TDatime.h"
+#include "KVUniqueNameList.h"
+#include "TMath.h"
+#ifdef WITH_CPP11
+#include <thread>
+#include <atomic>
+#endif
 
 //macro converting octal filemode to decimal value
 //to convert e.g. 664 (=u+rw, g+rw, o+r) use CHMODE(6,6,4)
@@ -250,6 +259,11 @@ KVDataRepository::KVDataRepository()
    fHelpers       = 0;
    fCommitDataSet = 0;
    SetType("local");
+#ifdef WITH_CPP11
+   SetNumberOfScanThreads(gEnv->GetValue("KVDataRepository.ScanThreads", 8));
+#else
+   fScanThreads = 1; // parallel scanning of files requires C++11
+#endif
 }
 
 //___________________________________________________________________________
@@ -265,7 +279,7 @@ KVDataRepository::~KVDataRepository()
       fHelpers->Delete();
       SafeDelete(fHelpers);
    }
-
+   ClearScanCache();
 }
 
 //___________________________________________________________________________
@@ -326,11 +340,8 @@ Bool_t KVDataRepository::GetFileInfo(const KVDataSet* dataset,
    //exists. If it does, the returned value is kTRUE (=1), in which case the FileStat_t object
    //contains information about the file.
 
-   TString path, tmp;
-   AssignAndDelete(path,
-                   gSystem->ConcatFileName(fAccessroot.Data(), dataset->GetDataPathSubdir()));
-   AssignAndDelete(tmp, gSystem->ConcatFileName(path.Data(), dataset->GetDataTypeSubdir(datatype)));
-   AssignAndDelete(path, gSystem->ConcatFileName(tmp.Data(), runfile));
+   TString path;
+   AssignAndDelete(path, gSystem->ConcatFileName(GetAccessPath(dataset, datatype), runfile));
    return !gSystem->GetPathInfo(path.Data(), fs);
 }
 
@@ -547,9 +558,21 @@ KVUniqueNameList* KVDataRepository::GetDirectoryListing(const KVDataSet* dataset
    //      /root_of_data_repository/[datasetdir]                    (if datatype="", default value)
    //
    //and fill a TList with one KVBase object for each entry in the directory,
-   //excluding "." and ".."
+   //excluding "." and ".." (see ListDirectory).
    //User must delete the TList after use (list will delete its members)
 
+   return ListDirectory(GetAccessPath(dataset, datatype));
+}
+
+//___________________________________________________________________________
+
+TString KVDataRepository::GetAccessPath(const KVDataSet* dataset, const Char_t* datatype) const
+{
+   //Returns path to directory (using the access protocol)
+   //
+   //      /root_of_data_repository/[datasetdir]/[datatype]
+   //      /root_of_data_repository/[datasetdir]                    (if datatype="", default value)
+
    TString path, tmp;
    AssignAndDelete(path,
                    gSystem->ConcatFileName(fAccessroot.Data(),
@@ -558,38 +581,206 @@ KVUniqueNameList* KVDataRepository::GetDirectoryListing(const KVDataSet* dataset
       AssignAndDelete(tmp, gSystem->ConcatFileName(path.Data(), dataset->GetDataTypeSubdir(datatype)));
       path = tmp;
    }
-   //open directory
-   void* dirp = gSystem->OpenDirectory(path.Data());
-   if (!dirp) {
-      Error("KVDataRepository::GetDirectoryListing", "Cannot open %s",
-            path.Data());
+   return path;
+}
+
+//___________________________________________________________________________
+
+KVDataRepository::DirectoryScan_t* KVDataRepository::GetDirectoryScan(const TString& path)
+{
+   //Returns the cached listing of the directory, which is discarded if the
+   //modification time of the directory has changed since it was obtained
+   //(i.e. files have been added, removed or renamed).
+   //Returns 0 if the directory does not exist.
+
+   FileStat_t dirstat;
+   if (gSystem->GetPathInfo(path, dirstat)) {
+      fScanCache.erase(path.Data());
       return 0;
    }
+   DirectoryScan_t& scan = fScanCache[path.Data()];
+   // files added during the same second as the first scan would not change the modification
+   // time: in this case the cache cannot be trusted
+   if (scan.fMtime == dirstat.fMtime && scan.fMtime < scan.fScanned) return &scan;
+   SafeDelete(scan.fListing);
+   scan.fMtime = dirstat.fMtime;
+   scan.fScanned = TDatime().Convert();
+   return &scan;
+}
 
-   KVUniqueNameList* dirlist = new KVUniqueNameList(kTRUE);
-   dirlist->SetOwner(kTRUE);
+//___________________________________________________________________________
+
+void KVDataRepository::ClearScanCache()
+{
+   //Forget all directory listings obtained with ListDirectory.
+
+   for (std::map<std::string, DirectoryScan_t>::iterator it = fScanCache.begin(); it != fScanCache.end(); ++it)
+      SafeDelete(it->second.fListing);
+   fScanCache.clear();
+}
 
-   TObjString* direntry = new TObjString(gSystem->GetDirEntry(dirp));
-   while (direntry->GetString() != "") {        //loop over all entries in directory
-      if (direntry->GetString() == "." || direntry->GetString() == "..") {
+//___________________________________________________________________________
+
+void KVDataRepository::SetNumberOfScanThreads(Int_t n)
+{
+   //Set maximum number of threads used to examine files in parallel (see ScanFiles).
+   //Default value is given by
+   //
+   //   KVDataRepository.ScanThreads:   8
+   //
+   //  n = 1 : files are examined one after the other
+   //  n = 0 : use as many threads as there are cores on the machine
+   //
+   //Parallel processing requires compilation with C++11; otherwise n is always set to 1.
+
+#ifdef WITH_CPP11
+   if (n == 0) n = TMath::Max(1, (Int_t)std::thread::hardware_concurrency());
+   fScanThreads = TMath::Max(1, n);
+#else
+   if (n != 1) Warning("SetNumberOfScanThreads", "Parallel scanning of files requires C++11: using 1 thread");
+   fScanThreads = 1;
+#endif
+}
+
+//___________________________________________________________________________
+
+KVUniqueNameList* KVDataRepository::ListDirectory(const TString& path)
+{
+   //Fill a TList with one KVBase object for each entry in the directory with the
+   //given (local) path, excluding "." and "..".
+   //User must delete the TList after use (list will delete its members)
+   //
+   //Listings are kept in memory, and as long as the modification time of the directory
+   //does not change, the directory is not read again.
+
+   DirectoryScan_t* scan = GetDirectoryScan(path);
+   if (!scan || !scan->fListing) {
+      //open directory
+      void* dirp = gSystem->OpenDirectory(path.Data());
+      if (!dirp) {
+         Error("KVDataRepository::GetDirectoryListing", "Cannot open %s",
+               path.Data());
+         return 0;
+      }
+
+      KVUniqueNameList* dirlist = new KVUniqueNameList(kTRUE);
+      dirlist->SetOwner(kTRUE);
+
+      TString direntry = gSystem->GetDirEntry(dirp);
+      while (direntry != "") {        //loop over all entries in directory
          //skip "." and ".."
-         delete direntry;
-      } else {
-         dirlist->Add(new KVBase(direntry->GetString().Data()));
-         delete direntry;
+         if (direntry != "." && direntry != "..") dirlist->Add(new KVBase(direntry.Data()));
+         //get next entry
+         direntry = gSystem->GetDirEntry(dirp);
       }
-      //get next entry
-      direntry = new TObjString(gSystem->GetDirEntry(dirp));
+      //close directory
+      gSystem->FreeDirectory(dirp);
+      if (!scan) return dirlist;
+      scan->fListing = dirlist;
    }
-   //delete last TObjString, which should contain ""
-   delete direntry;
-   //close directory
-   gSystem->FreeDirectory(dirp);
+   // return a copy of the listing
+   KVUniqueNameList* dirlist = new KVUniqueNameList(kTRUE);
+   dirlist->SetOwner(kTRUE);
+   TIter next(scan->fListing);
+   TObject* entry;
+   while ((entry = next())) dirlist->Add(new KVBase(entry->GetName()));
    return dirlist;
 }
 
 //___________________________________________________________________________
 
+Int_t KVDataRepository::ScanFiles(const TString& path, const std::vector<TString>& files, std::vector<FileStat_t>& infos)
+{
+   //Fill infos[i] with the informations (size, modification time, ...) on file files[i]
+   //in the directory with the given (local) path.
+   //For any file which does not exist, infos[i].fSize = -1.
+   //Returns the number of files which exist.
+   //
+   //Files are examined in parallel by (up to) GetNumberOfScanThreads() threads.
+   //Each file is always examined: a file can be modified without changing the
+   //modification time of its directory, so its size & modification time cannot be
+   //known without looking at the file itself.
+   //If gDebug>0, the number of files examined per second is printed.
+
+   infos.assign(files.size(), FileStat_t());
+   Int_t nfiles = files.size(), nfound = 0;
+   if (!nfiles) return 0;
+
+   TStopwatch timer;
+   Int_t nthreads = 1;
+#ifdef WITH_CPP11
+   nthreads = TMath::Min(fScanThreads, nfiles);
+   if (nthreads > 1) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+      ROOT::EnableThreadSafety();
+#endif
+      std::atomic<int> next_file(0);
+      auto worker = [&]() {
+         int i;
+         while ((i = next_file++) < nfiles) {
+            FileStat_t& fs = infos[i];
+            if (gSystem->GetPathInfo(path + "/" + files[i], fs)) fs.fSize = -1;
+         }
+      };
+      std::vector<std::thread> workers;
+      for (int t = 1; t < nthreads; ++t) workers.emplace_back(worker);
+      worker();
+      for (auto& w : workers) w.join();
+   } else
+#endif
+   {
+      for (Int_t i = 0; i < nfiles; ++i) {
+         FileStat_t& fs = infos[i];
+         if (gSystem->GetPathInfo(path + "/" + files[i], fs)) fs.fSize = -1;
+      }
+   }
+   for (Int_t i = 0; i < nfiles; ++i) {
+      if (infos[i].fSize > -1) ++nfound;
+   }
+   if (gDebug > 0) {
+      Double_t t = timer.RealTime();
+      Info("ScanFiles", "%s : %d files examined in %.2f s (%.0f files/s, %d threads)",
+           path.Data(), nfiles, t, (t > 0 ? nfiles / t : 0.), nthreads);
+   }
+   return nfound;
+}
+
+//___________________________________________________________________________
+
+Bool_t KVDataRepository::CanScanConcurrently() const
+{
+   //Returns kTRUE if files can be examined directly & in parallel by ScanFiles
+   //(i.e. repository accessed with local protocol), kFALSE if GetFileInfos has to
+   //call GetFileInfo for each file
+
+   return (!IsRemote() && fAccessprotocol == "local");
+}
+
+//___________________________________________________________________________
+
+Int_t KVDataRepository::GetFileInfos(const KVDataSet* dataset, const Char_t* datatype,
+                                     const std::vector<TString>& runfiles, std::vector<FileStat_t>& infos)
+{
+   //Fill infos[i] with the informations on run file runfiles[i] of the given type in the
+   //dataset subdirectory, as given by GetFileInfo.
+   //For any file which does not exist, infos[i].fSize = -1.
+   //Returns the number of files which exist.
+   //
+   //For local repositories the files are examined in parallel (see ScanFiles).
+
+   if (CanScanConcurrently()) return ScanFiles(GetAccessPath(dataset, datatype), runfiles, infos);
+
+   infos.assign(runfiles.size(), FileStat_t());
+   Int_t nfound = 0;
+   for (UInt_t i = 0; i < runfiles.size(); ++i) {
+      if (GetFileInfo(dataset, datatype, runfiles[i], infos[i])) ++nfound;
+      else infos[i].fSize = -1;
+   }
+   return nfound;
+}
+
+//___________________________________________________________________________
+
 TFile* KVDataRepository::CreateNewFile(const KVDataSet* dataset,
                                        const Char_t* datatype,
                                        const Char_t* filename)
@@ -981,9 +1172,16 @@ KVAvailableRunsFile* KVDataRepository::NewAvailableRunsFile(const Char_t* data_t
    // Actual class of object depends on the type of the repository,
    // which is used to select one of the
    // Plugin.KVDataAvailableRunsFile's defined in .kvrootrc.
+   //
+   // For local repositories, if
+   //   KVAvailableRunsFile.UseSQLite:   yes
+   // then the 'sqlite' plugin (KVSQLiteAvailableRunsFile) is used instead, if available.
 
    //check and load plugin library
-   TPluginHandler* ph = KVBase::LoadPlugin("KVAvailableRunsFile", GetType());
+   TPluginHandler* ph = 0;
+   if (!strcmp(GetType(), "local") && gEnv->GetValue("KVAvailableRunsFile.UseSQLite", kFALSE))
+      ph = KVBase::LoadPlugin("KVAvailableRunsFile", "sqlite");
+   if (!ph) ph = KVBase::LoadPlugin("KVAvailableRunsFile", GetType());
    if (!ph)
       return new KVAvailableRunsFile(data_type, ds);
 
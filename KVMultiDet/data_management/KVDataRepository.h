@@ -15,6 +15,9 @@ $Date: 2007/12/11 12:45:47 $
 #include "TSystem.h"
 #include "KVAvailableRunsFile.h"
 #include "TEnv.h"
+#include <map>
+#include <vector>
+#include <string>
 
 class KVList;
 class KVUniqueNameList;
@@ -60,6 +63,18 @@ protected:
 
    TSeqCollection*  fHelpers;          //List of helper classes for alternative file/directory access
    TObject* OpenDataSetFile(const KVDataSet* ds, const Char_t* type, const TString& fname, Option_t* opt = "");
+
+   Int_t fScanThreads;//! number of threads used to examine files (ScanFiles)
+   struct DirectoryScan_t {
+      Long_t fMtime;//modification time of directory
+      Long_t fScanned;//time when directory was first examined with this modification time
+      KVUniqueNameList* fListing;//listing of directory
+      DirectoryScan_t() : fMtime(0), fScanned(0), fListing(0) {}
+   };
+   std::map<std::string, DirectoryScan_t> fScanCache;//! listings of each examined directory
+   DirectoryScan_t* GetDirectoryScan(const TString& path);
+   TString GetAccessPath(const KVDataSet* dataset, const Char_t* datatype = "") const;
+   virtual Bool_t CanScanConcurrently() const;
 public:
    virtual int  CopyFile(const char* f, const char* t, Bool_t overwrite = kFALSE);
    TSystem*               FindHelper(const char* path, void* dirptr = 0);
@@ -107,6 +122,16 @@ public:
    }
    virtual KVUniqueNameList* GetDirectoryListing(const KVDataSet* dataset,
          const Char_t* datatype = "");
+   virtual Int_t GetFileInfos(const KVDataSet* dataset, const Char_t* datatype,
+                              const std::vector<TString>& runfiles, std::vector<FileStat_t>& infos);
+   KVUniqueNameList* ListDirectory(const TString& path);
+   Int_t ScanFiles(const TString& path, const std::vector<TString>& files, std::vector<FileStat_t>& infos);
+   void ClearScanCache();
+   void SetNumberOfScanThreads(Int_t n);
+   Int_t GetNumberOfScanThreads() const
+   {
+      return fScanThreads;
+   }
 
    virtual void CopyFileFromRepository(const KVDataSet* dataset,
                                        const Char_t* datatype,
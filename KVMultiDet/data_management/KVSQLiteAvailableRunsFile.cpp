@@ -0,0 +1,663 @@
+#include "KVSQLiteAvailableRunsFile.h"
+#include "KVDataBase.h"
+#include "KVDBRun.h"
+#include "KVDBSystem.h"
+#include "KVDataRepository.h"
+#include "KVRunFile.h"
+#include "KVList.h"
+#include "KVString.h"
+#include "TObjString.h"
+#include <map>
+#include <set>
+#include <vector>
+
+//macro converting octal filemode to decimal value
+//to convert e.g. 664 (=u+rw, g+rw, o+r) use CHMODE(6,6,4)
+#define CHMODE(u,g,o) ((u << 6) + (g << 3) + o)
+
+using namespace std;
+
+ClassImp(KVSQLiteAvailableRunsFile)
+
+////////////////////////////////////////////////////////////////////////////////
+// BEGIN_HTML <!--
+/* -->
+<h2>KVSQLiteAvailableRunsFile</h2>
+<h4>Indexed catalogue of available runs using an SQLite database</h4>
+<!-- */
+// --> END_HTML
+//Replaces the text files of available runs (see KVAvailableRunsFile) by an SQLite
+//database (see KVSQLite::database) with one table containing, for each available
+//runfile of each datatype of the dataset:
+//
+//   datatype | run | date | filename | kvversion | username | system
+//
+//with indexes on (datatype,run) and (datatype,system), so that looking for the
+//file(s) of a given run or the runs of a given system no longer requires reading
+//the whole list. One database file is used for all datatypes of a dataset:
+//
+//      [repository].available_runs.[dataset subdir].sqlite
+//
+//in the same directory as the text files (see KVAvailableRunsFile::GetFilePath).
+//
+//The first time the catalogue is used for a datatype, any existing text file of
+//available runs is imported (see ImportTextFile) before the repository directory is
+//scanned. Update() is incremental: if the modification time of the repository
+//directory has not changed since the last update, nothing is done; otherwise only
+//files which are not already in the catalogue are examined (see
+//KVDataRepository::GetFileInfos), and entries for files which have disappeared are removed.
+//
+//To use the catalogue for all local repositories, put the following in your .kvrootrc:
+//
+//   KVAvailableRunsFile.UseSQLite:   yes
+//
+//(requires ROOT with SQLite support).
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+   TString sql_quote(const TString& s)
+   {
+      // quote string for use in SQL selection, doubling any single quotes
+      TString q(s);
+      q.ReplaceAll("'", "''");
+      return Form("'%s'", q.Data());
+   }
+}
+
+KVSQLiteAvailableRunsFile::KVSQLiteAvailableRunsFile()
+   : KVAvailableRunsFile()
+{
+   // Default constructor
+}
+
+//____________________________________________________________________________//
+
+KVSQLiteAvailableRunsFile::KVSQLiteAvailableRunsFile(const Char_t* type, KVDataSet* ds)
+   : KVAvailableRunsFile(type, ds)
+{
+   // Constructor with name of datatype and pointer to dataset
+   fSelection.Form("datatype=%s", sql_quote(type).Data());
+}
+
+//____________________________________________________________________________//
+
+KVSQLiteAvailableRunsFile::~KVSQLiteAvailableRunsFile()
+{
+   // Destructor
+   if (fCatalogue.good() && fCatalogue.is_open()) fCatalogue.close();
+}
+
+//____________________________________________________________________________//
+
+TString KVSQLiteAvailableRunsFile::GetFullPathToCatalogue() const
+{
+   // Full path to database file containing catalogue of available runs for the dataset:
+   //   [GetFilePath()]/[repository].available_runs.[dataset subdir].sqlite
+
+   TString path, filename;
+   filename.Form("%s.available_runs.%s.sqlite", fDataSet->GetRepository()->GetName(), fDataSet->GetDataPathSubdir());
+   AssignAndDelete(path, gSystem->ConcatFileName(GetFilePath(), filename.Data()));
+   return path;
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVSQLiteAvailableRunsFile::OpenCatalogue()
+{
+   // Open database file containing the catalogue.
+   // If it does not exist, it is created along with the tables & indexes.
+   // Returns kFALSE in case of problems.
+
+   if (fCatalogue.good() && fCatalogue.is_open()) return kTRUE;
+   if (!fDataSet) {
+      Error("OpenCatalogue", "Dataset has not been set for this file.");
+      return kFALSE;
+   }
+   if (!CheckDirectoryForAvailableRunsFile()) return kFALSE;
+   TString path = GetFullPathToCatalogue();
+   Bool_t new_file = gSystem->AccessPathName(path);
+   fCatalogue.open(path);
+   if (!fCatalogue.good()) {
+      Error("OpenCatalogue", "Cannot open catalogue of available runs %s", path.Data());
+      return kFALSE;
+   }
+   if (!fCatalogue.has_table("AvailableRuns")) {
+      KVSQLite::table runs("AvailableRuns");
+      runs.add_column("datatype", KVSQLite::column_type::TEXT);
+      runs.add_column("run", KVSQLite::column_type::INTEGER);
+      runs.add_column("date", KVSQLite::column_type::TEXT);
+      runs.add_column("filename", KVSQLite::column_type::TEXT);
+      runs.add_column("kvversion", KVSQLite::column_type::TEXT);
+      runs.add_column("username", KVSQLite::column_type::TEXT);
+      runs.add_column("system", KVSQLite::column_type::TEXT);
+      fCatalogue.add_table(runs);
+      fCatalogue.add_index("AvailableRuns", "datatype,run");
+      fCatalogue.add_index("AvailableRuns", "datatype,system");
+   }
+   if (!fCatalogue.has_table("Directories")) {
+      // modification time of repository directory for each datatype at last update
+      KVSQLite::table dirs("Directories");
+      dirs.add_column("datatype", KVSQLite::column_type::TEXT);
+      dirs.add_column("mtime", KVSQLite::column_type::INTEGER);
+      dirs.add_column("scanned", KVSQLite::column_type::INTEGER);
+      fCatalogue.add_table(dirs);
+   }
+   //set access permissions to 664
+   if (new_file) gSystem->Chmod(path.Data(), CHMODE(6, 6, 4));
+   return kTRUE;
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVSQLiteAvailableRunsFile::IsCatalogued()
+{
+   // Returns kTRUE if the repository directory for this datatype has already been
+   // scanned at least once (see Update)
+
+   return fCatalogue.count("Directories", "datatype", fSelection) > 0;
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVSQLiteAvailableRunsFile::FileExists() const
+{
+   // Returns kTRUE if the catalogue exists and contains the runs for this datatype
+
+   if (gSystem->AccessPathName(GetFullPathToCatalogue())) return kFALSE;
+   KVSQLiteAvailableRunsFile* self = const_cast<KVSQLiteAvailableRunsFile*>(this);
+   return self->OpenCatalogue() && self->IsCatalogued();
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVSQLiteAvailableRunsFile::OpenAvailableRunsFile()
+{
+   // Open the catalogue. If the repository has never been scanned for this datatype,
+   // any existing text file of available runs is imported and Update() is called.
+   // Returns kFALSE in case of problems.
+
+   if (!OpenCatalogue()) return kFALSE;
+   if (!IsCatalogued()) {
+      if (KVAvailableRunsFile::FileExists()) ImportTextFile();
+      Update(kTRUE);
+   }
+   return kTRUE;
+}
+
+//____________________________________________________________________________//
+
+TString KVSQLiteAvailableRunsFile::RunSelection(Int_t run, const Char_t* filename) const
+{
+   // SQL selection of entries for given run (and filename, if given) of this datatype
+
+   TString sel;
+   sel.Form("%s AND run=%d", fSelection.Data(), run);
+   if (strcmp(filename, "")) sel += Form(" AND filename=%s", sql_quote(filename).Data());
+   return sel;
+}
+
+//____________________________________________________________________________//
+
+void KVSQLiteAvailableRunsFile::SetRowData(Int_t run, const TString& date, const TString& filename,
+      const TString& kvversion, const TString& username, KVDBTable* runs_table)
+{
+   // Set values of all columns of "AvailableRuns" table before insertion of a new row.
+   // Empty kvversion/username are stored as NULL. The name of the system for the run
+   // is taken from the dataset's database, if the run is known.
+
+   KVSQLite::table& tab = fCatalogue["AvailableRuns"];
+   tab["datatype"] = GetDataType();
+   tab["run"] = run;
+   tab["date"] = date;
+   tab["filename"] = filename;
+   if (kvversion != "") {
+      tab["kvversion"] = kvversion;
+      tab["username"] = username;
+   } else {
+      tab["kvversion"].set_null();
+      tab["username"].set_null();
+   }
+   KVDBRun* dbrun = (runs_table ? (KVDBRun*)runs_table->GetRecord(run) : 0);
+   if (dbrun && dbrun->GetSystem()) tab["system"] = dbrun->GetSystem()->GetName();
+   else tab["system"].set_null();
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVSQLiteAvailableRunsFile::ImportTextFile()
+{
+   // Import all entries of the text file of available runs for this datatype
+   // (see KVAvailableRunsFile) into the catalogue, replacing any existing entries.
+   // Duplicate entries (same run & date) are ignored.
+   // Returns kFALSE if the text file cannot be read.
+
+   if (!OpenCatalogue()) return kFALSE;
+   ifstream runlist;
+   if (!SearchAndOpenKVFile(GetFullPathToAvailableRunsFile(), runlist, "", &runlist_lock)) {
+      Error("ImportTextFile", "Cannot open %s", GetFullPathToAvailableRunsFile());
+      return kFALSE;
+   }
+
+   KVDBTable* runs_table = (fDataSet->GetDataBase() ? fDataSet->GetDataBase()->GetTable("Runs") : 0);
+   set<pair<Int_t, string> > run_dates;
+   Int_t nimported = 0;
+
+   fCatalogue.prepare_data_insertion("AvailableRuns");
+   fCatalogue.delete_data("AvailableRuns", fSelection);
+   KVString line;
+   line.ReadLine(runlist);
+   while (runlist.good()) {
+      // number of fields can vary
+      // nfields = 2: run number, date
+      // nfields = 3: run number, date, filename
+      // nfields = 5: run number, date, filename, KaliVeda version, username
+      // empty fields (e.g. no username) are kept: fields are separated by each '|'
+      TString fields[5];
+      Int_t nfields = 0, start = 0;
+      while (nfields < 5) {
+         Int_t sep = line.Index("|", start);
+         fields[nfields++] = line(start, (sep < 0 ? line.Length() : sep) - start);
+         if (sep < 0) break;
+         start = sep + 1;
+      }
+      if (nfields > 1 && fields[0].IsDigit()) {
+         Int_t run = fields[0].Atoi();
+         if (run_dates.insert(pair<Int_t, string>(run, fields[1].Data())).second) {
+            //backwards compatibility: an old available_runs file will not have the filename field
+            if (nfields < 3 || fields[2] == "") fields[2] = fDataSet->GetBaseFileName(GetDataType(), run);
+            SetRowData(run, fields[1], fields[2], fields[3], fields[4], runs_table);
+            fCatalogue.insert_data_row();
+            ++nimported;
+         }
+      }
+      line.ReadLine(runlist);
+   }
+   fCatalogue.end_data_insertion();
+   runlist.close();
+   runlist_lock.Release();
+
+   Info("ImportTextFile", "Imported %d entries for datatype %s from %s", nimported, GetDataType(),
+        GetFullPathToAvailableRunsFile());
+   return kTRUE;
+}
+
+//____________________________________________________________________________//
+
+void KVSQLiteAvailableRunsFile::Update(Bool_t)
+{
+   // Examine the contents of the repository directory corresponding to this datatype
+   // for parent dataset fDataSet and update the catalogue.
+   //
+   // If the modification time of the directory has not changed since the last update,
+   // nothing is done. Otherwise, for each runfile in the directory which is not already
+   // in the catalogue, we add an entry with the date of last modification of the file;
+   // entries for files which are no longer in the directory are removed. For files which
+   // were already in the catalogue we keep the existing informations (including KV version
+   // & username), but the name of the system of each run is updated from the database.
+
+   if (!OpenCatalogue()) return;
+   KVDataRepository* repository = fDataSet->GetRepository();
+
+   FileStat_t dir_stat;
+   Bool_t have_dir_stat = repository->GetFileInfo(fDataSet, GetDataType(), "", dir_stat);
+   if (have_dir_stat && fCatalogue.select_data("Directories", "mtime,scanned", fSelection)) {
+      Int_t mtime = -1, scanned = 0;
+      while (fCatalogue.get_next_result()) {
+         mtime = fCatalogue["Directories"]["mtime"].get_data<int>();
+         scanned = fCatalogue["Directories"]["scanned"].get_data<int>();
+      }
+      // files added during the same second as the last scan would not change the mtime:
+      // in this case we have to scan again
+      if (mtime == (Int_t)dir_stat.fMtime && mtime < scanned) {
+         Info("Update", "Catalogue of available runs for datatype %s is up to date", GetDataType());
+         return;
+      }
+   }
+
+   // read all existing entries: filename => run, date, KV version, username
+   struct entry_t {
+      Int_t run;
+      TString date, kvversion, username;
+   };
+   map<string, entry_t> previous;
+   if (fCatalogue.select_data("AvailableRuns", "run,date,filename,kvversion,username", fSelection)) {
+      KVSQLite::table& tab = fCatalogue["AvailableRuns"];
+      while (fCatalogue.get_next_result()) {
+         entry_t e;
+         e.run = tab["run"].get_data<int>();
+         e.date = tab["date"].get_data<TString>();
+         if (!tab["kvversion"].is_null()) {
+            e.kvversion = tab["kvversion"].get_data<TString>();
+            e.username = tab["username"].get_data<TString>();
+         }
+         previous[tab["filename"].get_data<TString>().Data()] = e;
+      }
+   }
+
+   cout << endl << "Updating runlist : " << flush;
+   //get directory listing from repository
+   KVUniqueNameList* dir_list =
+      repository->GetDirectoryListing(fDataSet, GetDataType());
+   if (!dir_list)
+      return;
+
+   KVDBTable* runs_table = (fDataSet->GetDataBase() ? fDataSet->GetDataBase()->GetTable("Runs") : 0);
+   // names & run numbers of runfiles in directory which are not in the catalogue
+   vector<TString> new_files;
+   vector<Int_t> new_runs;
+   TIter next(dir_list);
+   KVBase* objs;
+   Int_t nkept = 0, nnew = 0;
+
+   fCatalogue.prepare_data_insertion("AvailableRuns");
+   fCatalogue.delete_data("AvailableRuns", fSelection);
+   while ((objs = (KVBase*) next())) {      // loop over all entries in directory
+
+      Int_t run_num;
+      //is this the correct name of a run in the repository ?
+      if ((run_num = IsRunFileName(objs->GetName()))) {
+         map<string, entry_t>::iterator it = previous.find(objs->GetName());
+         if (it != previous.end()) {
+            // file already in catalogue: keep previous infos
+            SetRowData(it->second.run, it->second.date, objs->GetName(), it->second.kvversion, it->second.username, runs_table);
+            fCatalogue.insert_data_row();
+            ++nkept;
+         } else {
+            new_files.push_back(objs->GetName());
+            new_runs.push_back(run_num);
+         }
+      }
+   }
+
+   //get modification dates of new files (examined in parallel for local repositories)
+   vector<FileStat_t> infos;
+   repository->GetFileInfos(fDataSet, GetDataType(), new_files, infos);
+   //progress bar
+   Int_t ntot = new_files.size();
+   Int_t n5pc = TMath::Max(ntot / 20, 1);
+   for (Int_t i = 0; i < ntot; ++i) {
+      if (runs_table && !runs_table->GetRecord(new_runs[i]))
+         Info("Update", "the current run [%s] is not in database", new_files[i].Data());
+      if (infos[i].fSize > -1) {
+         TDatime modt(infos[i].fMtime);
+         SetRowData(new_runs[i], modt.AsSQLString(), new_files[i], "", "", runs_table);
+         fCatalogue.insert_data_row();
+         ++nnew;
+      } else {
+         Warning("Update", "%s GetFileInfo return kFALSE", new_files[i].Data());
+      }
+      if (!((i + 1) % n5pc))
+         cout << '>' << flush;
+   }
+   fCatalogue.end_data_insertion();
+   cout << " DONE" << endl;
+   delete dir_list;
+
+   // store modification time of directory at time of scan
+   fCatalogue.delete_data("Directories", fSelection);
+   fCatalogue.prepare_data_insertion("Directories");
+   KVSQLite::table& dirs = fCatalogue["Directories"];
+   dirs["datatype"] = GetDataType();
+   dirs["mtime"] = (have_dir_stat ? (Int_t)dir_stat.fMtime : -1);
+   dirs["scanned"] = (Int_t)TDatime().Convert();
+   fCatalogue.insert_data_row();
+   fCatalogue.end_data_insertion();
+
+   Info("Update", "%d new files, %d files removed, for datatype %s", nnew, (Int_t)previous.size() - nkept, GetDataType());
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVSQLiteAvailableRunsFile::CheckAvailable(Int_t run)
+{
+   //Look for a given run number in the catalogue
+   //If run not found, returns kFALSE
+
+   if (!OpenAvailableRunsFile()) {
+      Error("CheckAvailable", "Error opening available runs catalogue");
+      return kFALSE;
+   }
+   return fCatalogue.count("AvailableRuns", "run", RunSelection(run)) > 0;
+}
+
+//____________________________________________________________________________//
+
+Int_t KVSQLiteAvailableRunsFile::Count(Int_t run)
+{
+   //Count the number of files for a given run number in the catalogue
+
+   if (!OpenAvailableRunsFile()) {
+      Error("Count", "Error opening available runs catalogue");
+      return 0;
+   }
+   return fCatalogue.count("AvailableRuns", "run", RunSelection(run));
+}
+
+//____________________________________________________________________________//
+
+void KVSQLiteAvailableRunsFile::GetRunInfos(Int_t run, KVList* dates, KVList* files)
+{
+   //Look for a given run number in the catalogue, and read the modification date/time and filename
+   //of each file for the run.
+   //These informations are stored in the two TList as TObjString objects (these objects belong to the
+   //lists and will be deleted by them).
+
+   if (!OpenAvailableRunsFile()) {
+      Error("GetRunInfos", "Error opening available runs catalogue");
+      return;
+   }
+   //clear lists - delete objects
+   dates->Delete();
+   files->Delete();
+
+   if (fCatalogue.select_data("AvailableRuns", "date,filename", RunSelection(run))) {
+      KVSQLite::table& tab = fCatalogue["AvailableRuns"];
+      while (fCatalogue.get_next_result()) {
+         TString date = tab["date"].get_data<TString>();
+         // skip any spurious entries with the same date
+         if (dates->FindObject(date)) continue;
+         dates->Add(new TObjString(date));
+         files->Add(new TObjString(tab["filename"].get_data<TString>()));
+      }
+   }
+}
+
+//____________________________________________________________________________//
+
+TList* KVSQLiteAvailableRunsFile::GetListOfAvailableSystems(const KVDBSystem* systol)
+{
+   //Create and fill a sorted list of available systems based on the runs in the catalogue.
+   //If systol!=0 then create and fill a list of available runs (KVRunFile objects) for the given system.
+   //USER MUST DELETE THE LIST AFTER USE.
+   //  N.B. in case of list of KVRunFile, the list is the owner of the objects and will
+   //       destroy them when it is destroyed
+   //
+   //For each system in the list we set the number of available runs : this number
+   //can be retrieved with KVDBSystem::GetNumberRuns()
+
+   if (!OpenAvailableRunsFile()) {
+      Error("GetListOfAvailableSystems",
+            "Error opening available runs catalogue");
+      return 0;
+   }
+   if (!fDataSet->GetDataBase()) {
+      Error("GetListOfAvailableSystems", "No database for dataset %s", fDataSet->GetName());
+      return 0;
+   }
+   KVDBTable* runs_table = fDataSet->GetDataBase()->GetTable("Runs");
+
+   TString selection(fSelection);
+   if (systol) selection += Form(" AND system=%s", sql_quote(systol->GetName()).Data());
+
+   TList* sys_list = 0;
+   Int_t good_lines = 0;
+   if (fCatalogue.select_data("AvailableRuns", "run,date,filename,kvversion,username", selection, false, "ORDER BY run")) {
+      KVSQLite::table& tab = fCatalogue["AvailableRuns"];
+      while (fCatalogue.get_next_result()) {
+
+         good_lines++;
+
+         Int_t run = tab["run"].get_data<int>();
+         TDatime datime(tab["date"].get_data<TString>().Data());
+         TString kvversion, username;
+         if (!tab["kvversion"].is_null()) {
+            kvversion = tab["kvversion"].get_data<TString>();
+            username = tab["username"].get_data<TString>();
+         }
+
+         KVDBRun* a_run = (KVDBRun*) runs_table->GetRecord(run);
+         KVDBSystem* sys = (a_run ? a_run->GetSystem() : 0);
+         if (!systol) {
+            //making a systems list
+            if (!sys_list)
+               sys_list = new TList;
+            if (sys) {
+
+               a_run->SetDatime(datime);
+               a_run->SetKVVersion(kvversion);
+               a_run->SetUserName(username);
+
+               if (!sys_list->Contains(sys)) {
+                  //new system
+                  sys_list->Add(sys);
+                  sys->SetNumberRuns(1);   //set run count to 1
+               } else {
+                  //another run for this system
+                  sys->SetNumberRuns(sys->GetNumberRuns() + 1);
+               }
+            }
+         } else if (systol == sys) {
+            //making a runlist (check system in case database changed since last update)
+            if (!sys_list) {
+               sys_list = new TList;
+               sys_list->SetOwner(kTRUE);//will delete objects
+            }
+            sys_list->Add(new KVRunFile(a_run, tab["filename"].get_data<TString>(), datime, kvversion, username));
+         }
+      }
+   }
+
+   //sort list of systems in order of increasing run number
+   if (sys_list && sys_list->GetSize() > 1)
+      sys_list->Sort();
+
+   if (!good_lines && !systol) {
+      Error("GetListOfAvailableSystems",
+            "Available runs catalogue is empty");
+   }
+   return sys_list;
+}
+
+//____________________________________________________________________________//
+
+KVNumberList KVSQLiteAvailableRunsFile::GetRunList(const KVDBSystem* sys)
+{
+   //Returns list of available run numbers for this data type.
+   //If 'sys' gives the address of a valid database reaction system, only runs
+   //corresponding to the system will be included.
+
+   if (!OpenAvailableRunsFile()) {
+      Error("GetRunList", "Cannot open available runs catalogue");
+      return KVNumberList();
+   }
+   if (!sys) return fCatalogue.get_integer_list("AvailableRuns", "run", fSelection);
+
+   KVNumberList runs = fCatalogue.get_integer_list("AvailableRuns", "run",
+                       fSelection + Form(" AND system=%s", sql_quote(sys->GetName()).Data()));
+   // check runs are still associated with system (database may have changed since last update)
+   KVNumberList sysruns;
+   sys->GetRunList(sysruns);
+   runs.Inter(sysruns);
+   return runs;
+}
+
+//____________________________________________________________________________//
+
+void KVSQLiteAvailableRunsFile::Remove(Int_t run, const Char_t* filename)
+{
+   //Remove from the catalogue all entries for this run.
+   //If "filename" is given, we only remove the entry corresponding to both the run number
+   //and the filename.
+
+   if (!OpenAvailableRunsFile()) {
+      Error("Remove", "Error opening available runs catalogue");
+      return;
+   }
+   fCatalogue.delete_data("AvailableRuns", RunSelection(run, filename));
+}
+
+//____________________________________________________________________________//
+
+void KVSQLiteAvailableRunsFile::UpdateInfos(Int_t run, const Char_t* filename, const Char_t* kvversion, const Char_t* username)
+{
+   // Call this method to update informations on the file "filename" corresponding to run,
+   // by adding/replacing the KV version and username read from the file itself (not necessarily
+   // corresponding to current KV version and username)
+
+   if (!OpenAvailableRunsFile()) {
+      Error("UpdateInfos", "Error opening available runs catalogue");
+      return;
+   }
+   fCatalogue["AvailableRuns"]["kvversion"] = kvversion;
+   fCatalogue["AvailableRuns"]["username"] = username;
+   fCatalogue.update("AvailableRuns", "kvversion,username", RunSelection(run, filename));
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVSQLiteAvailableRunsFile::InfosNeedUpdate(Int_t run, const Char_t* filename)
+{
+   // return kTRUE if the given file for this run is lacking some information
+   // e.g. the KV version and username
+   // N.B.: if no file is known for this run, we return kFALSE
+
+   if (!OpenAvailableRunsFile()) {
+      Error("InfosNeedUpdate", "Error opening available runs catalogue");
+      return kFALSE;
+   }
+   Bool_t need_update = kFALSE;
+   if (fCatalogue.select_data("AvailableRuns", "kvversion", RunSelection(run, filename))) {
+      while (fCatalogue.get_next_result()) {
+         if (fCatalogue["AvailableRuns"]["kvversion"].is_null()) need_update = kTRUE;
+      }
+   }
+   return need_update;
+}
+
+//____________________________________________________________________________//
+
+void KVSQLiteAvailableRunsFile::Add(Int_t run, const Char_t* filename)
+{
+   //Add to the catalogue an entry corresponding to this run, assumed to be present in the repository
+   //with the given filename, with the current KaliVeda version and username.
+
+   if (!OpenAvailableRunsFile()) {
+      Error("Add", "Error opening available runs catalogue");
+      return;
+   }
+   FileStat_t fs;
+   //get file modification date
+   if (fDataSet->GetRepository()->GetFileInfo(fDataSet, GetDataType(), filename, fs)) {
+      TDatime modt(fs.fMtime);
+      UserGroup_t* userinfo = gSystem->GetUserInfo();
+      KVDBTable* runs_table = (fDataSet->GetDataBase() ? fDataSet->GetDataBase()->GetTable("Runs") : 0);
+      fCatalogue.prepare_data_insertion("AvailableRuns");
+      SetRowData(run, modt.AsSQLString(), filename, GetKVVersion(), userinfo->fUser, runs_table);
+      fCatalogue.insert_data_row();
+      fCatalogue.end_data_insertion();
+      delete userinfo;
+   }
+}
+
+//____________________________________________________________________________//
+
+KVNumberList KVSQLiteAvailableRunsFile::CheckMultiRunfiles()
+{
+   //Returns a list with all runs which occur more than once in the catalogue.
+
+   if (!OpenAvailableRunsFile()) {
+      Error("CheckMultiRunfiles", "Cannot open available runs catalogue");
+      return KVNumberList();
+   }
+   return fCatalogue.get_integer_list("AvailableRuns", "run", fSelection, "GROUP BY run HAVING count(*)>1");
+}
@@ -0,0 +1,48 @@
+#ifndef __KVSQLITEAVAILABLERUNSFILE_H
+#define __KVSQLITEAVAILABLERUNSFILE_H
+
+#include "KVAvailableRunsFile.h"
+#include "SQLiteDB.h"
+
+class KVDBTable;
+
+class KVSQLiteAvailableRunsFile : public KVAvailableRunsFile {
+
+   KVSQLite::database fCatalogue;//! catalogue of available runs
+   TString fSelection;//! SQL selection of entries for this datatype
+
+   TString GetFullPathToCatalogue() const;
+   Bool_t OpenCatalogue();
+   Bool_t IsCatalogued();
+   TString RunSelection(Int_t run, const Char_t* filename = "") const;
+   void SetRowData(Int_t run, const TString& date, const TString& filename,
+                   const TString& kvversion, const TString& username, KVDBTable* runs_table);
+
+protected:
+   virtual Bool_t OpenAvailableRunsFile();
+
+public:
+   KVSQLiteAvailableRunsFile();
+   KVSQLiteAvailableRunsFile(const Char_t* type, KVDataSet* ds);
+   virtual ~KVSQLiteAvailableRunsFile();
+
+   virtual Bool_t FileExists() const;
+   Bool_t ImportTextFile();
+
+   virtual void Update(Bool_t no_existing_file = kFALSE);
+   virtual Bool_t CheckAvailable(Int_t run);
+   virtual Int_t Count(Int_t run);
+   virtual void GetRunInfos(Int_t run, KVList* dates, KVList* names);
+   virtual TList* GetListOfAvailableSystems(const KVDBSystem* systol = 0);
+   virtual KVNumberList GetRunList(const KVDBSystem* system = 0);
+
+   virtual void Remove(Int_t run, const Char_t* filename = "");
+   virtual void UpdateInfos(Int_t run, const Char_t* filename, const Char_t* kvversion, const Char_t* username);
+   virtual Bool_t InfosNeedUpdate(Int_t run, const Char_t* filename);
+   virtual void Add(Int_t run, const Char_t* filename);
+   virtual KVNumberList CheckMultiRunfiles();
+
+   ClassDef(KVSQLiteAvailableRunsFile, 1) //Indexed catalogue of available runs using an SQLite database
+};
+
+#endif
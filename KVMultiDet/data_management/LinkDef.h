@@ -1,5 +1,6 @@
 #ifdef __CINT__
 #include "RVersion.h"
+#include "KVConfig.h"
 #pragma link off all globals;
 #pragma link off all classes;
 #pragma link off all functions;
@@ -31,4 +32,7 @@
 #pragma link C++ class DMSAvailableRunsFile+;
 #pragma link C++ class KVSimDir+;
 #pragma link C++ class KVSimFile+;
+#ifdef WITH_RSQLITE
+#pragma link C++ class KVSQLiteAvailableRunsFile+;
+#endif
 #endif
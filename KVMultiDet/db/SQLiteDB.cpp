@@ -216,6 +216,33 @@ namespace KVSQLite {
          fTables.insert(std::pair<std::string, KVSQLite::table>(t.name(), t));
    }
 
+   void database::add_index(const TString& table, const TString& columns)
+   {
+      // add an index to the table for the given (comma-separated list of) columns,
+      // if it does not exist already, in order to speed up selections using them
+      //
+      //   e.g. db.add_index("Cars", "Name,Price");
+      //
+      // This is equivalent to
+      //
+      //    CREATE INDEX IF NOT EXISTS "Cars_Name_Price" ON "Cars" ("Name","Price")
+
+      TString index_name(table), column_list;
+      KVString _columns(columns);
+      _columns.Begin(",");
+      while (!_columns.End()) {
+         KVString colnam = _columns.Next(kTRUE);
+         index_name += "_";
+         index_name += colnam;
+         if (column_list != "") column_list += ",";
+         column_list += Form("\"%s\"", colnam.Data());
+      }
+      index_name.ReplaceAll(" ", "_");
+      TString command = Form("CREATE INDEX IF NOT EXISTS \"%s\" ON \"%s\" (%s)",
+                             index_name.Data(), table.Data(), column_list.Data());
+      fDBserv->Exec(command);
+   }
+
    bool database::prepare_data_insertion(const TString& table)
    {
       // Call this method before insert_dat_row() in order to perform bulk data
@@ -362,6 +362,7 @@ namespace KVSQLite {
       void Dump() const;
 
       void add_table(KVSQLite::table&);
+      void add_index(const TString& table, const TString& columns);
       bool has_table(const TString& table)
       {
          // returns true if "table" exists in database
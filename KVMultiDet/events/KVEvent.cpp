@@ -23,6 +23,7 @@ $Id: KVEvent.cpp,v 1.41 2008/12/17 11:23:12 ebonnet Exp $
 #include "KVParticleCondition.h"
 #include "TClass.h"
 #include "KVIntegerList.h"
+#include "TEnv.h"
 
 using namespace std;
 
@@ -62,6 +63,17 @@ memory leaks).
 For this reason we provide the method:
     void MakeEventBranch(TTree*, const TString&, const TString&, void*)
 which should be used whenever it is required to stock KVEvent-derived objects in a TTree.
+
+The parameters associated with each particle (KVParticle::GetParameters) are also
+reset for each new event. By default this means deleting all KVNamedParameter objects
+in the list and creating new ones for the next event. If the same parameters are
+set for the particles of every event (as when filtering simulated data, for example)
+it is much more efficient to keep and reuse these objects: see
+SetRecycleParticleParameters(). The default behaviour is set by variable
+
+KVEvent.RecycleParticleParameters:    no
+
+in your .kvrootrc file.
 */
 /////////////////////////////////////////////////////////////////////////////://
 
@@ -79,6 +91,8 @@ KVEvent::KVEvent(Int_t mult, const char* classname)
    //
 
    fParticles = new TClonesArray(classname, mult);
+   fRecycleParameters = gEnv->GetValue("KVEvent.RecycleParticleParameters", kFALSE);
+   fParameters.SetRecycleParameters(fRecycleParameters);
    CustomStreamer();//force use of KVEvent::Streamer function for reading/writing
 }
 
@@ -151,11 +165,35 @@ KVNucleus* KVEvent::AddParticle()
       Error("AddParticle", "Allocation failure, Mult=%d", mult);
       return 0;
    }
+   if (tmp->GetParameters()->IsRecycleParameters() != fRecycleParameters)
+      tmp->GetParameters()->SetRecycleParameters(fRecycleParameters);
    return tmp;
 }
 
 //________________________________________________________________________________
 
+void KVEvent::SetRecycleParticleParameters(Bool_t on)
+{
+   // If on=kTRUE, the KVNamedParameter objects in the lists of parameters of
+   // each particle (and of the event) are not deleted when the event is cleared,
+   // but kept in order to be reused for the parameters of the next event.
+   // The number of objects kept for each particle is at most the number of
+   // parameters it had when it was last cleared.
+   //
+   // If on=kFALSE (default, unless KVEvent.RecycleParticleParameters is set in
+   // .kvrootrc), parameter objects are deleted when the event is cleared, and
+   // any objects kept until now are deleted.
+
+   fRecycleParameters = on;
+   fParameters.SetRecycleParameters(on);
+   for (Int_t i = 0; i < fParticles->GetEntriesFast(); ++i) {
+      KVNucleus* nuc = (KVNucleus*)fParticles->UncheckedAt(i);
+      if (nuc) nuc->GetParameters()->SetRecycleParameters(on);
+   }
+}
+
+//________________________________________________________________________________
+
 void KVEvent::Clear(Option_t*)
 {
    //Reset the event to zero ready for new event.
@@ -65,6 +65,7 @@ public:
       Type    fType;//iterator type
       mutable Bool_t  fIterating;//=kTRUE when iteration in progress
       TString fGroup;//groupname for group iterations
+      Int_t   fGroupIndex;//index of group for group iterations (see KVParticle::GetGroupIndex)
       Bool_t AcceptableIteration()
       {
          // Returns kTRUE if the current particle in the iteration
@@ -75,7 +76,8 @@ public:
                return current()->IsOK();
                break;
             case Group:
-               return current()->BelongsToGroup(fGroup);
+               // if the group name is known, test bit of group, otherwise use name
+               return (fGroupIndex > -1 ? current()->BelongsToGroup(fGroupIndex) : current()->BelongsToGroup(fGroup));
                break;
             case All:
             default:
@@ -98,13 +100,15 @@ public:
            fType(Null),
 #endif
            fIterating(kFALSE),
-           fGroup()
+           fGroup(),
+           fGroupIndex(-1)
       {}
       Iterator(const Iterator& i)
          : fIter(i.fIter),
            fType(i.fType),
            fIterating(i.fIterating),
-           fGroup(i.fGroup)
+           fGroup(i.fGroup),
+           fGroupIndex(i.fGroupIndex)
       {}
 
 #ifdef WITH_CPP11
@@ -112,7 +116,8 @@ public:
 #else
       Iterator(const KVEvent* e, Type t = All, TString grp = "")
 #endif
-         : fIter(e->fParticles), fType(t), fIterating(kTRUE), fGroup(grp)
+         : fIter(e->fParticles), fType(t), fIterating(kTRUE), fGroup(grp),
+           fGroupIndex(KVParticle::FindGroupIndex(grp))
       {
          // Construct an iterator object to read in sequence the particles in event *e.
          // By default, opt="" and all particles are included in the iteration.
@@ -133,7 +138,8 @@ public:
 #else
       Iterator(const KVEvent& e, Type t = All, TString grp = "")
 #endif
-         : fIter(e.fParticles), fType(t), fIterating(kTRUE), fGroup(grp)
+         : fIter(e.fParticles), fType(t), fIterating(kTRUE), fGroup(grp),
+           fGroupIndex(KVParticle::FindGroupIndex(grp))
       {
          // Construct an iterator object to read in sequence the particles in event *e.
          // By default, opt="" and all particles are included in the iteration.
@@ -189,6 +195,7 @@ public:
             fIter = rhs.fIter;
             fType = rhs.fType;
             fGroup = rhs.fGroup;
+            fGroupIndex = rhs.fGroupIndex;
             fIterating = rhs.fIterating;
          }
          return *this;
@@ -216,6 +223,7 @@ public:
             fType = t;
             fGroup = grp;
          }
+         fGroupIndex = KVParticle::FindGroupIndex(fGroup);
          fIter.Begin();
          fIterating = kTRUE;
          while ((current() != nullptr) && !AcceptableIteration()) ++fIter;
@@ -235,6 +243,7 @@ public:
    };
 protected:
    Iterator fIter;//! internal iterator used by GetNextParticle()
+   Bool_t fRecycleParameters;//! kTRUE if parameter objects of particles are recycled (see SetRecycleParticleParameters)
 
 public:
    KVNameValueList* GetParameters() const
@@ -252,6 +261,11 @@ public:
 #endif
 
    KVNucleus* AddParticle();
+   void SetRecycleParticleParameters(Bool_t on = kTRUE);
+   Bool_t IsRecycleParticleParameters() const
+   {
+      return fRecycleParameters;
+   }
    KVNucleus* GetParticle(Int_t npart) const;
    virtual Int_t GetMult(Option_t* opt = "");
    Int_t GetMultiplicity(Int_t Z, Int_t A = 0, Option_t* opt = "");
@@ -24,7 +24,38 @@ KVDetectionSimulator::KVDetectionSimulator(KVMultiDetArray* a, Double_t e_cut_of
    // The detector array is put into simulation mode, and the minimum cut-off energy
    // for propagation of particles is set
    a->SetSimMode(kTRUE);
-   static_cast<KVRangeTableGeoNavigator*>(a->GetNavigator())->SetCutOffKEForPropagation(e_cut_off);
+   SetMinKECutOff(e_cut_off);
+}
+
+KVRangeTableGeoNavigator* KVDetectionSimulator::GetRangeTableNavigator(const Char_t* method) const
+{
+   // Returns navigator of array if it is a KVRangeTableGeoNavigator (or derived class).
+   // If not (the navigator can be replaced by the user), returns nullptr and,
+   // if method is given, prints an error.
+
+   KVRangeTableGeoNavigator* nav = dynamic_cast<KVRangeTableGeoNavigator*>(fArray->GetNavigator());
+   if (!nav && method) {
+      Error(method, "Navigator of array %s is not a KVRangeTableGeoNavigator", fArray->GetName());
+   }
+   return nav;
+}
+
+Double_t KVDetectionSimulator::GetMinKECutOff() const
+{
+   // Minimum kinetic energy for propagation of particles through the array.
+   // Returns -1 if the navigator of the array is not a KVRangeTableGeoNavigator.
+
+   KVRangeTableGeoNavigator* nav = GetRangeTableNavigator("GetMinKECutOff");
+   return nav ? nav->GetCutOffKEForPropagation() : -1.;
+}
+
+void KVDetectionSimulator::SetMinKECutOff(Double_t cutoff)
+{
+   // Set minimum kinetic energy for propagation of particles through the array.
+   // Only possible if the navigator of the array is a KVRangeTableGeoNavigator.
+
+   KVRangeTableGeoNavigator* nav = GetRangeTableNavigator("SetMinKECutOff");
+   if (nav) nav->SetCutOffKEForPropagation(cutoff);
 }
 
 void KVDetectionSimulator::DetectEvent(KVEvent* event, const Char_t* detection_frame)
@@ -153,17 +184,47 @@ KVNameValueList KVDetectionSimulator::DetectParticle(KVNucleus* part)
    // Returns a list containing the name and energy loss of each
    // detector hit in array (list is empty if none i.e. particle
    // in beam pipe or dead zone of the multidetector)
+   //
+   // If the navigator of the array is not a KVRangeTableGeoNavigator (user-defined
+   // navigator), the energy losses are read from the named parameters "DE:..." which
+   // the navigator must set for the particle.
 
+   KVRangeTableGeoNavigator* nav = GetRangeTableNavigator(nullptr);
    fArray->GetNavigator()->PropagateParticle(part);
 
-   // particle missed all detectors
-   if (part->GetParameters()->IsEmpty()) return KVNameValueList();
-
    // list of energy losses in active layers of detectors
    KVNameValueList NVL;
 
-   // find detectors in array hit by particle
+   // find detectors in array hit by particle, using track record of navigator
    KVDetector* last_detector = nullptr;
+   if (!nav) {
+      NVL = GetEnergyLossesFromParameters(part, last_detector);
+   } else if (part->GetZ()) {
+      for (Int_t i = 0; i < nav->GetNumberOfTrackSteps(); ++i) {
+         const KVRangeTableGeoNavigator::TrackStep& step = nav->GetTrackStep(i);
+         if (step.IsActiveLayer()) {
+            // energy loss in active layer of detector
+            last_detector = step.GetDetector();
+            NVL.SetValue(last_detector->GetName(), step.GetDeltaE());
+         }
+      }
+   }
+
+   // add hit group to list if not already in it
+   if (last_detector) fHitGroups.AddGroup(last_detector->GetGroup());
+
+   return NVL;
+}
+
+KVNameValueList KVDetectionSimulator::GetEnergyLossesFromParameters(KVNucleus* part, KVDetector*& last_detector)
+{
+   // Used by DetectParticle when the navigator of the array is not a KVRangeTableGeoNavigator:
+   // find detectors hit by particle from its named parameters "DE:[detector name]" or
+   // "DE:[detector name]/ACTIVE_..." set by the navigator during propagation.
+   // last_detector is set to the last detector hit.
+
+   KVNameValueList NVL;
+   last_detector = nullptr;
    TIter next(part->GetParameters()->GetList());
    KVNamedParameter* param;
    while ((param = (KVNamedParameter*)next())) {
@@ -176,22 +237,18 @@ KVNameValueList KVDetectionSimulator::DetectParticle(KVNucleus* part)
          KVString det_name = pn3.Next();
          if (pn3.End() || pn3.Next().BeginsWith("ACTIVE")) {
             // energy loss in active layer of detector
-            KVDetector* curDet = last_detector = fArray->GetDetector(det_name);
+            KVDetector* curDet = fArray->GetDetector(det_name);
             if (!curDet) {
                Error("DetectParticle",
                      "Cannot find detector %s corresponding to particle energy loss %s",
                      det_name.Data(), pname.Data());
             } else {
-               Double_t de = param->GetDouble();
-               NVL.SetValue(curDet->GetName(), de);
+               last_detector = curDet;
+               NVL.SetValue(curDet->GetName(), param->GetDouble());
             }
          }
       }
    }
-
-   // add hit group to list if not already in it
-   if (last_detector) fHitGroups.AddGroup(last_detector->GetGroup());
-
    return NVL;
 }
 
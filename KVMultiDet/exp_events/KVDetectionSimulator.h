@@ -18,6 +18,9 @@ private:
    KVDetectorEvent fHitGroups;//        used to reset hit detectors in between events
    Bool_t fCalcTargELoss;//             whether to include energy loss in target, if defined
 
+   KVRangeTableGeoNavigator* GetRangeTableNavigator(const Char_t* method) const;
+   KVNameValueList GetEnergyLossesFromParameters(KVNucleus*, KVDetector*& last_detector);
+
 public:
    KVDetectionSimulator() : KVBase(), fArray(nullptr), fCalcTargELoss(kTRUE) {}
    KVDetectionSimulator(KVMultiDetArray* a, Double_t cut_off = 1.e-3);
@@ -43,14 +46,8 @@ public:
    {
       return fCalcTargELoss;
    }
-   Double_t GetMinKECutOff() const
-   {
-      return static_cast<KVRangeTableGeoNavigator*>(GetArray()->GetNavigator())->GetCutOffKEForPropagation();
-   }
-   void SetMinKECutOff(Double_t cutoff)
-   {
-      static_cast<KVRangeTableGeoNavigator*>(GetArray()->GetNavigator())->SetCutOffKEForPropagation(cutoff);
-   }
+   Double_t GetMinKECutOff() const;
+   void SetMinKECutOff(Double_t cutoff);
 
    void DetectEvent(KVEvent* event, const Char_t* detection_frame = "");
    KVNameValueList DetectParticle(KVNucleus*);
@@ -5,9 +5,98 @@
 #include "KVDetectorEvent.h"
 #include "KVGroupReconstructor.h"
 #include "KVTarget.h"
+#include "KVDataSet.h"
+#include "TEnv.h"
+#include "TMath.h"
+#include "TROOT.h"
+#ifdef WITH_CPP11
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#endif
 
 ClassImp(KVEventReconstructor)
 
+#ifdef WITH_CPP11
+class KVGroupReconstructorPool {
+   // Persistent pool of worker threads used by KVEventReconstructor::ReconstructEvent
+   // to reconstruct the particles of different groups in parallel.
+   // The threads are started once (see KVEventReconstructor::SetNumberOfThreads) and
+   // wait between events.
+public:
+   std::vector<std::thread> workers;
+   std::mutex mtx;
+   std::condition_variable start, done;
+   TClonesArray* groups;// group reconstructors for current event
+   Int_t ngroups;// number of groups in current event
+   std::atomic<int> next_group;// next group to treat
+   Int_t running;// number of workers still treating groups of current event
+   ULong64_t job;// incremented for each new event
+   Bool_t stop;// set to stop worker threads
+
+   KVGroupReconstructorPool(Int_t nworkers)
+      : groups(nullptr), ngroups(0), next_group(0), running(0), job(0), stop(kFALSE)
+   {
+      for (int t = 0; t < nworkers; ++t) workers.emplace_back(&KVGroupReconstructorPool::work, this);
+   }
+   ~KVGroupReconstructorPool()
+   {
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         stop = kTRUE;
+      }
+      start.notify_all();
+      for (auto& w : workers) w.join();
+   }
+   void reconstruct()
+   {
+      // each thread takes the next untreated group until all are done
+      int i;
+      while ((i = next_group++) < ngroups)
+         ((KVGroupReconstructor*)groups->UncheckedAt(i))->Reconstruct();
+   }
+   void work()
+   {
+      ULong64_t my_job = 0;
+      while (1) {
+         {
+            std::unique_lock<std::mutex> lock(mtx);
+            start.wait(lock, [&]() {
+               return stop || job != my_job;
+            });
+            if (stop) return;
+            my_job = job;
+         }
+         reconstruct();
+         std::lock_guard<std::mutex> lock(mtx);
+         if (--running == 0) done.notify_one();
+      }
+   }
+   void run(TClonesArray* g, Int_t n)
+   {
+      // treat n groups with the workers & the calling thread; returns when all are done
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         groups = g;
+         ngroups = n;
+         next_group = 0;
+         running = workers.size();
+         ++job;
+      }
+      start.notify_all();
+      reconstruct();
+      std::unique_lock<std::mutex> lock(mtx);
+      done.wait(lock, [&]() {
+         return running == 0;
+      });
+   }
+};
+#else
+class KVGroupReconstructorPool {};
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 // BEGIN_HTML <!--
 /* -->
@@ -27,19 +116,44 @@ ClassImp(KVEventReconstructor)
 //    using a KVGroupReconstructor-derived object (uses plugins)
 // 3. Merge together the different event fragments into the output reconstructed
 //    event object
+//
+// As detector groups are independent by construction, the reconstruction of
+// particles in each group (step 2) can be performed in parallel by several
+// threads: see SetNumberOfThreads(). The default number of threads is
+// given by the (dataset-dependent) configuration variable
+//
+//    [dataset].KVEventReconstructor.NumberOfThreads:   1
+//
+// Identification & calibration of particles, and merging of the event fragments
+// (step 3), are always performed by the calling thread: they use objects shared
+// between groups (target, range tables, random number generator, ...).
+//
+// WARNING: multi-threaded reconstruction is EXPERIMENTAL. It has not been validated
+// (nor its speed measured) with the group reconstructors of the different
+// experimental datasets, whose Reconstruct() methods must only modify the detectors
+// & particles of their own group. Keep the default value (1) unless you have checked
+// that results are identical to single-threaded reconstruction.
 ////////////////////////////////////////////////////////////////////////////////
 
 KVEventReconstructor::KVEventReconstructor(KVMultiDetArray* a, KVReconstructedEvent* e)
    : KVBase("KVEventReconstructor", Form("Reconstruction of events in array %s", a->GetName())),
-     fArray(a), fEvent(e), fGroupReconstructor(nullptr)
+     fArray(a), fEvent(e), fGroupReconstructor(nullptr), fNGrpRecon(0), fNThreads(1), fPool(nullptr)
 {
    // Default constructor
+   //
+   // The number of threads used to process groups is read from the configuration
+   // variable [dataset].KVEventReconstructor.NumberOfThreads (default: 1)
+
+   Int_t nthreads = (gDataSet ? (Int_t)gDataSet->GetDataSetEnv("KVEventReconstructor.NumberOfThreads", 1.0)
+                     : gEnv->GetValue("KVEventReconstructor.NumberOfThreads", 1));
+   SetNumberOfThreads(nthreads);
 }
 
 KVEventReconstructor::~KVEventReconstructor()
 {
    // Destructor
 
+   SafeDelete(fPool);
 }
 
 //________________________________________________________________
@@ -74,6 +188,37 @@ void KVEventReconstructor::SetGroupReconstructorPlugin(const char* p)
    }
 }
 
+void KVEventReconstructor::SetNumberOfThreads(Int_t n)
+{
+   // Set number of threads used to reconstruct particles in the different
+   // groups of the array.
+   //
+   //  n = 1 : (default) groups are treated one after the other
+   //  n > 1 : groups are distributed between n threads (the calling thread is one of them)
+   //  n = 0 : use as many threads as there are cores on the machine
+   //
+   // The n-1 additional threads are started here and wait between events.
+   // Parallel processing requires compilation with C++11; otherwise
+   // n is always set to 1.
+   //
+   // N.B. n > 1 is experimental: see class description.
+
+   SafeDelete(fPool);
+#ifdef WITH_CPP11
+   if (n == 0) n = TMath::Max(1, (Int_t)std::thread::hardware_concurrency());
+   fNThreads = TMath::Max(1, n);
+   if (fNThreads > 1) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+      ROOT::EnableThreadSafety();
+#endif
+      fPool = new KVGroupReconstructorPool(fNThreads - 1);
+   }
+#else
+   if (n != 1) Warning("SetNumberOfThreads", "Parallel processing of groups requires C++11: using 1 thread");
+   fNThreads = 1;
+#endif
+}
+
 void KVEventReconstructor::ReconstructEvent(TSeqCollection* fired)
 {
    // Reconstruct current event based on state of detectors in array
@@ -93,10 +238,20 @@ void KVEventReconstructor::ReconstructEvent(TSeqCollection* fired)
 
       KVGroupReconstructor* Grec = (KVGroupReconstructor*)fGroupReconstructor->ConstructedAt(fNGrpRecon++);
       Grec->SetGroup(g);
-      Grec->Reconstruct();
 
    }
 
+#ifdef WITH_CPP11
+   if (fPool && fNGrpRecon > 1) {
+      fPool->run(fGroupReconstructor, fNGrpRecon);
+      return;
+   }
+#endif
+   for (int i = 0; i < fNGrpRecon; i++) {
+
+      ((KVGroupReconstructor*)(*fGroupReconstructor)[i])->Reconstruct();
+
+   }
 }
 
 void KVEventReconstructor::IdentifyEvent()
@@ -8,12 +8,16 @@
 #include "KVMultiDetArray.h"
 #include "KVReconstructedEvent.h"
 
+class KVGroupReconstructorPool;
+
 class KVEventReconstructor : public KVBase {
 
    KVMultiDetArray*       fArray;//!       Array for which events are to be reconstructed
    KVReconstructedEvent*  fEvent;//!       The reconstructed event
    TClonesArray*   fGroupReconstructor;//! array of group reconstructors
    Int_t           fNGrpRecon;//!          number of group reconstructors for current event
+   Int_t           fNThreads;//!           number of threads used to reconstruct groups in parallel
+   KVGroupReconstructorPool* fPool;//!     worker threads used when fNThreads>1
 
 protected:
    KVMultiDetArray* GetArray()
@@ -29,6 +33,13 @@ public:
 
    void SetGroupReconstructorPlugin(const char* p);
 
+   void SetNumberOfThreads(Int_t n);
+   Int_t GetNumberOfThreads() const
+   {
+      // Number of threads used to reconstruct groups in parallel (1 = serial processing)
+      return fNThreads;
+   }
+
    void ReconstructEvent(TSeqCollection* = nullptr);
    void IdentifyEvent();
    void CalibrateEvent();
@@ -11,9 +11,86 @@
 #include "TPluginManager.h"
 #include "RVersion.h"
 #include <TInterpreter.h>
+#ifdef WITH_CPP11
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#endif
 
 ClassImp(KVGANILDataReader)
 
+#ifdef WITH_CPP11
+class KVGANILDataPipeline {
+   // Ring of events decoded by a separate reader thread, used by KVGANILDataReader::EnablePipeline
+public:
+   struct event {
+      std::vector<Int_t> index;// indices of fired parameters
+      std::vector<UShort_t> value;// values of fired parameters
+      Bool_t ok;// result of GTGanilData::Next()
+   };
+   std::vector<event> ring;
+   Int_t head;// next event to analyse
+   Int_t tail;// next event to decode
+   Int_t count;// number of decoded events in ring
+   Bool_t stop;// set to stop reader thread
+   Bool_t finished;// set by reader thread after last event
+   std::mutex mtx;
+   std::condition_variable not_empty, not_full;
+   std::thread reader;
+
+   // statistics
+   Long64_t nevents;// number of events taken from ring
+   Long64_t sum_depth;// sum of number of decoded events in ring when an event is taken
+   Long64_t analysis_stalls;// number of times analysis waited for reader thread
+   Long64_t reader_stalls;// number of times reader thread waited for analysis
+   Double_t analysis_wait;// total time (s) analysis waited for reader thread
+   Double_t reader_wait;// total time (s) reader thread waited for analysis
+
+   KVGANILDataPipeline(Int_t depth)
+      : ring(depth), head(0), tail(0), count(0), stop(kFALSE), finished(kFALSE), nevents(0), sum_depth(0),
+        analysis_stalls(0), reader_stalls(0), analysis_wait(0), reader_wait(0)
+   {}
+
+   void read(GTGanilData* data)
+   {
+      // reader thread: decode events until end of file or stop
+      Bool_t ok = kTRUE;
+      while (ok) {
+         {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (count == (Int_t)ring.size() && !stop) {
+               ++reader_stalls;
+               auto start = std::chrono::steady_clock::now();
+               not_full.wait(lock, [&]() {
+                  return count < (Int_t)ring.size() || stop;
+               });
+               reader_wait += std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
+            }
+            if (stop) return;
+         }
+         // slot ring[tail] is not used by analysis until count is incremented
+         event& e = ring[tail];
+         ok = data->Next();
+         Int_t nfired = data->GetNbFiredParameters();
+         const Int_t* fired = data->GetFiredParameterIndices();
+         const UShort_t* values = data->GetDataArray();
+         e.index.assign(fired, fired + nfired);
+         e.value.resize(nfired);
+         for (Int_t i = 0; i < nfired; ++i) e.value[i] = values[fired[i]];
+         e.ok = ok;
+         std::lock_guard<std::mutex> lock(mtx);
+         tail = (tail + 1) % ring.size();
+         ++count;
+         finished = !ok;
+         not_empty.notify_one();
+      }
+   }
+};
+#else
+class KVGANILDataPipeline {};
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 // BEGIN_HTML <!--
 /* -->
@@ -55,6 +132,12 @@ For possible values, see <a href="GTGanilData.html#GTGanilData:SetScalerBuffersM
 You can also add a second TTree to the user tree generated above containing the values
 of all scaler buffers written in the data file. The TTree will be called 'Scalers'.
 You need to add "SCALERS" to the option given to method <a href="#KVGANILDataReader:SetUserTree">SetUserTree()</a> (see below).
+<h4>Pipelined decoding</h4>
+After opening the file, <a href="#KVGANILDataReader:EnablePipeline">EnablePipeline()</a> can be called in order to
+read &amp; decode buffers (byte swapping, event unravelling...) in a separate thread, which fills a ring of
+pre-decoded events (indices &amp; values of fired parameters) while the current event is analysed.
+<a href="#KVGANILDataReader:PrintPipelineStatistics">PrintPipelineStatistics()</a> shows how often the
+analysis had to wait for the reader thread (or vice versa).
 <!-- */
 // --> END_HTML
 ////////////////////////////////////////////////////////////////////////////////
@@ -82,6 +165,7 @@ KVGANILDataReader::KVGANILDataReader(const Char_t* file)
 KVGANILDataReader::~KVGANILDataReader()
 {
    // Destructor
+   StopPipeline();
    if (fGanilData) {
       delete fGanilData;
       fGanilData = 0;
@@ -107,6 +191,7 @@ void KVGANILDataReader::init()
    fGanilData = 0;
    fUserTree = 0;
    fFired = new KVHashList;
+   fPipeline = 0;
    ParVal = 0;
    ParNum = 0;
    make_arrays = make_leaves = kFALSE;
@@ -265,6 +350,7 @@ void KVGANILDataReader::OpenFile(const Char_t* file)
    //then a list of KVACQParam objects will be generated and connected ready for reading the data.
    //This list can be obtained with method GetRawDataParameters().
 
+   StopPipeline();
    if (fGanilData) {
       delete fGanilData;
       fGanilData = 0;
@@ -333,6 +419,10 @@ void KVGANILDataReader::ConnectRawDataParameters()
    //To access the full list of data parameters in the file after this method has been
    //called (i.e. after the file is opened), use GetRawDataParameters().
 
+   //The parameters are also stored in a vector indexed by their number in the file, which is used
+   //to fill the list of fired parameters in each event (see FillFiredParameterList()).
+
+   fParamIndex.clear();
    TIter next(fGanilData->GetListOfDataParameters());
    KVACQParam* par;
    GTDataPar* daq_par;
@@ -342,6 +432,8 @@ void KVGANILDataReader::ConnectRawDataParameters()
       par->SetNumber(daq_par->Index());
       par->SetNbBits(daq_par->Bits());
       fParameters->Add(par);
+      if (daq_par->Index() >= (Int_t)fParamIndex.size()) fParamIndex.resize(daq_par->Index() + 1, 0);
+      if (!fParamIndex[daq_par->Index()]) fParamIndex[daq_par->Index()] = par;
    }
 }
 
@@ -379,23 +471,164 @@ Bool_t KVGANILDataReader::GetNextEvent()
    // If SetUserTree(TTree*) has been called, the TTree is filled with the values of all
    // parameters in this event.
 
+   if (fPipeline) return GetNextPipelinedEvent();
+
    Bool_t ok = fGanilData->Next();
-   FillFiredParameterList();
-   if (fUserTree) {
-      if (make_arrays) {
-         NbParFired = fFired->GetEntries();
-         TIter next(fFired);
-         KVACQParam* par;
-         int i = 0;
-         while ((par = (KVACQParam*)next())) {
-            ParVal[i] = par->GetCoderData();
-            ParNum[i] = par->GetNumber();
-            i++;
-         }
+   FillFiredParameterList(fGanilData->GetFiredParameterIndices(), fGanilData->GetNbFiredParameters());
+   if (fUserTree) fUserTree->Fill();
+   return ok;
+}
+
+//___________________________________________________________________________
+
+Bool_t KVGANILDataReader::EnablePipeline(Int_t depth)
+{
+   // Read & decode events in a separate thread, ahead of their analysis.
+   // Must be called after opening the file, before reading the first event.
+   //
+   // The reader thread calls GTGanilData::Next() and copies the indices & values of all
+   // fired parameters of each event in a ring of 'depth' pre-decoded events.
+   // GetNextEvent() then takes the next event from the ring and sets the values of
+   // the parameters (KVACQParam), which are connected to a separate array which is
+   // only modified by the analysis thread.
+   //
+   // Returns kFALSE (pipeline not used) if:
+   //   - the code is not compiled with C++11;
+   //   - scaler buffers are not skipped/dumped (they have to be handled by the
+   //     analysis thread at the time they are read: see SetScalerBuffersManagement)
+   //   - SetUserTree was called with option "leaves" (the branches are connected
+   //     to the array of values modified by the reader thread)
+   //   - the GTGanilData object fills branches of a user tree (e.g. INDRA-VAMOS data)
+
+#ifdef WITH_CPP11
+   if (fPipeline) return kTRUE;
+   if (!fGanilData || !fGanilData->IsOpen() || depth < 1) return kFALSE;
+   GTGanilData::ScalerWhat_t sc = fGanilData->GetScalerBuffersManagement();
+   if (sc != GTGanilData::kSkipScaler && sc != GTGanilData::kDumpScaler) {
+      Warning("EnablePipeline", "Pipelined decoding is not possible when scaler buffers are reported/written: not used");
+      return kFALSE;
+   }
+   if (fUserTree && make_leaves) {
+      Warning("EnablePipeline", "Pipelined decoding is not possible with a user tree with option \"leaves\": not used");
+      return kFALSE;
+   }
+   if (fGanilData->HasUserTree()) {
+      Warning("EnablePipeline", "Pipelined decoding is not possible when raw data are also written in a user tree by the GANIL tape interface: not used");
+      return kFALSE;
+   }
+
+   // connect all parameters to our own array of values
+   fPipelineData.assign(fGanilData->GetDataArraySize() + 1, (UShort_t) - 1);
+   TIter next(fParameters);
+   KVACQParam* par;
+   while ((par = (KVACQParam*)next())) {
+      if (par->GetNumber() < fPipelineData.size())
+         *(par->ConnectData()) = &fPipelineData[par->GetNumber()];
+   }
+   fPipelineFired.clear();
+
+   fPipeline = new KVGANILDataPipeline(depth);
+   fPipeline->reader = std::thread(&KVGANILDataPipeline::read, fPipeline, fGanilData);
+   return kTRUE;
+#else
+   Warning("EnablePipeline", "Pipelined decoding requires C++11: not used");
+   return kFALSE;
+#endif
+}
+
+//___________________________________________________________________________
+
+void KVGANILDataReader::StopPipeline()
+{
+   // Stop reader thread used for pipelined decoding (see EnablePipeline).
+   // Parameters are connected again to the data array of GTGanilData, and the
+   // file can be read normally from the last event decoded by the reader thread.
+
+#ifdef WITH_CPP11
+   if (!fPipeline) return;
+   {
+      std::lock_guard<std::mutex> lock(fPipeline->mtx);
+      fPipeline->stop = kTRUE;
+      fPipeline->not_full.notify_one();
+   }
+   fPipeline->reader.join();
+   delete fPipeline;
+   fPipeline = 0;
+   TIter next(fParameters);
+   KVACQParam* par;
+   while ((par = (KVACQParam*)next())) fGanilData->Connect(par->GetName(), par->ConnectData());
+#endif
+}
+
+//___________________________________________________________________________
+
+Bool_t KVGANILDataReader::GetNextPipelinedEvent()
+{
+   // GetNextEvent() when events are decoded by a separate thread (see EnablePipeline).
+   // Takes the next event from the ring of pre-decoded events, waiting for the
+   // reader thread if necessary.
+
+#ifdef WITH_CPP11
+   // reset parameters of previous event
+   for (std::vector<Int_t>::iterator it = fPipelineFired.begin(); it != fPipelineFired.end(); ++it)
+      fPipelineData[*it] = (UShort_t) - 1;
+
+   KVGANILDataPipeline& p = *fPipeline;
+   {
+      std::unique_lock<std::mutex> lock(p.mtx);
+      if (!p.count) {
+         if (p.finished) return kFALSE;
+         ++p.analysis_stalls;
+         auto start = std::chrono::steady_clock::now();
+         p.not_empty.wait(lock, [&]() {
+            return p.count > 0;
+         });
+         p.analysis_wait += std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
       }
-      fUserTree->Fill();
+      ++p.nevents;
+      p.sum_depth += p.count;
+   }
+   // slot ring[head] is not modified by reader thread until count is decremented
+   KVGANILDataPipeline::event& e = p.ring[p.head];
+   fPipelineFired.swap(e.index);
+   for (UInt_t i = 0; i < fPipelineFired.size(); ++i) fPipelineData[fPipelineFired[i]] = e.value[i];
+   Bool_t ok = e.ok;
+   {
+      std::lock_guard<std::mutex> lock(p.mtx);
+      p.head = (p.head + 1) % p.ring.size();
+      --p.count;
+      p.not_full.notify_one();
    }
+
+   FillFiredParameterList(fPipelineFired.empty() ? 0 : &fPipelineFired[0], fPipelineFired.size());
+   if (fUserTree) fUserTree->Fill();
    return ok;
+#else
+   return kFALSE;
+#endif
+}
+
+//___________________________________________________________________________
+
+void KVGANILDataReader::PrintPipelineStatistics() const
+{
+   // Print statistics of pipelined decoding (see EnablePipeline):
+   //   - mean number of decoded events waiting in the ring when each event is analysed;
+   //   - number of times & total time the analysis had to wait for the reader thread
+   //     (reading/decoding is the bottleneck);
+   //   - number of times & total time the reader thread had to wait because the ring
+   //     was full (analysis is the bottleneck).
+
+#ifdef WITH_CPP11
+   if (!fPipeline) return;
+   KVGANILDataPipeline& p = *fPipeline;
+   std::lock_guard<std::mutex> lock(p.mtx);
+   Info("PrintPipelineStatistics", "%lld events read through ring of %d pre-decoded events",
+        p.nevents, (Int_t)p.ring.size());
+   Info("PrintPipelineStatistics", "mean queue depth = %.2f", p.nevents ? (Double_t)p.sum_depth / p.nevents : 0.);
+   Info("PrintPipelineStatistics", "analysis waited for reader thread %lld times (%.3f s)", p.analysis_stalls, p.analysis_wait);
+   Info("PrintPipelineStatistics", "reader thread waited for analysis %lld times (%.3f s)", p.reader_stalls, p.reader_wait);
+#endif
 }
 
 //___________________________________________________________________________
@@ -436,13 +669,29 @@ KVGANILDataReader* KVGANILDataReader::Open(const Char_t* filename, Option_t*)
 
 //____________________________________________________________________________
 
-void KVGANILDataReader::FillFiredParameterList()
+void KVGANILDataReader::FillFiredParameterList(const Int_t* fired, Int_t nfired)
 {
-   // clears and then fills list fFired with all fired acquisition parameters in event
+   // clears and then fills list fFired with all fired acquisition parameters in event.
+   // if SetUserTree(TTree*) has been called with option "arrays", the arrays
+   // NbParFired, ParNum and ParVal are filled at the same time.
+   //
+   // Only the parameters present in the event, whose indices are given by
+   // GTGanilData::GetFiredParameterIndices() (or by the reader thread in pipelined
+   // mode), are considered: the full list of parameters is not scanned.
+   // The parameters are in the order in which they appear in the event.
+
    fFired->Clear();
-   TIter next(fParameters);
-   KVACQParam* par;
-   while ((par = (KVACQParam*)next())) if (par->Fired()) fFired->Add(par);
+   NbParFired = 0;
+   for (Int_t i = 0; i < nfired; i++) {
+      KVACQParam* par = (fired[i] < (Int_t)fParamIndex.size() ? fParamIndex[fired[i]] : 0);
+      if (!par || !par->Fired()) continue;
+      fFired->Add(par);
+      if (make_arrays) {
+         ParVal[NbParFired] = par->GetCoderData();
+         ParNum[NbParFired] = par->GetNumber();
+         NbParFired++;
+      }
+   }
 }
 
 //____________________________________________________________________________
@@ -9,7 +9,9 @@
 #include "KVACQParam.h"
 #include "KVHashList.h"
 #include "TTree.h"
+#include <vector>
 class GTGanilData;
+class KVGANILDataPipeline;
 
 class KVGANILDataReader : public KVRawDataReader {
 protected:
@@ -26,11 +28,17 @@ protected:
    KVHashList* fParameters;//list of all data parameters contained in file
    KVHashList* fExtParams;//list of data parameters in file not defined by gMultiDetArray
    KVHashList* fFired;//list of fired parameters in one event
+   std::vector<KVACQParam*> fParamIndex;//! parameters in fParameters, indexed by their number in file
 
    virtual GTGanilData* NewGanTapeInterface();
    virtual KVACQParam* CheckACQParam(const Char_t*);
 
-   void FillFiredParameterList();
+   void FillFiredParameterList(const Int_t* fired, Int_t nfired);
+
+   KVGANILDataPipeline* fPipeline;//! reader thread & ring of pre-decoded events (see EnablePipeline)
+   std::vector<UShort_t> fPipelineData;//! values of all parameters of current event in pipelined mode
+   std::vector<Int_t> fPipelineFired;//! indices of parameters present in current event in pipelined mode
+   Bool_t GetNextPipelinedEvent();
 
 public:
    KVGANILDataReader()
@@ -47,6 +55,15 @@ public:
 
    virtual void SetUserTree(TTree*, Option_t* = "arrays");
 
+   virtual Bool_t EnablePipeline(Int_t depth);
+   void StopPipeline();
+   virtual Bool_t IsPipelined() const
+   {
+      // kTRUE if events are decoded by a separate thread (see EnablePipeline)
+      return (fPipeline != 0);
+   }
+   virtual void PrintPipelineStatistics() const;
+
    const KVSeqCollection* GetUnknownParameters() const
    {
       return fExtParams;
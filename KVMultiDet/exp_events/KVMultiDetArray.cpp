@@ -1722,7 +1722,7 @@ void KVMultiDetArray::SetParameters(UShort_t run)
          ds = gDataSetManager->GetDataSet(fDataSet.Data());
    }
    if (ds) {
-      GetUpDater()->SetParameters(run);
+      GetUpDater()->SetRunParameters(run);
       SetBit(kParamsSet);
    }
 }
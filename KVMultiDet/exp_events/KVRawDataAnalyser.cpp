@@ -7,6 +7,7 @@
 #include "KVDataSet.h"
 #include "TH1.h"
 #include "TSystem.h"
+#include "TEnv.h"
 
 using namespace std;
 
@@ -19,6 +20,15 @@ ClassImp(KVRawDataAnalyser)
 <h4>Abstract base class for user analysis of raw data</h4>
 <!-- */
 // --> END_HTML
+//
+// Raw data files can be read & decoded by a separate thread, ahead of the
+// reconstruction & analysis of each event (see KVRawDataReader::EnablePipeline),
+// by giving the number of events which can be decoded in advance:
+//
+//    KVRawDataAnalyser.PipelineDepth:   64
+//
+// or by calling SetPipelineDepth(). Statistics showing whether reading or
+// analysis is the bottleneck are printed at the end of each run.
 ////////////////////////////////////////////////////////////////////////////////
 
 KVRawDataAnalyser::KVRawDataAnalyser()
@@ -27,6 +37,7 @@ KVRawDataAnalyser::KVRawDataAnalyser()
    fRunFile = 0;
    fDetEv = 0;
    TotalEntriesToRead = 0;
+   fPipelineDepth = gEnv->GetValue("KVRawDataAnalyser.PipelineDepth", 0);
 }
 
 KVRawDataAnalyser::~KVRawDataAnalyser()
@@ -83,6 +94,9 @@ void KVRawDataAnalyser::ProcessRun()
 
    fDetEv = new KVDetectorEvent;
 
+   if (fPipelineDepth > 0 && !fRunFile->EnablePipeline(fPipelineDepth))
+      Info("ProcessRun", "Events will be read without pipelined decoding");
+
    //loop over events in file
    while ((nevents-- ? fRunFile->GetNextEvent() : kFALSE) && !AbortProcessingLoop()) {
 
@@ -108,6 +122,7 @@ void KVRawDataAnalyser::ProcessRun()
    TDatime now2;
    cout <<  now2.AsString() << endl << endl;
    cout << endl << "Finished reading " << fEventNumber - 1 << " events from file " << raw_file.Data() << endl << endl;
+   if (fRunFile->IsPipelined()) fRunFile->PrintPipelineStatistics();
 
    preEndRun();
    //call user's end of run function
@@ -17,6 +17,7 @@ protected:
    Long64_t fEventNumber;        //event number in current run
    KVDetectorEvent* fDetEv;      //list of hit groups for current event
    KVHashList fHistoList;        //list of histograms of user analysis
+   Int_t fPipelineDepth;         //number of events decoded ahead of analysis (0 = no pipeline)
 
    virtual void ProcessRun();
    void clearallhistos(TCollection*);
@@ -34,6 +35,17 @@ public:
    KVRawDataAnalyser();
    virtual ~KVRawDataAnalyser();
 
+   void SetPipelineDepth(Int_t n)
+   {
+      // Number of events read & decoded by a separate thread ahead of their
+      // analysis (0 = events are read by the analysis thread)
+      fPipelineDepth = n;
+   }
+   Int_t GetPipelineDepth() const
+   {
+      return fPipelineDepth;
+   }
+
    virtual void InitAnalysis() = 0;
    virtual void InitRun() = 0;
    virtual Bool_t Analysis() = 0;
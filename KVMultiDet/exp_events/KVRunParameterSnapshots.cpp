@@ -0,0 +1,430 @@
+#include "KVRunParameterSnapshots.h"
+#include "KVMultiDetArray.h"
+#include "KVDetector.h"
+#include "KVACQParam.h"
+#include "KVCalibrator.h"
+#include "KVIDTelescope.h"
+#include "KVIDGridManager.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TDirectory.h"
+#include "TMath.h"
+
+ClassImp(KVRunParameterSnapshots)
+
+////////////////////////////////////////////////////////////////////////////////
+// BEGIN_HTML <!--
+/* -->
+<h2>KVRunParameterSnapshots</h2>
+<h4>Snapshots of detector array parameters for each run</h4>
+<p>
+A snapshot is the set of values of all parameters of a detector array which are
+set for each run by a KVUpDater:
+</p>
+<ul>
+<li>gain, presence & working status of each detector (and pressure for gas detectors);</li>
+<li>pedestal & working status of each acquisition parameter;</li>
+<li>status & parameters of each calibrator;</li>
+<li>identification grids of each ID telescope.</li>
+</ul>
+<p>
+Snapshots for all runs of a dataset are written in a TTree in a ROOT file
+(one entry per run, indexed by run number). They can then be used to change
+the parameters of the array from one run to another by setting only the
+parameters whose values are different, instead of reading & setting all
+parameters from the database (see ApplySnapshot()).
+</p>
+<p>
+The parameters are identified by their position in a list built from the
+detectors, acquisition parameters, calibrators and ID telescopes of the array
+(see BuildLayout()). A checksum of the names of all parameters is stored with the
+snapshots, and they are only used if it is the same as for the current array.
+</p>
+<p>
+No copy of the values currently set in the array is kept: ApplySnapshot() compares
+each value of the snapshot with the value read from the detector, acquisition
+parameter, calibrator or ID telescope, so that the array is always left in the
+state of the snapshot even if parameters were modified by other means in between.
+</p>
+<!-- */
+// --> END_HTML
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+   void AddToLayoutHash(UInt_t& hash, const TString& name)
+   {
+      hash = 31 * hash + name.Hash();
+   }
+}
+
+KVRunParameterSnapshots::KVRunParameterSnapshots(KVMultiDetArray* array)
+   : KVBase("RunParameterSnapshots", "Snapshots of detector array parameters for each run"),
+     fArray(array), fLayoutHash(0), fFile(0), fTree(0), fRun(0),
+     fValues(new std::vector<Double_t>), fGrids(new std::vector<Int_t>), fFileLayoutHash(0)
+{
+   // Create object to handle snapshots of parameters of the given array
+   // (gMultiDetArray by default)
+
+   if (!fArray) fArray = gMultiDetArray;
+}
+
+//____________________________________________________________________________//
+
+KVRunParameterSnapshots::~KVRunParameterSnapshots()
+{
+   // Destructor: closes any open file
+   CloseFile();
+   delete fValues;
+   delete fGrids;
+}
+
+//____________________________________________________________________________//
+
+void KVRunParameterSnapshots::BuildLayout()
+{
+   // Build the list of all parameters of the array and the corresponding checksum.
+   // This must be done again if detectors, acquisition parameters, calibrators or
+   // ID telescopes are added to the array.
+
+   fObject.clear();
+   fType.clear();
+   fIndex.clear();
+   fTelescopes.clear();
+   fLayoutHash = 0;
+   if (!fArray) return;
+
+   TIter next_det(fArray->GetDetectors());
+   KVDetector* det;
+   while ((det = (KVDetector*)next_det())) {
+      TString detname = det->GetName();
+      Int_t ntype = det->IsGas() ? kPressure : kDetecting;
+      for (Int_t type = kGain; type <= ntype; ++type) {
+         fObject.push_back(det);
+         fType.push_back(type);
+         fIndex.push_back(0);
+         AddToLayoutHash(fLayoutHash, Form("%s/%d", detname.Data(), type));
+      }
+      if (det->GetACQParamList()) {
+         TIter next_acq(det->GetACQParamList());
+         KVACQParam* acq;
+         while ((acq = (KVACQParam*)next_acq())) {
+            for (Int_t type = kPedestal; type <= kWorking; ++type) {
+               fObject.push_back(acq);
+               fType.push_back(type);
+               fIndex.push_back(0);
+               AddToLayoutHash(fLayoutHash, Form("%s/%s/%d", detname.Data(), acq->GetName(), type));
+            }
+         }
+      }
+      if (det->GetListOfCalibrators()) {
+         TIter next_cal(det->GetListOfCalibrators());
+         KVCalibrator* cal;
+         while ((cal = (KVCalibrator*)next_cal())) {
+            for (Int_t i = -1; i < cal->GetNumberParams(); ++i) {
+               fObject.push_back(cal);
+               fType.push_back(i < 0 ? kCalibStatus : kCalibParameter);
+               fIndex.push_back(TMath::Max(i, 0));
+               AddToLayoutHash(fLayoutHash, Form("%s/%s/%s/%d", detname.Data(), cal->GetName(), cal->GetType(), i));
+            }
+         }
+      }
+   }
+
+   if (fArray->GetListOfIDTelescopes()) {
+      TIter next_idt(fArray->GetListOfIDTelescopes());
+      TObject* idt;
+      while ((idt = next_idt())) {
+         fTelescopes.push_back(idt);
+         AddToLayoutHash(fLayoutHash, idt->GetName());
+      }
+   }
+   // grids are stored as indices in gIDGridManager->GetGrids(): the names of all
+   // grids, in order, are part of the layout
+   if (gIDGridManager) {
+      TIter next_grid(gIDGridManager->GetGrids());
+      TObject* grid;
+      while ((grid = next_grid())) AddToLayoutHash(fLayoutHash, grid->GetName());
+   }
+}
+
+//____________________________________________________________________________//
+
+Double_t KVRunParameterSnapshots::GetParameterValue(Int_t i) const
+{
+   // Current value of i-th parameter of array
+   switch (fType[i]) {
+      case kGain:
+         return ((KVDetector*)fObject[i])->GetGain();
+      case kPresent:
+         return ((KVDetector*)fObject[i])->IsPresent();
+      case kDetecting:
+         return ((KVDetector*)fObject[i])->IsDetecting();
+      case kPressure:
+         return ((KVDetector*)fObject[i])->GetPressure();
+      case kPedestal:
+         return ((KVACQParam*)fObject[i])->GetPedestal();
+      case kWorking:
+         return ((KVACQParam*)fObject[i])->IsWorking();
+      case kCalibStatus:
+         return ((KVCalibrator*)fObject[i])->GetStatus();
+      case kCalibParameter:
+         return ((KVCalibrator*)fObject[i])->GetParameter(fIndex[i]);
+   }
+   return 0.;
+}
+
+//____________________________________________________________________________//
+
+void KVRunParameterSnapshots::SetParameterValue(Int_t i, Double_t val)
+{
+   // Set value of i-th parameter of array
+   switch (fType[i]) {
+      case kGain:
+         ((KVDetector*)fObject[i])->SetGain(val);
+         break;
+      case kPresent:
+         ((KVDetector*)fObject[i])->SetPresent(val != 0.);
+         break;
+      case kDetecting:
+         ((KVDetector*)fObject[i])->SetDetecting(val != 0.);
+         break;
+      case kPressure:
+         ((KVDetector*)fObject[i])->SetPressure(val);
+         break;
+      case kPedestal:
+         ((KVACQParam*)fObject[i])->SetPedestal(val);
+         break;
+      case kWorking:
+         ((KVACQParam*)fObject[i])->SetWorking(val != 0.);
+         break;
+      case kCalibStatus:
+         ((KVCalibrator*)fObject[i])->SetStatus(val != 0.);
+         break;
+      case kCalibParameter:
+         ((KVCalibrator*)fObject[i])->SetParameter(fIndex[i], val);
+         break;
+   }
+}
+
+//____________________________________________________________________________//
+
+void KVRunParameterSnapshots::ReadGrids(std::vector<Int_t>& grids) const
+{
+   // Fill vector with, for each ID telescope, the number of grids
+   // followed by the index of each grid in gIDGridManager->GetGrids()
+
+   grids.clear();
+   KVList* all_grids = gIDGridManager ? gIDGridManager->GetGrids() : 0;
+   for (std::vector<TObject*>::const_iterator it = fTelescopes.begin(); it != fTelescopes.end(); ++it) {
+      KVList* idgrids = ((KVIDTelescope*)(*it))->GetListOfIDGrids();
+      Int_t ngrids = (idgrids && all_grids ? idgrids->GetEntries() : 0);
+      grids.push_back(ngrids);
+      for (Int_t j = 0; j < ngrids; ++j) grids.push_back(all_grids->IndexOf(idgrids->At(j)));
+   }
+}
+
+//____________________________________________________________________________//
+
+Int_t KVRunParameterSnapshots::SetGrids(const std::vector<Int_t>& grids)
+{
+   // Set grids of each ID telescope according to the vector (see ReadGrids).
+   // Grids are only changed for telescopes whose grids are not the same as
+   // the ones they currently have. Returns number of telescopes changed.
+
+   KVList* all_grids = gIDGridManager ? gIDGridManager->GetGrids() : 0;
+   if (!all_grids) return 0;
+   // index -> grid, to avoid repeated look-ups in the list
+   std::vector<TObject*> grid_list;
+   grid_list.reserve(all_grids->GetEntries());
+   TIter next_grid(all_grids);
+   TObject* grid;
+   while ((grid = next_grid())) grid_list.push_back(grid);
+
+   Int_t nchanged = 0;
+   UInt_t p = 0;
+   for (std::vector<TObject*>::const_iterator it = fTelescopes.begin(); it != fTelescopes.end(); ++it) {
+      if (p >= grids.size()) break;
+      KVIDTelescope* idt = (KVIDTelescope*)(*it);
+      Int_t ngrids = grids[p];
+      KVList* idgrids = idt->GetListOfIDGrids();
+      Bool_t same = (ngrids == (idgrids ? idgrids->GetEntries() : 0));
+      for (Int_t j = 1; same && j <= ngrids; ++j) {
+         Int_t index = grids[p + j];
+         same = (index >= 0 && index < (Int_t)grid_list.size() && idgrids->At(j - 1) == grid_list[index]);
+      }
+      if (!same) {
+         idt->RemoveGrids();
+         for (Int_t j = 1; j <= ngrids; ++j) {
+            Int_t index = grids[p + j];
+            if (index >= 0 && index < (Int_t)grid_list.size()) idt->SetIDGrid((KVIDGraph*)grid_list[index]);
+         }
+         ++nchanged;
+      }
+      p += ngrids + 1;
+   }
+   return nchanged;
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVRunParameterSnapshots::OpenFile(const Char_t* path)
+{
+   // Open file containing snapshots in order to apply them to the array.
+   // Returns kFALSE if file cannot be opened or contains no snapshots.
+
+   CloseFile();
+   TDirectory* work_dir = gDirectory;
+   fFile = TFile::Open(path);
+   work_dir->cd();
+   if (!fFile || fFile->IsZombie()) {
+      Error("OpenFile", "Cannot open file %s", path);
+      CloseFile();
+      return kFALSE;
+   }
+   fTree = (TTree*)fFile->Get("RunParameters");
+   if (!fTree || !fTree->GetTreeIndex()) {
+      Error("OpenFile", "No snapshots found in file %s", path);
+      CloseFile();
+      return kFALSE;
+   }
+   TObject* hash = fTree->GetUserInfo()->FindObject("LayoutHash");
+   fFileLayoutHash = (hash ? (UInt_t)TString(hash->GetTitle()).Atoll() : 0);
+   fTree->SetBranchAddress("Run", &fRun);
+   fTree->SetBranchAddress("Values", &fValues);
+   fTree->SetBranchAddress("Grids", &fGrids);
+   return kTRUE;
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVRunParameterSnapshots::CreateFile(const Char_t* path)
+{
+   // Create new file in which to write snapshots (see AddSnapshot).
+   // Any existing file with the same name is overwritten.
+
+   CloseFile();
+   TDirectory* work_dir = gDirectory;
+   fFile = TFile::Open(path, "RECREATE");
+   if (!fFile || fFile->IsZombie()) {
+      Error("CreateFile", "Cannot create file %s", path);
+      work_dir->cd();
+      CloseFile();
+      return kFALSE;
+   }
+   fTree = new TTree("RunParameters", "Parameters of detector array for each run");
+   fTree->Branch("Run", &fRun, "Run/i");
+   fTree->Branch("Values", &fValues);
+   fTree->Branch("Grids", &fGrids);
+   work_dir->cd();
+   return kTRUE;
+}
+
+//____________________________________________________________________________//
+
+void KVRunParameterSnapshots::CloseFile()
+{
+   // Close file of snapshots. If the file was created with CreateFile(),
+   // the tree of snapshots is indexed by run number and written before closing.
+
+   if (fFile && fTree && fFile->IsWritable()) {
+      TDirectory* work_dir = gDirectory;
+      fFile->cd();
+      if (fTree->GetEntries()) fTree->BuildIndex("Run");
+      fTree->GetUserInfo()->Add(new TNamed("LayoutHash", Form("%u", fFileLayoutHash)));
+      fTree->Write();
+      work_dir->cd();
+   }
+   if (fFile) {
+      fFile->Close();
+      delete fFile;
+   }
+   fFile = 0;
+   fTree = 0;
+   fFileLayoutHash = 0;
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVRunParameterSnapshots::IsLayoutCompatible()
+{
+   // Returns kTRUE if snapshots in the file were made for an array with
+   // the same parameters as the current array. If not, the list of parameters
+   // is rebuilt in case the array has been modified since it was last built.
+
+   if (!fTree) return kFALSE;
+   if (fLayoutHash && fLayoutHash == fFileLayoutHash) return kTRUE;
+   BuildLayout();
+   return (fLayoutHash == fFileLayoutHash);
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVRunParameterSnapshots::HasSnapshot(UInt_t run)
+{
+   // Returns kTRUE if the open file contains a snapshot for this run
+   // which can be applied to the current array
+   return IsLayoutCompatible() && fTree->GetEntryNumberWithIndex(run) > -1;
+}
+
+//____________________________________________________________________________//
+
+Bool_t KVRunParameterSnapshots::AddSnapshot(UInt_t run)
+{
+   // Add snapshot of current parameters of array for this run
+   // to file opened with CreateFile().
+   // The parameters of the array must have been set for the run beforehand.
+   // Returns kFALSE if the list of parameters of the array is not the same as
+   // for previous snapshots in the file.
+
+   if (!fTree || !fFile->IsWritable()) {
+      Error("AddSnapshot", "No file open for writing: call CreateFile() first");
+      return kFALSE;
+   }
+   BuildLayout();
+   if (!fTree->GetEntries()) fFileLayoutHash = fLayoutHash;
+   else if (fLayoutHash != fFileLayoutHash) {
+      Error("AddSnapshot", "Parameters of array for run %u are not the same as for previous runs", run);
+      return kFALSE;
+   }
+   fRun = run;
+   fValues->resize(fType.size());
+   for (UInt_t i = 0; i < fType.size(); ++i)(*fValues)[i] = GetParameterValue(i);
+   ReadGrids(*fGrids);
+   TDirectory* work_dir = gDirectory;
+   fFile->cd();
+   fTree->Fill();
+   work_dir->cd();
+   return kTRUE;
+}
+
+//____________________________________________________________________________//
+
+Int_t KVRunParameterSnapshots::ApplySnapshot(UInt_t run)
+{
+   // Set parameters of array to the values in the snapshot for this run.
+   // Only parameters whose value is different from the value currently set
+   // are changed, and only ID telescopes whose grids are different have their
+   // grids changed. The current values are read from the array each time, so
+   // parameters changed by other means since the last snapshot are also reset.
+   //
+   // Returns the number of parameters & ID telescopes changed,
+   // or -1 if no snapshot for the run can be applied.
+
+   if (!HasSnapshot(run)) return -1;
+   fTree->GetEntry(fTree->GetEntryNumberWithIndex(run));
+   if (fValues->size() != fType.size()) {
+      Error("ApplySnapshot", "Snapshot for run %u has %d parameters, array has %d",
+            run, (Int_t)fValues->size(), (Int_t)fType.size());
+      return -1;
+   }
+   Int_t nchanged = 0;
+   for (UInt_t i = 0; i < fType.size(); ++i) {
+      Double_t val = (*fValues)[i];
+      if (val != GetParameterValue(i)) {
+         SetParameterValue(i, val);
+         ++nchanged;
+      }
+   }
+   nchanged += SetGrids(*fGrids);
+   return nchanged;
+}
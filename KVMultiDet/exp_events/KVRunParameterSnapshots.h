@@ -0,0 +1,70 @@
+#ifndef __KVRUNPARAMETERSNAPSHOTS_H
+#define __KVRUNPARAMETERSNAPSHOTS_H
+
+#include "KVBase.h"
+#include <vector>
+
+class TFile;
+class TTree;
+class KVMultiDetArray;
+
+class KVRunParameterSnapshots : public KVBase {
+
+public:
+   enum EParameterType {
+      kGain,            // detector gain
+      kPresent,         // detector present
+      kDetecting,       // detector working
+      kPressure,        // pressure of gas detector
+      kPedestal,        // pedestal of acquisition parameter
+      kWorking,         // acquisition parameter working
+      kCalibStatus,     // calibrator ready
+      kCalibParameter   // parameter of calibrator
+   };
+
+private:
+   KVMultiDetArray* fArray;//! array whose parameters are saved & restored
+   std::vector<TObject*> fObject;//! detector, acquisition parameter or calibrator for each parameter
+   std::vector<Int_t> fType;//! type of each parameter (EParameterType)
+   std::vector<Int_t> fIndex;//! index of calibrator parameter
+   std::vector<TObject*> fTelescopes;//! identification telescopes of array
+   UInt_t fLayoutHash;//! checksum of names of all parameters of array
+
+   TFile* fFile;//! file containing snapshots
+   TTree* fTree;//! tree of snapshots (one entry per run)
+   UInt_t fRun;//! run number of current snapshot
+   std::vector<Double_t>* fValues;//! parameter values of current snapshot
+   std::vector<Int_t>* fGrids;//! grids of ID telescopes of current snapshot
+   UInt_t fFileLayoutHash;//! checksum of parameter names for snapshots in file
+
+   Double_t GetParameterValue(Int_t i) const;
+   void SetParameterValue(Int_t i, Double_t val);
+   void ReadGrids(std::vector<Int_t>&) const;
+   Int_t SetGrids(const std::vector<Int_t>&);
+
+public:
+   KVRunParameterSnapshots(KVMultiDetArray* array = 0);
+   virtual ~KVRunParameterSnapshots();
+
+   void BuildLayout();
+   UInt_t GetLayoutHash() const
+   {
+      return fLayoutHash;
+   }
+   Int_t GetNumberOfParameters() const
+   {
+      return fType.size();
+   }
+
+   Bool_t OpenFile(const Char_t* path);
+   Bool_t CreateFile(const Char_t* path);
+   void CloseFile();
+   Bool_t IsLayoutCompatible();
+   Bool_t HasSnapshot(UInt_t run);
+   Bool_t AddSnapshot(UInt_t run);
+   Int_t ApplySnapshot(UInt_t run);
+
+   ClassDef(KVRunParameterSnapshots, 0) //Snapshots of detector array parameters for each run
+};
+
+#endif
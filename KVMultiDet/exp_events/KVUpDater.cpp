@@ -15,6 +15,13 @@ $Author: franklan $
 #include "KVDetector.h"
 #include "KVCalibrator.h"
 #include "KVDataBase.h"
+#include "KVDataSet.h"
+#include "KVDataSetManager.h"
+#include "KVNumberList.h"
+#include "KVRunParameterSnapshots.h"
+#include "TSystem.h"
+#include "TROOT.h"
+#include "TError.h"
 
 using namespace std;
 
@@ -30,7 +37,32 @@ ClassImp(KVUpDater)
 //      void SetParameters (UInt_t run)
 //must be defined. This updates the current detector array gMultiDetArray with the
 //parameter values for the run found in the current gDataBase database.
-KVUpDater::KVUpDater()
+//
+//Run parameter snapshots
+//=======================
+//Changing run means reading & setting again all parameters of the array from the
+//database (calibrations, pedestals, gains, ...). For datasets with many short runs
+//this can take a significant part of the time of an analysis. Instead, the parameters
+//of the array for all runs can be written once and for all in a file of 'snapshots'
+//(see KVRunParameterSnapshots) in the same directory as the database file:
+//
+//   gMultiDetArray->GetUpDater()->BuildRunParameterSnapshots()
+//
+//Then, if the variable
+//
+//   KVUpDater.RunParameterSnapshots:   yes
+//
+//(or [dataset].KVUpDater.RunParameterSnapshots) is set in your .kvrootrc, when the run
+//changes (see SetRunParameters) only the parameters whose values are different for the
+//new run are modified. Any parameters which are not stored in the snapshots must be set
+//by SetParametersNotInSnapshot (default: target only). The file of snapshots is not used
+//if it is older than the database file.
+//
+//Snapshots are only used by updaters which declare that they can use them by
+//overriding CanUseRunParameterSnapshots(): an updater which sets anything else for
+//each run (e.g. PSA parameters, acquisition parameter names, reference gains) must
+//either set it in SetParametersNotInSnapshot, or not use snapshots.
+KVUpDater::KVUpDater() : fSnapshots(0), fSnapshotsChecked(kFALSE)
 {
    //Default ctor for KVUpDater object.
 }
@@ -40,6 +72,7 @@ KVUpDater::KVUpDater()
 KVUpDater::~KVUpDater()
 {
    //Destructor.
+   delete fSnapshots;
 }
 
 KVUpDater* KVUpDater::MakeUpDater(const Char_t* uri)
@@ -60,6 +93,147 @@ KVUpDater* KVUpDater::MakeUpDater(const Char_t* uri)
    return upd;
 }
 
+void KVUpDater::SetRunParameters(UInt_t run)
+{
+   // Set parameters of multidetector for this run (called by KVMultiDetArray::SetParameters).
+   //
+   // If run parameter snapshots are used (see class description) and a snapshot is
+   // available for the run, SetParametersNotInSnapshot is called, then only parameters
+   // whose values are different from the current values are changed, and the ID
+   // telescopes are initialized again if any parameters were changed.
+   // Otherwise SetParameters is called.
+
+   Int_t nchanged = -1;
+   if (UseRunParameterSnapshots()) {
+      if (!fSnapshotsChecked) {
+         fSnapshotsChecked = kTRUE;
+         TString path = GetRunParameterSnapshotsFile();
+         // no file, or file older than database: silently use the database
+         if (path != "" && !gSystem->AccessPathName(path)) {
+            fSnapshots = new KVRunParameterSnapshots(gMultiDetArray);
+            if (!fSnapshots->OpenFile(path)) SafeDelete(fSnapshots);
+         }
+      }
+      KVDBRun* kvrun = (gDataBase ? dynamic_cast<KVDBRun*>(gDataBase->GetTable("Runs")->GetRecord(run)) : 0);
+      if (fSnapshots && kvrun && fSnapshots->HasSnapshot(run)) {
+         if (gDebug > 0) ::Info("KVUpDater::SetRunParameters", "Setting parameters of multidetector array for run %u from snapshot", run);
+         SetParametersNotInSnapshot(kvrun);
+         nchanged = fSnapshots->ApplySnapshot(run);
+         if (nchanged > 0) gMultiDetArray->InitializeIDTelescopes();
+      }
+   }
+   if (nchanged < 0) {
+      SetParameters(run);
+   }
+}
+
+//_______________________________________________________________//
+
+void KVUpDater::SetParametersNotInSnapshot(KVDBRun* kvrun)
+{
+   // Called by SetRunParameters when parameters of the array are set from a
+   // snapshot: set any parameters for the run which are not stored in snapshots
+   // (see KVRunParameterSnapshots).
+   // Default: set the target for the run.
+
+   SetTarget(kvrun);
+}
+
+//_______________________________________________________________//
+
+Bool_t KVUpDater::CanUseRunParameterSnapshots() const
+{
+   // Returns kTRUE if all parameters set by SetParameters for a run are either
+   // stored in the snapshots (see KVRunParameterSnapshots) or set again by
+   // SetParametersNotInSnapshot.
+   // Default: kFALSE. Each updater class which can use snapshots must say so by
+   // overriding this method.
+   return kFALSE;
+}
+
+//_______________________________________________________________//
+
+Bool_t KVUpDater::UseRunParameterSnapshots() const
+{
+   // Returns kTRUE if this updater can use snapshots (see CanUseRunParameterSnapshots)
+   // and [dataset].KVUpDater.RunParameterSnapshots (or KVUpDater.RunParameterSnapshots)
+   // is set to 'yes' in .kvrootrc
+   return CanUseRunParameterSnapshots()
+          && KVDataSet::GetDataSetEnv(fDataSet, "KVUpDater.RunParameterSnapshots", kFALSE);
+}
+
+//_______________________________________________________________//
+
+TString KVUpDater::GetRunParameterSnapshotsFile() const
+{
+   // Full path to file of run parameter snapshots for dataset, in the same directory
+   // as the database file. Name of file is given by variable
+   //   KVUpDater.RunParameterSnapshots.File:    RunParameters.root
+   // Returns empty string if dataset is not known, or if the file of snapshots is
+   // older than the database file (i.e. the database has been rebuilt since).
+
+   KVDataSet* ds = (gDataSetManager ? gDataSetManager->GetDataSet(fDataSet) : 0);
+   if (!ds) return "";
+   TString dbfile = ds->GetFullPathToDB();
+   TString path;
+   AssignAndDelete(path, gSystem->ConcatFileName(gSystem->DirName(dbfile),
+                   gEnv->GetValue("KVUpDater.RunParameterSnapshots.File", "RunParameters.root")));
+   FileStat_t dbstat, snapstat;
+   if (!gSystem->GetPathInfo(dbfile, dbstat) && !gSystem->GetPathInfo(path, snapstat)
+         && snapstat.fMtime < dbstat.fMtime) {
+      ::Warning("KVUpDater::GetRunParameterSnapshotsFile",
+                "File %s is older than database: call BuildRunParameterSnapshots to rebuild it", path.Data());
+      return "";
+   }
+   return path;
+}
+
+//_______________________________________________________________//
+
+void KVUpDater::BuildRunParameterSnapshots(const KVNumberList& runs)
+{
+   // Write snapshots of the parameters of the array for all runs in the list
+   // in the file of run parameter snapshots (see class description).
+   // If the list is empty (default), snapshots are made for all runs in the database.
+   // For each run, SetParameters is called in order to set the parameters from
+   // the database. Any existing file is overwritten.
+
+   TString dbfile = gDataSetManager && gDataSetManager->GetDataSet(fDataSet) ?
+                    gDataSetManager->GetDataSet(fDataSet)->GetFullPathToDB() : "";
+   if (dbfile == "") {
+      ::Error("KVUpDater::BuildRunParameterSnapshots", "Unknown dataset %s", fDataSet.Data());
+      return;
+   }
+   TString path;
+   AssignAndDelete(path, gSystem->ConcatFileName(gSystem->DirName(dbfile),
+                   gEnv->GetValue("KVUpDater.RunParameterSnapshots.File", "RunParameters.root")));
+
+   SafeDelete(fSnapshots);
+   fSnapshotsChecked = kFALSE;
+   KVRunParameterSnapshots snapshots(gMultiDetArray);
+   if (!snapshots.CreateFile(path)) return;
+   KVNumberList runlist(runs);
+   if (runlist.IsEmpty() && gDataBase) {
+      TIter next_run(gDataBase->GetTable("Runs")->GetRecords());
+      KVDBRun* dbrun;
+      while ((dbrun = (KVDBRun*)next_run())) runlist.Add(dbrun->GetNumber());
+   }
+   Int_t nruns = 0;
+   runlist.Begin();
+   while (!runlist.End()) {
+      UInt_t run = runlist.Next();
+      if (!gDataBase || !gDataBase->GetTable("Runs")->GetRecord(run)) continue;
+      SetParameters(run);
+      if (!snapshots.AddSnapshot(run)) break;
+      ++nruns;
+   }
+   snapshots.CloseFile();
+   ::Info("KVUpDater::BuildRunParameterSnapshots", "Snapshots of %d parameters for %d runs written in %s",
+          snapshots.GetNumberOfParameters(), nruns, path.Data());
+}
+
+//_______________________________________________________________//
+
 void KVUpDater::SetParameters(UInt_t run)
 {
    // Set parameters of multidetector for this run
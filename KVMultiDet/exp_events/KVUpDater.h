@@ -11,17 +11,30 @@ $Author: franklan $
 #include "TObject.h"
 #include "TString.h"
 #include "KVDBRun.h"
+#include "KVNumberList.h"
+
+class KVRunParameterSnapshots;
 
 class KVUpDater {
 
 protected:
    TString fDataSet;            //!name of dataset associated
+   KVRunParameterSnapshots* fSnapshots;//!snapshots of array parameters for each run
+   Bool_t fSnapshotsChecked;//!kTRUE if we already tried to open the file of snapshots
+
+   Bool_t UseRunParameterSnapshots() const;
+   virtual Bool_t CanUseRunParameterSnapshots() const;
+   TString GetRunParameterSnapshotsFile() const;
+
 public:
 
    KVUpDater();
    virtual ~ KVUpDater();
 
+   void SetRunParameters(UInt_t);
    virtual void SetParameters(UInt_t);
+   virtual void SetParametersNotInSnapshot(KVDBRun*);
+   void BuildRunParameterSnapshots(const KVNumberList& runs = "");
    virtual void SetIdentificationParameters(UInt_t) ;
    virtual void SetCalibrationParameters(UInt_t);
    virtual void SetTarget(KVDBRun*);
@@ -22,6 +22,7 @@
 #pragma link C++ class KVRTGIDManager+;
 #endif
 #pragma link C++ class KVUpDater;
+#pragma link C++ class KVRunParameterSnapshots+;
 #ifdef WITH_BUILTIN_GRU
 #pragma link C++ class KVGANILDataReader+;
 #pragma link C++ class KVRawDataAnalyser+;
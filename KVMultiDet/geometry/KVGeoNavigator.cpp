@@ -210,7 +210,7 @@ void KVGeoNavigator::FormatDetectorName(const Char_t* basename, KVString& name)
 
 KVGeoNavigator::KVGeoNavigator(TGeoManager* g)
    : fGeometry(g), fCurrentStructures("KVGeoStrucElement", 50), fDetStrucNameCorrespList(nullptr),
-     fDetectorPaths(kTRUE)
+     fDetectorPaths(kTRUE), fNDetectorNodes(-1)
 {
    // Constructor. Call with pointer to geometry.
    SetTracking(kFALSE);
@@ -355,7 +355,7 @@ TGeoVolume* KVGeoNavigator::GetCurrentDetectorNameAndVolume(KVString& detector_n
    // See ExtractDetectorNameFromPath(KVString&) for details on detector name formatting.
 
 //    Info("GetCurrentDetectorNameAndVolume","now i am in %s on node %s with path %s and matrix:",
-//         fCurrentVolume->GetName(),fCurrentNode->GetName(),fCurrentPath.Data());
+//         fCurrentVolume->GetName(),fCurrentNode->GetName(),GetCurrentPath().Data());
 //    fCurrentMatrix.Print();
 
    multilayer = kFALSE;
@@ -503,7 +503,7 @@ void KVGeoNavigator::PropagateParticle(KVNucleus* part, TVector3* TheOrigin)
    fCurrentNode = fGeometry->GetCurrentNode();
    fMotherNode = fGeometry->GetMother();
    fCurrentMatrix = *(fGeometry->GetCurrentMatrix());
-   fCurrentPath = fGeometry->GetPath();
+   GetCurrentBranch(fCurrentBranch);
    // move along trajectory until we hit a new volume
    fGeometry->FindNextBoundaryAndStep();
    fStepSize = fGeometry->GetStep();
@@ -511,7 +511,7 @@ void KVGeoNavigator::PropagateParticle(KVNucleus* part, TVector3* TheOrigin)
    TGeoNode* newNod = fGeometry->GetCurrentNode();
    TGeoNode* newMom = fGeometry->GetMother();
    TGeoHMatrix* newMatx = fGeometry->GetCurrentMatrix();
-   TString newPath = fGeometry->GetPath();
+   GetCurrentBranch(fNewBranch);
 
    Double_t XX, YY, ZZ;
    XX = YY = ZZ = 0.;
@@ -520,7 +520,7 @@ void KVGeoNavigator::PropagateParticle(KVNucleus* part, TVector3* TheOrigin)
    SetStopPropagation(kFALSE);
 
 //    if(IsTracking()) Info("PropagateParticle","Beginning: i am in %s on node %s with path %s",
-//         fCurrentVolume->GetName(),fCurrentNode->GetName(),fCurrentPath.Data());
+//         fCurrentVolume->GetName(),fCurrentNode->GetName(),GetCurrentPath().Data());
 
    if (IsTracking() && fGeometry->IsOutside()) {
       const Double_t* posi = fGeometry->GetCurrentPoint();
@@ -539,14 +539,13 @@ void KVGeoNavigator::PropagateParticle(KVNucleus* part, TVector3* TheOrigin)
       ZZ = posi[2];
       fExitPoint.SetXYZ(XX, YY, ZZ);
 
-      TString vn = GetCurrentVolume()->GetName();
-      if (vn.BeginsWith("DEADZONE")) {
+      if (!strncmp(GetCurrentVolume()->GetName(), "DEADZONE", 8)) {
          part->GetParameters()->SetValue("DEADZONE", Form("%s/%s", GetCurrentVolume()->GetName(), GetCurrentNode()->GetName()));
          break;
       }
 
 //        if(IsTracking()) Info("PropagateParticle","just before ParticleEntersNewVolume\nnow i am in %s on node %s with path %s",
-//             fCurrentVolume->GetName(),fCurrentNode->GetName(),fCurrentPath.Data());
+//             fCurrentVolume->GetName(),fCurrentNode->GetName(),GetCurrentPath().Data());
 
       ParticleEntersNewVolume(part);
 
@@ -556,10 +555,10 @@ void KVGeoNavigator::PropagateParticle(KVNucleus* part, TVector3* TheOrigin)
       fCurrentNode = newNod;
       fMotherNode = newMom;
       fCurrentMatrix = *newMatx;
-      fCurrentPath = newPath;
+      fCurrentBranch.swap(fNewBranch);
 
 //       if(IsTracking()) Info("PropagateParticle","after ParticleEntersNewVolume\nnow i am in %s on node %s with path %s",
-//             fCurrentVolume->GetName(),fCurrentNode->GetName(),fCurrentPath.Data());
+//             fCurrentVolume->GetName(),fCurrentNode->GetName(),GetCurrentPath().Data());
 
       // move on to next volume crossed by trajectory
       fGeometry->FindNextBoundaryAndStep();
@@ -568,7 +567,7 @@ void KVGeoNavigator::PropagateParticle(KVNucleus* part, TVector3* TheOrigin)
       newNod = fGeometry->GetCurrentNode();
       newMom = fGeometry->GetMother();
       newMatx = fGeometry->GetCurrentMatrix();
-      newPath = fGeometry->GetPath();
+      GetCurrentBranch(fNewBranch);
    }
    if (IsTracking() && fGeometry->IsOutside()) {
       const Double_t* posi = fGeometry->GetCurrentPoint();
@@ -599,3 +598,80 @@ void KVGeoNavigator::DrawTracks(KVNumberList* zlist)
       }
    }
 }
+
+void KVGeoNavigator::GetCurrentBranch(std::vector<TGeoNode*>& branch) const
+{
+   // Fill vector with the nodes of the current branch of the geometry, from the top node
+   // (branch[0]) to the current node. As the vector keeps its capacity between calls,
+   // no memory allocation is required once it is large enough for the deepest branch.
+
+   Int_t level = fGeometry->GetLevel();
+   branch.resize(level + 1);
+   for (Int_t i = 0; i <= level; ++i) branch[i] = fGeometry->GetMother(level - i);
+}
+
+TString KVGeoNavigator::GetCurrentPath() const
+{
+   // Returns full path to current physical node, i.e. the names of all nodes of the
+   // current branch of the geometry separated by '/', as given by TGeoManager::GetPath().
+   // The path is only constructed when this method is called.
+
+   TString path;
+   for (std::vector<TGeoNode*>::const_iterator it = fCurrentBranch.begin(); it != fCurrentBranch.end(); ++it) {
+      path += "/";
+      path += (*it)->GetName();
+   }
+   return path;
+}
+
+void KVGeoNavigator::UpdateDetectorNodeMap()
+{
+   // Deduce from the list of paths to physical nodes of detectors (fDetectorPaths)
+   // the correspondance between nodes of the geometry and detectors, which is used by
+   // GetDetectorFromCurrentNode() to find detectors without any string manipulation.
+   // Nothing is done if the map is already up to date.
+
+   if (fNDetectorNodes == fDetectorPaths.GetEntries()) return;
+   fDetectorNodes.clear();
+   fNDetectorNodes = fDetectorPaths.GetEntries();
+   TGeoNode* top = fGeometry->GetTopNode();
+   TIter it(&fDetectorPaths);
+   KVGeoDetectorPath* gdp;
+   std::vector<TGeoNode*> branch;
+   while ((gdp = (KVGeoDetectorPath*)it())) {
+      KVString path(gdp->GetName());
+      path.Begin("/");
+      branch.clear();
+      TGeoNode* node = nullptr;
+      while (!path.End()) {
+         KVString name = path.Next();
+         if (!node) node = (name == top->GetName() ? top : nullptr);
+         else node = node->GetVolume()->GetNode(name);
+         if (!node) break;
+         branch.push_back(node);
+      }
+      if (!node) {
+         Warning("UpdateDetectorNodeMap", "Path %s for detector %s not found in geometry",
+                 gdp->GetName(), gdp->GetDetector()->GetName());
+         continue;
+      }
+      fDetectorNodes[node].push_back(DetectorBranch(branch, gdp->GetDetector()));
+   }
+}
+
+KVDetector* KVGeoNavigator::GetDetectorFromCurrentNode() const
+{
+   // Fast look-up of detector corresponding to the current physical node, using only
+   // the pointers to the nodes of the current branch of the geometry.
+   // This is equivalent to GetDetectorFromPath(GetCurrentPath()), and can only be used
+   // AFTER a KVGeoImport of the geometry and a call to UpdateDetectorNodeMap().
+
+   std::map<TGeoNode*, std::vector<DetectorBranch> >::const_iterator it = fDetectorNodes.find(fCurrentNode);
+   if (it == fDetectorNodes.end()) return nullptr;
+   // the same node may be used in several branches of the geometry,
+   // each one corresponding to a different detector
+   for (std::vector<DetectorBranch>::const_iterator db = it->second.begin(); db != it->second.end(); ++db) {
+      if (db->first == fCurrentBranch) return db->second;
+   }
+   return nullptr;
+}
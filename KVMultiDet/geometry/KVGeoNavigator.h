@@ -10,6 +10,8 @@
 #include "KVDetector.h"
 #include <KVNameValueList.h>
 #include <TGeoMatrix.h>
+#include <vector>
+#include <map>
 class KVNucleus;
 class KVEvent;
 class TGeoManager;
@@ -24,7 +26,8 @@ private:
    TGeoNode* fCurrentNode;//current node
    TGeoNode* fCurrentDetectorNode;//node for current detector
    TGeoHMatrix fCurrentMatrix;//current global transformation matrix
-   TString fCurrentPath;//current full path to physical node
+   std::vector<TGeoNode*> fCurrentBranch;//! nodes from top of geometry to current physical node
+   std::vector<TGeoNode*> fNewBranch;//! nodes from top of geometry to next physical node
    TClonesArray fCurrentStructures;//list of current structures deduced from path
    Int_t fCurStrucNumber;//number of current parent structures
    TGeoNode* fMotherNode;//mother node of current node
@@ -40,6 +43,7 @@ protected:
    TEnv* fDetStrucNameCorrespList;//list(s) of correspondance for renaming structures/detectors
    void FormatStructureName(const Char_t* type, Int_t number, KVString& name);
    void FormatDetectorName(const Char_t* basename, KVString& name);
+   void GetCurrentBranch(std::vector<TGeoNode*>&) const;
 
 public:
    class KVGeoDetectorPath : public TNamed {
@@ -65,6 +69,12 @@ protected:
       return (KVDetector*)(gdp ? gdp->GetDetector() : nullptr);
    }
 
+   typedef std::pair<std::vector<TGeoNode*>, KVDetector*> DetectorBranch;
+   std::map<TGeoNode*, std::vector<DetectorBranch> > fDetectorNodes;//! correspondance between nodes and detectors, deduced from fDetectorPaths
+   Int_t fNDetectorNodes;//! number of entries of fDetectorPaths used to fill fDetectorNodes
+   void UpdateDetectorNodeMap();
+   KVDetector* GetDetectorFromCurrentNode() const;
+
 public:
    KVGeoNavigator(TGeoManager*);
    virtual ~KVGeoNavigator();
@@ -134,10 +144,7 @@ public:
    }
    TGeoVolume* GetCurrentDetectorNameAndVolume(KVString&, Bool_t&);
    TGeoNode* GetCurrentDetectorNode() const;
-   TString GetCurrentPath() const
-   {
-      return fCurrentPath;
-   }
+   TString GetCurrentPath() const;
 
    Bool_t StopPropagation() const
    {
@@ -163,6 +170,7 @@ public:
 
       fDetectorPaths.AddAll(&GN->fDetectorPaths);
       GN->fDetectorPaths.SetOwner(kFALSE);
+      fNDetectorNodes = -1;
    }
    void PrintDetectorPaths()
    {
@@ -8,6 +8,7 @@
 #include <TGeoNode.h>
 #include "KVNucleus.h"
 #include <KVIonRangeTableMaterial.h>
+#include <TEnv.h>
 
 ClassImp(KVRangeTableGeoNavigator)
 
@@ -21,8 +22,20 @@ ClassImp(KVRangeTableGeoNavigator)
 // Given a valid ROOT geometry, we propagate the particles of an event
 // and, every time a particle traverses a volume made of a TGeoMaterial
 // with a name corresponding to a material known by this range table,
-// we calculate the energy loss of the particle,
-// and store it in the particle's list KVParticle::fParameters in the form
+// we calculate the energy loss of the particle.
+//
+// For each particle, the detector, energy loss and entry & exit points for each
+// absorber crossed are stored in a track record which can be examined after
+// propagation using GetNumberOfTrackSteps() and GetTrackStep(i) (see TrackStep).
+// The track record is overwritten by the next particle to be propagated.
+//
+// STORAGE AS PARTICLE PARAMETERS
+// ==============================
+// If SetStoreParticleParameters() is called (or if variable
+// KVRangeTableGeoNavigator.StoreParticleParameters is set to 'yes'),
+// or for a single particle by calling StoreTrackRecordInParticle()
+// after propagation, the energy losses are stored
+// in the particle's list KVParticle::fParameters in the form
 //
 //   "DE:[detector name]" = [energy lost in volume]
 //
@@ -55,6 +68,7 @@ ClassImp(KVRangeTableGeoNavigator)
 // nuc->SetZAandE(1,1,200); nuc->SetTheta(theta); nuc->SetPhi(phi);
 //
 // KVRangeTableGeoNavigator rtgn(gGeoManager, new KVedaLoss)
+// rtgn.SetStoreParticleParameters()
 // rtgn.PropagateEvent(evt)
 // evt->Print()
 //
@@ -95,6 +109,17 @@ ClassImp(KVRangeTableGeoNavigator)
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+KVRangeTableGeoNavigator::KVRangeTableGeoNavigator(TGeoManager* g, KVIonRangeTable* r)
+   : KVGeoNavigator(g), fRangeTable(r), fCutOffEnergy(1.e-3), fCurrentTrack(nullptr),
+     fTrackTime(0.), fNTrackSteps(0)
+{
+   // Propagate particles through geometry g using range table r.
+   // Storage of energy losses etc. as named parameters of particles is enabled or not
+   // according to the value of variable
+   //    KVRangeTableGeoNavigator.StoreParticleParameters
+   fStoreParticleParameters = gEnv->GetValue("KVRangeTableGeoNavigator.StoreParticleParameters", kFALSE);
+}
+
 void KVRangeTableGeoNavigator::ParticleEntersNewVolume(KVNucleus* part)
 {
    // Overrides method in KVGeoNavigator base class.
@@ -106,7 +131,8 @@ void KVRangeTableGeoNavigator::ParticleEntersNewVolume(KVNucleus* part)
    // SetCutOffKEForPropagation(Double_t) ), we stop the propagation.
    //
    // The (cumulated) energy losses in the active layers of all hit detectors
-   // are updated with the energy lost by this particle
+   // are updated with the energy lost by this particle, and a new step is added
+   // to the track record of the particle.
 
    Double_t de = 0;
    Double_t e = part->GetEnergy();
@@ -139,58 +165,87 @@ void KVRangeTableGeoNavigator::ParticleEntersNewVolume(KVNucleus* part)
       //initial energy
       if (!part->GetPInitial()) part->SetE0();
 
-      TString absorber_name;
-      KVDetector* theDet = GetDetectorFromPath(GetCurrentPath());
-      Bool_t active_layer = kFALSE;
+      // add new step to track record (storage is reused from one particle to the next)
+      if (fNTrackSteps == (Int_t)fTrackRecord.size()) fTrackRecord.push_back(TrackStep());
+      TrackStep& step = fTrackRecord[fNTrackSteps++];
+      step.fDetector = GetDetectorFromCurrentNode();
+      step.fNode = GetCurrentNode();
+      step.fMaterial = irmat;
+      step.fDE = de;
+      step.fActive = kFALSE;
+      KVDetector* theDet = step.fDetector;
       if (theDet) {
          if (!theDet->IsSingleLayer()) {
-            absorber_name.Form("%s/%s", theDet->GetName(), GetCurrentNode()->GetName());
-            if (strncmp(GetCurrentNode()->GetName(), "ACTIVE", 6) == 0) active_layer = kTRUE;
-         } else {
-            absorber_name = theDet->GetName();
-            active_layer = kTRUE;
-         }
-      } else
-         absorber_name = irmat->GetName();
-
-      if (part->GetZ()) {
-         part->GetParameters()->SetValue(Form("DE:%s", absorber_name.Data()), de);
-         if (active_layer) {
-            // update energy loss in active layer of detector
-            Double_t E = theDet->GetEnergyLoss() + de;
-            theDet->SetEnergyLoss(E);
-            theDet->AddHit(part);
-         }
+            if (strncmp(GetCurrentNode()->GetName(), "ACTIVE", 6) == 0) step.fActive = kTRUE;
+         } else
+            step.fActive = kTRUE;
       }
-      part->GetParameters()->SetValue(Form("Xin:%s", absorber_name.Data()), GetEntryPoint().X());
-      part->GetParameters()->SetValue(Form("Yin:%s", absorber_name.Data()), GetEntryPoint().Y());
-      part->GetParameters()->SetValue(Form("Zin:%s", absorber_name.Data()), GetEntryPoint().Z());
+
+      if (part->GetZ() && step.fActive) {
+         // update energy loss in active layer of detector
+         Double_t E = theDet->GetEnergyLoss() + de;
+         theDet->SetEnergyLoss(E);
+         theDet->AddHit(part);
+      }
+      GetEntryPoint().GetXYZ(step.fIn);
       if (StopPropagation()) {
          // If particle stops in this volume, we use as 'exit point' the point corresponding to
          // the calculated range of the particle
          Double_t r = irmat->GetRangeOfLastDE() / irmat->GetDensity();
          TVector3 path = GetExitPoint() - GetEntryPoint();
          TVector3 midVol = GetEntryPoint() + (r / path.Mag()) * path;
-         part->GetParameters()->SetValue(Form("Xout:%s", absorber_name.Data()), midVol.X());
-         part->GetParameters()->SetValue(Form("Yout:%s", absorber_name.Data()), midVol.Y());
-         part->GetParameters()->SetValue(Form("Zout:%s", absorber_name.Data()), midVol.Z());
-         if (IsTracking()) {
-            AddPointToCurrentTrack(GetEntryPoint().X(), GetEntryPoint().Y(), GetEntryPoint().Z());
-            AddPointToCurrentTrack(midVol.X(), midVol.Y(), midVol.Z());
-         }
-      } else {
-         part->GetParameters()->SetValue(Form("Xout:%s", absorber_name.Data()), GetExitPoint().X());
-         part->GetParameters()->SetValue(Form("Yout:%s", absorber_name.Data()), GetExitPoint().Y());
-         part->GetParameters()->SetValue(Form("Zout:%s", absorber_name.Data()), GetExitPoint().Z());
-         if (IsTracking()) {
-            AddPointToCurrentTrack(GetEntryPoint().X(), GetEntryPoint().Y(), GetEntryPoint().Z());
-            AddPointToCurrentTrack(GetExitPoint().X(), GetExitPoint().Y(), GetExitPoint().Z());
-         }
+         midVol.GetXYZ(step.fOut);
+      } else
+         GetExitPoint().GetXYZ(step.fOut);
+      if (IsTracking()) {
+         AddPointToCurrentTrack(step.fIn[0], step.fIn[1], step.fIn[2]);
+         AddPointToCurrentTrack(step.fOut[0], step.fOut[1], step.fOut[2]);
       }
+      if (fStoreParticleParameters) StoreParticleParameters(part, step);
       part->SetEnergy(e);
    }
 }
 
+void KVRangeTableGeoNavigator::TrackStep::GetAbsorberName(TString& absorber_name) const
+{
+   // Name of absorber used for named parameters of particles:
+   //   - for single-layer detectors, name of detector
+   //   - for multi-layer detectors, "[detector name]/[layer name]"
+   //   - for absorbers which are not part of a detector, name of material
+
+   if (fDetector) {
+      if (!fDetector->IsSingleLayer()) absorber_name.Form("%s/%s", fDetector->GetName(), fNode->GetName());
+      else absorber_name = fDetector->GetName();
+   } else
+      absorber_name = fMaterial->GetName();
+}
+
+void KVRangeTableGeoNavigator::StoreParticleParameters(KVNucleus* part, const TrackStep& step) const
+{
+   // Store energy loss and entry & exit points for one step of the track record
+   // as named parameters of the particle
+
+   TString absorber_name;
+   step.GetAbsorberName(absorber_name);
+   if (part->GetZ()) part->GetParameters()->SetValue(Form("DE:%s", absorber_name.Data()), step.fDE);
+   part->GetParameters()->SetValue(Form("Xin:%s", absorber_name.Data()), step.fIn[0]);
+   part->GetParameters()->SetValue(Form("Yin:%s", absorber_name.Data()), step.fIn[1]);
+   part->GetParameters()->SetValue(Form("Zin:%s", absorber_name.Data()), step.fIn[2]);
+   part->GetParameters()->SetValue(Form("Xout:%s", absorber_name.Data()), step.fOut[0]);
+   part->GetParameters()->SetValue(Form("Yout:%s", absorber_name.Data()), step.fOut[1]);
+   part->GetParameters()->SetValue(Form("Zout:%s", absorber_name.Data()), step.fOut[2]);
+}
+
+void KVRangeTableGeoNavigator::StoreTrackRecordInParticle(KVNucleus* part) const
+{
+   // Store the track record of the last propagated particle as named parameters of
+   // the given particle (see class description). Use this if you need these parameters
+   // for a particle and storage of parameters for all particles is not enabled
+   // (see SetStoreParticleParameters).
+
+   for (Int_t i = 0; i < fNTrackSteps; ++i) StoreParticleParameters(part, fTrackRecord[i]);
+}
+
 void KVRangeTableGeoNavigator::InitialiseTrack(KVNucleus* part, TVector3* TheOrigin)
 {
    // Start a new track to visualise trajectory of nucleus through the array
@@ -210,7 +265,10 @@ void KVRangeTableGeoNavigator::PropagateParticle(KVNucleus* part, TVector3* TheO
    // Slight modification of KVGeoNavigator::PropagateParticle:
    //   if particle hits a DEADZONE, set its energy to zero
    // We start a new track to represent the particle's trajectory through the array
+   // The track record of the previous particle is cleared.
 
+   fNTrackSteps = 0;
+   UpdateDetectorNodeMap();
    if (IsTracking()) InitialiseTrack(part, TheOrigin);
 
    KVGeoNavigator::PropagateParticle(part, TheOrigin);
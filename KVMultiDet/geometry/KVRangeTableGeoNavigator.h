@@ -7,13 +7,67 @@
 #include "TVirtualGeoTrack.h"
 #include "KVGeoNavigator.h"
 #include "KVIonRangeTable.h"
+#include <vector>
+
+class KVIonRangeTableMaterial;
 
 class KVRangeTableGeoNavigator : public KVGeoNavigator {
 
+public:
+   class TrackStep {
+      // Record of the passage of a particle through one absorber of the geometry
+      friend class KVRangeTableGeoNavigator;
+
+      KVDetector* fDetector;               // detector to which absorber belongs (nullptr if none)
+      TGeoNode* fNode;                     // physical node of absorber
+      KVIonRangeTableMaterial* fMaterial;  // material of absorber
+      Double_t fDE;                        // energy lost in absorber [MeV]
+      Double_t fIn[3];                     // world coordinates of entry point
+      Double_t fOut[3];                    // world coordinates of exit point (or point where particle stopped)
+      Bool_t fActive;                      // kTRUE if absorber is active layer of detector
+
+   public:
+      KVDetector* GetDetector() const
+      {
+         return fDetector;
+      }
+      TGeoNode* GetNode() const
+      {
+         return fNode;
+      }
+      KVIonRangeTableMaterial* GetMaterial() const
+      {
+         return fMaterial;
+      }
+      Double_t GetDeltaE() const
+      {
+         return fDE;
+      }
+      TVector3 GetEntryPoint() const
+      {
+         return TVector3(fIn);
+      }
+      TVector3 GetExitPoint() const
+      {
+         return TVector3(fOut);
+      }
+      Bool_t IsActiveLayer() const
+      {
+         return fActive;
+      }
+      void GetAbsorberName(TString&) const;
+   };
+
+private:
    KVIonRangeTable* fRangeTable;
    Double_t fCutOffEnergy;//cut-off KE in MeV below which we stop propagation
    TVirtualGeoTrack* fCurrentTrack;//! current track of nucleus being propagated
    Double_t fTrackTime;//! track "clock"
+   std::vector<TrackStep> fTrackRecord;//! absorbers crossed by last propagated particle
+   Int_t fNTrackSteps;//! number of absorbers crossed by last propagated particle
+   Bool_t fStoreParticleParameters;//! store energy losses & entry/exit points as named parameters of particles
+
+   void StoreParticleParameters(KVNucleus*, const TrackStep&) const;
 
    void InitialiseTrack(KVNucleus* part, TVector3* TheOrigin);
    void AddPointToCurrentTrack(Double_t x, Double_t y, Double_t z)
@@ -24,10 +78,7 @@ class KVRangeTableGeoNavigator : public KVGeoNavigator {
    }
 
 public:
-   KVRangeTableGeoNavigator(TGeoManager* g, KVIonRangeTable* r)
-      : KVGeoNavigator(g), fRangeTable(r), fCutOffEnergy(1.e-3), fCurrentTrack(nullptr),
-        fTrackTime(0.)
-   {}
+   KVRangeTableGeoNavigator(TGeoManager* g, KVIonRangeTable* r);
    virtual ~KVRangeTableGeoNavigator() {}
    void SetCutOffKEForPropagation(Double_t e)
    {
@@ -37,6 +88,28 @@ public:
    {
       return fCutOffEnergy;
    }
+   void SetStoreParticleParameters(Bool_t on = kTRUE)
+   {
+      // If on=kTRUE, energy losses and entry/exit points of particles in each absorber
+      // are stored as named parameters of each particle ("DE:...", "Xin:...", etc.)
+      fStoreParticleParameters = on;
+   }
+   Bool_t IsStoreParticleParameters() const
+   {
+      return fStoreParticleParameters;
+   }
+
+   Int_t GetNumberOfTrackSteps() const
+   {
+      // Number of absorbers crossed by the last propagated particle
+      return fNTrackSteps;
+   }
+   const TrackStep& GetTrackStep(Int_t i) const
+   {
+      // Record of i-th absorber crossed by the last propagated particle (0<=i<GetNumberOfTrackSteps())
+      return fTrackRecord[i];
+   }
+   void StoreTrackRecordInParticle(KVNucleus*) const;
 
    virtual void ParticleEntersNewVolume(KVNucleus*);
    virtual void PropagateParticle(KVNucleus*, TVector3* TheOrigin = 0);
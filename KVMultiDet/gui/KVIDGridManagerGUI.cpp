@@ -1238,7 +1238,7 @@ TFile* KVIDGridManagerGUI::TestIdentificationWithTree(KVIDGraph* gr, const Char_
                gr->Identify(x, y, idr);
                nuc.SetIdentification(idr);
                br_pid = nuc.GetPID();
-               br_idcode = gr->GetQualityCode();
+               br_idcode = idr->IDquality;
                idmap->SetBinContent(i, j, br_idcode);
             } else {
                br_isid = 0;
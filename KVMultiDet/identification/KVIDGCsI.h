@@ -41,15 +41,15 @@ public:
    };
 
 
-   virtual void Identify(Double_t x, Double_t y,
-                         KVIdentificationResult*) const;
+   virtual void IdentifyWithContext(Double_t x, Double_t y,
+                                    KVIdentificationResult*, IdentContext&) const;
 
    virtual Bool_t IsIdentifiable(Double_t x, Double_t y) const;
 
    KVIDZALine* GetZALine(Int_t z, Int_t a, Int_t&) const;
    KVIDZALine* GetZLine(Int_t z, Int_t&) const;
 
-   void IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A);
+   void IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A, IdentContext& ctx) const;
    virtual void Initialize();
    virtual TClass* DefaultIDLineClass()
    {
@@ -1258,7 +1258,7 @@ void KVIDGraph::TestIdentification(TH2F* data, TH1F* id_real,
             y = gRandom->Uniform(y0 - .5 * wy, y0 + .5 * wy);
             if (IsIdentifiable(x, y)) {
                Identify(x, y, idr);
-               if (AcceptIDForTest()) {
+               if (AcceptIDForTest(idr)) {
                   Float_t PID = idr->PID;
                   if (idr->Aident) PID = (idr->Z + 0.1 * (idr->PID - 2. * idr->Z));
                   id_real->Fill(PID, weight);
@@ -55,11 +55,12 @@ protected:
    virtual void BackwardsCompatibilityFix();
 
 public:
-   virtual Bool_t AcceptIDForTest()
+   virtual Bool_t AcceptIDForTest(const KVIdentificationResult*) const
    {
       // Used by TestIdentification.
       // The result of the identification may be excluded from the histograms of PID
-      // and PID vs. Eres, depending on e.g. some status code of the identification algorithm.
+      // and PID vs. Eres, depending on e.g. some status code of the identification algorithm
+      // (KVIdentificationResult::IDquality).
       // By default, this returns kTRUE (accept all), but may be overridden in child classes.
       return kTRUE;
    };
@@ -323,7 +324,8 @@ public:
    {
       return fYmax;
    };
-   // Return quality code related to previously-attempted identification using grid.
+   // Return quality code set by IsIdentifiable() when a point cannot be identified
+   // (the quality code of an identification is KVIdentificationResult::IDquality).
    // Redefine in child classes.
    virtual Int_t GetQualityCode() const
    {
@@ -35,7 +35,7 @@ with:
 </ul>
 
 <h3>Identification quality codes</h3>
-After each identification attempt, the value returned by GetQualityCode() indicates whether the
+After each identification attempt, the quality code KVIdentificationResult::IDquality indicates whether the
 identification was successful or not. The meaning of the different codes depends on the type
 of identification.
 
@@ -238,7 +238,7 @@ void KVIDZAFromZGrid::Initialize()
 
 }
 
-void KVIDZAFromZGrid::Identify(Double_t x, Double_t y, KVIdentificationResult* idr) const
+void KVIDZAFromZGrid::IdentifyWithContext(Double_t x, Double_t y, KVIdentificationResult* idr, IdentContext& ctx) const
 {
    // Fill the KVIdentificationResult object with the results of identification for point (x,y)
    // corresponding to some physically measured quantities related to a reconstructed nucleus.
@@ -264,25 +264,27 @@ void KVIDZAFromZGrid::Identify(Double_t x, Double_t y, KVIdentificationResult* i
    // (usual case), then particles between the two lines can have "real" masses
    // between 7.5 and 8.5, but their integer A will be =7 or =9, never 8.
    //
+   // All intermediate results are stored in 'ctx': the grid is not modified
+   // (see KVIDZAGrid::IdentifyWithContext).
 
    idr->IDOK = kFALSE;
-   if (!const_cast<KVIDZAFromZGrid*>(this)->FindFourEmbracingLines(x, y, "above")) {
-      const_cast < KVIDZAFromZGrid* >(this)->fICode = kICODE8;         // Z indetermine ou (x,y) hors limites
+   if (!FindFourEmbracingLines(x, y, "above", ctx)) {
+      ctx.fICode = kICODE8;         // Z indetermine ou (x,y) hors limites
       idr->IDquality = kICODE8;
       idr->SetComment("no identification: (x,y) out of range covered by grid");
       return;
    }
 
    Double_t Z;
-   const_cast < KVIDZAFromZGrid* >(this)->IdentZ(x, y, Z);
-   idr->IDquality = fICode;
-   if (fICode < kICODE4 || fICode == kICODE7) {
+   IdentZ(x, y, Z, ctx);
+   idr->IDquality = ctx.fICode;
+   if (ctx.fICode < kICODE4 || ctx.fICode == kICODE7) {
       idr->Zident = kTRUE;
    }
-   if (fICode < kICODE4) {
+   if (ctx.fICode < kICODE4) {
       idr->IDOK = kTRUE;
    }
-   idr->Z = Zint;
+   idr->Z = ctx.Zint;
    idr->PID = Z;
    idr->Aident = kFALSE;
 
@@ -295,7 +297,7 @@ void KVIDZAFromZGrid::Identify(Double_t x, Double_t y, KVIdentificationResult* i
          idr->IDOK = kTRUE;
       } else if (idr->IDquality == kICODE4) idr->IDquality = kICODE3;
    } else {
-      switch (fICode) {
+      switch (ctx.fICode) {
          case kICODE0:
             idr->SetComment("ok");
             break;
@@ -38,7 +38,7 @@ public:
 
 //   virtual void ReadAsciiFile(const Char_t* filename);
    virtual void ReadFromAsciiFile(std::ifstream& gridfile);
-   virtual void Identify(Double_t x, Double_t y, KVIdentificationResult*) const;
+   virtual void IdentifyWithContext(Double_t x, Double_t y, KVIdentificationResult*, IdentContext&) const;
    virtual double DeduceAfromPID(KVIdentificationResult* idr);
    void LoadPIDRanges();
    void ReloadPIDRanges();
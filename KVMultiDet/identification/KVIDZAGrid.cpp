@@ -24,6 +24,8 @@ $Id: KVIDZAGrid.cpp,v 1.24 2009/05/05 15:57:52 franklan Exp $
 #include "TCanvas.h"
 #include "TROOT.h"
 #include "KVIdentificationResult.h"
+#include "TEnv.h"
+#include <algorithm>
 
 ClassImp(KVIDZAGrid)
 /////////////////////////////////////////////////////////////////////////////
@@ -36,7 +38,7 @@ particles (if lines for several isotopes of each atomic number are drawn), or so
 (if only one isotope per Z is drawn, and if SetOnlyZId(kTRUE) is called).
 
 <h3>Identification quality codes</h3>
-After each identification attempt, the value returned by GetQualityCode() indicates whether the
+After each identification attempt, the quality code KVIdentificationResult::IDquality indicates whether the
 identification was successful or not. The meaning of the different codes depends on the type
 of identification.
 
@@ -70,6 +72,20 @@ In both cases, an acceptable identification is achieved if the quality code is k
 Points with codes kICODE4 or kICODE5 are normally considered as "noise" and should be rejected.<br>
 Points which are (vertically) out of range for this grid have code kICODE6 (point too far below) or kICODE7 (point too far above).<br>
 Points with code kICODE8 are totally out of range.
+
+<h3>Lookup map for fast identification</h3>
+For each point to identify, the lines of the grid lying around the point are located
+by FindFourEmbracingLines, which by default has to test the position of the point with respect
+to many lines of the grid. If SetUseLookupMap(kTRUE) is called before Initialize(), or if
+the configuration variable
+<code>
+KVIDZAGrid.LookupMap:  yes
+</code>
+is set, Initialize() will build a lookup map of the grid (see BuildLookupMap) which gives
+directly the lines situated above and below most points. The results of identification are exactly
+the same with or without the map: for points too close to lines which cross or overlap each other,
+the full search is performed.<br>
+If the lines of the grid are modified after calling Initialize(), Initialize() must be called again.
 <!-- */
 // --> END_HTML
 //
@@ -115,13 +131,10 @@ void KVIDZAGrid::init()
    fZMax = 0;
    fZMaxLine = 0;
 
-   kinfi = kinf = ksup = ksups = -1;
-   dinf = dsup = dinfi = dsups = 0.;
-   winf = wsup = winfi = wsups = 0.;
-   Zinfi = Zinf = Zsup = Zsups = Ainfi = Ainf = Asup = Asups = 0;
-   fDistanceClosest = -1.;
-   fClosest = fLsups = fLsup = fLinf = fLinfi = 0;
-   fIdxClosest = -1;
+   fICode = kICODE8;
+   fUseLookupMap = gEnv->GetValue("KVIDZAGrid.LookupMap", kFALSE);
+   fLookupMapNLines = 0;
+   fLookupMapScaleX = fLookupMapScaleY = 1.;
 }
 
 //_________________________________________________________________________//
@@ -459,7 +472,7 @@ void KVIDZAGrid::DrawLinesWithWidth()
 
 //______________________________________________________________________________________________//
 
-Bool_t KVIDZAGrid::FindFourEmbracingLines(Double_t x, Double_t y, const Char_t* position)
+Bool_t KVIDZAGrid::FindFourEmbracingLines(Double_t x, Double_t y, const Char_t* position, IdentContext& ctx) const
 {
    // This method will locate (at most) four lines close to the point (x,y), the point must
    // lie within the endpoints (in X) of each line (the lines "embrace" the point).
@@ -485,106 +498,176 @@ Bool_t KVIDZAGrid::FindFourEmbracingLines(Double_t x, Double_t y, const Char_t*
    // ordinate before hand in Initialize(), we simply use the order of lines in the list of identifiers.
    // The Z, A, width and distance to each of these lines are stored in the variables
    //      Zsups, Asups, wsups, dsups
-   // etc. etc. to be used by IdentZA or IdentZ.
-
-   kinfi = kinf = ksup = ksups = -1;
-   dinf = dsup = dinfi = dsups = 0.;
-   winf = wsup = winfi = wsups = 16000.;
-   Zinfi = Zinf = Zsup = Zsups = Ainfi = Ainf = Asup = Asups = -1;
-   fDistanceClosest = -1.;
-   fClosest = fLsups = fLsup = fLinf = fLinfi = 0;
-   fIdxClosest = -1;
+   // etc. etc. of the context 'ctx' to be used by IdentZA or IdentZ.
+
+   ctx.kinfi = ctx.kinf = ctx.ksup = ctx.ksups = -1;
+   ctx.dinf = ctx.dsup = ctx.dinfi = ctx.dsups = 0.;
+   ctx.winf = ctx.wsup = ctx.winfi = ctx.wsups = 16000.;
+   ctx.Zinfi = ctx.Zinf = ctx.Zsup = ctx.Zsups = ctx.Ainfi = ctx.Ainf = ctx.Asup = ctx.Asups = -1;
+   ctx.fDistanceClosest = -1.;
+   ctx.fClosest = ctx.fLsups = ctx.fLsup = ctx.fLinf = ctx.fLinfi = 0;
+   ctx.fIdxClosest = -1;
+
+   if (HasLookupMap() && !strcmp(position, "above")) {
+      Int_t found = FindFourEmbracingLinesWithLookupMap(x, y, ctx);
+      if (!found) return kFALSE; // no lines found
+      if (found > 0) {
+         SetEmbracingLineParameters(ctx);
+         return kTRUE;
+      }
+      // map cannot be used for this point: full search
+   }
 
-   fClosest = FindNearestEmbracingIDLine(x, y, position, "x", fIdxClosest, kinf, ksup, fDistanceClosest, dinf, dsup);
+   ctx.fClosest = FindNearestEmbracingIDLine(x, y, position, "x", ctx.fIdxClosest, ctx.kinf, ctx.ksup, ctx.fDistanceClosest, ctx.dinf, ctx.dsup);
 
-   if (!fClosest) return kFALSE; // no lines found
+   if (!ctx.fClosest) return kFALSE; // no lines found
 
    Int_t dummy = 0;
-   if (kinf > -1 && kinf == fIdxClosest) {
+   if (ctx.kinf > -1 && ctx.kinf == ctx.fIdxClosest) {
       //point is above closest line, closest line is "kinf"
       //need to look for 2 lines above (ksup, ksups) and 1 line below (kinfi)
-      fLinf = fClosest;
-      if (fLinf->InheritsFrom("KVIDZALine")) {
-         winf = ((KVIDZALine*)fLinf)->GetWidth();
-         Zinf = fLinf->GetZ();
-         Ainf = fLinf->GetA();
-      }
-      if (ksup > -1) {
-         fLsup = (KVIDLine*)GetIdentifierAt(ksup);
-         if (fLsup->InheritsFrom("KVIDZALine")) {
-            wsup = ((KVIDZALine*)fLsup)->GetWidth();
-            Zsup = fLsup->GetZ();
-            Asup = fLsup->GetA();
-         }
-      }
-   } else if (ksup > -1 && ksup == fIdxClosest) {
+      ctx.fLinf = ctx.fClosest;
+      if (ctx.ksup > -1) ctx.fLsup = (KVIDLine*)GetIdentifierAt(ctx.ksup);
+   } else if (ctx.ksup > -1 && ctx.ksup == ctx.fIdxClosest) {
       //point is below closest line, closest line is "ksup"
       //need to look for 1 line above (ksups) and 2 lines below (kinf, kinfi)
-      fLsup = fClosest;
-      if (fLsup->InheritsFrom("KVIDZALine")) {
-         wsup = ((KVIDZALine*)fLsup)->GetWidth();
-         Zsup = fLsup->GetZ();
-         Asup = fLsup->GetA();
-      }
-      if (kinf > -1) {
-         fLinf = (KVIDLine*)GetIdentifierAt(kinf);
-         if (fLinf->InheritsFrom("KVIDZALine")) {
-            winf = ((KVIDZALine*)fLinf)->GetWidth();
-            Zinf = fLinf->GetZ();
-            Ainf = fLinf->GetA();
-         }
-      }
+      ctx.fLsup = ctx.fClosest;
+      if (ctx.kinf > -1) ctx.fLinf = (KVIDLine*)GetIdentifierAt(ctx.kinf);
    } else {
       Error("FindFourEmbracingLines",
             "I do not understand the result of FindNearestEmbracingIDLine!!!");
       return kFALSE;
    }
 
-
-   if (kinf > -1) {
+   if (ctx.kinf > -1) {
       // look for kinfi line -> next line below 'inf' line
-      kinfi = kinf;
-      fLinfi = FindNextEmbracingLine(kinfi, -1, x, y, "x");
-      if (!fLinfi) kinfi = -1;   // no 'infi' line found
-      else {
-         dinfi = TMath::Abs(fLinfi->DistanceToLine(x, y, dummy));
-         if (fLinfi->InheritsFrom("KVIDZALine")) {
-            winfi = ((KVIDZALine*)fLinfi)->GetWidth();
-            Zinfi = fLinfi->GetZ();
-            Ainfi = fLinfi->GetA();
-         }
-      }
+      ctx.kinfi = ctx.kinf;
+      ctx.fLinfi = FindNextEmbracingLine(ctx.kinfi, -1, x, y, "x");
+      if (!ctx.fLinfi) ctx.kinfi = -1;   // no 'infi' line found
+      else ctx.dinfi = TMath::Abs(ctx.fLinfi->DistanceToLine(x, y, dummy));
    }
-   if (ksup > -1) {
+   if (ctx.ksup > -1) {
       // look for ksups line -> next line above 'sup' line
-      ksups = ksup;
-      fLsups = FindNextEmbracingLine(ksups, 1, x, y, "x");
-      if (!fLsups) ksups = -1;   // no 'sups' line found
-      else {
-         dsups = TMath::Abs(fLsups->DistanceToLine(x, y, dummy));
-         if (fLsups->InheritsFrom("KVIDZALine")) {
-            wsups = ((KVIDZALine*)fLsups)->GetWidth();
-            Zsups = fLsups->GetZ();
-            Asups = fLsups->GetA();
-         }
-      }
+      ctx.ksups = ctx.ksup;
+      ctx.fLsups = FindNextEmbracingLine(ctx.ksups, 1, x, y, "x");
+      if (!ctx.fLsups) ctx.ksups = -1;   // no 'sups' line found
+      else ctx.dsups = TMath::Abs(ctx.fLsups->DistanceToLine(x, y, dummy));
    }
+   SetEmbracingLineParameters(ctx);
    return kTRUE;
 }
 
+//______________________________________________________________________________________________//
+
+void KVIDZAGrid::SetEmbracingLineParameters(IdentContext& ctx) const
+{
+   // Set Z, A and width of each of the (at most) four lines found by FindFourEmbracingLines
+
+   if (ctx.fLinf && ctx.fLinf->InheritsFrom(KVIDZALine::Class())) {
+      ctx.winf = ((KVIDZALine*)ctx.fLinf)->GetWidth();
+      ctx.Zinf = ctx.fLinf->GetZ();
+      ctx.Ainf = ctx.fLinf->GetA();
+   }
+   if (ctx.fLsup && ctx.fLsup->InheritsFrom(KVIDZALine::Class())) {
+      ctx.wsup = ((KVIDZALine*)ctx.fLsup)->GetWidth();
+      ctx.Zsup = ctx.fLsup->GetZ();
+      ctx.Asup = ctx.fLsup->GetA();
+   }
+   if (ctx.fLinfi && ctx.fLinfi->InheritsFrom(KVIDZALine::Class())) {
+      ctx.winfi = ((KVIDZALine*)ctx.fLinfi)->GetWidth();
+      ctx.Zinfi = ctx.fLinfi->GetZ();
+      ctx.Ainfi = ctx.fLinfi->GetA();
+   }
+   if (ctx.fLsups && ctx.fLsups->InheritsFrom(KVIDZALine::Class())) {
+      ctx.wsups = ((KVIDZALine*)ctx.fLsups)->GetWidth();
+      ctx.Zsups = ctx.fLsups->GetZ();
+      ctx.Asups = ctx.fLsups->GetA();
+   }
+}
+
+//______________________________________________________________________________________________//
+
+Int_t KVIDZAGrid::FindFourEmbracingLinesWithLookupMap(Double_t x, Double_t y, IdentContext& ctx) const
+{
+   // Locate the (at most) four lines around point (x,y) using the lookup map built by
+   // BuildLookupMap. Gives exactly the same result as the full search in FindFourEmbracingLines
+   // with position="above".
+   // Returns 1 if lines were found, 0 if there are no lines embracing the point, or -1 if the
+   // map cannot be used for this point (point too close to crossing/overlapping lines, lying exactly
+   // on the boundary of a band of the map, or grid modified since map was built) in which case
+   // the full search has to be performed.
+
+   if (fLookupMapNLines != GetNumberOfIdentifiers()
+         || fLookupMapScaleX != fLastScaleX || fLookupMapScaleY != fLastScaleY) return -1;
+
+   std::vector<Double_t>::const_iterator it = std::upper_bound(fLookupMapX.begin(), fLookupMapX.end(), x);
+   if (it == fLookupMapX.begin()) return 0; // point to the left of all lines
+   if (*(it - 1) == x) return -1; // point on boundary of band (maybe on endpoint of a line)
+   if (it == fLookupMapX.end()) return 0; // point to the right of all lines
+   Int_t band = (it - fLookupMapX.begin()) - 1;
+   Int_t first = fLookupMapBand[band];
+   Int_t nlines = fLookupMapBand[band + 1] - first;
+   if (!nlines) return 0; // no lines in band
+
+   // all lines [0,p) in band are below the point, all lines [q,nlines) are above it
+   const Double_t* ymax = &fLookupMapYmax[first];
+   const Double_t* ymin = &fLookupMapYmin[first];
+   Int_t p = std::lower_bound(ymax, ymax + nlines, y) - ymax;
+   Int_t q = std::upper_bound(ymin, ymin + nlines, y) - ymin;
+   if (q < p || q > p + 1) return -1;
+
+   // number of lines below the point
+   const Int_t* line = &fLookupMapLine[first];
+   Int_t nbelow = p;
+   if (q > p && ((KVIDLine*)GetIdentifierAt(line[p]))->WhereAmI(x, y, "above")) ++nbelow;
+
+   Int_t dummy = 0;
+   ctx.dinf = ctx.dsup = -1.;
+   if (nbelow > 0) {
+      ctx.kinf = line[nbelow - 1];
+      ctx.fLinf = (KVIDLine*)GetIdentifierAt(ctx.kinf);
+      ctx.dinf = TMath::Abs(ctx.fLinf->DistanceToLine(x, y, dummy));
+   }
+   if (nbelow < nlines) {
+      ctx.ksup = line[nbelow];
+      ctx.fLsup = (KVIDLine*)GetIdentifierAt(ctx.ksup);
+      ctx.dsup = TMath::Abs(ctx.fLsup->DistanceToLine(x, y, dummy));
+   }
+   if (nbelow > 1) {
+      ctx.kinfi = line[nbelow - 2];
+      ctx.fLinfi = (KVIDLine*)GetIdentifierAt(ctx.kinfi);
+      ctx.dinfi = TMath::Abs(ctx.fLinfi->DistanceToLine(x, y, dummy));
+   }
+   if (nbelow < nlines - 1) {
+      ctx.ksups = line[nbelow + 1];
+      ctx.fLsups = (KVIDLine*)GetIdentifierAt(ctx.ksups);
+      ctx.dsups = TMath::Abs(ctx.fLsups->DistanceToLine(x, y, dummy));
+   }
+   if (ctx.fLsup && (!ctx.fLinf || ctx.dsup < ctx.dinf)) {
+      ctx.fClosest = ctx.fLsup;
+      ctx.fIdxClosest = ctx.ksup;
+      ctx.fDistanceClosest = ctx.dsup;
+   } else {
+      ctx.fClosest = ctx.fLinf;
+      ctx.fIdxClosest = ctx.kinf;
+      ctx.fDistanceClosest = ctx.dinf;
+   }
+   return 1;
+}
+
 //_________________________________________________________________________//
 
-void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
+void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A, IdentContext& ctx) const
 {
    //Finds Z, A and 'real A' for point (x,y) once closest lines to point have been found
-   //by calling method FindFourEmbracingLines beforehand.
+   //by calling method FindFourEmbracingLines beforehand with the same context 'ctx'.
    //This is a line-for-line copy of the latter part of IdnCsOr, even the same
    //variable names and comments have been used (as much as possible).
 
-   fICode = kICODE0;
+   ctx.fICode = kICODE0;
    Z = -1;
    A = -1;
-   Aint = 0;
+   ctx.Aint = 0;
    /*    cout << "kinfi = " << kinfi << " Zinfi = " << Zinfi << "  Ainfi = " << Ainfi << "  winfi = " << winfi << "  dinfi = " << dinfi << endl;
       cout << "kinf = " << kinf << " Zinf = " << Zinf << "  Ainf = " << Ainf << "  winf = " << winf << "  dinf = " << dinf << endl;
       cout << "ksup = " << ksup << " Zsup = " << Zsup << "  Asup = " << Asup << "  wsup = " << wsup << "  dsup = " << dsup << endl;
@@ -596,37 +679,37 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
    Int_t ix1, ix2;
    yy = y1 = y2 = 0;
    ix1 = ix2 = 0;
-   if (ksup > -1) {
-      if (kinf > -1) {
+   if (ctx.ksup > -1) {
+      if (ctx.kinf > -1) {
          //cout << " /******************* 2 lignes encadrant le point ont ete trouvees ************************/" << endl;
-         Double_t dt = dinf + dsup;     //distance between the 2 lines
-         if (Zinf == Zsup) {
+         Double_t dt = ctx.dinf + ctx.dsup;     //distance between the 2 lines
+         if (ctx.Zinf == ctx.Zsup) {
             //   cout << "      /****************meme Z**************/" << endl;
-            Z = Zinf;
-            Int_t dA = Asup - Ainf;
+            Z = ctx.Zinf;
+            Int_t dA = ctx.Asup - ctx.Ainf;
             Double_t dist = dt / dA;    //distance between the 2 lines normalised to difference in A of lines
             /*** A = Asup ***/
-            if (dinf > dsup) {  //point is closest to upper line, 'sup' line
+            if (ctx.dinf > ctx.dsup) {  //point is closest to upper line, 'sup' line
                ibif = 1;
-               k = ksup;
-               yy = -dsup;
-               A = Asup;
-               Aint = Asup;
-               if (ksups > -1) {        // there is a 'sups' line above the 2 which encadrent le point
-                  y2 = dsups - dsup;
-                  if (Zsups == Zsup) {
+               k = ctx.ksup;
+               yy = -ctx.dsup;
+               A = ctx.Asup;
+               ctx.Aint = ctx.Asup;
+               if (ctx.ksups > -1) {        // there is a 'sups' line above the 2 which encadrent le point
+                  y2 = ctx.dsups - ctx.dsup;
+                  if (ctx.Zsups == ctx.Zsup) {
                      ibif = 0;
                      y2 /= 2.;
-                     ix2 = Asups - Asup;
+                     ix2 = ctx.Asups - ctx.Asup;
                   } else {
                      y2 /= 2.;
-                     Double_t x2 = wsup;
+                     Double_t x2 = ctx.wsup;
                      x2 = 0.5 * TMath::Max(x2, dist);
                      y2 = TMath::Min(y2, x2);
                      ix2 = 1;
                   }
                } else {       // ksups == -1 i.e. no 'sups' line
-                  y2 = wsup;
+                  y2 = ctx.wsup;
                   y2 = 0.5 * TMath::Max(y2, dist);
                   ix2 = 1;
                }
@@ -636,24 +719,24 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
             /*** A = Ainf ***/
             else {              //point is closest to lower line, 'inf' line
                ibif = 2;
-               k = kinf;
-               yy = dinf;
-               A = Ainf;
-               Aint = Ainf;
-               if (kinfi > -1) {        // there is a 'infi' line below the 2 which encadrent le point
-                  y1 = 0.5 * (dinfi - dinf);
-                  if (Zinfi == Zinf) {
+               k = ctx.kinf;
+               yy = ctx.dinf;
+               A = ctx.Ainf;
+               ctx.Aint = ctx.Ainf;
+               if (ctx.kinfi > -1) {        // there is a 'infi' line below the 2 which encadrent le point
+                  y1 = 0.5 * (ctx.dinfi - ctx.dinf);
+                  if (ctx.Zinfi == ctx.Zinf) {
                      ibif = 0;
-                     ix1 = Ainfi - Ainf;
+                     ix1 = ctx.Ainfi - ctx.Ainf;
                      y1 = -y1;
                   } else {
-                     Double_t x1 = winf;
+                     Double_t x1 = ctx.winf;
                      x1 = 0.5 * TMath::Max(x1, dist);
                      y1 = -TMath::Min(y1, x1);
                      ix1 = -1;
                   }
                } else {       // kinfi = -1 i.e. no 'infi' line
-                  y1 = winf;
+                  y1 = ctx.winf;
                   y1 = -0.5 * TMath::Max(y1, dist);
                   ix1 = -1;
                }
@@ -664,18 +747,18 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
             //cout << "         /****************Z differents**************/ " << endl;
             /*** Z = Zsup ***/
             ibif = 3;
-            if (dinf > dsup) {  // closest to upper 'sup' line
-               k = ksup;
-               yy = -dsup;
-               Z = Zsup;
-               A = Asup;
-               Aint = Asup;
-               y1 = 0.5 * wsup;
-               if (ksups > -1) {        // there is a 'sups' line above the 2 which encadrent the point
-                  y2 = dsups - dsup;
-                  if (Zsups == Zsup) {
+            if (ctx.dinf > ctx.dsup) {  // closest to upper 'sup' line
+               k = ctx.ksup;
+               yy = -ctx.dsup;
+               Z = ctx.Zsup;
+               A = ctx.Asup;
+               ctx.Aint = ctx.Asup;
+               y1 = 0.5 * ctx.wsup;
+               if (ctx.ksups > -1) {        // there is a 'sups' line above the 2 which encadrent the point
+                  y2 = ctx.dsups - ctx.dsup;
+                  if (ctx.Zsups == ctx.Zsup) {
                      ibif = 2;
-                     ix2 = Asups - Asup;
+                     ix2 = ctx.Asups - ctx.Asup;
                      Double_t x1 = y2 / ix2 / 2.;
                      y1 = TMath::Max(y1, x1);
                      y1 = -TMath::Min(y1, dt / 2.);
@@ -689,7 +772,7 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
                      ix1 = -1;
                   }
                } else {       // ksups == -1, i.e. no 'sups' line
-                  fICode = kICODE7;     //a gauche de la ligne fragment, Z est alors un Zmin et le plus probable
+                  ctx.fICode = kICODE7;     //a gauche de la ligne fragment, Z est alors un Zmin et le plus probable
                   y2 = y1;
                   ix2 = 1;
                   y1 = -TMath::Min(y1, dt / 2.);
@@ -698,17 +781,17 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
             }
             /*** Z = Zinf ***/
             else {              // closest to lower 'inf' line
-               k = kinf;
-               yy = dinf;
-               Z = Zinf;
-               A = Ainf;
-               Aint = Ainf;
-               y2 = 0.5 * winf;
-               if (kinfi > -1) {        // there is a 'infi' line below the 2 which encadrent the point
-                  y1 = dinfi - dinf;
-                  if (Zinfi == Zinf) {
+               k = ctx.kinf;
+               yy = ctx.dinf;
+               Z = ctx.Zinf;
+               A = ctx.Ainf;
+               ctx.Aint = ctx.Ainf;
+               y2 = 0.5 * ctx.winf;
+               if (ctx.kinfi > -1) {        // there is a 'infi' line below the 2 which encadrent the point
+                  y1 = ctx.dinfi - ctx.dinf;
+                  if (ctx.Zinfi == ctx.Zinf) {
                      ibif = 1;
-                     ix1 = Ainfi - Ainf;
+                     ix1 = ctx.Ainfi - ctx.Ainf;
                      Double_t x2 = -y1 / ix1 / 2.;
                      y2 = TMath::Max(y2, x2);
                      y2 = TMath::Min(y2, dt / 2.);
@@ -729,20 +812,20 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
             }
          }
       }//if(kinf>-1)...
-      else if (Zsup > 0) {
+      else if (ctx.Zsup > 0) {
          //cout<<" /****************** Seule une ligne superieure a ete trouvee *********************/" << endl;
          ibif = 3;
-         k = ksup;
-         yy = -dsup;
-         Z = Zsup;
-         A = Asup;
-         Aint = Asup;
-         y1 = 0.5 * wsup;
-         if (ksups > -1) {      // there is a 'sups' line above the closest line to the point
-            y2 = dsups - dsup;
-            if (Zsups == Zsup) {
+         k = ctx.ksup;
+         yy = -ctx.dsup;
+         Z = ctx.Zsup;
+         A = ctx.Asup;
+         ctx.Aint = ctx.Asup;
+         y1 = 0.5 * ctx.wsup;
+         if (ctx.ksups > -1) {      // there is a 'sups' line above the closest line to the point
+            y2 = ctx.dsups - ctx.dsup;
+            if (ctx.Zsups == ctx.Zsup) {
                ibif = 2;
-               ix2 = Asups - Asup;
+               ix2 = ctx.Asups - ctx.Asup;
                Double_t x1 = y2 / ix2 / 2.;
                y1 = -TMath::Max(y1, x1);
                ix1 = -1;
@@ -755,37 +838,37 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
                ix1 = -1;
             }
          } else {             // no 'sups' line above closest line
-            fICode = kICODE7;   //Z est alors un Zmin et le plus probable
+            ctx.fICode = kICODE7;   //Z est alors un Zmin et le plus probable
             y2 = y1;
             ix2 = 1;
             y1 = -y1;
             ix1 = -1;
          }
          if (yy >= y1)
-            fICode = kICODE0; // we are within the 'natural width' of the last line
+            ctx.fICode = kICODE0; // we are within the 'natural width' of the last line
          else {
-            fICode = kICODE6; // we are too far from first line to extrapolate correctly
-            Z = Zsup - 1; // give Z below first line of grid, but this is an upper limit
+            ctx.fICode = kICODE6; // we are too far from first line to extrapolate correctly
+            Z = ctx.Zsup - 1; // give Z below first line of grid, but this is an upper limit
          }
       } else {
-         fICode = kICODE8;      //  Z indetermine ou (x,y) hors limites
+         ctx.fICode = kICODE8;      //  Z indetermine ou (x,y) hors limites
       }
-   } else if (kinf > -1) {
+   } else if (ctx.kinf > -1) {
 
       //cout <<"/****************** Seule une ligne inferieure a ete trouvee ***********************/" << endl;
 
       ibif = 3;
-      k = kinf;
-      Z = Zinf;
-      A = Ainf;
-      Aint = Ainf;
-      yy = dinf;
-      y2 = 0.5 * winf;
-      if (kinfi > -1) {
-         y1 = dinfi - dinf;
-         if (Zinfi == Zinf) {
+      k = ctx.kinf;
+      Z = ctx.Zinf;
+      A = ctx.Ainf;
+      ctx.Aint = ctx.Ainf;
+      yy = ctx.dinf;
+      y2 = 0.5 * ctx.winf;
+      if (ctx.kinfi > -1) {
+         y1 = ctx.dinfi - ctx.dinf;
+         if (ctx.Zinfi == ctx.Zinf) {
             ibif = 1;
-            ix1 = Ainfi - Ainf;
+            ix1 = ctx.Ainfi - ctx.Ainf;
             Double_t x2 = -y1 / ix1 / 2.;
             y2 = TMath::Max(y2, x2);
             ix2 = 1;
@@ -801,30 +884,30 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
          ix2 = 1;
       }
       if (yy <= y2)
-         fICode = kICODE0; // we are within the 'natural width' of the last line
+         ctx.fICode = kICODE0; // we are within the 'natural width' of the last line
       else
-         fICode = kICODE7; // we are too far from last line to extrapolate correctly
+         ctx.fICode = kICODE7; // we are too far from last line to extrapolate correctly
 
    }
    /*****************Aucune ligne n'a ete trouvee*********************************/
    else {
-      fICode = kICODE8;         // Z indetermine ou (x,y) hors limites
+      ctx.fICode = kICODE8;         // Z indetermine ou (x,y) hors limites
    }
    /****************Test des bornes********************************************/
-   if (k > -1 && fICode == kICODE0) {
+   if (k > -1 && ctx.fICode == kICODE0) {
       if (yy > y2)
-         fICode = kICODE4;      // Z ok, masse hors limite superieure ou egale a A
+         ctx.fICode = kICODE4;      // Z ok, masse hors limite superieure ou egale a A
    }
-   if (k > -1 && (fICode == kICODE0 || fICode == kICODE7)) {
+   if (k > -1 && (ctx.fICode == kICODE0 || ctx.fICode == kICODE7)) {
       if (yy < y1)
-         fICode = kICODE5;      // Z ok, masse hors limite inferieure ou egale a A
+         ctx.fICode = kICODE5;      // Z ok, masse hors limite inferieure ou egale a A
    }
-   if (fICode == kICODE4 || fICode == kICODE5) {
+   if (ctx.fICode == kICODE4 || ctx.fICode == kICODE5) {
       A = -1;
-      Aint = 0;
+      ctx.Aint = 0;
    }
    /****************Interpolation de la masse: da = f*log(1+b*dy)********************/
-   if (fICode == kICODE0) {
+   if (ctx.fICode == kICODE0) {
       Double_t deltaA = 0.;
       Bool_t i = kFALSE;
       Double_t dt, dist = y1 * y2;
@@ -877,18 +960,18 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
       }
    }
    /***************D'autres masses sont-elles possibles ?*************************/
-   if (fICode == kICODE0 && (ibif > 0 && ibif < 4)) {
+   if (ctx.fICode == kICODE0 && (ibif > 0 && ibif < 4)) {
       if (ibif != 2) {        /***Masse superieure***/
          //We look at next line in the complete list of lines, after the closest line.
          //If it has the same Z as the closest line, but was excluded from research for closest line
          //because the point lies outside the endpoints, there remains a doubt about the mass:
          //on rajoute 1 a fICode, effectivement on le met = kICODE1
-         Int_t idx = fIdxClosest; // index of closest line
+         Int_t idx = ctx.fIdxClosest; // index of closest line
          if (idx > -1 && ++idx < GetNumberOfIdentifiers()) {
             KVIDentifier* nextline = GetIdentifierAt(idx);
             if (nextline->GetZ() == Z
                   && !((KVIDLine*)nextline)->IsBetweenEndPoints(x, y, "x")) {
-               fICode++;        // Z ok, mais les masses superieures a A sont possibles
+               ctx.fICode++;        // Z ok, mais les masses superieures a A sont possibles
                //cout <<"//on rajoute 1 a fICode, effectivement on le met = kICODE1" << endl;
             }
          }
@@ -898,12 +981,12 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
          //If it has the same Z as the closest line, but was excluded from research for closest line
          //because the point lies outside the endpoints, there remains a doubt about the mass:
          //on rajoute 2 a fICode, so it can be = kICODE2 or kICODE3
-         Int_t idx = fIdxClosest;
+         Int_t idx = ctx.fIdxClosest;
          if (idx > -1 && --idx >= 0) {
             KVIDentifier* nextline = GetIdentifierAt(idx);
             if (nextline->GetZ() == Z
                   && !((KVIDLine*)nextline)->IsBetweenEndPoints(x, y, "x")) {
-               fICode += 2;
+               ctx.fICode += 2;
                //cout << "//on rajoute 2 a fICode, so it can be = kICODE2 or kICODE3" << endl;
             }
          }
@@ -915,16 +998,17 @@ void KVIDZAGrid::IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A)
 
 //_________________________________________________________________________//
 
-void KVIDZAGrid::IdentZ(Double_t x, Double_t y, Double_t& Z)
+void KVIDZAGrid::IdentZ(Double_t x, Double_t y, Double_t& Z, IdentContext& ctx) const
 {
-   // Finds Z & 'real Z' for point (x,y) once closest lines to point have been found (see GetNearestIDLine).
+   // Finds Z & 'real Z' for point (x,y) once closest lines to point have been found
+   // by calling method FindFourEmbracingLines beforehand with the same context 'ctx'.
    // This is is based on the algorithm developed by L. Tassan-Got in IdnCsOr, even the same
    // variable names and comments have been used (as much as possible).
 
-   fICode = kICODE0;
+   ctx.fICode = kICODE0;
    Z = -1;
-   Aint = 0;
-   Zint = 0;
+   ctx.Aint = 0;
+   ctx.Zint = 0;
    /*   cout << "kinfi = " << kinfi << " Zinfi = " << Zinfi << "  Ainfi = " << Ainfi << "  winfi = " << winfi << "  dinfi = " << dinfi << endl;
       cout << "kinf = " << kinf << " Zinf = " << Zinf << "  Ainf = " << Ainf << "  winf = " << winf << "  dinf = " << dinf << endl;
       cout << "ksup = " << ksup << " Zsup = " << Zsup << "  Asup = " << Asup << "  wsup = " << wsup << "  dsup = " << dsup << endl;
@@ -937,31 +1021,31 @@ void KVIDZAGrid::IdentZ(Double_t x, Double_t y, Double_t& Z)
    yy = y1 = y2 = 0;
    ix1 = ix2 = 0;
 
-   if (ksup > -1) {         // there is a line above the point
-      if (kinf > -1) {              // there is a line below the point
+   if (ctx.ksup > -1) {         // there is a line above the point
+      if (ctx.kinf > -1) {              // there is a line below the point
 
          //printf("------------>/*  We found a line above and a line below the point */\n");
 
-         Double_t dt = dinf + dsup;     //distance between the 2 lines
-         Int_t dZ = Zsup - Zinf;
+         Double_t dt = ctx.dinf + ctx.dsup;     //distance between the 2 lines
+         Int_t dZ = ctx.Zsup - ctx.Zinf;
          Double_t dist = dt / (1.0 * dZ);  //distance between the 2 lines normalised to difference in Z of lines
 
          /*** Z = Zsup ***/
-         if (dinf > dsup) {  //point is closest to upper line, 'sup' line
+         if (ctx.dinf > ctx.dsup) {  //point is closest to upper line, 'sup' line
             ibif = 1;
-            k = ksup;
-            yy = -dsup;
-            Z = Zsup;
-            Zint = Zsup;
-            Aint = Asup;
-            if (ksups > -1) {        // there is a 'sups' line above the 2 which encadrent le point
-               y2 = dsups - dsup;
+            k = ctx.ksup;
+            yy = -ctx.dsup;
+            Z = ctx.Zsup;
+            ctx.Zint = ctx.Zsup;
+            ctx.Aint = ctx.Asup;
+            if (ctx.ksups > -1) {        // there is a 'sups' line above the 2 which encadrent le point
+               y2 = ctx.dsups - ctx.dsup;
 
                ibif = 0;
                y2 /= 2.;
-               ix2 = Zsups - Zsup;
+               ix2 = ctx.Zsups - ctx.Zsup;
             } else {       // ksups == -1 i.e. no 'sups' line
-               y2 = wsup;
+               y2 = ctx.wsup;
                y2 = 0.5 * TMath::Max(y2, dist);
                ix2 = 1;
             }
@@ -971,20 +1055,20 @@ void KVIDZAGrid::IdentZ(Double_t x, Double_t y, Double_t& Z)
          /*** Z = Zinf ***/
          else {              //point is closest to lower line, 'inf' line
             ibif = 2;
-            k = kinf;
-            yy = dinf;
-            Z = Zinf;
-            Zint = Zinf;
-            Aint = Ainf;
-            if (kinfi > -1) {        // there is a 'infi' line below the 2 which encadrent le point
-               y1 = 0.5 * (dinfi - dinf);
+            k = ctx.kinf;
+            yy = ctx.dinf;
+            Z = ctx.Zinf;
+            ctx.Zint = ctx.Zinf;
+            ctx.Aint = ctx.Ainf;
+            if (ctx.kinfi > -1) {        // there is a 'infi' line below the 2 which encadrent le point
+               y1 = 0.5 * (ctx.dinfi - ctx.dinf);
 
                ibif = 0;
-               ix1 = Zinfi - Zinf;
+               ix1 = ctx.Zinfi - ctx.Zinf;
                y1 = -y1;
 
             } else {       // kinfi = -1 i.e. no 'infi' line
-               y1 = winf;
+               y1 = ctx.winf;
                y1 = -0.5 * TMath::Max(y1, dist);
                ix1 = -1;
             }
@@ -997,17 +1081,17 @@ void KVIDZAGrid::IdentZ(Double_t x, Double_t y, Double_t& Z)
          //printf("------------>/*  Only a line above the point was found, no line below */\n");
          /* This means the point is below the first Z line of the grid (?) */
          ibif = 3;
-         k = ksup;
-         yy = -dsup;
-         Z = Zsup;
-         Zint = Zsup;
-         Aint = Asup;
-         y1 = 0.5 * wsup;
-         if (ksups > -1) {      // there is a 'sups' line above the closest line to the point
-            y2 = dsups - dsup;
+         k = ctx.ksup;
+         yy = -ctx.dsup;
+         Z = ctx.Zsup;
+         ctx.Zint = ctx.Zsup;
+         ctx.Aint = ctx.Asup;
+         y1 = 0.5 * ctx.wsup;
+         if (ctx.ksups > -1) {      // there is a 'sups' line above the closest line to the point
+            y2 = ctx.dsups - ctx.dsup;
 
             ibif = 2;
-            ix2 = Zsups - Zsup;
+            ix2 = ctx.Zsups - ctx.Zsup;
             Double_t x1 = y2 / ix2 / 2.;
             y1 = -TMath::Max(y1, x1);
             ix1 = -1;
@@ -1020,30 +1104,30 @@ void KVIDZAGrid::IdentZ(Double_t x, Double_t y, Double_t& Z)
             ix1 = -1;
          }
          if (yy >= y1)
-            fICode = kICODE0; // we are within the 'natural width' of the last line
+            ctx.fICode = kICODE0; // we are within the 'natural width' of the last line
          else {
-            fICode = kICODE6; // we are too far from first line to extrapolate correctly
-            Z = Zsup - 1; // give Z below first line of grid, but this is an upper limit
-            Zint = Zsup - 1;
-            Aint = 0;
+            ctx.fICode = kICODE6; // we are too far from first line to extrapolate correctly
+            Z = ctx.Zsup - 1; // give Z below first line of grid, but this is an upper limit
+            ctx.Zint = ctx.Zsup - 1;
+            ctx.Aint = 0;
          }
       }
    }  //if(ksup>-1)***************************************************************
-   else if (kinf > -1) {
+   else if (ctx.kinf > -1) {
 
       //printf("------------>/*  Only a line below the point was found, no line above */\n");
       /* This means the point is above the last Z line of the grid (?) */
       ibif = 3;
-      k = kinf;
-      Z = Zinf;
-      Zint = Zinf;
-      Aint = Ainf;
-      yy = dinf;
-      y2 = 0.5 * winf;
-      if (kinfi > -1) { // there is a 'infi' line below the closest line to the point
-         y1 = dinfi - dinf;
+      k = ctx.kinf;
+      Z = ctx.Zinf;
+      ctx.Zint = ctx.Zinf;
+      ctx.Aint = ctx.Ainf;
+      yy = ctx.dinf;
+      y2 = 0.5 * ctx.winf;
+      if (ctx.kinfi > -1) { // there is a 'infi' line below the closest line to the point
+         y1 = ctx.dinfi - ctx.dinf;
          ibif = 1;
-         ix1 = Zinfi - Zinf;
+         ix1 = ctx.Zinfi - ctx.Zinf;
          Double_t x2 = -y1 / ix1 / 2.;
          y2 = TMath::Max(y2, x2);
          ix2 = 1;
@@ -1054,35 +1138,35 @@ void KVIDZAGrid::IdentZ(Double_t x, Double_t y, Double_t& Z)
          ix2 = 1;
       }
       if (yy <= y2)
-         fICode = kICODE0; // we are within the 'natural width' of the last line
+         ctx.fICode = kICODE0; // we are within the 'natural width' of the last line
       else {
-         fICode = kICODE7; // we are too far from last line to extrapolate correctly
-         Z = Zinf + 1; // give Z above last line in grid, it is a lower limit
-         Zint = Zinf + 1;
-         Aint = 0;//calculate mass from Z
+         ctx.fICode = kICODE7; // we are too far from last line to extrapolate correctly
+         Z = ctx.Zinf + 1; // give Z above last line in grid, it is a lower limit
+         ctx.Zint = ctx.Zinf + 1;
+         ctx.Aint = 0;//calculate mass from Z
       }
 
    }
    /*no lines found at all*/
    else {
-      fICode = kICODE8;         // Z indetermine ou (x,y) hors limites
+      ctx.fICode = kICODE8;         // Z indetermine ou (x,y) hors limites
    }
 
 
    /****************Test des bornes********************************************/
-   if (k > -1 && fICode == kICODE0) {
+   if (k > -1 && ctx.fICode == kICODE0) {
       if (yy > y2)
-         fICode = kICODE4;      // Z ok, masse hors limite superieure ou egale a A
+         ctx.fICode = kICODE4;      // Z ok, masse hors limite superieure ou egale a A
    }
-   if (k > -1 && fICode == kICODE0) {
+   if (k > -1 && ctx.fICode == kICODE0) {
       if (yy < y1)
-         fICode = kICODE5;      // Z ok, masse hors limite inferieure ou egale a A
+         ctx.fICode = kICODE5;      // Z ok, masse hors limite inferieure ou egale a A
    }
-   if (fICode == kICODE4 || fICode == kICODE5) Aint = 0;
+   if (ctx.fICode == kICODE4 || ctx.fICode == kICODE5) ctx.Aint = 0;
 
    /****************Interpolation to find 'real Z': dz = f*log(1+b*dy)********************/
 
-   if (fICode < kICODE6) {
+   if (ctx.fICode < kICODE6) {
       Double_t deltaZ = 0.;
       Bool_t i = kFALSE;
       Double_t dt, dist = y1 * y2;
@@ -1135,18 +1219,18 @@ void KVIDZAGrid::IdentZ(Double_t x, Double_t y, Double_t& Z)
       }
    }
    /***************Is there still a doubt about the Z ?*************************/
-   if (fICode == kICODE0 && (ibif > 0 && ibif < 4)) {
+   if (ctx.fICode == kICODE0 && (ibif > 0 && ibif < 4)) {
       /***z superieure***/
       if (ibif != 2) {
          //We look at next line in the complete list of lines, after the closest line.
          //If it was excluded from research for closest line
          //because the point lies outside the endpoints, there remains a doubt about the Z:
          //on rajoute 1 a fICode, effectivement on le met = kICODE1
-         Int_t idx = fIdxClosest;
+         Int_t idx = ctx.fIdxClosest;
          if (idx > -1 && ++idx < GetNumberOfIdentifiers()) {
             KVIDLine* nextline = (KVIDLine*)GetIdentifierAt(idx);
             if (!nextline->IsBetweenEndPoints(x, y, "x")) {
-               fICode++;        // Z might be bigger than we think
+               ctx.fICode++;        // Z might be bigger than we think
                //cout <<"//on rajoute 1 a fICode, effectivement on le met = kICODE1" << endl;
             }
          }
@@ -1157,11 +1241,11 @@ void KVIDZAGrid::IdentZ(Double_t x, Double_t y, Double_t& Z)
          //If it was excluded from research for closest line
          //because the point lies outside the endpoints, there remains a doubt about the Z:
          //on rajoute 2 a fICode, so it can be = kICODE2 or kICODE3
-         Int_t idx = fIdxClosest;
+         Int_t idx = ctx.fIdxClosest;
          if (idx > -1 && --idx >= 0) {
             KVIDLine* nextline = (KVIDLine*) GetIdentifierAt(idx);
             if (!nextline->IsBetweenEndPoints(x, y, "x")) {
-               fICode += 2;
+               ctx.fICode += 2;
                //cout << "//on rajoute 2 a fICode, so it can be = kICODE2 or kICODE3" << endl;
             }
          }
@@ -1173,10 +1257,31 @@ void KVIDZAGrid::IdentZ(Double_t x, Double_t y, Double_t& Z)
 //_______________________________________________________________________________________________//
 
 void KVIDZAGrid::Identify(Double_t x, Double_t y, KVIdentificationResult* idr) const
+{
+   // Fill the KVIdentificationResult object with the results of identification for point (x,y)
+   // corresponding to some physically measured quantities related to a reconstructed nucleus
+   // (see IdentifyWithContext).
+   //
+   // The grid is not modified: the quality code of the identification is given by
+   // idr->IDquality. Use IdentifyWithContext if you need the other intermediate results
+   // (closest line, distance to closest line, etc.).
+
+   IdentContext ctx;
+   IdentifyWithContext(x, y, idr, ctx);
+}
+
+//_______________________________________________________________________________________________//
+
+void KVIDZAGrid::IdentifyWithContext(Double_t x, Double_t y, KVIdentificationResult* idr, IdentContext& ctx) const
 {
    // Fill the KVIdentificationResult object with the results of identification for point (x,y)
    // corresponding to some physically measured quantities related to a reconstructed nucleus.
    //
+   // All intermediate results of the identification are stored in the context 'ctx', not in
+   // the grid, which is not modified. Therefore the same grid can be used to identify
+   // different points simultaneously in several threads, each with its own context (which
+   // can be a local variable). The quality code is given by idr->IDquality (or ctx.fICode).
+   //
    // By default (OnlyZId()=kFALSE) this means identifying the Z & A of the nucleus.
    // In this case, we consider that the nucleus' Z & A have been correctly measured
    // if the 'quality code' returned by IdentZA() is < kICODE4:
@@ -1200,28 +1305,28 @@ void KVIDZAGrid::Identify(Double_t x, Double_t y, KVIdentificationResult* idr) c
    //
    idr->IDOK = kFALSE;
 
-   if (!const_cast<KVIDZAGrid*>(this)->FindFourEmbracingLines(x, y, "above")) {
+   if (!FindFourEmbracingLines(x, y, "above", ctx)) {
       //no lines corresponding to point were found
-      const_cast < KVIDZAGrid* >(this)->fICode = kICODE8;         // Z indetermine ou (x,y) hors limites
+      ctx.fICode = kICODE8;         // Z indetermine ou (x,y) hors limites
       idr->IDquality = kICODE8;
       idr->SetComment("no identification: (x,y) out of range covered by grid");
       return;
    }
    if (OnlyZId()) {
       Double_t Z;
-      const_cast < KVIDZAGrid* >(this)->IdentZ(x, y, Z);
-      idr->IDquality = fICode;
-      if (fICode < kICODE4 || fICode == kICODE7) {
+      IdentZ(x, y, Z, ctx);
+      idr->IDquality = ctx.fICode;
+      if (ctx.fICode < kICODE4 || ctx.fICode == kICODE7) {
          idr->Zident = kTRUE;
       }
-      if (fICode < kICODE4) {
+      if (ctx.fICode < kICODE4) {
          idr->IDOK = kTRUE;
       }
-      idr->Z = Zint;
+      idr->Z = ctx.Zint;
       idr->PID = Z;
-      idr->A = Aint;
+      idr->A = ctx.Aint;
 
-      switch (fICode) {
+      switch (ctx.fICode) {
          case kICODE0:
             idr->SetComment("ok");
             break;
@@ -1253,20 +1358,20 @@ void KVIDZAGrid::Identify(Double_t x, Double_t y, KVIdentificationResult* idr) c
 
       Int_t Z;
       Double_t A;
-      const_cast < KVIDZAGrid* >(this)->IdentZA(x, y, Z, A);
-      idr->IDquality = fICode;
+      IdentZA(x, y, Z, A, ctx);
+      idr->IDquality = ctx.fICode;
       idr->Z = Z;
       idr->PID = A;
 
-      if (fICode < kICODE4 || fICode == kICODE7) {
+      if (ctx.fICode < kICODE4 || ctx.fICode == kICODE7) {
          idr->Zident = kTRUE;
       }
-      idr->A = Aint;
-      if (fICode < kICODE4) {
+      idr->A = ctx.Aint;
+      if (ctx.fICode < kICODE4) {
          idr->Aident = kTRUE;
          idr->IDOK = kTRUE;
       }
-      switch (fICode) {
+      switch (ctx.fICode) {
          case kICODE0:
             idr->SetComment("ok");
             break;
@@ -1312,6 +1417,113 @@ void KVIDZAGrid::Initialize()
    fZMaxLine = (KVIDZALine*) GetIdentifiers()->Last();
    if (fZMaxLine) fZMax = fZMaxLine->GetZ();
    else             fZMax = 0;     // protection au cas ou il n y a aucune ligne de Z
+   if (fUseLookupMap) BuildLookupMap();
+   else ClearLookupMap();
+}
+
+//___________________________________________________________________________________
+
+namespace {
+   // y-coordinate of (strictly increasing in x) polyline at x, by linear interpolation
+   Double_t KVIDZAGrid_InterpolateLine(Int_t n, const Double_t* X, const Double_t* Y, Double_t x)
+   {
+      Int_t k = TMath::Min(TMath::Max((Int_t)TMath::BinarySearch(n, X, x), 0), n - 2);
+      return Y[k] + (Y[k + 1] - Y[k]) * (x - X[k]) / (X[k + 1] - X[k]);
+   }
+}
+
+void KVIDZAGrid::BuildLookupMap(Int_t nbands)
+{
+   // Build lookup map used by FindFourEmbracingLines to find the lines around each point
+   // to identify without searching through all lines of the grid.
+   // This method is called by Initialize() if SetUseLookupMap(kTRUE) was called or if
+   // the configuration variable KVIDZAGrid.LookupMap is set to "yes".
+   //
+   // The X-axis is divided into bands whose boundaries are the endpoints of all lines
+   // plus 'nbands' bands of equal width covering the whole grid (if nbands=0, the value of the
+   // configuration variable KVIDZAGrid.LookupMap.NBands is used). Inside each band,
+   // the same lines embrace every point, and we store their indices in the list of identifiers
+   // together with the minimum and maximum Y-coordinate of each line in the band.
+   // For most points in a band, this is enough to know which lines are above and below.
+   // Points lying in the Y-range of more than one line in the band (near crossing/overlapping lines)
+   // are handled by the full search.
+   //
+   // The map can only be built if all lines have strictly increasing X-coordinates;
+   // otherwise no map is built.
+   // The map has to be rebuilt (by calling Initialize()) each time the lines of the grid are modified.
+
+   ClearLookupMap();
+   Int_t nlines = GetNumberOfIdentifiers();
+   if (!nlines) return;
+   if (nbands < 1) nbands = gEnv->GetValue("KVIDZAGrid.LookupMap.NBands", 256);
+
+   std::vector<Double_t> bounds;
+   Double_t xmin = 0, xmax = 0;
+   for (Int_t i = 0; i < nlines; ++i) {
+      KVIDLine* l = (KVIDLine*)GetIdentifierAt(i);
+      Int_t np = l->GetN();
+      if (np < 2) return;
+      const Double_t* X = l->GetX();
+      for (Int_t k = 0; k < np - 1; ++k) if (X[k + 1] <= X[k]) return;
+      bounds.push_back(X[0]);
+      bounds.push_back(X[np - 1]);
+      if (!i || X[0] < xmin) xmin = X[0];
+      if (!i || X[np - 1] > xmax) xmax = X[np - 1];
+   }
+   for (Int_t b = 1; b < nbands; ++b) bounds.push_back(xmin + b * (xmax - xmin) / nbands);
+   std::sort(bounds.begin(), bounds.end());
+   bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+   fLookupMapBand.push_back(0);
+   for (UInt_t b = 0; b + 1 < bounds.size(); ++b) {
+      Double_t x0 = bounds[b], x1 = bounds[b + 1];
+      Int_t first = fLookupMapLine.size();
+      for (Int_t i = 0; i < nlines; ++i) {
+         KVIDLine* l = (KVIDLine*)GetIdentifierAt(i);
+         Int_t np = l->GetN();
+         const Double_t* X = l->GetX();
+         const Double_t* Y = l->GetY();
+         if (X[0] > x0 || X[np - 1] < x1) continue; // line does not cross band
+         Double_t y0 = KVIDZAGrid_InterpolateLine(np, X, Y, x0);
+         Double_t y1 = KVIDZAGrid_InterpolateLine(np, X, Y, x1);
+         Double_t ylo = TMath::Min(y0, y1), yhi = TMath::Max(y0, y1);
+         for (Int_t k = 0; k < np; ++k) {
+            if (X[k] <= x0) continue;
+            if (X[k] >= x1) break;
+            ylo = TMath::Min(ylo, Y[k]);
+            yhi = TMath::Max(yhi, Y[k]);
+         }
+         // safety margin for rounding errors
+         Double_t eps = 1.e-9 * (TMath::Abs(ylo) + TMath::Abs(yhi)) + 1.e-12;
+         fLookupMapLine.push_back(i);
+         fLookupMapYmin.push_back(ylo - eps);
+         fLookupMapYmax.push_back(yhi + eps);
+      }
+      Int_t last = fLookupMapLine.size();
+      for (Int_t k = first + 1; k < last; ++k)
+         fLookupMapYmax[k] = TMath::Max(fLookupMapYmax[k], fLookupMapYmax[k - 1]);
+      for (Int_t k = last - 2; k >= first; --k)
+         fLookupMapYmin[k] = TMath::Min(fLookupMapYmin[k], fLookupMapYmin[k + 1]);
+      fLookupMapBand.push_back(last);
+   }
+   fLookupMapX.swap(bounds);
+   fLookupMapNLines = nlines;
+   fLookupMapScaleX = fLastScaleX;
+   fLookupMapScaleY = fLastScaleY;
+}
+
+//___________________________________________________________________________________
+
+void KVIDZAGrid::ClearLookupMap()
+{
+   // Delete lookup map (see BuildLookupMap)
+
+   fLookupMapNLines = 0;
+   fLookupMapX.clear();
+   fLookupMapBand.clear();
+   fLookupMapLine.clear();
+   fLookupMapYmin.clear();
+   fLookupMapYmax.clear();
 }
 
 
@@ -13,42 +13,13 @@ $Id: KVIDZAGrid.h,v 1.14 2009/04/01 09:38:10 franklan Exp $
 
 #include "KVIDGrid.h"
 #include "TObjArray.h"
+#include "KVIdentificationResult.h"
+#include <vector>
 
 class KVIDZALine;
 
 class KVIDZAGrid: public KVIDGrid {
 
-protected:
-
-   UShort_t fZMax;              //largest Z of lines in grid
-   KVIDZALine*  fZMaxLine;//! line with biggest Z and A
-
-   void SetZmax(Int_t z)
-   {
-      fZMax = z;
-   };
-
-   KVIDLine* fClosest;          //!closest line to last-identified point
-   KVIDLine* fLsups;//!
-   KVIDLine* fLsup;//!
-   KVIDLine* fLinf;//!
-   KVIDLine* fLinfi;//!
-   Double_t fDistanceClosest;   //!distance from point to closest line
-   Int_t fIdxClosest;         //!index of closest line in main list fIdentifiers
-   Int_t fICode;                //!code de retour
-
-   Int_t kinfi, kinf, ksup, ksups;//! used by IdentZA and IdentZ
-   Double_t dinf, dsup, dinfi, dsups;//!
-   Double_t winf, wsup, winfi, wsups;//!
-   Int_t Zinfi, Zinf, Zsup, Zsups;//!
-   Int_t Ainfi, Ainf, Asup, Asups;//!
-
-   Int_t Aint;//!mass of line used to identify particle
-   Int_t Zint;//!Z of line used to identify particle
-
-   virtual Bool_t FindFourEmbracingLines(Double_t x, Double_t y, const Char_t* position);
-   void init();
-
 public:
 
    enum {
@@ -65,15 +36,82 @@ public:
       kICODE10
    };
 
+   class IdentContext {
+      // Working variables used by FindFourEmbracingLines, IdentZA and IdentZ
+      // for the identification of one point (see KVIDZAGrid::IdentifyWithContext)
+   public:
+      KVIDLine* fClosest;          //closest line to point
+      KVIDLine* fLsups;
+      KVIDLine* fLsup;
+      KVIDLine* fLinf;
+      KVIDLine* fLinfi;
+      Double_t fDistanceClosest;   //distance from point to closest line
+      Int_t fIdxClosest;           //index of closest line in main list fIdentifiers
+      Int_t fICode;                //code de retour
+
+      Int_t kinfi, kinf, ksup, ksups;
+      Double_t dinf, dsup, dinfi, dsups;
+      Double_t winf, wsup, winfi, wsups;
+      Int_t Zinfi, Zinf, Zsup, Zsups;
+      Int_t Ainfi, Ainf, Asup, Asups;
+
+      Int_t Aint;//mass of line used to identify particle
+      Int_t Zint;//Z of line used to identify particle
+
+      IdentContext()
+      {
+         Reset();
+      }
+      void Reset()
+      {
+         kinfi = kinf = ksup = ksups = -1;
+         dinf = dsup = dinfi = dsups = 0.;
+         winf = wsup = winfi = wsups = 16000.;
+         Zinfi = Zinf = Zsup = Zsups = Ainfi = Ainf = Asup = Asups = -1;
+         fDistanceClosest = -1.;
+         fClosest = fLsups = fLsup = fLinf = fLinfi = 0;
+         fIdxClosest = -1;
+         fICode = kICODE8;
+         Aint = Zint = 0;
+      }
+   };
+
 protected:
-   Bool_t AcceptIDForTest()
+
+   UShort_t fZMax;              //largest Z of lines in grid
+   KVIDZALine*  fZMaxLine;//! line with biggest Z and A
+
+   void SetZmax(Int_t z)
+   {
+      fZMax = z;
+   };
+
+   Int_t fICode;                //!code de retour (set by IsIdentifiable() in some derived classes)
+
+   Bool_t fUseLookupMap;//!kTRUE if lookup map is to be built by Initialize()
+   Int_t fLookupMapNLines;//!number of lines in grid when lookup map was built
+   Double_t fLookupMapScaleX;//!X scaling factor when lookup map was built
+   Double_t fLookupMapScaleY;//!Y scaling factor when lookup map was built
+   std::vector<Double_t> fLookupMapX;//!boundaries in X of bands of lookup map
+   std::vector<Int_t> fLookupMapBand;//!offset in fLookupMapLine of first line of each band
+   std::vector<Int_t> fLookupMapLine;//!indices of lines crossing each band
+   std::vector<Double_t> fLookupMapYmax;//!running maximum (from lowest line) of Y of lines in each band
+   std::vector<Double_t> fLookupMapYmin;//!running minimum (from highest line) of Y of lines in each band
+
+   virtual Bool_t FindFourEmbracingLines(Double_t x, Double_t y, const Char_t* position, IdentContext& ctx) const;
+   Int_t FindFourEmbracingLinesWithLookupMap(Double_t x, Double_t y, IdentContext& ctx) const;
+   void SetEmbracingLineParameters(IdentContext& ctx) const;
+   void init();
+
+protected:
+   Bool_t AcceptIDForTest(const KVIdentificationResult* idr) const
    {
       // Used by TestIdentification.
       // The result of the identification may be excluded from the histograms of PID
       // and PID vs. Eres, depending on the quality code of the identification algorithm.
-      // (given by GetQualityCode()).
-      // For a general (Z,A) grid we only include particles with GetQualityCode() < 4 as being "well-identified"
-      return (fICode < kICODE4);
+      // (given by idr->IDquality).
+      // For a general (Z,A) grid we only include particles with quality code < 4 as being "well-identified"
+      return (idr->IDquality < kICODE4);
    };
 
 public:
@@ -114,39 +152,47 @@ public:
    };
    virtual KVIDZALine* GetZALine(Int_t z, Int_t a, Int_t&) const;
 
-   virtual void IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A);
+   virtual void IdentZA(Double_t x, Double_t y, Int_t& Z, Double_t& A, IdentContext& ctx) const;
    virtual TClass* DefaultIDLineClass()
    {
       return TClass::GetClass("KVIDZALine");
    };
-   virtual void IdentZ(Double_t x, Double_t y, Double_t& Z);
+   virtual void IdentZ(Double_t x, Double_t y, Double_t& Z, IdentContext& ctx) const;
    Int_t GetQualityCode() const
    {
-      // Return quality code for previously-attempted identification
+      // Return quality code set by IsIdentifiable() in derived classes for points
+      // which cannot be identified (kICODE8 by default).
+      // The quality code of an identification is given by KVIdentificationResult::IDquality.
       // Meanings of code values are given in class description
       return fICode;
    };
 
    virtual void Identify(Double_t x, Double_t y, KVIdentificationResult*) const;
-
-   inline KVIDLine* GetClosestLine() const
-   {
-      return fClosest;
-   };
-   inline Double_t GetDistanceClosestLine() const
-   {
-      return fDistanceClosest;
-   };
-   inline UChar_t GetIndexClosest() const
-   {
-      return fIdxClosest;
-   };
+   virtual void IdentifyWithContext(Double_t x, Double_t y, KVIdentificationResult*, IdentContext&) const;
 
    //virtual void MakeEDeltaEZGrid(Int_t Zmin, Int_t Zmax, Int_t npoints=20, Double_t gamma = 2);//*MENU*
 
    KVIDGraph* MakeSubsetGraph(Int_t Zmin, Int_t Zmax, const Char_t* /*graph_class*/ = ""); //*MENU*
    KVIDGraph* MakeSubsetGraph(TList*, TClass* /*graph_class*/ = 0);
 
+   void SetUseLookupMap(Bool_t yes = kTRUE)
+   {
+      // Enable/disable use of lookup map for fast location of lines around each
+      // identified point (see BuildLookupMap). Takes effect at next call to Initialize().
+      fUseLookupMap = yes;
+   }
+   Bool_t GetUseLookupMap() const
+   {
+      return fUseLookupMap;
+   }
+   void BuildLookupMap(Int_t nbands = 0);
+   void ClearLookupMap();
+   Bool_t HasLookupMap() const
+   {
+      // Returns kTRUE if lookup map has been built (see BuildLookupMap)
+      return fLookupMapNLines > 0;
+   }
+
    ClassDef(KVIDZAGrid, 2)     //Base class for 2D Z & A identification grids
 };
 
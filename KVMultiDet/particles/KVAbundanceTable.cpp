@@ -50,9 +50,9 @@ void KVAbundanceTable::Initialize()
       //Info("Initialize","%s will be read",gEnv->GetValue(dfile.Data(),""));
    }
    SetTitle(gEnv->GetValue(dfile.Data(), ""));
+   if (ReadCache(cl_path)) return;
 
    Int_t ntot = 0;
-   nucMap = new TMap(50, 2);
    KVFileReader* fr = new KVFileReader();
    fr->OpenFileToRead(cl_path.Data());
 
@@ -140,6 +140,8 @@ void KVAbundanceTable::Initialize()
 // Info("Initialize","table initialised correctly for %d/%d nuclei", ntot,GetNumberOfNuclei());
    fr->CloseFile();
    delete fr;
+   BuildIndex();
+   WriteCache(cl_path);
 
    /*
    for (Int_t zz=0;zz<=zmax;zz+=1){
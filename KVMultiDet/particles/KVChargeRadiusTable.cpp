@@ -4,6 +4,7 @@
 #include "KVChargeRadiusTable.h"
 #include "TEnv.h"
 #include "KVFileReader.h"
+#include "KVDataFileCache.h"
 #include "KVBase.h"
 
 ClassImp(KVChargeRadiusTable)
@@ -51,9 +52,9 @@ void KVChargeRadiusTable::Initialize()
       //Info("Initialize","%s will be read",gEnv->GetValue(dfile.Data(),""));
    }
    SetTitle(gEnv->GetValue(dfile.Data(), ""));
+   if (ReadCache(cl_path)) return;
 
    Int_t ntot = 0;
-   nucMap = new TMap(50, 2);
    KVFileReader* fr = new KVFileReader();
    fr->OpenFileToRead(cl_path.Data());
 
@@ -108,6 +109,8 @@ void KVChargeRadiusTable::Initialize()
    //Info("Initialize","table initialised correctly for %d nuclei", ntot);
    fr->CloseFile();
    delete fr;
+   BuildIndex();
+   WriteCache(cl_path);
 
 }
 
@@ -118,3 +121,17 @@ KVChargeRadius* KVChargeRadiusTable::GetChargeRadius(Int_t zz, Int_t aa) const
    return (KVChargeRadius*)GetData(zz, aa);
 
 }
+
+//_____________________________________________
+void KVChargeRadiusTable::ReadCachedElement(KVDataFileCache& cache, KVNuclData* nd)
+{
+   // Read error on charge radius from binary cache
+   ((KVChargeRadius*)nd)->SetError(cache.ReadDouble());
+}
+
+//_____________________________________________
+void KVChargeRadiusTable::WriteCachedElement(KVDataFileCache& cache, const KVNuclData* nd) const
+{
+   // Write error on charge radius in binary cache
+   cache.WriteDouble(((const KVChargeRadius*)nd)->GetError());
+}
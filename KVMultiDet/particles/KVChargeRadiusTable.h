@@ -10,6 +10,8 @@
 class KVChargeRadiusTable : public KVNuclDataTable {
 protected:
    virtual void init();
+   virtual void ReadCachedElement(KVDataFileCache&, KVNuclData*);
+   virtual void WriteCachedElement(KVDataFileCache&, const KVNuclData*) const;
 
 public:
    KVChargeRadiusTable();
@@ -3,6 +3,7 @@
 
 #include "KVElementDensityTable.h"
 #include "KVFileReader.h"
+#include "KVDataFileCache.h"
 #include "TEnv.h"
 #include "KVElementDensity.h"
 #include "KVUnits.h"
@@ -71,9 +72,9 @@ void KVElementDensityTable::Initialize()
 //    Info("Initialize","%s will be read",gEnv->GetValue(dfile.Data(),""));
    }
    SetTitle(gEnv->GetValue(dfile.Data(), ""));
+   if (ReadCache(cl_path)) return;
 
    Int_t ntot = 0;
-   nucMap = new TMap(50, 2);
    KVFileReader* fr = new KVFileReader();
    fr->OpenFileToRead(cl_path.Data());
 
@@ -136,6 +137,8 @@ void KVElementDensityTable::Initialize()
 // Info("Initialize","table initialised correctly for %d/%d nuclei", ntot,GetNumberOfNuclei());
    fr->CloseFile();
    delete fr;
+   BuildIndex();
+   WriteCache(cl_path);
 
 }
 
@@ -152,7 +155,7 @@ void KVElementDensityTable::GiveIndexToNucleus(Int_t zz, Int_t aa, Int_t ntot)
 //_____________________________________________
 NDT::value* KVElementDensityTable::getNDTvalue(Int_t zz, Int_t aa) const
 {
-   // Return NDT::value object pointer stored at map position (Z,A).
+   // Return NDT::value object pointer for element Z, 0 if not in table.
    //Masses are not important, we use aa=2*zz+1
    aa = 2 * zz + 1;
    return KVNuclDataTable::getNDTvalue(zz, aa);
@@ -187,3 +190,25 @@ KVElementDensity* KVElementDensityTable::FindElementBySymbol(const Char_t* X) co
    }
    return 0x0;
 }
+
+//_____________________________________________
+void KVElementDensityTable::ReadCachedElement(KVDataFileCache& cache, KVNuclData* nd)
+{
+   // Read element properties from binary cache
+   KVElementDensity* ed = (KVElementDensity*)nd;
+   ed->SetIsGas(cache.ReadInt());
+   ed->SetElementSymbol(cache.ReadString());
+   ed->SetElementName(cache.ReadString());
+   ed->SetZ(cache.ReadInt());
+}
+
+//_____________________________________________
+void KVElementDensityTable::WriteCachedElement(KVDataFileCache& cache, const KVNuclData* nd) const
+{
+   // Write element properties in binary cache
+   const KVElementDensity* ed = (const KVElementDensity*)nd;
+   cache.WriteInt(ed->IsGas());
+   cache.WriteString(ed->GetElementSymbol());
+   cache.WriteString(ed->GetElementName());
+   cache.WriteInt(ed->GetZ());
+}
@@ -11,6 +11,8 @@ class KVElementDensity;
 class KVElementDensityTable : public KVNuclDataTable {
 
    virtual NDT::value* getNDTvalue(Int_t zz, Int_t aa) const;
+   virtual void ReadCachedElement(KVDataFileCache&, KVNuclData*);
+   virtual void WriteCachedElement(KVDataFileCache&, const KVNuclData*) const;
 
 public:
    KVElementDensityTable();
@@ -3,6 +3,7 @@
 
 #include "KVLifeTimeTable.h"
 #include "KVFileReader.h"
+#include "KVDataFileCache.h"
 #include "TEnv.h"
 #include "KVBase.h"
 
@@ -133,9 +134,9 @@ void KVLifeTimeTable::Initialize()
       //Info("Initialize","%s will be read",gEnv->GetValue(dfile.Data(),""));
    }
    SetTitle(gEnv->GetValue(dfile.Data(), ""));
+   if (ReadCache(cl_path)) return;
 
    Int_t ntot = 0;
-   nucMap = new TMap(50, 2);
    KVFileReader* fr = new KVFileReader();
    fr->OpenFileToRead(cl_path.Data());
 
@@ -204,6 +205,8 @@ void KVLifeTimeTable::Initialize()
    //Info("Initialize","table initialised correctly for %d nuclei", ntot);
    fr->CloseFile();
    delete fr;
+   BuildIndex();
+   WriteCache(cl_path);
 
 }
 
@@ -252,3 +255,17 @@ Bool_t KVLifeTimeTable::IsAResonance(Int_t zz, Int_t aa) const
 
 
 }
+
+//_____________________________________________
+void KVLifeTimeTable::ReadCachedElement(KVDataFileCache& cache, KVNuclData* nd)
+{
+   // Read resonance flag from binary cache
+   ((KVLifeTime*)nd)->SetResonance(cache.ReadInt());
+}
+
+//_____________________________________________
+void KVLifeTimeTable::WriteCachedElement(KVDataFileCache& cache, const KVNuclData* nd) const
+{
+   // Write resonance flag in binary cache
+   cache.WriteInt(((const KVLifeTime*)nd)->IsAResonance());
+}
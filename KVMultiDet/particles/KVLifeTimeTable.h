@@ -28,6 +28,9 @@ protected:
    KVNameValueList lu_t;
    KVNameValueList lu_e;
 
+   virtual void ReadCachedElement(KVDataFileCache&, KVNuclData*);
+   virtual void WriteCachedElement(KVDataFileCache&, const KVNuclData*) const;
+
 public:
    KVLifeTimeTable();
    virtual ~KVLifeTimeTable();
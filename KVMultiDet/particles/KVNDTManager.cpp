@@ -6,6 +6,8 @@
 #include "KVNuclData.h"
 #include "KVString.h"
 #include "KVBase.h"
+#include "KVDataFileCache.h"
+#include "TStopwatch.h"
 #include "Riostream.h"
 #include "TObjArray.h"
 
@@ -18,9 +20,22 @@ ClassImp(KVNDTManager)
 <h4>Allow to navigate between different tables of nuclear data</h4>
 <!-- */
 // --> END_HTML
+// The standard tables ("MassExcess", "LifeTime", "Abundance", "ChargeRadius",
+// "ElementDensity") can be accessed using the enumeration KVNDTManager::ETable
+// instead of their names, e.g.
+//
+//    gNDTManager->GetValue(z, a, KVNDTManager::kMassExcess)
+//
+// which avoids looking up the table by name for each call. The methods with a
+// table name argument can still be used for any table.
 ////////////////////////////////////////////////////////////////////////////////
 KVNDTManager* gNDTManager;
 
+namespace {
+   // names of standard tables in same order as KVNDTManager::ETable
+   const Char_t* ndt_names[] = {"MassExcess", "LifeTime", "Abundance", "ChargeRadius", "ElementDensity"};
+}
+
 KVNDTManager::KVNDTManager()
 {
    // Default constructor
@@ -39,9 +54,12 @@ void KVNDTManager::init()
    // We automatically instantiate a data table of each class which is
    // declared as a "KVNuclDataTable" plugin
    // If a new class is added to the .kvrootrc, there is no need to alter the code.
+   // The time taken to initialise each table (from its binary cache or its text file)
+   // is recorded for KVDataFileCache::PrintTimingReport().
 
    Arange = 0;
    Zrange = 0;
+   for (Int_t t = 0; t < kNumberOfTables; ++t) fTables[t] = 0;
 
    KVString plugins = KVBase::GetListOfPlugins("KVNuclDataTable");
    plugins.Begin(" ");
@@ -49,17 +67,65 @@ void KVNDTManager::init()
       Add((KVNuclDataTable*)TClass::GetClass(plugins.Next())->New());
    }
 
-   Execute("Initialize", "");
+   TIter next(this);
+   KVNuclDataTable* tab;
+   TStopwatch timer;
+   while ((tab = (KVNuclDataTable*)next())) {
+      timer.Start();
+      tab->Initialize();
+      KVDataFileCache::AddTiming(tab->GetName(), tab->GetReadFileName(), tab->IsReadFromCache(), timer.RealTime());
+   }
+
+   for (Int_t t = 0; t < kNumberOfTables; ++t) fTables[t] = (KVNuclDataTable*)FindObject(ndt_names[t]);
+}
+
+const Char_t* KVNDTManager::GetTableName(ETable t)
+{
+   // Name of standard table, empty string if t is not a standard table
+   return (t >= 0 && t < kNumberOfTables ? ndt_names[t] : "");
+}
 
+Int_t KVNDTManager::GetTableHandle(const Char_t* name)
+{
+   // Value of ETable corresponding to name of standard table, -1 for other names
+   for (Int_t t = 0; t < kNumberOfTables; ++t) if (!strcmp(name, ndt_names[t])) return t;
+   return -1;
 }
 
 KVNuclDataTable* KVNDTManager::GetTable(const Char_t* name) const
 {
+   // Table with given name (standard tables are found without searching the list)
 
+   Int_t t = GetTableHandle(name);
+   if (t > -1) return fTables[t];
    return (KVNuclDataTable*)FindObject(name);
 
 }
 
+Bool_t KVNDTManager::IsInTable(Int_t zz, Int_t aa, ETable t) const
+{
+   KVNuclDataTable* tab = GetTable(t);
+   return (tab && IsValidNucleus(zz, aa) && tab->IsInTable(zz, aa));
+}
+
+Double_t KVNDTManager::GetValue(Int_t zz, Int_t aa, ETable t) const
+{
+   // Returns -666 if table is not present, -555 if nucleus is not in table
+   // (as KVNuclDataTable::GetValue), including for Z<0 or N<0
+
+   KVNuclDataTable* tab = GetTable(t);
+   if (!tab) return -666;
+   if (!IsValidNucleus(zz, aa)) return -555;
+   return tab->GetValue(zz, aa);
+}
+
+KVNuclData* KVNDTManager::GetData(Int_t zz, Int_t aa, ETable t) const
+{
+   KVNuclDataTable* tab = GetTable(t);
+   if (tab && IsValidNucleus(zz, aa)) return tab->GetData(zz, aa);
+   return 0;
+}
+
 Bool_t KVNDTManager::IsInTable(Int_t zz, Int_t aa, const Char_t* name) const
 {
    KVNuclDataTable* tab = 0;
@@ -11,18 +11,46 @@ class KVNuclData;
 class TObjArray;
 
 class KVNDTManager : public KVList {
+public:
+   // standard tables, for fast access without table names
+   enum ETable {
+      kMassExcess,
+      kLifeTime,
+      kAbundance,
+      kChargeRadius,
+      kElementDensity,
+      kNumberOfTables
+   };
 
 protected:
    void init();
    TObjArray* Arange;
    TObjArray* Zrange;
+   KVNuclDataTable* fTables[kNumberOfTables];//! standard tables (0 if not present)
 
+   static Bool_t IsValidNucleus(Int_t zz, Int_t aa)
+   {
+      // kFALSE if Z or N = A - Z is negative (such nuclei are in no table)
+      return (zz >= 0 && aa >= zz);
+   }
 
 public:
    KVNDTManager();
    virtual ~KVNDTManager();
 
+   static const Char_t* GetTableName(ETable t);
+   static Int_t GetTableHandle(const Char_t* name);
+
    KVNuclDataTable* GetTable(const Char_t* name) const;
+   KVNuclDataTable* GetTable(ETable t) const
+   {
+      // Standard table (no look-up by name), 0 if not present
+      return (t >= 0 && t < kNumberOfTables ? fTables[t] : 0);
+   }
+
+   Bool_t IsInTable(Int_t zz, Int_t aa, ETable t) const;
+   Double_t GetValue(Int_t zz, Int_t aa, ETable t) const;
+   KVNuclData* GetData(Int_t zz, Int_t aa, ETable t) const;
 
    Bool_t IsInTable(Int_t zz, Int_t aa, const Char_t* name) const;
    Double_t GetValue(Int_t zz, Int_t aa, const Char_t* name) const;
@@ -2,6 +2,8 @@
 //Author: bonnet
 
 #include "KVNuclDataTable.h"
+#include "KVDataFileCache.h"
+#include "TMath.h"
 
 using namespace NDT;
 
@@ -42,6 +44,20 @@ Specific implementations must define the methods:
    }
    For further detail see the KVLifeTimeTable and KVLifeTime class
 </ul>
+<p>Nuclei are found in the table using a dense array indexed by Z and N, built by
+BuildIndex() once all nuclei have been given to GiveIndexToNucleus:
+each look-up costs a few array accesses, whatever the number of nuclei in the table.
+All look-ups go through the virtual method getNDTvalue(), which can be overridden
+to change the way nuclei are found (see KVElementDensityTable).
+Derived classes which create the TMap nucMap in Initialize() (as was required
+before the dense index existed) still have it filled by GiveIndexToNucleus,
+but it is not used for look-ups.</p>
+<p>Tables read from text files in Initialize() are kept in a binary cache (see
+KVDataFileCache): after calling SetTitle(), Initialize() should first try ReadCache()
+(which builds the index), and call BuildIndex() then WriteCache() after reading the
+text file. Implementations which store more than the value and the 'measured' flag
+for each nucleus must override
+ReadCachedElement()/WriteCachedElement().</p>
 <!-- */
 // --> END_HTML
 ////////////////////////////////////////////////////////////////////////////////
@@ -79,6 +95,7 @@ void KVNuclDataTable::init()
 {
    nucMap = 0;
    tobj = 0;
+   fFromCache = kFALSE;
 
    current_idx = 0;
    NbNuc = 0;
@@ -92,16 +109,67 @@ void KVNuclDataTable::GiveIndexToNucleus(Int_t zz, Int_t aa, Int_t ntot)
 {
 
    //Add a new entry in the table
-   nucMap->Add(new NDT::key(zz, aa), new NDT::value(ntot));
+   if (nucMap) nucMap->Add(new NDT::key(zz, aa), new NDT::value(ntot));
+   fEntries.push_back(zz);
+   fEntries.push_back(aa);
+   fEntries.push_back(ntot);
    NbNuc += 1;
 
 }
 
+//_____________________________________________
+void KVNuclDataTable::BuildIndex()
+{
+   // Build dense (Z,N) index of all nuclei given to GiveIndexToNucleus:
+   // for each Z, the positions in fValues of nuclei with N = Nmin(Z), ..., Nmax(Z)
+   // are stored contiguously in fNucIndex (-1 for nuclei not in table).
+   // If the same nucleus appears several times, the first one is used.
+   // Called at the end of Initialize() and ReadCache(): nuclei given to
+   // GiveIndexToNucleus afterwards are not found until this is called again.
+
+   Int_t nent = fEntries.size() / 3;
+   Int_t zmax = -1;
+   for (Int_t i = 0; i < nent; ++i) zmax = TMath::Max(zmax, fEntries[3 * i]);
+   fNmin.assign(zmax + 1, 1);
+   fNmax.assign(zmax + 1, 0);
+   std::vector<Bool_t> seen(zmax + 1, kFALSE);
+   for (Int_t i = 0; i < nent; ++i) {
+      Int_t zz = fEntries[3 * i], nn = fEntries[3 * i + 1] - zz;
+      if (zz < 0) continue;
+      if (!seen[zz]) {
+         fNmin[zz] = fNmax[zz] = nn;
+         seen[zz] = kTRUE;
+      } else {
+         fNmin[zz] = TMath::Min(fNmin[zz], nn);
+         fNmax[zz] = TMath::Max(fNmax[zz], nn);
+      }
+   }
+   fZOffset.assign(zmax + 1, 0);
+   Int_t size = 0;
+   for (Int_t zz = 0; zz <= zmax; ++zz) {
+      fZOffset[zz] = size;
+      if (seen[zz]) size += fNmax[zz] - fNmin[zz] + 1;
+   }
+   fNucIndex.assign(size, -1);
+   fValues.clear();
+   fValues.reserve(nent);
+   for (Int_t i = 0; i < nent; ++i) {
+      Int_t zz = fEntries[3 * i], nn = fEntries[3 * i + 1] - zz;
+      if (zz < 0) continue;
+      Int_t& idx = fNucIndex[fZOffset[zz] + nn - fNmin[zz]];
+      if (idx < 0) {
+         idx = fValues.size();
+         fValues.push_back(NDT::value(fEntries[3 * i + 2]));
+      }
+   }
+}
+
 //_____________________________________________
 NDT::value* KVNuclDataTable::getNDTvalue(Int_t zz, Int_t aa) const
 {
-   // Return NDT::value object pointer stored at map position (Z,A).
-   return (NDT::value*)nucMap->GetValue(Form("%d:%d", zz, aa));
+   // Return NDT::value object pointer for nucleus (Z,A), 0 if not in table.
+   // The nucleus is found using the dense (Z,N) index (see BuildIndex).
+   return const_cast<NDT::value*>(FindValue(zz, aa));
 }
 
 //_____________________________________________
@@ -120,7 +188,7 @@ KVNuclData* KVNuclDataTable::GetData(Int_t zz, Int_t aa) const
    //returns 0 if no such object is present
 
    NDT::value* val = getNDTvalue(zz, aa);
-   if (val) return (KVNuclData*)tobj->At(val->Index());
+   if (val && val->Index() < tobj->GetEntriesFast()) return (KVNuclData*)tobj->UncheckedAt(val->Index());
    return 0;
 
 }
@@ -238,3 +306,77 @@ void KVNuclDataTable::InfoOnMeasured() const
 
 
 }
+
+//_____________________________________________
+void KVNuclDataTable::ClearTable()
+{
+   // Delete all nuclei in table
+
+   if (tobj) delete tobj;
+   tobj = 0;
+   if (nucMap) nucMap->DeleteAll();
+   fEntries.clear();
+   BuildIndex();
+   current_idx = 0;
+   NbNuc = 0;
+   kcomments = "";
+}
+
+//_____________________________________________
+Bool_t KVNuclDataTable::ReadCache(const TString& source)
+{
+   // Fill table from binary cache of text file 'source' (full path), if it exists
+   // and is up to date. Returns kFALSE if the text file has to be read.
+
+   KVDataFileCache cache(ClassName(), source);
+   if (!cache.Open()) return kFALSE;
+
+   kcomments = cache.ReadString();
+   Int_t ntot = cache.ReadInt();
+   if (!cache.IsOK() || ntot < 0) {
+      ClearTable();
+      return kFALSE;
+   }
+   CreateTable(ntot);
+   for (Int_t i = 0; i < ntot && cache.IsOK(); ++i) {
+      Int_t zz = cache.ReadInt();
+      Int_t aa = cache.ReadInt();
+      GiveIndexToNucleus(zz, aa, i);
+      CreateElement(i);
+      KVNuclData* nd = GetCurrent();
+      nd->SetValue(cache.ReadDouble());
+      nd->SetMeasured(cache.ReadInt());
+      ReadCachedElement(cache, nd);
+   }
+   if (!cache.IsOK()) {
+      Warning("ReadCache", "Binary cache %s is corrupted: reading %s", cache.GetCacheFile(), source.Data());
+      ClearTable();
+      return kFALSE;
+   }
+   BuildIndex();
+   fFromCache = kTRUE;
+   return kTRUE;
+}
+
+//_____________________________________________
+void KVNuclDataTable::WriteCache(const TString& source) const
+{
+   // Write binary cache of table read from text file 'source' (full path).
+   // Nothing is written if the table is incomplete (problem reading file).
+
+   Int_t ntot = fEntries.size() / 3;
+   if (!tobj || tobj->GetEntriesFast() != ntot) return;
+   KVDataFileCache cache(ClassName(), source);
+   cache.WriteString(kcomments);
+   cache.WriteInt(ntot);
+   for (Int_t i = 0; i < ntot; ++i) {
+      KVNuclData* nd = (KVNuclData*)tobj->At(fEntries[3 * i + 2]);
+      if (!nd) return;
+      cache.WriteInt(fEntries[3 * i]);
+      cache.WriteInt(fEntries[3 * i + 1]);
+      cache.WriteDouble(nd->GetValue());
+      cache.WriteInt(nd->IsMeasured());
+      WriteCachedElement(cache, nd);
+   }
+   cache.Save();
+}
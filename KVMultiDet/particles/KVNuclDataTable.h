@@ -12,6 +12,7 @@
 
 #include "KVString.h"
 #include "KVNuclData.h"
+#include <vector>
 
 
 namespace NDT {
@@ -37,12 +38,14 @@ namespace NDT {
    };
 };
 
+class KVDataFileCache;
+
 class KVNuclDataTable : public TNamed {
 
 protected:
 
    TClass* cl;          //pointeur pour gerer les heritages de classes de KVNuclData
-   TMap* nucMap;        //mapping (Z,A) -> nucleus index
+   TMap* nucMap;        //mapping (Z,A) -> nucleus index (only filled if created by derived class)
    Int_t current_idx;   //current index
    Int_t NbNuc;         //nbre de noyaux presents dans la table
 
@@ -54,6 +57,15 @@ protected:
    TObjArray* tobj;  //! array where all nucldata objects are
    //TObjArray* tobj_rangeA;  //! array where range of A associated to each Z is stored via KVIntegerList
 
+   // dense (Z,N) -> nucleus index mapping (see BuildIndex)
+   std::vector<Int_t> fEntries;//! (Z,A,index) of each nucleus given to GiveIndexToNucleus
+   std::vector<Int_t> fZOffset;//! for each Z, position in fNucIndex of smallest N
+   std::vector<Int_t> fNmin;//! for each Z, smallest N in table
+   std::vector<Int_t> fNmax;//! for each Z, largest N in table
+   std::vector<Int_t> fNucIndex;//! position in fValues for each (Z,N), -1 if absent
+   std::vector<NDT::value> fValues;//! index in tobj of each nucleus in fNucIndex
+   Bool_t fFromCache;//! kTRUE if table was read from binary cache
+
    KVNuclData* GetCurrent() const
    {
       return (KVNuclData*)tobj->At(current_idx);
@@ -62,8 +74,25 @@ protected:
    void CreateElement(Int_t idx);//a new KVNuclData pointeur is created and added
    void InfoOnMeasured() const;
 
+   void BuildIndex();
+   const NDT::value* FindValue(Int_t zz, Int_t aa) const
+   {
+      // Entry of dense (Z,N) index for nucleus (Z,A), 0 if not in table
+      if (zz < 0 || zz >= (Int_t)fNmin.size()) return 0;
+      Int_t nn = aa - zz;
+      if (nn < fNmin[zz] || nn > fNmax[zz]) return 0;
+      Int_t i = fNucIndex[fZOffset[zz] + nn - fNmin[zz]];
+      return (i < 0 ? 0 : &fValues[i]);
+   }
    virtual NDT::value* getNDTvalue(Int_t zz, Int_t aa) const;
 
+   // binary cache of table (see KVDataFileCache)
+   void ClearTable();
+   Bool_t ReadCache(const TString& source);
+   void WriteCache(const TString& source) const;
+   virtual void ReadCachedElement(KVDataFileCache&, KVNuclData*) {}
+   virtual void WriteCachedElement(KVDataFileCache&, const KVNuclData*) const {}
+
 public:
    KVNuclDataTable();
    KVNuclDataTable(KVString classname);
@@ -83,6 +112,11 @@ public:
    Int_t GetNumberOfNuclei() const;
    const Char_t*   GetReadFileName() const;
    KVString GetCommentsFromFile() const;
+   Bool_t IsReadFromCache() const
+   {
+      // kTRUE if table was read from binary cache instead of text file
+      return fFromCache;
+   }
 
    ClassDef(KVNuclDataTable, 1) //Store information on nuclei
 
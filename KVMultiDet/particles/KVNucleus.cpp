@@ -18,6 +18,9 @@ $Id: KVNucleus.cpp,v 1.48 2009/04/02 09:32:55 ebonnet Exp $
 #include "KVParticleCondition.h"
 #include "Riostream.h"
 #include "TMethodCall.h"
+#ifdef WITH_CPP11
+#include <mutex>
+#endif
 #include "TPluginManager.h"
 #include "KVNDTManager.h"
 
@@ -133,7 +136,12 @@ ClassImp(KVNucleus);
 //+Plugin.KVNuclDataTable: MyMassExcessTable  MyMassExcessTable  MyMassExcessTable.cpp+  " MyMassExcessTable()"
 ////////////////////////////////////////////////////////////////////////////
 
+#ifdef WITH_CPP11
+// atomic: nuclei are created & deleted concurrently by different threads
+std::atomic<UInt_t> KVNucleus::fNb_nuc(0);
+#else
 UInt_t KVNucleus::fNb_nuc = 0;
+#endif
 
 #define MAXZ_ELEMENT_SYMBOL 111
 Char_t KVNucleus::fElements[][3] = {
@@ -270,6 +278,12 @@ void KVNucleus::init()
 
    fZ = fA = 0;
    if (!fNb_nuc) {
+#ifdef WITH_CPP11
+      // first nuclei may be created at the same time by several threads
+      // (e.g. parallel event reconstruction, see KVEventReconstructor)
+      static std::mutex init_mutex;
+      std::lock_guard<std::mutex> lock(init_mutex);
+#endif
       KVBase::InitEnvironment(); // initialise environment i.e. read .kvrootrc
       if (!gNDTManager) gNDTManager = new KVNDTManager;
    }
@@ -671,7 +685,7 @@ Double_t KVNucleus::GetMassExcess(Int_t z, Int_t a) const
 
    CheckZAndA(z, a);
 
-   Double_t val = gNDTManager->GetValue(z, a, "MassExcess");
+   Double_t val = gNDTManager->GetValue(z, a, KVNDTManager::kMassExcess);
    if (val == -555) return GetExtraMassExcess(z, a);
    else           return val;
 
@@ -709,7 +723,7 @@ KVMassExcess* KVNucleus::GetMassExcessPtr(Int_t z, Int_t a) const
    //If optional arguments (z,a) are given we return the value for the
    //required nucleus.
    CheckZAndA(z, a);
-   return (KVMassExcess*)gNDTManager->GetData(z, a, "MassExcess");
+   return (KVMassExcess*)gNDTManager->GetData(z, a, KVNDTManager::kMassExcess);
 
 }
 
@@ -750,7 +764,7 @@ KVLifeTime* KVNucleus::GetLifeTimePtr(Int_t z, Int_t a) const
    //required nucleus.
 
    CheckZAndA(z, a);
-   return (KVLifeTime*)gNDTManager->GetData(z, a, "LifeTime");
+   return (KVLifeTime*)gNDTManager->GetData(z, a, KVNDTManager::kLifeTime);
 
 }
 
@@ -836,7 +850,7 @@ KVChargeRadius* KVNucleus::GetChargeRadiusPtr(Int_t z, Int_t a) const
    //required nucleus.
 
    CheckZAndA(z, a);
-   return (KVChargeRadius*)gNDTManager->GetData(z, a, "ChargeRadius");
+   return (KVChargeRadius*)gNDTManager->GetData(z, a, KVNDTManager::kChargeRadius);
 
 }
 
@@ -849,7 +863,7 @@ Double_t KVNucleus::GetAbundance(Int_t z, Int_t a) const
    //required nucleus.
 
    CheckZAndA(z, a);
-   return TMath::Max(0.0, gNDTManager->GetValue(z, a, "Abundance"));
+   return TMath::Max(0.0, gNDTManager->GetValue(z, a, KVNDTManager::kAbundance));
 }
 
 //________________________________________________________________________________________
@@ -884,7 +898,7 @@ KVAbundance* KVNucleus::GetAbundancePtr(Int_t z, Int_t a) const
    //required nucleus.
 
    CheckZAndA(z, a);
-   return (KVAbundance*)gNDTManager->GetData(z, a, "Abundance");
+   return (KVAbundance*)gNDTManager->GetData(z, a, KVNDTManager::kAbundance);
 
 }
 
@@ -899,7 +913,7 @@ Bool_t KVNucleus::IsKnown(int z, int a) const
 
    CheckZAndA(z, a);
    //return fMassTable->IsKnown(z,a);
-   return gNDTManager->IsInTable(z, a, "MassExcess");
+   return gNDTManager->IsInTable(z, a, KVNDTManager::kMassExcess);
 }
 
 //________________________________________________________________________________________
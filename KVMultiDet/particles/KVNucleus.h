@@ -18,6 +18,9 @@ $Id: KVNucleus.h,v 1.40 2009/04/02 09:32:55 ebonnet Exp $
 #include "KVParticleCondition.h"
 #include "TLorentzRotation.h"
 #include "KVString.h"
+#ifdef WITH_CPP11
+#include <atomic>
+#endif
 
 class KVLifeTime;
 class KVMassExcess;
@@ -31,7 +34,11 @@ private:
    UChar_t fA;                  //nuclear mass number
    UChar_t fZ;                  //nuclear charge number (atomic number)
    UChar_t fMassFormula;        //mass formula for calculating A from Z
+#ifdef WITH_CPP11
+   static std::atomic<UInt_t> fNb_nuc;       //!counts number of existing KVNucleus objects
+#else
    static UInt_t fNb_nuc;       //!counts number of existing KVNucleus objects
+#endif
    static Char_t fElements[][3];        //!symbols of chemical elements
    TString fSymbolName;        //!
 
@@ -25,9 +25,43 @@ $Id: KVParticle.cpp,v 1.50 2009/04/28 08:59:05 franklan Exp $
 #include "TObjString.h"
 #include "TClass.h"
 #include "KVKinematicalFrame.h"
+#include "KVConfig.h"
+#ifdef WITH_CPP11
+#include <mutex>
+#include <atomic>
+#endif
 
 Double_t KVParticle::kSpeedOfLight = TMath::C() * 1.e-07;
 
+namespace {
+   // registry of group names: each name (in upper case) is associated with
+   // the index of a bit in KVParticle::fGroupMask.
+   // Names are only ever added, each one in the next free element of group_name,
+   // before group_number is incremented: names with indices < group_number can
+   // therefore be read without locking the mutex, which only serialises additions.
+   TString group_name[KVParticle::kMaxGroups];
+#ifdef WITH_CPP11
+   std::atomic<Int_t> group_number(0);
+   std::mutex group_registry_mutex;
+#else
+   Int_t group_number = 0;
+#endif
+   Bool_t group_registry_full = kFALSE;
+
+   Int_t find_registered_group(const Char_t* groupname, Int_t first, Int_t last)
+   {
+      // index of group name (case-insensitive) among registered names [first,last), or -1
+      for (Int_t i = first; i < last; ++i)
+         if (group_name[i].EqualTo(groupname, TString::kIgnoreCase)) return i;
+      return -1;
+   }
+}
+#ifdef WITH_CPP11
+#define GROUP_REGISTRY_LOCK std::lock_guard<std::mutex> group_registry_lock(group_registry_mutex)
+#else
+#define GROUP_REGISTRY_LOCK
+#endif
+
 using namespace std;
 
 ClassImp(KVParticle);
@@ -99,8 +133,15 @@ ClassImp(KVParticle);
 //      such as belonging to the QP, to the backward of events or as to be taken into account in the
 //      calorimetry
 //      For KVNucleus and derived classes group can be defined using KVParticleCondition.
-//      For the same particle, number of groups is unlimited.
-//      All these groups are stored in the fGroups pointeur (KVUniqueNameList of TObjString objects)
+//      Each different group name is registered once and for all in a global registry
+//      which associates it with an index (see GetGroupIndex()), and the groups a particle
+//      belongs to are stored as bits in a mask. The registry is never emptied, and can hold
+//      at most kMaxGroups=256 different names (for all particles, during the whole session):
+//      once it is full, groups with new names cannot be added (an error is printed once).
+//      Therefore adding a group, testing whether the particle belongs to a group and
+//      clearing the groups are simple bit operations. In loops over many particles,
+//      BelongsToGroup(Int_t) with the index of the group should be used (this is what
+//      KVEvent::Iterator does for group iterations).
 //
 //      The name of the frame which particle as been created via the SetFrame() method is now stored
 //      in the non persistent field fFrameName
@@ -237,6 +278,7 @@ void KVParticle::init()
    fE0 = 0;
    SetFrameName("");
    fGroups.SetOwner(kTRUE);
+   RemoveAllGroups();
 }
 
 //_________________________________________________________
@@ -399,7 +441,8 @@ void KVParticle::Copy(TObject& obj)
    // The list of parameters associated with the particle is copied
 
    ((KVParticle&) obj) = *this;
-   ((KVParticle&) obj).SetGroups(this->GetGroups());
+   for (Int_t i = 0; i < kMaxGroups / 64; ++i)((KVParticle&) obj).fGroupMask[i] = 0;
+   ((KVParticle&) obj).AddGroups(fGroupMask);
    ((KVParticle&) obj).SetName(this->GetName());
    fParameters.Copy(((KVParticle&) obj).fParameters);
 }
@@ -418,7 +461,7 @@ void KVParticle::Clear(Option_t*)
    ResetIsOK();                 //in case IsOK() status was set "by hand" in previous event
    ResetBit(kIsDetected);
    fParameters.Clear();
-   fGroups.Clear();
+   for (Int_t i = 0; i < kMaxGroups / 64; ++i) fGroupMask[i] = 0;
    fBoosted.Delete();
 }
 
@@ -516,26 +559,20 @@ void KVParticle::AddGroup_Sanscondition(const Char_t* groupname, const Char_t* f
    // Implementation of AddGroup_Sansconditioncon(st Char_t*, const Char_t*)
    // Can be overridden in child classes [instead of AddGroup(const Char_t*, const Char_t*),
    // which cannot]
-   // if this method is overridde in child class
-   // the line
-   //         if (!fGroups) CreateGroups();
-   // has to be included
    // The group will be added to all 'particles' representing different kinematical frames
    // for this particle
 
-   TString sfrom(from);
-   sfrom.ToUpper();
-   TString sgroupname(groupname);
-   sgroupname.ToUpper();
+   Int_t idx = GetGroupIndex(groupname);
+   if (idx < 0) return;
 
-   if (BelongsToGroup(sfrom.Data()) && !BelongsToGroup(sgroupname.Data())) {
-      fGroups.Add(new TObjString(sgroupname.Data()));
+   if (BelongsToGroup(from) && !BelongsToGroup(idx)) {
+      SetGroupBit(idx);
       if (fBoosted.GetEntries()) {
          // recursively add to all boosted particles
          TIter it(&fBoosted);
          KVKinematicalFrame* f;
          while ((f = (KVKinematicalFrame*)it())) {
-            f->GetParticle()->AddGroup(sgroupname);
+            f->GetParticle()->AddGroup(groupname);
          }
       }
    }
@@ -570,7 +607,7 @@ void KVParticle::SetGroups(KVUniqueNameList* un)
 {
    //Define for the particle a new list of groups
    //if there is an existing list, it's deleted
-   fGroups.Clear();
+   for (Int_t i = 0; i < kMaxGroups / 64; ++i) fGroupMask[i] = 0;
    AddGroups(un);
 }
 
@@ -586,6 +623,21 @@ void KVParticle::AddGroups(KVUniqueNameList* un)
 
 }
 
+//___________________________________________________________________________//
+void KVParticle::AddGroups(const ULong64_t* mask)
+{
+   //groups in mask (with the same format as fGroupMask) are added to the current ones
+   //they are also added to all particles stored in fBoosted
+   for (Int_t i = 0; i < kMaxGroups / 64; ++i) fGroupMask[i] |= mask[i];
+   if (fBoosted.GetEntries()) {
+      TIter it(&fBoosted);
+      KVKinematicalFrame* f;
+      while ((f = (KVKinematicalFrame*)it())) {
+         f->GetParticle()->AddGroups(mask);
+      }
+   }
+}
+
 Int_t KVParticle::GetNumberOfDefinedFrames()
 {
    // Returns the total number of defined kinematical frames for this particle.
@@ -605,14 +657,23 @@ Int_t KVParticle::GetNumberOfDefinedFrames()
 Int_t KVParticle::GetNumberOfDefinedGroups(void)
 {
    //return the number of defined groups for the particle
-   return fGroups.GetEntries();
+   Int_t n = 0;
+   for (Int_t i = 0; i < kMaxGroups / 64; ++i) {
+      for (ULong64_t m = fGroupMask[i]; m; m &= (m - 1)) ++n;
+   }
+   return n;
 }
 
 //___________________________________________________________________________//
 KVUniqueNameList* KVParticle::GetGroups() const
 {
    //return the KVUniqueNameList pointeur where list of groups are stored
-   return (KVUniqueNameList*)&fGroups;
+   //N.B. the list is filled with the names of the groups each time this method is called
+   fGroups.Clear();
+   for (Int_t idx = 0; idx < kMaxGroups; ++idx) {
+      if (BelongsToGroup(idx)) fGroups.Add(new TObjString(GetGroupName(idx)));
+   }
+   return &fGroups;
 }
 
 //___________________________________________________________________________//
@@ -622,14 +683,9 @@ Bool_t KVParticle::BelongsToGroup(const Char_t* groupname) const
    //return kTRUE if groupname="".
    //return kFALSE if no group has be defined
 
-   TString sgroupname(groupname);
-   sgroupname.ToUpper();
    //Important for KVEvent::GetNextParticle()
-   if (sgroupname.IsNull()) return kTRUE;
-   //retourne kFALSE si aucun groupe n'est defini
-   if (!fGroups.GetEntries()) return kFALSE;
-   if (fGroups.FindObject(sgroupname.Data())) return kTRUE;
-   return kFALSE;
+   if (!groupname || !groupname[0]) return kTRUE;
+   return BelongsToGroup(FindGroupIndex(groupname));
 }
 
 //___________________________________________________________________________//
@@ -637,19 +693,15 @@ void KVParticle::RemoveGroup(const Char_t* groupname)
 {
    // Remove group from list of groups
    // Apply the method to all particles stored in fBoosted
-   if (!fGroups.GetEntries()) return;
-   TString sgroupname(groupname);
-   sgroupname.ToUpper();
+   Int_t idx = FindGroupIndex(groupname);
+   if (!BelongsToGroup(idx)) return;
 
-   TObjString* os = 0;
-   if ((os = (TObjString*)fGroups.FindObject(sgroupname.Data()))) {
-      delete fGroups.Remove(os);
-      if (fBoosted.GetEntries()) {
-         TIter it(&fBoosted);
-         KVKinematicalFrame* f;
-         while ((f = (KVKinematicalFrame*)it())) {
-            f->GetParticle()->RemoveGroup(sgroupname);
-         }
+   ResetGroupBit(idx);
+   if (fBoosted.GetEntries()) {
+      TIter it(&fBoosted);
+      KVKinematicalFrame* f;
+      while ((f = (KVKinematicalFrame*)it())) {
+         f->GetParticle()->RemoveGroup(groupname);
       }
    }
 }
@@ -659,7 +711,7 @@ void KVParticle::RemoveAllGroups()
 {
    //Remove all groups
    // Apply the method to all particles stored in fBoosted
-   fGroups.Clear();
+   for (Int_t i = 0; i < kMaxGroups / 64; ++i) fGroupMask[i] = 0;
    if (fBoosted.GetEntries()) {
       TIter it(&fBoosted);
       KVKinematicalFrame* f;
@@ -674,19 +726,87 @@ void KVParticle::RemoveAllGroups()
 void KVParticle::ListGroups(void) const
 {
    //List all stored groups
-   if (!fGroups.GetEntries()) {
+   if (!const_cast<KVParticle*>(this)->GetNumberOfDefinedGroups()) {
       cout << "Cette particle n appartient a aucun groupe" << endl;
       return;
    } else {
       cout << "--------------------------------------------------" << endl;
       cout << "Liste des groupes auxquels la particule appartient" << endl;
    }
-   TObjString* os = 0;
-   TIter no(GetGroups());
-   while ((os = (TObjString*)no.Next())) cout << os->GetName() << endl;
+   for (Int_t idx = 0; idx < kMaxGroups; ++idx) {
+      if (BelongsToGroup(idx)) cout << GetGroupName(idx) << endl;
+   }
    cout << "--------------------------------------------------" << endl;
 }
 
+//___________________________________________________________________________//
+
+Int_t KVParticle::GetGroupIndex(const Char_t* groupname)
+{
+   // Static method returning the index associated with the given group name
+   // (case-insensitive). If the name is not yet known, it is added to the global
+   // registry of group names with the next free index.
+   // Indices go from 0 to kMaxGroups-1. Returns -1 for an empty name, or if all
+   // indices are already used (in this case an error message is printed the first
+   // time it happens).
+   //
+   // This index can be used with BelongsToGroup(Int_t) for fast tests in loops.
+
+   if (!groupname || !groupname[0]) return -1;
+   Int_t n = group_number;
+   Int_t idx = find_registered_group(groupname, 0, n);
+   if (idx > -1) return idx;
+   GROUP_REGISTRY_LOCK;
+   // name may have been added by another thread
+   idx = find_registered_group(groupname, n, group_number);
+   if (idx > -1) return idx;
+   n = group_number;
+   if (n == kMaxGroups) {
+      if (!group_registry_full) {
+         ::Error("KVParticle::GetGroupIndex", "Cannot register group %s: maximum number of different group names (%d) reached. "
+                 "Groups with new names will be ignored.", groupname, (Int_t)kMaxGroups);
+         group_registry_full = kTRUE;
+      }
+      return -1;
+   }
+   group_name[n] = groupname;
+   group_name[n].ToUpper();
+   group_number = n + 1;
+   return n;
+}
+
+//___________________________________________________________________________//
+
+Int_t KVParticle::FindGroupIndex(const Char_t* groupname)
+{
+   // Static method returning the index associated with the given group name
+   // (case-insensitive), or -1 if no group with this name has ever been defined.
+   // Unlike GetGroupIndex(), unknown names are not added to the registry.
+
+   if (!groupname || !groupname[0]) return -1;
+   return find_registered_group(groupname, 0, group_number);
+}
+
+//___________________________________________________________________________//
+
+const Char_t* KVParticle::GetGroupName(Int_t idx)
+{
+   // Static method returning the (upper case) name of the group with the given index,
+   // or an empty string if no group has this index
+
+   if (idx < 0 || idx >= group_number) return "";
+   return group_name[idx].Data();
+}
+
+//___________________________________________________________________________//
+
+Int_t KVParticle::GetNumberOfRegisteredGroups()
+{
+   // Static method returning the number of different group names in the registry
+
+   return group_number;
+}
+
 KVParticle KVParticle::InFrame(const KVFrameTransform& t)
 {
    // Use this method to obtain 'on-the-fly' some information on particle kinematics
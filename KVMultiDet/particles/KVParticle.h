@@ -44,7 +44,13 @@ private:
    TString fName;                       //!non-persistent name field - Is useful
    TString fFrameName;                  //!non-persistent frame name field, sets when calling SetFrame method
    KVList fBoosted;                     //!list of momenta of the particle in different Lorentz-boosted frames
-   KVUniqueNameList fGroups;            //!list of TObjString for manage different group name
+public:
+   enum {
+      kMaxGroups = 256       //maximum number of different group names (see GetGroupIndex)
+   };
+private:
+   ULong64_t fGroupMask[kMaxGroups / 64];//!bits set for each group the particle belongs to
+   mutable KVUniqueNameList fGroups;    //!list of TObjString with group names, filled by GetGroups()
    static Double_t kSpeedOfLight;       //speed of light in cm/ns
 
    // TLorentzVector setters should not be used
@@ -127,6 +133,15 @@ protected:
    void CreateGroups();
    void SetGroups(KVUniqueNameList* un);
    void AddGroups(KVUniqueNameList* un);
+   void AddGroups(const ULong64_t* mask);
+   void SetGroupBit(Int_t index)
+   {
+      fGroupMask[index >> 6] |= (1ULL << (index & 63));
+   }
+   void ResetGroupBit(Int_t index)
+   {
+      fGroupMask[index >> 6] &= ~(1ULL << (index & 63));
+   }
 
 public:
 
@@ -345,6 +360,16 @@ public:
    void AddGroup(const Char_t* groupname, KVParticleCondition*);
 
    Bool_t BelongsToGroup(const Char_t* groupname) const;
+   Bool_t BelongsToGroup(Int_t group_index) const
+   {
+      // Check if particle belongs to group with given index (see GetGroupIndex)
+      // return kFALSE if group_index<0 or group_index>=kMaxGroups
+      return group_index >= 0 && group_index < kMaxGroups && ((fGroupMask[group_index >> 6] >> (group_index & 63)) & 1ULL);
+   }
+   static Int_t GetGroupIndex(const Char_t* groupname);
+   static Int_t FindGroupIndex(const Char_t* groupname);
+   static const Char_t* GetGroupName(Int_t group_index);
+   static Int_t GetNumberOfRegisteredGroups();
    void RemoveGroup(const Char_t* groupname);
    void RemoveAllGroups();
    void ListGroups(void) const;
@@ -14,7 +14,10 @@ $Date: 2007/03/26 10:14:56 $
 #include "TSystem.h"
 #include "KVClassFactory.h"
 #include "TPluginManager.h"
-#include "TUUID.h"
+#include "TMD5.h"
+#include "TEnv.h"
+#include "TClass.h"
+#include "KVLockfile.h"
 
 using namespace std;
 
@@ -43,6 +46,30 @@ ClassImp(KVParticleCondition)
 //    KVParticleCondition pc3 = pc && pc2;
 //
 //WARNING: for pc2, see method AddExtraInclude
+//
+//OPTIMISATION
+//The first time that Test() is called, a new class implementing the condition is
+//generated and compiled with ACLiC (see Optimize). The class name is made from a
+//checksum of the condition (with the particle class name, extra '#include' files,
+//and versions of KaliVeda & ROOT), and the source code & library are kept in the
+//directory given by
+//
+//    KVParticleCondition.CacheDirectory:   $(HOME)/.kaliveda/ParticleConditions
+//
+//(see GetCacheDirectory): any later process using the same condition loads the
+//library directly without any compilation. If several jobs (e.g. batch jobs on a
+//computing farm) share this directory, the first job compiles the class while the
+//others wait for it (using KVLockfile).
+//
+//CONDITIONS WITHOUT CODE GENERATION
+//In compiled code (e.g. analysis classes), a condition can be given as any function
+//or lambda expression taking a 'const KVNucleus*' argument and returning bool:
+//
+//    KVParticleCondition pc3("z>2", [](const KVNucleus* nuc){ return nuc->GetZ()>2; });
+//
+//Such conditions are tested directly, without generating or compiling any code.
+//They can be combined with '&&' and '||' with each other or with conditions given
+//as strings.
 ////////////////////////////////////////////////////////////////////////////////
 
 KVHashList KVParticleCondition::fgOptimized;
@@ -89,12 +116,36 @@ KVParticleCondition::KVParticleCondition(const Char_t* cond)
 
 //_____________________________________________________________________________//
 
+#ifdef WITH_CPP11
+KVParticleCondition::KVParticleCondition(const Char_t* name, const std::function<bool(const KVNucleus*)>& func)
+   : KVBase(name, "KVParticleCondition"), fLambda(func)
+{
+   //Create named object with condition given as a function or lambda expression,
+   //for example:
+   //
+   //    KVParticleCondition pc("z>2", [](const KVNucleus* nuc){ return nuc->GetZ()>2; });
+   //
+   //No code is generated or compiled for such a condition (see Test()).
+   fOptimal = 0;
+   cf = 0;
+   fOptOK = kFALSE;
+   fNUsing = 0;
+   fCondition = name;
+}
+#endif
+
+//_____________________________________________________________________________//
+
 Bool_t KVParticleCondition::Test(KVNucleus* nuc)
 {
    //Evaluates the condition for the particle in question
    //If optimisation fails (see method Optimize()), the condition will always
    //be evaluated as 'kFALSE' for all particles
+   //Conditions given as functions/lambdas are evaluated directly.
 
+#ifdef WITH_CPP11
+   if (fLambda) return fLambda(nuc);
+#endif
    if (!fOptimal) Optimize();
 
    return (fOptOK ? fOptimal->Test(nuc) : kFALSE);
@@ -116,6 +167,9 @@ void KVParticleCondition::Set(const Char_t* cond)
    //    KVParticleCondition pc2;
    //    pc2.Set("_NUC_->GetTimeMarker()<110 && _NUC_->GetTimeMarker()>80");
 
+#ifdef WITH_CPP11
+   fLambda = nullptr;
+#endif
    //we add a ";" if there isn't already
    fCondition = cond;
    Ssiz_t ind = fCondition.Index(";");
@@ -136,6 +190,10 @@ void KVParticleCondition::Copy(TObject& obj) const
    KVBase::Copy(obj);
    ((KVParticleCondition&) obj).Set(fCondition.Data());
    ((KVParticleCondition&) obj).fOptOK = fOptOK;
+   ((KVParticleCondition&) obj).fExtraIncludes = fExtraIncludes;
+#ifdef WITH_CPP11
+   ((KVParticleCondition&) obj).fLambda = fLambda;
+#endif
    if (fClassName != "")((KVParticleCondition&) obj).SetParticleClassName(fClassName.Data());
    if (cf) {
       ((KVParticleCondition&) obj).SetClassFactory(cf);
@@ -196,6 +254,17 @@ KVParticleCondition KVParticleCondition::operator&&(const KVParticleCondition& o
    //Perform boolean AND between the two selection conditions
    //If SetParticleClassName has been called for either of the two conditions,
    //it will be called for the resulting condition with the same value
+   //If either condition is given as a function/lambda, the result is a
+   //function which tests both conditions.
+#ifdef WITH_CPP11
+   if (fLambda || obj.fLambda) {
+      KVParticleCondition c1(*this), c2(obj);
+      return KVParticleCondition(Form("(%s) && (%s)", GetName(), obj.GetName()),
+      [c1, c2](const KVNucleus * nuc) mutable {
+         return c1.Test(const_cast<KVNucleus*>(nuc)) && c2.Test(const_cast<KVNucleus*>(nuc));
+      });
+   }
+#endif
    KVParticleCondition tmp(fCondition_brackets + " && " + obj.fCondition_brackets);
    if (fClassName != "") tmp.SetParticleClassName(fClassName);
    else if (obj.fClassName != "") tmp.SetParticleClassName(obj.fClassName);
@@ -209,6 +278,17 @@ KVParticleCondition KVParticleCondition::operator||(const KVParticleCondition& o
    //Perform boolean OR between the two selection conditions
    //If SetParticleClassName has been called for either of the two conditions,
    //it will be called for the resulting condition with the same value
+   //If either condition is given as a function/lambda, the result is a
+   //function which tests both conditions.
+#ifdef WITH_CPP11
+   if (fLambda || obj.fLambda) {
+      KVParticleCondition c1(*this), c2(obj);
+      return KVParticleCondition(Form("(%s) || (%s)", GetName(), obj.GetName()),
+      [c1, c2](const KVNucleus * nuc) mutable {
+         return c1.Test(const_cast<KVNucleus*>(nuc)) || c2.Test(const_cast<KVNucleus*>(nuc));
+      });
+   }
+#endif
    KVParticleCondition tmp(fCondition_brackets + " || " + obj.fCondition_brackets);
    if (fClassName != "") tmp.SetParticleClassName(fClassName);
    else if (obj.fClassName != "") tmp.SetParticleClassName(obj.fClassName);
@@ -246,6 +326,8 @@ void KVParticleCondition::AddExtraInclude(const Char_t* inc_file)
 
    CreateClassFactory();
    cf->AddImplIncludeFile(inc_file);
+   fExtraIncludes += inc_file;
+   fExtraIncludes += " ";
 }
 
 //_____________________________________________________________________________//
@@ -256,15 +338,88 @@ void KVParticleCondition::CreateClassFactory()
 
    if (cf) return;
 
-   // unique name for new class
-   TUUID unique;
-   KVString new_class = unique.AsString();
-   // only first 8 characters are unique
-   new_class.Remove(8);
-   new_class.Prepend("KVParticleCondition_");
+   //create new class (final name is set by Optimize(), see GetOptimizedClassName())
+   cf = new KVClassFactory(GetOptimizedClassName(), "Particle condition to test", "KVParticleCondition");
+}
+
+//_____________________________________________________________________________//
+
+TString KVParticleCondition::GetOptimizedClassName() const
+{
+   //Name of the class generated by Optimize() for this condition:
+   //"KVParticleCondition_" followed by the first 16 characters of the MD5 checksum
+   //of the condition, the particle class name, any extra '#include' files, and the
+   //versions of KaliVeda and ROOT.
+
+   TString key;
+   key.Form("%s|%s|%s|%s|%s", fCondition.Data(), fClassName.Data(), fExtraIncludes.Data(),
+            GetKVVersion(), gROOT->GetVersion());
+   TMD5 md5;
+   md5.Update((const UChar_t*)key.Data(), key.Length());
+   md5.Final();
+   TString name = md5.AsString();
+   name.Remove(16);
+   name.Prepend("KVParticleCondition_");
+   return name;
+}
+
+//_____________________________________________________________________________//
 
-   //create new class
-   cf = new KVClassFactory(new_class.Data(), "Particle condition to test", "KVParticleCondition");
+TString KVParticleCondition::GetCacheDirectory()
+{
+   //Directory where the source code and libraries of optimized conditions are kept,
+   //given by the value of
+   //
+   //    KVParticleCondition.CacheDirectory:
+   //
+   //(environment variables and '~' are expanded). By default, this is the
+   //'ParticleConditions' subdirectory of the user's KaliVeda working directory.
+   //Several users/jobs can share the same directory, e.g. on a computing farm.
+
+   TString dir = gEnv->GetValue("KVParticleCondition.CacheDirectory", "");
+   if (dir == "") dir = GetWORKDIRFilePath("ParticleConditions");
+   gSystem->ExpandPathName(dir);
+   return dir;
+}
+
+//_____________________________________________________________________________//
+
+KVParticleCondition* KVParticleCondition::LoadOptimizedClass(const TString& classname)
+{
+   //Return a new object of the class generated for this condition.
+   //If the class is not already loaded, we look for it in the cache directory
+   //(GetCacheDirectory()): if the source code does not exist it is generated,
+   //then it is compiled (if necessary) and loaded with ACLiC. The directory is
+   //locked during generation/compilation so that several processes sharing it
+   //do not generate/compile the same class at the same time.
+   //Returns 0 in case of problems.
+
+   TClass* cl = TClass::GetClass(classname);
+   if (!cl || !cl->IsLoaded()) {
+      TString dir = GetCacheDirectory();
+      gSystem->mkdir(dir, kTRUE);
+      KVLockfile lock(Form("%s/%s", dir.Data(), classname.Data()));
+      lock.SetSleeptime(1);
+      lock.SetTimeout(600);
+      if (!lock.Lock()) {
+         Error("LoadOptimizedClass", "Cannot get lock on %s in %s", classname.Data(), dir.Data());
+         return 0;
+      }
+      TString imp = Form("%s/%s.cpp", dir.Data(), classname.Data());
+      if (gSystem->AccessPathName(imp)) {
+         // generate .cpp and .h for new class
+         cf->SetOutputPath(dir);
+         cf->GenerateCode();
+      } else
+         Info("LoadOptimizedClass", "Using cached code for %s", classname.Data());
+      // compile only if library is missing or out of date
+      Int_t ok = gSystem->CompileMacro(imp, "kO", "", dir);
+      lock.Release();
+      if (!ok) return 0;
+      cl = TClass::GetClass(classname);
+      if (!cl) return 0;
+   }
+   return (KVParticleCondition*)cl->New();
 }
 
 //_____________________________________________________________________________//
@@ -274,12 +429,14 @@ void KVParticleCondition::Optimize()
    //Generate a new class which inherits from KVParticleCondition but having a Test
    //method which tests explicitely the condition which is set by the user.
    //The 'KVNucleus' pointer argument is casted to the type given to SetParticleClassName.
-   //The new class is added to the list of plugins of type KVParticleCondition,
-   //then an instance of the class is generated and a pointer to it stored in fOptimal.
+   //An instance of the class is generated and a pointer to it stored in fOptimal.
    //This object is then used in the Test method of this object to test the condition.
 
+   //The class is compiled only once: see GetCacheDirectory() and LoadOptimizedClass().
+
+   TString classname = GetOptimizedClassName();
    /* check that the same condition has not already been optimized */
-   fOptimal = (KVParticleCondition*)fgOptimized.FindObject(GetName());
+   fOptimal = (KVParticleCondition*)fgOptimized.FindObject(classname);
    if (fOptimal) {
       //Info("Optimize", "Using existing optimized condition %p", fOptimal);
       fOptimal->fNUsing++;
@@ -289,6 +446,7 @@ void KVParticleCondition::Optimize()
    Info("Optimize", "Optimization of KVParticleCondition : %s", fCondition.Data());
 
    CreateClassFactory();
+   cf->SetClassName(classname);
    //add Test() method
    cf->AddMethod("Test", "Bool_t");
    cf->AddMethodArgument("Test", "KVNucleus*", "nuc");
@@ -310,31 +468,10 @@ void KVParticleCondition::Optimize()
 
    cf->AddMethodBody("Test", body);
 
-   //generate .cpp and .h for new class
-   cf->GenerateCode();
-
-   //add plugin for new class
-   gROOT->GetPluginManager()->AddHandler("KVParticleCondition", cf->GetClassName(), cf->GetClassName(),
-                                         Form("%s+", cf->GetImpFileName()), Form("%s()", cf->GetClassName()));
-   //load plugin
-   TPluginHandler* ph;
-   if (!(ph = LoadPlugin("KVParticleCondition", cf->GetClassName()))) {
-      Error("Optimize", " *** Optimization failed for KVParticleCondition : %s", fCondition.Data());
-      Error("Optimize", " *** Use method AddExtraInclude(const Char_t*) to give the names of all necessary header files for compilation of your condition.");
-      Fatal("Optimize", " *** THIS CONDITION WILL BE EVALUATED AS kFALSE FOR ALL PARTICLES!!!");
-      delete cf;
-      cf = 0;
-      //we set fOptimal to a non-zero value to avoid calling Optimize
-      //every time that Test() is called subsequently.
-      fOptimal = this;
-      fOptOK = kFALSE;
-      return;
-   }
-   fOptOK = kTRUE;
+   //generate (if needed), compile (if needed) & load class, create instance
+   fOptimal = LoadOptimizedClass(classname);
    delete cf;
    cf = 0;
-   //execute constructor
-   fOptimal = (KVParticleCondition*) ph->ExecPlugin(0);
 
    Info("Optimize", "fOptimal = %p", fOptimal);
    if (!fOptimal) {
@@ -345,9 +482,11 @@ void KVParticleCondition::Optimize()
       //every time that Test() is called subsequently.
       fOptimal = this;
       fOptOK = kFALSE;
+      return;
    }
+   fOptOK = kTRUE;
    // add to list of optimized conditions
-   fOptimal->SetName(GetName());
+   fOptimal->SetName(classname);
    fgOptimized.Add(fOptimal);
    fOptimal->fNUsing++;
    Info("Optimize", "Success");
@@ -359,6 +498,9 @@ void KVParticleCondition::Print(Option_t*) const
    Info("Print", "object name = %s, address = %p", GetName(), this);
    cout << " * condition = " << fCondition.Data() << endl;
    cout << " * classname = " << fClassName.Data() << endl;
+#ifdef WITH_CPP11
+   if (fLambda) cout << " * condition is a function/lambda" << endl;
+#endif
    cout << " * fOptimal = " << fOptimal << endl;
    cout << " * fNUsing = " << fNUsing << endl;
    if (cf) {
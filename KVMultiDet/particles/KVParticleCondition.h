@@ -13,6 +13,10 @@ $Date: 2007/03/26 10:14:56 $
 #include "KVBase.h"
 #include "KVString.h"
 #include "KVHashList.h"
+#include "KVConfig.h"
+#ifdef WITH_CPP11
+#include <functional>
+#endif
 class KVNucleus;
 class KVClassFactory;
 
@@ -30,8 +34,14 @@ protected:
    KVString fClassName;//!
    KVClassFactory* cf;//! used to generate code for optimisation
    Bool_t fOptOK;//!false if optimisation failed (can't load generated code)
+   KVString fExtraIncludes;//! extra '#include' files given to AddExtraInclude
+#ifdef WITH_CPP11
+   std::function<bool(const KVNucleus*)> fLambda;//! condition given as function/lambda
+#endif
 
    void Optimize();
+   TString GetOptimizedClassName() const;
+   KVParticleCondition* LoadOptimizedClass(const TString& classname);
    void CreateClassFactory();
    void SetClassFactory(KVClassFactory* CF);
 
@@ -40,6 +50,14 @@ public:
    KVParticleCondition();
    KVParticleCondition(const KVParticleCondition&);
    KVParticleCondition(const Char_t* cond);
+#ifdef WITH_CPP11
+   KVParticleCondition(const Char_t* name, const std::function<bool(const KVNucleus*)>& func);
+   Bool_t IsLambda() const
+   {
+      // kTRUE if condition is given as a function/lambda (no code generation)
+      return (bool)fLambda;
+   }
+#endif
    virtual ~KVParticleCondition();
    virtual void Set(const Char_t*);
    virtual Bool_t Test(KVNucleus*);
@@ -62,6 +80,7 @@ public:
    {
       fgOptimized.Print();
    }
+   static TString GetCacheDirectory();
 
    ClassDef(KVParticleCondition, 1) //Implements parser of particle selection criteria
 };
@@ -3,6 +3,7 @@
 
 #include "KVSimNucleus.h"
 #include "TVector3.h"
+#include "TEnv.h"
 
 ClassImp(KVSimNucleus)
 
@@ -118,9 +119,15 @@ Double_t KVSimNucleus::GetEnergyLoss(const TString& detname) const
    // For particles whose detection has been simulated in a KVMultiDetArray:
    // return the energy loss in given detector
    // returns -1.0 if detector not hit
+   // N.B. requires storage of particle parameters by the navigator of the array
+   // (see KVRangeTableGeoNavigator::SetStoreParticleParameters), which is no longer
+   // the default (KVRangeTableGeoNavigator.StoreParticleParameters: no). A warning
+   // is printed the first time it is called for a particle without any stored
+   // energy losses if storage is disabled.
 
    TString parname;
    parname.Form("DE:%s", detname.Data());
+   if (!GetParameters()->HasParameter(parname)) CheckTrackParametersStored("GetEnergyLoss");
    return GetParameters()->GetDoubleValue(parname);
 }
 
@@ -129,6 +136,11 @@ TVector3 KVSimNucleus::GetEntrancePosition(const TString& detname) const
    // For particles whose detection has been simulated in a KVMultiDetArray:
    // returns coordinates of point of entry in detector
    // returns (0,0,0) (coordinate origin) if detector not hit
+   // N.B. requires storage of particle parameters by the navigator of the array
+   // (see KVRangeTableGeoNavigator::SetStoreParticleParameters), which is no longer
+   // the default (KVRangeTableGeoNavigator.StoreParticleParameters: no). A warning
+   // is printed the first time it is called for a particle without any stored
+   // energy losses if storage is disabled.
    TString parname;
    parname.Form("Xin:%s", detname.Data());
    if (GetParameters()->HasParameter(parname)) {
@@ -137,6 +149,7 @@ TVector3 KVSimNucleus::GetEntrancePosition(const TString& detname) const
       Double_t z = GetParameters()->GetDoubleValue(Form("Zin:%s", detname.Data()));
       return TVector3(x, y, z);
    }
+   CheckTrackParametersStored("GetEntrancePosition");
    return TVector3(0, 0, 0);
 }
 
@@ -145,6 +158,11 @@ TVector3 KVSimNucleus::GetExitPosition(const TString& detname) const
    // For particles whose detection has been simulated in a KVMultiDetArray:
    // returns coordinates of point of exit from detector
    // returns (0,0,0) (coordinate origin) if detector not hit
+   // N.B. requires storage of particle parameters by the navigator of the array
+   // (see KVRangeTableGeoNavigator::SetStoreParticleParameters), which is no longer
+   // the default (KVRangeTableGeoNavigator.StoreParticleParameters: no). A warning
+   // is printed the first time it is called for a particle without any stored
+   // energy losses if storage is disabled.
    TString parname;
    parname.Form("Xout:%s", detname.Data());
    if (GetParameters()->HasParameter(parname)) {
@@ -153,9 +171,28 @@ TVector3 KVSimNucleus::GetExitPosition(const TString& detname) const
       Double_t z = GetParameters()->GetDoubleValue(Form("Zout:%s", detname.Data()));
       return TVector3(x, y, z);
    }
+   CheckTrackParametersStored("GetExitPosition");
    return TVector3(0, 0, 0);
 }
 
+void KVSimNucleus::CheckTrackParametersStored(const Char_t* method) const
+{
+   // Called when a parameter "DE:...", "Xin:..." etc. is not found for this particle.
+   // If the particle has no stored energy losses at all and storage of particle
+   // parameters during simulated detection is disabled, print a warning (only once)
+   // explaining how to enable it.
+
+   static Bool_t warned = kFALSE;
+   if (warned || gEnv->GetValue("KVRangeTableGeoNavigator.StoreParticleParameters", kFALSE)) return;
+   for (Int_t i = 0; i < GetParameters()->GetNpar(); ++i) {
+      if (!strncmp(GetParameters()->GetNameAt(i), "DE:", 3)) return;
+   }
+   warned = kTRUE;
+   Warning(method, "No energy losses or entry/exit points stored in particle. By default these are not stored "
+           "during simulated detection: call KVRangeTableGeoNavigator::SetStoreParticleParameters() or set "
+           "KVRangeTableGeoNavigator.StoreParticleParameters: yes in your .kvrootrc file");
+}
+
 void KVSimNucleus::Print(Option_t* t) const
 {
    KVNucleus::Print(t);
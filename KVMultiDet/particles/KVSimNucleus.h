@@ -15,6 +15,8 @@ protected:
    TVector3 position;   // vector position of the particle in fm
    TVector3 angmom;  // angular momentum of the particle in units
    Double_t fDensity;   //density of the nucleus in nuc.fm-3
+
+   void CheckTrackParametersStored(const Char_t* method) const;
 public:
 
    KVSimNucleus() : KVNucleus() {}
@@ -53,6 +53,11 @@ ClassImp(KVEventFiltering)
 //                give option PhiRot=no
 //    Gemini:     if option Gemini=yes, then each event will be "decayed" with Gemini++,
 //                if KaliVeda has been compiled with Gemini++ support.
+//    RandomSeed: seed used for the random numbers of each event (default: 4357): phi rotation
+//                and simulated detection. These depend only on this seed, the name
+//                of the simulation file and the number of the event in the file, so that
+//                filtered data is always the same whatever the order in which events are
+//                treated (see below).
 //
 // The filtered data will be written in the directory given as option "OutputDir".
 // The filename is built up from the original simulation filename and the values
@@ -63,6 +68,28 @@ ClassImp(KVEventFiltering)
 // The data will be stored in a TTree with name 'ReconstructedEvents', in a branch with name
 // 'ReconEvent'. The class used for reconstructed events depends on the dataset,
 // it is given by KVDataSet::GetReconstructedEventClassName().
+//
+// PARALLEL FILTERING
+// As the detectors of the array accumulate the energy losses and hits of each event,
+// and as the array is accessed through global pointers (gMultiDetArray, gGeoManager, ...),
+// one array can only be used to filter one event at a time. In order to filter events in
+// parallel, use PROOFLite (batch system 'PROOFLite'): each worker process builds its own
+// array and filters a part of the events, and the filtered data of all workers is merged
+// into the same output file at the end. The number of workers is given by variable
+// PROOFLite.BatchSystem.NumberOfWorkers.
+// Each reconstructed event has the same number (KVEvent::GetNumber) as the entry of the
+// corresponding simulated event in the simulation file (when all events of a file are
+// filtered, this is the same numbering 0, 1, 2, ... as in previous versions; if some
+// entries are skipped, e.g. with TTree::Process(...,nentries,firstentry), the numbers
+// are no longer consecutive). The random generators used for the phi rotation and
+// for the simulated detection are re-seeded for each event (see GetEventSeed),
+// so that they do not depend on the worker which treated the event. They belong to
+// the KVEventFiltering object: during the simulated detection of each event, gRandom
+// points to the detection generator, and is then restored, so that gRandom is not
+// re-seeded. Therefore the result
+// is the same as for sequential filtering, apart from the order of events in the output
+// TTree, except if the events are decayed with Gemini++, which uses its own random
+// number generator.
 ////////////////////////////////////////////////////////////////////////////////
 
 KVEventFiltering::KVEventFiltering()
@@ -72,6 +99,8 @@ KVEventFiltering::KVEventFiltering()
    fNewFrame = "";
    fRotate = kTRUE;
    fGemini = kFALSE;
+   fRandomSeed = 4357;
+   fFileSeed = 0;
 }
 
 //________________________________________________________________
@@ -86,6 +115,7 @@ KVEventFiltering::KVEventFiltering(const KVEventFiltering& obj)  : KVEventSelect
 
    fTransformKinematics = kTRUE;
    fNewFrame = "";
+   fFileSeed = 0;
    obj.Copy(*this);
 }
 
@@ -109,18 +139,41 @@ void KVEventFiltering::Copy(TObject& obj) const
    KVEventFiltering& CastedObj = (KVEventFiltering&)obj;
    CastedObj.fRotate = fRotate;
    CastedObj.fGemini = fGemini;
+   CastedObj.fRandomSeed = fRandomSeed;
 }
 
-void KVEventFiltering::RandomRotation(KVEvent* to_rotate, const TString& frame_name) const
+void KVEventFiltering::RandomRotation(KVEvent* to_rotate, const TString& frame_name)
 {
    // do random phi rotation around z-axis
    // if frame_name is given, apply rotation to that frame
+   //
+   // The random generator is re-seeded for each event using the number of the event in
+   // the current file, so that the rotation of each event is reproducible whatever
+   // the order in which events are treated (parallel filtering with PROOFLite).
+   fRotationRandom.SetSeed(GetEventSeed(0));
    TRotation r;
-   r.RotateZ(gRandom->Uniform(TMath::TwoPi()));
+   r.RotateZ(fRotationRandom.Uniform(TMath::TwoPi()));
    if (frame_name != "") to_rotate->SetFrame("rotated_frame", frame_name, r);
    else to_rotate->SetFrame("rotated_frame", r);
 }
 
+UInt_t KVEventFiltering::GetEventSeed(UInt_t stream) const
+{
+   // Seed for the random numbers used to treat the current event, depending only on
+   // the RandomSeed option, the name of the current file and the entry number.
+   // Different values of stream give independent seeds: stream=0 is used for the
+   // phi rotation, stream=1 for the simulated detection.
+   // The seed is a splitmix64 hash of these values, so that seeds of successive entries
+   // are not correlated. It is never 0, which would make TRandom3 use a time-dependent seed.
+
+   ULong64_t z = (((ULong64_t)fFileSeed << 32) | stream) + (ULong64_t)(fTreeEntry + 1) * 0x9E3779B97F4A7C15ULL;
+   z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+   z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+   z ^= (z >> 31);
+   UInt_t seed = (UInt_t)(z ^ (z >> 32));
+   return (seed ? seed : 4357);
+}
+
 Bool_t KVEventFiltering::Analysis()
 {
    // Event-by-event filtering of simulated data.
@@ -129,6 +182,9 @@ Bool_t KVEventFiltering::Analysis()
    // Detection of particles in event is simulated with KVMultiDetArray::DetectEvent,
    // then the reconstructed detected event is treated by the same identification and calibration
    // procedures as for experimental data.
+   // The detection is simulated with gRandom pointing to our own generator, re-seeded
+   // for each event (see GetEventSeed), so that it does not depend on the order in which
+   // events are treated; gRandom is restored afterwards.
 
    KVEvent* to_be_detected = GetEvent();
    if (fGemini) {
@@ -138,6 +194,9 @@ Bool_t KVEventFiltering::Analysis()
       to_be_detected = &fGemEvent;
 #endif
    }
+   fDetectionRandom.SetSeed(GetEventSeed(1));
+   TRandom* user_random = gRandom;
+   gRandom = &fDetectionRandom;
    if (fTransformKinematics) {
       if (fNewFrame == "proj")   to_be_detected->SetFrame("lab", fProjVelocity);
       else                    to_be_detected->SetFrame("lab", fCMVelocity);
@@ -155,9 +214,12 @@ Bool_t KVEventFiltering::Analysis()
          gMultiDetArray->DetectEvent(to_be_detected, fReconEvent);
       }
    }
-   fReconEvent->SetNumber(fEVN++);
+   gRandom = user_random;
+   // use number of simulated event in file, independent of order of treatment of events
+   fReconEvent->SetNumber(fTreeEntry);
+   fEVN++;
    fReconEvent->SetFrameName("lab");
-   fTree->Fill();
+   fTreeOutput.FillTree(fTree);
 
    /*    if (!(fEventsRead % fEventsReadInterval) && fEventsRead) {
          memory_check.Check();
@@ -168,6 +230,8 @@ Bool_t KVEventFiltering::Analysis()
 
 void KVEventFiltering::EndAnalysis()
 {
+   // Print time spent filling output tree (the tree is written by KVEventSelector::SlaveTerminate)
+   fTreeOutput.PrintReport();
 }
 
 void KVEventFiltering::EndRun()
@@ -275,7 +339,9 @@ void KVEventFiltering::InitAnalysis()
    if (IsOptGiven("PhiRot")) {
       if (GetOpt("PhiRot") == "no") fRotate = kFALSE;
    }
+   if (IsOptGiven("RandomSeed")) fRandomSeed = (UInt_t)GetOpt("RandomSeed").Atoll();
    if (fRotate) Info("InitAnalysis", "Random phi rotation around beam axis performed for each event");
+   Info("InitAnalysis", "Random numbers of each event depend on seed=%u", fRandomSeed);
 #ifdef WITH_GEMINI
    if (IsOptGiven("Gemini")) {
       if (GetOpt("Gemini") == "yes") fGemini = kTRUE;
@@ -306,12 +372,16 @@ void KVEventFiltering::InitAnalysis()
    KVEvent::MakeEventBranch(fTree, "ReconEvent", reconevclass, &fReconEvent);
 
    AddTree(fTree);
+   fTreeOutput.Reset();
+   fTreeOutput.AddTree(fTree);
 }
 
 void KVEventFiltering::InitRun()
 {
 //   memory_check.SetInitStatistics();
    fEVN = 0;
+   // seed for random rotations depends on name (not full path) of current file
+   fFileSeed = fRandomSeed ^ TString(gSystem->BaseName(fChain->GetCurrentFile()->GetName())).Hash();
 }
 
 void KVEventFiltering::OpenOutputFile(KVDBSystem* S, Int_t run)
@@ -334,6 +404,7 @@ void KVEventFiltering::OpenOutputFile(KVDBSystem* S, Int_t run)
    // KEY: TNamed Origin;1 title=[name of simulation file]
    // KEY: TNamed RandomPhi;1 title=[yes/no, random rotation about beam axis]
    // KEY: TNamed Gemini++;1 title=[yes/no, Gemini++ decay before detection]
+   // KEY: TNamed RandomSeed;1 title=[seed for random numbers of each event]
    //
    TString basefile = GetOpt("SimFileName");
    basefile.Remove(basefile.Index(".root"), 5);
@@ -389,5 +460,6 @@ void KVEventFiltering::OpenOutputFile(KVDBSystem* S, Int_t run)
    (new TNamed("Origin", (basefile + ".root").Data()))->Write();
    (new TNamed("RandomPhi", (fRotate ? "yes" : "no")))->Write();
    (new TNamed("Gemini++", (fGemini ? "yes" : "no")))->Write();
+   (new TNamed("RandomSeed", Form("%u", fRandomSeed)))->Write();
    curdir->cd();
 }
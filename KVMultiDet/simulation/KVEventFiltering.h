@@ -8,6 +8,8 @@
 #include "KVClassMonitor.h"
 #include "KVReconstructedEvent.h"
 #include <KVSimEvent.h>
+#include "TRandom3.h"
+#include "KVTreeOutput.h"
 
 class KVDBSystem;
 class KVEventFiltering : public KVEventSelector {
@@ -16,8 +18,14 @@ class KVEventFiltering : public KVEventSelector {
    Bool_t fRotate;//true if random phi rotation should be applied [default: yes]
    Bool_t fGemini;//true if Gemini++ decay should be performed before detection [default: no]
    KVSimEvent fGemEvent;//event after decay with Gemini
-
-   void RandomRotation(KVEvent* to_rotate, const TString& frame_name = "") const;
+   UInt_t fRandomSeed;//seed for random numbers of each event (rotation & detection) [default: 4357]
+   UInt_t fFileSeed;//! seed deduced from fRandomSeed and name of current file
+   TRandom3 fRotationRandom;//! generator for random phi rotations
+   TRandom3 fDetectionRandom;//! generator used as gRandom during simulated detection
+   KVTreeOutput fTreeOutput;//! fills output tree, compression & I/O timing
+
+   UInt_t GetEventSeed(UInt_t stream) const;
+   void RandomRotation(KVEvent* to_rotate, const TString& frame_name = "");
 public:
    KVEventFiltering();
    KVEventFiltering(const KVEventFiltering&) ;
@@ -39,7 +47,7 @@ public:
    Bool_t fTransformKinematics;//=kTRUE if simulation not in lab frame
    TString fNewFrame;   //allow the definition of a specific frame
 
-   ClassDef(KVEventFiltering, 1) //Filter simulated events with multidetector response
+   ClassDef(KVEventFiltering, 2) //Filter simulated events with multidetector response
 };
 
 #endif
@@ -3,6 +3,15 @@
 
 #include "KVSimReader.h"
 #include "TDirectory.h"
+#include "TEnv.h"
+#include "TClass.h"
+#ifdef WITH_CPP11
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#endif
 
 ClassImp(KVSimReader)
 
@@ -38,6 +47,16 @@ ClassImp(KVSimReader)
 // To convert primary events (before secondary decay) from an ELIE simulation in file "elie.out", do:
 //
 //    kaliveda[0] KVSimReader::MakeReader("ELIE")->ConvertAndSaveEventsInFile("elie.out")
+//
+// PARALLEL CONVERSION
+// For models whose events can be read independently of each other (see CanReadInParallel),
+// large files can be converted using several threads (see SetNumberOfThreads):
+// the file is memory-mapped (see KVFileReader::UseMemoryMapping), split into chunks
+// of consecutive events (see SetChunkSize) which are converted by different threads,
+// and the events are written in the TTree in the same order as in the file.
+// The default number of threads is given by
+//
+//    KVSimReader.NumberOfThreads:   1
 ////////////////////////////////////////////////////////////////////////////////
 
 //____________________________________________________
@@ -61,6 +80,10 @@ void KVSimReader::init()
 
    nv = new KVNameValueList();
 
+   fNThreads = 1;
+   fChunkSize = 1000;
+   SetNumberOfThreads(gEnv->GetValue("KVSimReader.NumberOfThreads", 1));
+
    CreateObjectList();
    CreateInfoList();
 
@@ -73,9 +96,40 @@ KVSimReader::KVSimReader()
    init();
 }
 
+void KVSimReader::SetNumberOfThreads(Int_t n)
+{
+   // Set number of threads used to convert events.
+   //
+   //  n = 1 : events are read one after the other
+   //  n > 1 : chunks of events are converted by n-1 threads, while the calling
+   //          thread writes them in the TTree
+   //  n = 0 : use as many threads as there are cores on the machine
+   //
+   // This is only used for models which can be read in parallel (see CanReadInParallel).
+   // Parallel reading requires compilation with C++11; otherwise n is always set to 1.
+
+#ifdef WITH_CPP11
+   if (n == 0) n = TMath::Max(1, (Int_t)std::thread::hardware_concurrency());
+   fNThreads = TMath::Max(1, n);
+   if (fNThreads > 1) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+      ROOT::EnableThreadSafety();
+#endif
+   }
+#else
+   if (n != 1) Warning("SetNumberOfThreads", "Parallel reading of files requires C++11: using 1 thread");
+   fNThreads = 1;
+#endif
+}
+
 void KVSimReader::ConvertEventsInFile(KVString filename)
 {
    // Method called by constructors with KVString filename argument
+   //
+   // If the model can be read in parallel (see CanReadInParallel) and more than
+   // one thread is used (see SetNumberOfThreads), the file is memory-mapped.
+
+   if (fNThreads > 1 && CanReadInParallel()) UseMemoryMapping();
    if (!OpenFileToRead(filename)) return;
 
    Run();
@@ -242,6 +296,117 @@ Bool_t KVSimReader::ReadNucleus()
    return kTRUE;
 }
 
+//____________________________________________________
+void KVSimReader::ReadFileInParallel()
+{
+   // Convert all events in (memory-mapped) file using several threads.
+   //
+   // After reading the file header (ReadFileHeader), the positions of the
+   // beginning of each chunk of fChunkSize events are found with SkipEvent.
+   // Each chunk is then converted by one of fNThreads-1 worker threads, using
+   // a new reader of the same class reading only this part of the file
+   // (KVFileReader::OpenMappedRange) with a new KVSimEvent for each event.
+   // The calling thread calls ProcessEvent (i.e. fills the TTree) for each
+   // event in the same order as in the file. To limit memory consumption, workers
+   // can only convert chunks up to 2*(fNThreads-1) chunks ahead of the chunk
+   // being written.
+
+#ifdef WITH_CPP11
+   if (!ReadFileHeader()) return;
+
+   std::vector<Long64_t> offsets;
+   offsets.push_back(GetPosition());
+   Int_t ntot = 0;
+   while (SkipEvent()) {
+      if (++ntot % fChunkSize == 0) offsets.push_back(GetPosition());
+   }
+   if (ntot % fChunkSize) offsets.push_back(GetPosition());
+   Int_t nchunks = offsets.size() - 1;
+   Info("ReadFileInParallel", "%d evts in %d chunks to convert with %d threads", ntot, nchunks, fNThreads);
+
+   // set up environment & nuclear data tables before starting threads, with a real
+   // look-up in the tables; keeping this nucleus alive until all threads have finished
+   // ensures that they are not set up again by the nuclei created in the threads
+   KVSimNucleus first_nuc;
+   first_nuc.SetZandA(6, 12);
+   first_nuc.GetMassExcess();
+
+   struct chunk {
+      std::vector<KVSimEvent*> events;
+      Bool_t done;
+   };
+   std::vector<chunk> chunks(nchunks);
+   std::mutex chunk_mutex;
+   std::condition_variable chunk_done, chunk_written;
+   std::atomic<int> next_chunk(0);
+   int writing = 0;
+   const int nworkers = fNThreads - 1;
+   const int max_ahead = 2 * nworkers;
+
+   auto worker = [&]() {
+      KVSimReader* reader = (KVSimReader*)IsA()->New();
+      InitParallelReader(reader);
+      int i;
+      while ((i = next_chunk++) < nchunks) {
+         {
+            std::unique_lock<std::mutex> lock(chunk_mutex);
+            chunk_written.wait(lock, [&]() {
+               return i < writing + max_ahead;
+            });
+         }
+         std::vector<KVSimEvent*> events;
+         if (reader->OpenMappedRange(*this, offsets[i], offsets[i + 1])) {
+            reader->nevt = i * fChunkSize;
+            Int_t nread = TMath::Min(fChunkSize, ntot - i * fChunkSize);
+            for (Int_t n = 0; n < nread; ++n) {
+               reader->evt = new KVSimEvent;
+               if (!reader->ReadEvent()) {
+                  delete reader->evt;
+                  break;
+               }
+               events.push_back(reader->evt);
+            }
+            reader->evt = 0;
+         }
+         std::lock_guard<std::mutex> lock(chunk_mutex);
+         chunks[i].events.swap(events);
+         chunks[i].done = kTRUE;
+         chunk_done.notify_all();
+      }
+      delete reader;
+   };
+
+   for (auto& c : chunks) c.done = kFALSE;
+   std::vector<std::thread> workers;
+   for (int t = 0; t < nworkers; ++t) workers.emplace_back(worker);
+
+   KVSimEvent* main_evt = evt;
+   for (int i = 0; i < nchunks; ++i) {
+      std::vector<KVSimEvent*> events;
+      {
+         std::unique_lock<std::mutex> lock(chunk_mutex);
+         chunk_done.wait(lock, [&]() {
+            return chunks[i].done;
+         });
+         events.swap(chunks[i].events);
+      }
+      for (std::vector<KVSimEvent*>::iterator it = events.begin(); it != events.end(); ++it) {
+         evt = *it;
+         ProcessEvent();
+         if (++nevt % 1000 == 0) Info("ReadFileInParallel", "%d evts lus", nevt);
+         delete evt;
+      }
+      std::lock_guard<std::mutex> lock(chunk_mutex);
+      ++writing;
+      chunk_written.notify_all();
+   }
+   for (auto& w : workers) w.join();
+   evt = main_evt;
+#else
+   ReadFile();
+#endif
+}
+
 void KVSimReader::ConvertAndSaveEventsInFile(KVString filename)
 {
    // Read events, convert and save in ROOT file
@@ -276,7 +441,8 @@ void KVSimReader::Run(Option_t* option)
    nuc = 0;
    nevt = 0;
 
-   ReadFile();
+   if (fNThreads > 1 && CanReadInParallel() && IsMemoryMapped()) ReadFileInParallel();
+   else ReadFile();
 
    if (HasToFill())
       GetTree()->ResetBranchAddress(GetTree()->GetBranch(branch_name.Data()));
@@ -47,6 +47,34 @@ protected:
 
    KVNameValueList* nv;
 
+   Int_t fNThreads;//! number of threads used to convert events (see SetNumberOfThreads)
+   Int_t fChunkSize;//! number of events in each chunk of file converted by one thread
+
+   virtual Bool_t ReadFileHeader()
+   {
+      // Read anything which comes before the first event in the file.
+      // Called by ReadFileInParallel() before reading events.
+      return kTRUE;
+   }
+   virtual Bool_t SkipEvent()
+   {
+      // Skip next event in file without converting it (used to find the
+      // boundaries between events before reading file in parallel).
+      // Returns kFALSE at end of file.
+      return kFALSE;
+   }
+   virtual void ProcessEvent()
+   {
+      // Called for each event read from file (in event order)
+      if (HasToFill()) FillTree();
+   }
+   virtual void InitParallelReader(KVSimReader*) const
+   {
+      // Called for each of the readers used to convert events in parallel, in
+      // order to copy any settings required by ReadEvent() to them
+   }
+   void ReadFileInParallel();
+
 public:
 
    KVSimReader();
@@ -84,6 +112,25 @@ public:
 
    }
 
+   void SetNumberOfThreads(Int_t n);
+   Int_t GetNumberOfThreads() const
+   {
+      // Number of threads used to convert events (1 = serial reading)
+      return fNThreads;
+   }
+   void SetChunkSize(Int_t n)
+   {
+      // Number of events in each chunk of file converted by one thread
+      fChunkSize = TMath::Max(1, n);
+   }
+   virtual Bool_t CanReadInParallel() const
+   {
+      // Return kTRUE if different parts of a file can be converted independently
+      // (i.e. events do not depend on anything read in previous events),
+      // and SkipEvent() is implemented.
+      return kFALSE;
+   }
+
    void SetFillingMode(Bool_t mode = kTRUE)
    {
       kmode = mode;
@@ -37,16 +37,12 @@ KVSimReader_HIPSE::~KVSimReader_HIPSE()
 void KVSimReader_HIPSE::ReadFile()
 {
 
-   AddObject(new TH1F("impact_parameter", "distri", 200, 0, 20));
-   h1 = (TH1F*)GetLinkedObjects()->Last();
-
-   if (!ReadHeader()) return;
+   if (!ReadFileHeader()) return;
 
    while (IsOK()) {
       while (ReadEvent()) {
          if (nevt % 1000 == 0) Info("ReadFile", "%d evts lus", nevt);
-         h1->Fill(evt->GetParameters()->GetDoubleValue("Bparstore"));
-         if (HasToFill()) FillTree();
+         ProcessEvent();
       }
    }
 
@@ -58,6 +54,30 @@ void KVSimReader_HIPSE::ReadFile()
    */
 }
 
+Bool_t KVSimReader_HIPSE::ReadFileHeader()
+{
+   // Create impact parameter histogram & read header
+   AddObject(new TH1F("impact_parameter", "distri", 200, 0, 20));
+   h1 = (TH1F*)GetLinkedObjects()->Last();
+
+   return ReadHeader();
+}
+
+Bool_t KVSimReader_HIPSE::SkipEvent()
+{
+   // Skip event without reading the nuclei: first line gives number of nuclei,
+   // then 3 lines of event informations + 4 lines per nucleus
+   if (ReadLineAndCheck(2, " ") != 1) return kFALSE;
+   Int_t mult = GetIntReadPar(0);
+   return SkipLines(3 + 4 * mult);
+}
+
+void KVSimReader_HIPSE::ProcessEvent()
+{
+   h1->Fill(evt->GetParameters()->GetDoubleValue("Bparstore"));
+   KVSimReader::ProcessEvent();
+}
+
 Bool_t KVSimReader_HIPSE::ReadHeader()
 {
 
@@ -19,6 +19,10 @@ class KVSimReader_HIPSE : public KVSimReader {
 protected:
    TH1F* h1;
 
+   Bool_t ReadFileHeader();
+   Bool_t SkipEvent();
+   void ProcessEvent();
+
 public:
    KVSimReader_HIPSE();
    KVSimReader_HIPSE(KVString filename);
@@ -30,6 +34,11 @@ public:
    Bool_t ReadEvent();
    Bool_t ReadNucleus();
 
+   virtual Bool_t CanReadInParallel() const
+   {
+      return kTRUE;
+   }
+
    virtual void SetPotentialHardness(Double_t val)
    {
       KVString sval;
@@ -36,6 +36,12 @@ public:
    virtual Bool_t ReadEvent();
    virtual Bool_t ReadNucleus();
 
+   virtual Bool_t CanReadInParallel() const
+   {
+      // events are rotated by a random angle: they must be read by a single thread
+      return kFALSE;
+   }
+
    ClassDef(KVSimReader_HIPSE_asym, 1) //Read ascii file for asymptotic events of the HIPSE code after SIMON deexcitation
 
 };
@@ -38,13 +38,20 @@ void KVSimReader_MMM::ReadFile()
    while (IsOK()) {
       while (ReadEvent()) {
          if (nevt % 1000 == 0) Info("ReadFile", "%d evts lus", nevt);
-         if (HasToFill()) FillTree();
+         ProcessEvent();
       }
    }
 
 }
 
 
+Bool_t KVSimReader_MMM::SkipEvent()
+{
+   // Each event is written on one line
+   ReadLine(0);
+   return !IsCurrentLineEmpty();
+}
+
 Bool_t KVSimReader_MMM::ReadEvent()
 {
 
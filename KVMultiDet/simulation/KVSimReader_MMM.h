@@ -18,6 +18,8 @@ class KVSimReader_MMM : public KVSimReader {
 protected:
    Int_t idx;
 
+   virtual Bool_t SkipEvent();
+
 public:
    KVSimReader_MMM();
    KVSimReader_MMM(KVString filename);
@@ -28,6 +30,11 @@ public:
    virtual Bool_t ReadEvent();
    virtual Bool_t ReadNucleus();
 
+   virtual Bool_t CanReadInParallel() const
+   {
+      return kTRUE;
+   }
+
    ClassDef(KVSimReader_MMM, 1) //Read ascii file for events of the MMM code at Freeze Out
 };
 
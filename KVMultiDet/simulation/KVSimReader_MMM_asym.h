@@ -21,6 +21,15 @@ protected:
    TVector3 fBoostQP;
    TVector3 fBoostQC;
 
+   virtual Bool_t SkipEvent();
+   virtual void InitParallelReader(KVSimReader* reader) const
+   {
+      KVSimReader_MMM_asym* r = (KVSimReader_MMM_asym*)reader;
+      r->fApplyBoost = fApplyBoost;
+      r->fBoostQP = fBoostQP;
+      r->fBoostQC = fBoostQC;
+   }
+
 public:
    KVSimReader_MMM_asym();
    KVSimReader_MMM_asym(KVString filename);
@@ -32,6 +41,11 @@ public:
    virtual Bool_t ReadEvent();
    virtual Bool_t ReadNucleus();
 
+   virtual Bool_t CanReadInParallel() const
+   {
+      return kTRUE;
+   }
+
    ClassDef(KVSimReader_MMM_asym, 1) //Read ascii file for asymptotic events of the MMM code after deexcitation
 };
 
@@ -6,6 +6,10 @@
 #include <TPluginManager.h>
 #include <TError.h>
 #include "TGeoManager.h"
+#include "TEnv.h"
+#include "TMath.h"
+#include "KVNucleus.h"
+#include "KVRangeEnergyTable.h"
 
 #define FIND_MAT_AND_EXEC(method,defval) \
    KVIonRangeTableMaterial* M = GetMaterial(mat); \
@@ -29,12 +33,29 @@ ClassImp(KVIonRangeTable)
 <h4>Abstract base class for calculation of range & energy loss of charged particles in matter</h4>
 <!-- */
 // --> END_HTML
+// For applications requiring a very large number of energy loss calculations (e.g. filtering
+// of simulated events, reconstruction), the range-energy relation of each ion in each material
+// can be tabulated the first time it is needed, after which all calculations are performed by
+// interpolation in the table, without any iterative inversion of the range function
+// (see KVRangeEnergyTable). This mode is enabled by calling SetTabulatedMode(), or for all range
+// tables by setting the following variables in your .kvrootrc:
+//
+//    KVIonRangeTable.Tabulated:             yes
+//    KVIonRangeTable.TabulationAccuracy:    1.e-4
+//
+// The accuracy is the largest relative deviation of interpolated range or energy from the exact
+// calculation which is tolerated. Use TestTabulation() to check the accuracy for a given material.
 ////////////////////////////////////////////////////////////////////////////////
 
 KVIonRangeTable::KVIonRangeTable(const Char_t* name, const Char_t* title)
    : KVBase(name, title)
 {
    // Default constructor
+   // Tabulated mode is enabled or not according to the values of variables
+   //    KVIonRangeTable.Tabulated
+   //    KVIonRangeTable.TabulationAccuracy
+   fTabulated = gEnv->GetValue("KVIonRangeTable.Tabulated", kFALSE);
+   fTabAccuracy = gEnv->GetValue("KVIonRangeTable.TabulationAccuracy", 1.e-4);
 }
 
 KVIonRangeTable::~KVIonRangeTable()
@@ -360,3 +381,42 @@ void KVIonRangeTable::Print(Option_t*) const
    printf("%s::%s\n%s\n", ClassName(), GetName(), GetTitle());
 }
 
+
+void KVIonRangeTable::TestTabulation(const Char_t* material, Int_t zmin, Int_t zmax)
+{
+   // For ions zmin<=Z<=zmax (A given by default mass formula of KVNucleus), build the tabulated
+   // range-energy relation in the given material and print the number of points in the table
+   // and the largest relative deviations of tabulated range and residual energy (for a thickness
+   // equal to half the range) from the exact calculations, for energies between 0.1 MeV/u and the
+   // upper limit of the table.
+   // The current accuracy of tabulation is used (see SetTabulatedMode).
+
+   KVIonRangeTableMaterial* M = GetMaterial(material);
+   if (!M) {
+      Warning("TestTabulation", "Material %s is unknown", material);
+      return;
+   }
+   Bool_t tab = fTabulated;
+   fTabulated = kTRUE;
+   printf("Tabulation of range-energy relations in %s (%s) : required accuracy %g\n\n", M->GetName(), GetName(), fTabAccuracy);
+   printf("   Z   A  points  dev.(build)  dev.(range)  dev.(Eres)\n");
+   KVNucleus nuc;
+   for (Int_t Z = zmin; Z <= zmax; ++Z) {
+      nuc.SetZ(Z);
+      Int_t A = nuc.GetA();
+      if (!CheckIon(Z, A)) continue;
+      const KVRangeEnergyTable* t = M->GetTabulation(Z, A);
+      if (!t) continue;
+      Double_t max_range = 0, max_eres = 0;
+      Double_t emax = M->GetEmaxValid(Z, A);
+      for (Double_t E = 0.1 * A; E <= emax; E *= 1.1) {
+         Double_t R = M->CalcRangeOfIon(Z, A, E);
+         if (R <= 0) continue;
+         max_range = TMath::Max(max_range, TMath::Abs(t->GetRange(E) - R) / R);
+         Double_t eres = M->CalcEResOfIon(Z, A, E, 0.5 * R);
+         if (eres > 0) max_eres = TMath::Max(max_eres, TMath::Abs(t->GetERes(E, 0.5 * R) - eres) / eres);
+      }
+      printf("%4d %3d  %6d  %11.3g  %11.3g  %10.3g\n", Z, A, t->GetNumberOfPoints(), t->GetMaxDeviation(), max_range, max_eres);
+   }
+   fTabulated = tab;
+}
@@ -14,6 +14,9 @@ class TVector3;
 
 class KVIonRangeTable : public KVBase {
 
+   Bool_t fTabulated;      // kTRUE if tabulated range-energy relations are used for calculations
+   Double_t fTabAccuracy;  // required relative accuracy of tabulated range-energy relations
+
 protected:
    virtual KVIonRangeTableMaterial* GetMaterialWithPointer(TGeoMaterial*);
    virtual KVIonRangeTableMaterial* GetMaterialWithNameOrType(const Char_t* material) = 0;
@@ -144,6 +147,27 @@ public:
 
    virtual void Print(Option_t* = "") const;
 
+   void SetTabulatedMode(Bool_t on = kTRUE, Double_t accuracy = 1.e-4)
+   {
+      // Use (on=kTRUE) or not (on=kFALSE) tabulated range-energy relations for
+      // the Get... calculations of all materials of this table.
+      // accuracy = required relative accuracy of interpolated range & energy.
+      // See KVRangeEnergyTable.
+      fTabulated = on;
+      fTabAccuracy = accuracy;
+   }
+   Bool_t IsTabulated() const
+   {
+      // Returns kTRUE if tabulated range-energy relations are used for calculations
+      return fTabulated;
+   }
+   Double_t GetTabulationAccuracy() const
+   {
+      // Required relative accuracy of tabulated range-energy relations
+      return fTabAccuracy;
+   }
+   void TestTabulation(const Char_t* material, Int_t zmin = 1, Int_t zmax = 92);
+
    virtual Bool_t CheckIon(Int_t, Int_t) const
    {
       AbstractMethod("CheckIon");
@@ -8,9 +8,60 @@
 #include "TGeoMaterial.h"
 #include "KVElementDensity.h"
 #include "KVNDTManager.h"
+#include "KVRangeEnergyTable.h"
+#include "Math/IFunction.h"
+#include "Math/BrentRootFinder.h"
+#include "Math/BrentMinimizer1D.h"
 
 using namespace std;
 
+namespace {
+   // Functions of incident energy used by the re-entrant calculations
+   // (KVIonRangeTableMaterial::Calc... methods). All parameters are held
+   // by the function object, which only calls const methods of the material.
+
+   class KVIRTM_RangeFunc : public ROOT::Math::IBaseFunctionOneDim {
+      const KVIonRangeTableMaterial* fMat;
+      Int_t fZ, fA;
+      Double_t fIsoAmat, fR0;
+      double DoEval(double E) const
+      {
+         // range of ion minus required range
+         return fMat->CalcRangeOfIon(fZ, fA, E, fIsoAmat) - fR0;
+      }
+   public:
+      KVIRTM_RangeFunc(const KVIonRangeTableMaterial* m, Int_t Z, Int_t A, Double_t iso, Double_t R0 = 0.)
+         : fMat(m), fZ(Z), fA(A), fIsoAmat(iso), fR0(R0) {}
+      ROOT::Math::IBaseFunctionOneDim* Clone() const
+      {
+         return new KVIRTM_RangeFunc(*this);
+      }
+   };
+
+   class KVIRTM_DeltaEFunc : public ROOT::Math::IBaseFunctionOneDim {
+      const KVIonRangeTableMaterial* fMat;
+      Int_t fZ, fA;
+      Double_t fThick, fIsoAmat, fDE0, fSign;
+      double DoEval(double E) const
+      {
+         // (sign * energy loss) minus required energy loss
+         return fSign * fMat->CalcDeltaEOfIon(fZ, fA, E, fThick, fIsoAmat) - fDE0;
+      }
+   public:
+      KVIRTM_DeltaEFunc(const KVIonRangeTableMaterial* m, Int_t Z, Int_t A, Double_t e, Double_t iso, Double_t DE0 = 0., Double_t sign = 1.)
+         : fMat(m), fZ(Z), fA(A), fThick(e), fIsoAmat(iso), fDE0(DE0), fSign(sign) {}
+      ROOT::Math::IBaseFunctionOneDim* Clone() const
+      {
+         return new KVIRTM_DeltaEFunc(*this);
+      }
+   };
+
+   // same default precision & number of points as TF1::GetX/GetMaximumX
+   const Double_t KVIRTM_EPSILON = 1.e-10;
+   const Int_t KVIRTM_MAXITER = 100;
+   const Int_t KVIRTM_NPX = 100;
+}
+
 ClassImp(KVIonRangeTableMaterial)
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -20,6 +71,16 @@ ClassImp(KVIonRangeTableMaterial)
 <h4>Material for use in energy loss & range calculations</h4>
 <!-- */
 // --> END_HTML
+// The Get...OfIon methods use TF1 objects which are members of the material
+// and which are re-parameterised for each calculation: they cannot be used by
+// several threads at the same time. For multithreaded applications, use instead
+// the equivalent Calc... methods (CalcRangeOfIon, CalcEResOfIon, CalcDeltaEOfIon,
+// CalcEIncFromEResOfIon, CalcEIncFromDeltaEOfIon, CalcPunchThroughEnergy, ...)
+// which are const and keep all parameters of each calculation on the stack.
+//
+// If tabulated mode is enabled for the range table (see KVIonRangeTable::SetTabulatedMode),
+// the Get...OfIon methods use instead a KVRangeEnergyTable built for each ion the first
+// time it is required (see GetTabulation).
 ////////////////////////////////////////////////////////////////////////////////
 
 KVIonRangeTableMaterial::KVIonRangeTableMaterial()
@@ -37,6 +98,9 @@ KVIonRangeTableMaterial::KVIonRangeTableMaterial()
      fEres(0),
      fRange(0),
      fStopping(0)
+#ifdef WITH_CPP11
+   , fTabulationMutex(new std::mutex)
+#endif
 {
    // Default constructor
 }
@@ -57,6 +121,9 @@ KVIonRangeTableMaterial::KVIonRangeTableMaterial(const KVIonRangeTable* tab, con
      fEres(0),
      fRange(0),
      fStopping(0)
+#ifdef WITH_CPP11
+   , fTabulationMutex(new std::mutex)
+#endif
 {
    // Create new material with given (long) name and symbol
    //        symbol convention: for elements, use element symbol. for compounds, use chemical formula.
@@ -70,7 +137,7 @@ KVIonRangeTableMaterial::KVIonRangeTableMaterial(const KVIonRangeTable* tab, con
    // Densities of gases are calculated from the molar weight, temperature and pressure.
 
    if (Z > 0 && density < 0) {
-      KVElementDensity* ed = (KVElementDensity*)gNDTManager->GetData(Z, A, "ElementDensity");
+      KVElementDensity* ed = (KVElementDensity*)gNDTManager->GetData(Z, A, KVNDTManager::kElementDensity);
       if (!ed) {
          Warning("KVIonRangeTableMaterial",
                  "No element found in density table with Z=%f, density unknown", Z);
@@ -95,6 +162,9 @@ KVIonRangeTableMaterial::KVIonRangeTableMaterial(const KVIonRangeTableMaterial&
    fEres(0),
    fRange(0),
    fStopping(0)
+#ifdef WITH_CPP11
+   , fTabulationMutex(new std::mutex)
+#endif
 {
    // Copy constructor
    // This ctor is used to make a copy of an existing object (for example
@@ -113,6 +183,13 @@ KVIonRangeTableMaterial::~KVIonRangeTableMaterial()
    SafeDelete(fEres);
    SafeDelete(fDeltaE);
    SafeDelete(fStopping);
+   for (std::map<Int_t, KVRangeEnergyTable*>::iterator it = fTabulation.begin(); it != fTabulation.end(); ++it)
+      delete it->second;
+   for (std::vector<KVRangeEnergyTable*>::iterator it = fOldTabulations.begin(); it != fOldTabulations.end(); ++it)
+      delete *it;
+#ifdef WITH_CPP11
+   delete fTabulationMutex;
+#endif
 }
 
 //________________________________________________________________
@@ -292,6 +369,7 @@ Double_t KVIonRangeTableMaterial::GetRangeOfIon(Int_t Z, Int_t A, Double_t E, Do
    // Returns range (in g/cm**2) of ion (Z,A) with energy E (MeV) in material.
    // Give Amat to change default (isotopic) mass of material,
 
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return t->GetRange(E);
    TF1* f = GetRangeFunction(Z, A, isoAmat);
    return f->Eval(E);
 }
@@ -312,6 +390,7 @@ Double_t KVIonRangeTableMaterial::GetDeltaEOfIon(Int_t Z, Int_t A, Double_t E, D
    // Returns energy lost (in MeV) by ion (Z,A) with energy E (MeV) after thickness e (in g/cm**2).
    // Give Amat to change default (isotopic) mass of material,
 
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return E - GetTabulatedERes(t, E, e);
    TF1* f = GetDeltaEFunction(e, Z, A, isoAmat);
    return f->Eval(E);
 }
@@ -334,6 +413,7 @@ Double_t KVIonRangeTableMaterial::GetEResOfIon(Int_t Z, Int_t A, Double_t E, Dou
    // Returns energy lost (in MeV) by ion (Z,A) with energy E (MeV) after thickness e (in g/cm**2).
    // Give Amat to change default (isotopic) mass of material,
 
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return GetTabulatedERes(t, E, e);
    TF1* f = GetEResFunction(e, Z, A, isoAmat);
    return f->Eval(E);
 }
@@ -354,6 +434,7 @@ Double_t KVIonRangeTableMaterial::GetEIncFromEResOfIon(Int_t Z, Int_t A, Double_
 {
    // Calculates incident energy (in MeV) of an ion (Z,A) with residual energy Eres (MeV) after thickness e (in g/cm**2).
    // Give Amat to change default (isotopic) mass of material,
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return t->GetEIncFromERes(Eres, e);
    GetRangeFunction(Z, A, isoAmat);
    Double_t R0 = fRange->Eval(Eres) + e;
    return fRange->GetX(R0);
@@ -375,6 +456,7 @@ Double_t KVIonRangeTableMaterial::GetEIncFromDeltaEOfIon(Int_t Z, Int_t A, Doubl
 {
    // Calculates incident energy (in MeV) of an ion (Z,A) from energy loss DeltaE (MeV) in thickness e (in g/cm**2).
    // Give Amat to change default (isotopic) mass of material,
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return t->GetEIncFromDeltaE(DeltaE, e, type);
    GetDeltaEFunction(e, Z, A, isoAmat);
    Double_t e1, e2;
    fDeltaE->GetRange(e1, e2);
@@ -408,6 +490,7 @@ Double_t KVIonRangeTableMaterial::GetPunchThroughEnergy(Int_t Z, Int_t A, Double
    // for all energies above this energy the residual energy is > 0.
    // Give Amat to change default (isotopic) mass of material.
 
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return t->GetPunchThroughEnergy(e);
    return GetRangeFunction(Z, A, isoAmat)->GetX(e);
 }
 
@@ -429,6 +512,7 @@ Double_t KVIonRangeTableMaterial::GetMaxDeltaEOfIon(Int_t Z, Int_t A, Double_t e
    // Calculate maximum energy loss (in MeV) of ion (Z,A) in given thickness e (in g/cm**2).
    // Give Amat to change default (isotopic) mass of material.
 
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return t->GetDeltaE(t->GetEIncOfMaxDeltaE(e), e);
    return GetDeltaEFunction(e, Z, A, isoAmat)->GetMaximum();
 }
 
@@ -438,6 +522,7 @@ Double_t KVIonRangeTableMaterial::GetEIncOfMaxDeltaEOfIon(Int_t Z, Int_t A, Doub
    // in given thickness e (in g/cm**2).
    // Give Amat to change default (isotopic) mass of material.
 
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return t->GetEIncOfMaxDeltaE(e);
    return GetDeltaEFunction(e, Z, A, isoAmat)->GetMaximumX();
 }
 
@@ -464,6 +549,178 @@ Double_t KVIonRangeTableMaterial::GetLinearEIncOfMaxDeltaEOfIon(Int_t Z, Int_t A
    return GetEIncOfMaxDeltaEOfIon(Z, A, e, isoAmat);
 }
 
+const KVRangeEnergyTable* KVIonRangeTableMaterial::GetTabulation(Int_t Z, Int_t A, Double_t isoAmat)
+{
+   // If tabulated mode is enabled for the range table (see KVIonRangeTable::SetTabulatedMode),
+   // returns the tabulated range-energy relation for ion (Z,A) in this material.
+   // The table is built the first time it is required for each ion, between the limits
+   // of energy used by the re-entrant calculations (see GetCalcEnergyLimits), and rebuilt
+   // if a better accuracy is later required.
+   // Returns nullptr if tabulated mode is not enabled, for Z=0 (neutral particles),
+   // or if a non-default isotopic mass of the material is given (isoAmat>0).
+   //
+   // This method can be called concurrently by several threads: look-up & insertion of
+   // tables are protected by a mutex (one per material). Tables which are replaced by
+   // more accurate ones are kept until the material is deleted, as they may still be
+   // in use by another thread.
+
+   if (!fTable || !fTable->IsTabulated() || Z < 1 || isoAmat > 0) return nullptr;
+#ifdef WITH_CPP11
+   std::lock_guard<std::mutex> lock(*fTabulationMutex);
+#endif
+   Int_t key = 1000 * Z + A;
+   std::map<Int_t, KVRangeEnergyTable*>::iterator it = fTabulation.find(key);
+   if (it != fTabulation.end()) {
+      if (it->second->GetAccuracy() <= fTable->GetTabulationAccuracy()) return it->second;
+      fOldTabulations.push_back(it->second);
+      fTabulation.erase(it);
+   }
+   Double_t emin, emax;
+   GetCalcEnergyLimits(Z, A, isoAmat, emin, emax);
+   KVRangeEnergyTable* t = new KVRangeEnergyTable(this, Z, A, emin, emax, fTable->GetTabulationAccuracy());
+   fTabulation[key] = t;
+   return t;
+}
+
+Double_t KVIonRangeTableMaterial::GetTabulatedERes(const KVRangeEnergyTable* t, Double_t E, Double_t e)
+{
+   // Residual energy (in MeV) after thickness e (in g/cm**2) for incident energy E (in MeV)
+   // using tabulated range-energy relation. The range corresponding to the energy loss is
+   // stored (see GetRangeOfLastDE).
+
+   Double_t R0 = t->GetRange(E);
+   if (R0 < e) {
+      fRangeOfLastDE = R0;
+      return 0.0;
+   }
+   fRangeOfLastDE = e;
+   return t->GetEnergy(R0 - e);
+}
+
+void KVIonRangeTableMaterial::GetCalcEnergyLimits(Int_t Z, Int_t A, Double_t, Double_t& emin, Double_t& emax) const
+{
+   // Interval of incident energies (in MeV) used for the re-entrant inversion of range
+   // and energy loss functions (see CalcEnergyFromRange, CalcEIncFromDeltaEOfIon, ...)
+   // Default is [0, GetEmaxValid(Z,A)]
+
+   emin = 0.;
+   emax = GetEmaxValid(Z, A);
+}
+
+Double_t KVIonRangeTableMaterial::SolveEnergyFromRange(Int_t Z, Int_t A, Double_t R, Double_t isoAmat, Double_t emin, Double_t emax) const
+{
+   // Find incident energy (in MeV) in interval [emin,emax] for which the range of ion (Z,A)
+   // is equal to R (in g/cm**2), using the same Brent method & precision as TF1::GetX
+
+   KVIRTM_RangeFunc rf(this, Z, A, isoAmat, R);
+   ROOT::Math::BrentRootFinder brf;
+   brf.SetFunction(rf, emin, emax);
+   brf.SetNpx(KVIRTM_NPX);
+   brf.Solve(KVIRTM_MAXITER, KVIRTM_EPSILON, KVIRTM_EPSILON);
+   return brf.Root();
+}
+
+Double_t KVIonRangeTableMaterial::CalcRangeOfIon(Int_t, Int_t, Double_t, Double_t) const
+{
+   // Re-entrant calculation of range (in g/cm**2) of ion (Z,A) with energy E (MeV) in material.
+   // Give isoAmat to change default (isotopic) mass of material.
+   //
+   // Must be implemented in child classes: all other Calc... methods use it by default.
+
+   AbstractMethod("CalcRangeOfIon");
+   return 0.;
+}
+
+Double_t KVIonRangeTableMaterial::CalcEnergyFromRange(Int_t Z, Int_t A, Double_t R, Double_t isoAmat) const
+{
+   // Re-entrant calculation of incident energy (in MeV) of ion (Z,A) with range R (in g/cm**2).
+   // Give isoAmat to change default (isotopic) mass of material.
+   //
+   // Default method inverts CalcRangeOfIon numerically in the interval given by GetCalcEnergyLimits.
+
+   Double_t emin, emax;
+   GetCalcEnergyLimits(Z, A, isoAmat, emin, emax);
+   return SolveEnergyFromRange(Z, A, R, isoAmat, emin, emax);
+}
+
+Double_t KVIonRangeTableMaterial::CalcEResOfIon(Int_t Z, Int_t A, Double_t E, Double_t e, Double_t isoAmat) const
+{
+   // Re-entrant calculation of residual energy (in MeV) of ion (Z,A) with energy E (MeV) after thickness e (in g/cm**2).
+   // Give isoAmat to change default (isotopic) mass of material.
+   //
+   // Equivalent to GetEResOfIon(Z,A,E,e,isoAmat), but can be used concurrently by several threads.
+
+   Double_t R0 = CalcRangeOfIon(Z, A, E, isoAmat);
+   if (R0 < e) return 0.0; // particle stops in material
+   return CalcEnergyFromRange(Z, A, R0 - e, isoAmat);
+}
+
+Double_t KVIonRangeTableMaterial::CalcEIncFromEResOfIon(Int_t Z, Int_t A, Double_t Eres, Double_t e, Double_t isoAmat) const
+{
+   // Re-entrant calculation of incident energy (in MeV) of an ion (Z,A) with residual energy Eres (MeV)
+   // after thickness e (in g/cm**2).
+   // Give isoAmat to change default (isotopic) mass of material.
+   //
+   // Equivalent to GetEIncFromEResOfIon(Z,A,Eres,e,isoAmat), but can be used concurrently by several threads.
+
+   return CalcEnergyFromRange(Z, A, CalcRangeOfIon(Z, A, Eres, isoAmat) + e, isoAmat);
+}
+
+Double_t KVIonRangeTableMaterial::CalcPunchThroughEnergy(Int_t Z, Int_t A, Double_t e, Double_t isoAmat) const
+{
+   // Re-entrant calculation of incident energy (in MeV) for ion (Z,A) for which the range is equal to the
+   // given thickness e (in g/cm**2).
+   // Give isoAmat to change default (isotopic) mass of material.
+   //
+   // Equivalent to GetPunchThroughEnergy(Z,A,e,isoAmat), but can be used concurrently by several threads.
+
+   return CalcEnergyFromRange(Z, A, e, isoAmat);
+}
+
+Double_t KVIonRangeTableMaterial::CalcEIncOfMaxDeltaEOfIon(Int_t Z, Int_t A, Double_t e, Double_t isoAmat) const
+{
+   // Re-entrant calculation of incident energy (in MeV) corresponding to maximum energy loss of ion (Z,A)
+   // in given thickness e (in g/cm**2).
+   // Give isoAmat to change default (isotopic) mass of material.
+   //
+   // Equivalent to GetEIncOfMaxDeltaEOfIon(Z,A,e,isoAmat), but can be used concurrently by several threads.
+
+   Double_t emin, emax;
+   GetCalcEnergyLimits(Z, A, isoAmat, emin, emax);
+   KVIRTM_DeltaEFunc mde(this, Z, A, e, isoAmat, 0., -1.);
+   ROOT::Math::BrentMinimizer1D bm;
+   bm.SetFunction(mde, emin, emax);
+   bm.SetNpx(KVIRTM_NPX);
+   bm.Minimize(KVIRTM_MAXITER, KVIRTM_EPSILON, KVIRTM_EPSILON);
+   return bm.XMinimum();
+}
+
+Double_t KVIonRangeTableMaterial::CalcEIncFromDeltaEOfIon(Int_t Z, Int_t A, Double_t DeltaE, Double_t e, enum KVIonRangeTable::SolType type, Double_t isoAmat) const
+{
+   // Re-entrant calculation of incident energy (in MeV) of an ion (Z,A) from energy loss DeltaE (MeV)
+   // in thickness e (in g/cm**2).
+   // Give isoAmat to change default (isotopic) mass of material.
+   //
+   // Equivalent to GetEIncFromDeltaEOfIon(Z,A,DeltaE,e,type,isoAmat), but can be used concurrently by several threads.
+
+   Double_t e1, e2;
+   GetCalcEnergyLimits(Z, A, isoAmat, e1, e2);
+   switch (type) {
+      case KVIonRangeTable::kEmin:
+         e2 = CalcEIncOfMaxDeltaEOfIon(Z, A, e, isoAmat);
+         break;
+      case KVIonRangeTable::kEmax:
+         e1 = CalcEIncOfMaxDeltaEOfIon(Z, A, e, isoAmat);
+         break;
+   }
+   KVIRTM_DeltaEFunc def(this, Z, A, e, isoAmat, DeltaE);
+   ROOT::Math::BrentRootFinder brf;
+   brf.SetFunction(def, e1, e2);
+   brf.SetNpx(KVIRTM_NPX);
+   brf.Solve(KVIRTM_MAXITER, KVIRTM_EPSILON, KVIRTM_EPSILON);
+   return brf.Root();
+}
+
 TGeoMaterial* KVIonRangeTableMaterial::GetTGeoMaterial() const
 {
    // Create and return pointer to a TGeoMaterial or TGeoMixture (for compound materials)
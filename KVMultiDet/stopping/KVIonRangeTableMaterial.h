@@ -8,9 +8,15 @@
 #include <TString.h>
 #include <KVList.h>
 #include "KVIonRangeTable.h"
+#include <map>
+#include <vector>
+#ifdef WITH_CPP11
+#include <mutex>
+#endif
 
 class TGeoMaterial;
 class TF1;
+class KVRangeEnergyTable;
 
 #define RTT  62.36367e+03  // cm^3.Torr.K^-1.mol^-1
 #define ZERO_KELVIN  273.15
@@ -34,6 +40,17 @@ protected:
    TF1* fRange; // function parameterising range of charged particles in material
    TF1* fStopping; // function parameterising stopping power of charged particles in material
 
+   std::map<Int_t, KVRangeEnergyTable*> fTabulation;//! tabulated range-energy relations, key=1000*Z+A
+   std::vector<KVRangeEnergyTable*> fOldTabulations;//! tabulations replaced by more accurate ones
+#ifdef WITH_CPP11
+   std::mutex* fTabulationMutex;//! protects fTabulation (see GetTabulation)
+#endif
+
+   Double_t GetTabulatedERes(const KVRangeEnergyTable*, Double_t E, Double_t e);
+
+   virtual void GetCalcEnergyLimits(Int_t Z, Int_t A, Double_t isoAmat, Double_t& emin, Double_t& emax) const;
+   Double_t SolveEnergyFromRange(Int_t Z, Int_t A, Double_t R, Double_t isoAmat, Double_t emin, Double_t emax) const;
+
 public:
    KVIonRangeTableMaterial();
    KVIonRangeTableMaterial(const KVIonRangeTable*, const Char_t* name, const Char_t* symbol, const Char_t* state,
@@ -134,6 +151,8 @@ public:
    virtual TF1* GetEResFunction(Double_t e, Int_t Z, Int_t A, Double_t isoAmat = 0) = 0;
    virtual TF1* GetStoppingFunction(Int_t Z, Int_t A, Double_t isoAmat = 0) = 0;
 
+   const KVRangeEnergyTable* GetTabulation(Int_t Z, Int_t A, Double_t isoAmat = 0.);
+
    void PrintRangeTable(Int_t Z, Int_t A, Double_t isoAmat = 0, Double_t units = KVUnits::cm, Double_t T = -1, Double_t P = -1);
    void PrintComposition(std::ostream&) const;
 
@@ -176,6 +195,26 @@ public:
    virtual Double_t GetLinearMaxDeltaEOfIon(Int_t Z, Int_t A, Double_t e, Double_t isoAmat = 0., Double_t T = -1., Double_t P = -1.);
    virtual Double_t GetLinearEIncOfMaxDeltaEOfIon(Int_t Z, Int_t A, Double_t e, Double_t isoAmat = 0., Double_t T = -1., Double_t P = -1.);
 
+   // Re-entrant calculations: no internal state (TF1 objects etc.) is modified,
+   // therefore these methods can be used concurrently from several threads
+   virtual Double_t CalcRangeOfIon(Int_t Z, Int_t A, Double_t E, Double_t isoAmat = 0.) const;
+   virtual Double_t CalcEnergyFromRange(Int_t Z, Int_t A, Double_t R, Double_t isoAmat = 0.) const;
+   virtual Double_t CalcEResOfIon(Int_t Z, Int_t A, Double_t E, Double_t e, Double_t isoAmat = 0.) const;
+   Double_t CalcDeltaEOfIon(Int_t Z, Int_t A, Double_t E, Double_t e, Double_t isoAmat = 0.) const
+   {
+      // Re-entrant calculation of energy lost (in MeV) by ion (Z,A) with energy E (MeV) after thickness e (in g/cm**2).
+      return (E - CalcEResOfIon(Z, A, E, e, isoAmat));
+   }
+   virtual Double_t CalcEIncFromEResOfIon(Int_t Z, Int_t A, Double_t Eres, Double_t e, Double_t isoAmat = 0.) const;
+   virtual Double_t CalcPunchThroughEnergy(Int_t Z, Int_t A, Double_t e, Double_t isoAmat = 0.) const;
+   virtual Double_t CalcEIncOfMaxDeltaEOfIon(Int_t Z, Int_t A, Double_t e, Double_t isoAmat = 0.) const;
+   Double_t CalcMaxDeltaEOfIon(Int_t Z, Int_t A, Double_t e, Double_t isoAmat = 0.) const
+   {
+      // Re-entrant calculation of maximum energy loss (in MeV) of ion (Z,A) in given thickness e (in g/cm**2).
+      return CalcDeltaEOfIon(Z, A, CalcEIncOfMaxDeltaEOfIon(Z, A, e, isoAmat), e, isoAmat);
+   }
+   virtual Double_t CalcEIncFromDeltaEOfIon(Int_t Z, Int_t A, Double_t DeltaE, Double_t e, enum KVIonRangeTable::SolType type = KVIonRangeTable::kEmax, Double_t isoAmat = 0.) const;
+
    Double_t GetRangeOfLastDE() const
    {
       // Returns range (in g/cm) of particle of last calculated dE
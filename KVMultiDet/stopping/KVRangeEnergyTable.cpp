@@ -0,0 +1,249 @@
+#include "KVRangeEnergyTable.h"
+#include "KVIonRangeTableMaterial.h"
+#include "TMath.h"
+#include "Math/IFunction.h"
+#include "Math/BrentRootFinder.h"
+#include "Math/BrentMinimizer1D.h"
+#include <algorithm>
+
+ClassImp(KVRangeEnergyTable)
+
+////////////////////////////////////////////////////////////////////////////////
+// BEGIN_HTML <!--
+/* -->
+<h2>KVRangeEnergyTable</h2>
+<h4>Tabulated range-energy relation for an ion in a material with monotone interpolation</h4>
+<!-- */
+// --> END_HTML
+// The range R(E) of an ion (Z,A) in a material is tabulated on a grid of
+// equally-spaced points in log(E), and both R(E) and its inverse E(R) are
+// interpolated in log-log coordinates with monotone piecewise cubic (Fritsch-Carlson)
+// Hermite polynomials. Therefore the interpolated functions are strictly increasing
+// like the exact ones, and all calculations can be deduced from them without any
+// iterative root-finding:
+//
+//    residual energy    : Eres = E( R(Einc) - e )
+//    incident energy    : Einc = E( R(Eres) + e )
+//    punch-through      : Einc = E( e )
+//
+// The number of grid points is doubled until the relative deviation of both
+// interpolated range and energy from the exact calculation at the mid-point of each
+// interval of the grid is smaller than the required accuracy (or until 1024 points
+// per decade of energy are used).
+//
+// Outside of the tabulated interval of energy, range & energy are extrapolated
+// linearly in log-log coordinates.
+//
+// Tables are built and used by KVIonRangeTableMaterial when tabulated mode is enabled
+// for the range table: see KVIonRangeTable::SetTabulatedMode.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+   // tabulated energy loss as a function of incident energy, for root-finding & maximisation
+   class KVRET_DeltaEFunc : public ROOT::Math::IBaseFunctionOneDim {
+      const KVRangeEnergyTable* fTab;
+      Double_t fThick, fDE0, fSign;
+      double DoEval(double E) const
+      {
+         return fSign * fTab->GetDeltaE(E, fThick) - fDE0;
+      }
+   public:
+      KVRET_DeltaEFunc(const KVRangeEnergyTable* t, Double_t e, Double_t DE0 = 0., Double_t sign = 1.)
+         : fTab(t), fThick(e), fDE0(DE0), fSign(sign) {}
+      ROOT::Math::IBaseFunctionOneDim* Clone() const
+      {
+         return new KVRET_DeltaEFunc(*this);
+      }
+   };
+}
+
+KVRangeEnergyTable::KVRangeEnergyTable()
+   : TObject(), fZ(0), fA(0), fAccuracy(0), fMaxDeviation(0), fLogEmin(0), fDlogE(0)
+{
+   // Default constructor
+}
+
+KVRangeEnergyTable::KVRangeEnergyTable(const KVIonRangeTableMaterial* mat, Int_t Z, Int_t A, Double_t emin, Double_t emax, Double_t accuracy)
+   : TObject(), fZ(Z), fA(A), fAccuracy(accuracy), fMaxDeviation(0), fLogEmin(0), fDlogE(0)
+{
+   // Build table for ion (Z,A) in material, for incident energies emin<=E<=emax (in MeV),
+   // using the (exact) re-entrant calculation KVIonRangeTableMaterial::CalcRangeOfIon.
+   // The grid is refined until the given relative accuracy is reached.
+
+   emin = TMath::Max(emin, 1.e-3 * A);
+   Double_t ndecades = TMath::Log10(emax / emin);
+   for (Int_t npd = 8; npd <= 1024; npd *= 2) {
+      FillGrid(mat, emin, emax, TMath::Max(2, TMath::CeilNint(ndecades * npd) + 1));
+      fMaxDeviation = TestGrid(mat);
+      if (fMaxDeviation <= fAccuracy) break;
+   }
+   if (fMaxDeviation > fAccuracy)
+      Warning("KVRangeEnergyTable", "%s Z=%d A=%d : required accuracy %g not reached (max. deviation %g)",
+              mat->GetName(), Z, A, fAccuracy, fMaxDeviation);
+}
+
+KVRangeEnergyTable::~KVRangeEnergyTable()
+{
+   // Destructor
+}
+
+void KVRangeEnergyTable::FillGrid(const KVIonRangeTableMaterial* mat, Double_t emin, Double_t emax, Int_t npts)
+{
+   // Fill grid with npts equally-spaced points in log(E) from emin to emax.
+   // Points with zero or negative range at low energy are skipped; the grid stops
+   // at the first point where the range does not increase.
+
+   fLogE.clear();
+   fLogR.clear();
+   Double_t lemin = TMath::Log(emin);
+   Double_t dle = (TMath::Log(emax) - lemin) / (npts - 1.);
+   for (int i = 0; i < npts; ++i) {
+      Double_t le = lemin + i * dle;
+      Double_t R = mat->CalcRangeOfIon(fZ, fA, TMath::Exp(le));
+      if (R <= 0) {
+         if (fLogE.size()) break;
+         continue;
+      }
+      Double_t lr = TMath::Log(R);
+      if (fLogR.size() && lr <= fLogR.back()) break;
+      fLogE.push_back(le);
+      fLogR.push_back(lr);
+   }
+   fLogEmin = fLogE.size() ? fLogE.front() : 0.;
+   fDlogE = dle;
+   MonotoneSlopes(fLogE, fLogR, fSlopeR);
+   MonotoneSlopes(fLogR, fLogE, fSlopeE);
+}
+
+Double_t KVRangeEnergyTable::TestGrid(const KVIonRangeTableMaterial* mat) const
+{
+   // Compare interpolated range & energy with exact calculation at mid-point of each
+   // interval of the grid. Returns largest relative deviation.
+
+   Double_t maxdev = 0;
+   for (UInt_t i = 0; i + 1 < fLogE.size(); ++i) {
+      Double_t E = TMath::Exp(0.5 * (fLogE[i] + fLogE[i + 1]));
+      Double_t R = mat->CalcRangeOfIon(fZ, fA, E);
+      if (R <= 0) continue;
+      maxdev = TMath::Max(maxdev, TMath::Abs(GetRange(E) - R) / R);
+      maxdev = TMath::Max(maxdev, TMath::Abs(GetEnergy(R) - E) / E);
+   }
+   return maxdev;
+}
+
+void KVRangeEnergyTable::MonotoneSlopes(const std::vector<Double_t>& x, const std::vector<Double_t>& y, std::vector<Double_t>& m)
+{
+   // Calculate slopes m at each point (x,y) for monotone piecewise cubic Hermite
+   // interpolation (Fritsch & Carlson, SIAM J. Numer. Anal. 17 (1980) 238)
+
+   Int_t n = x.size();
+   m.assign(n, 0.);
+   if (n < 2) return;
+   std::vector<Double_t> d(n - 1);
+   for (int k = 0; k < n - 1; ++k) d[k] = (y[k + 1] - y[k]) / (x[k + 1] - x[k]);
+   m[0] = d[0];
+   m[n - 1] = d[n - 2];
+   for (int k = 1; k < n - 1; ++k) m[k] = (d[k - 1] * d[k] > 0 ? 0.5 * (d[k - 1] + d[k]) : 0.);
+   for (int k = 0; k < n - 1; ++k) {
+      if (d[k] == 0) {
+         m[k] = m[k + 1] = 0.;
+         continue;
+      }
+      Double_t a = m[k] / d[k];
+      Double_t b = m[k + 1] / d[k];
+      Double_t s = a * a + b * b;
+      if (s > 9.) {
+         Double_t t = 3. / TMath::Sqrt(s);
+         m[k] = t * a * d[k];
+         m[k + 1] = t * b * d[k];
+      }
+   }
+}
+
+Double_t KVRangeEnergyTable::Hermite(Double_t x, Double_t x0, Double_t x1, Double_t y0, Double_t y1, Double_t m0, Double_t m1)
+{
+   // Cubic Hermite interpolation between (x0,y0) and (x1,y1) with slopes m0 & m1
+
+   Double_t h = x1 - x0;
+   Double_t t = (x - x0) / h;
+   Double_t t2 = t * t;
+   Double_t t3 = t2 * t;
+   return (2 * t3 - 3 * t2 + 1) * y0 + (t3 - 2 * t2 + t) * h * m0 + (-2 * t3 + 3 * t2) * y1 + (t3 - t2) * h * m1;
+}
+
+Double_t KVRangeEnergyTable::GetRange(Double_t E) const
+{
+   // Interpolated range (in g/cm**2) for incident energy E (in MeV)
+
+   if (E <= 0) return 0.;
+   Int_t n = fLogE.size();
+   if (n < 2) return 0.;
+   Double_t le = TMath::Log(E);
+   if (le <= fLogEmin) return TMath::Exp(fLogR[0] + fSlopeR[0] * (le - fLogE[0]));
+   Int_t k = (Int_t)((le - fLogEmin) / fDlogE);
+   if (k >= n - 1) return TMath::Exp(fLogR[n - 1] + fSlopeR[n - 1] * (le - fLogE[n - 1]));
+   return TMath::Exp(Hermite(le, fLogE[k], fLogE[k + 1], fLogR[k], fLogR[k + 1], fSlopeR[k], fSlopeR[k + 1]));
+}
+
+Double_t KVRangeEnergyTable::GetEnergy(Double_t R) const
+{
+   // Interpolated incident energy (in MeV) corresponding to range R (in g/cm**2)
+
+   if (R <= 0) return 0.;
+   Int_t n = fLogR.size();
+   if (n < 2) return 0.;
+   Double_t lr = TMath::Log(R);
+   if (lr <= fLogR[0]) return TMath::Exp(fLogE[0] + fSlopeE[0] * (lr - fLogR[0]));
+   if (lr >= fLogR[n - 1]) return TMath::Exp(fLogE[n - 1] + fSlopeE[n - 1] * (lr - fLogR[n - 1]));
+   Int_t k = std::upper_bound(fLogR.begin(), fLogR.end(), lr) - fLogR.begin() - 1;
+   return TMath::Exp(Hermite(lr, fLogR[k], fLogR[k + 1], fLogE[k], fLogE[k + 1], fSlopeE[k], fSlopeE[k + 1]));
+}
+
+Double_t KVRangeEnergyTable::GetEIncOfMaxDeltaE(Double_t e) const
+{
+   // Incident energy (MeV) corresponding to maximum energy loss in thickness e (g/cm**2).
+   // As all particles with E below the punch-through energy stop in the material (DeltaE=E),
+   // the maximum is searched for between the punch-through energy and the upper limit of the table.
+
+   Double_t emin = GetPunchThroughEnergy(e);
+   Double_t emax = TMath::Exp(fLogE.back());
+   if (emin >= emax) return emin;
+   KVRET_DeltaEFunc mde(this, e, 0., -1.);
+   ROOT::Math::BrentMinimizer1D bm;
+   bm.SetFunction(mde, emin, emax);
+   bm.SetNpx(100);
+   bm.Minimize(100, 1.e-10, 1.e-10);
+   return bm.XMinimum();
+}
+
+Double_t KVRangeEnergyTable::GetEIncFromDeltaE(Double_t DeltaE, Double_t e, enum KVIonRangeTable::SolType type) const
+{
+   // Incident energy (MeV) corresponding to energy loss DeltaE (MeV) in thickness e (g/cm**2).
+   // type = KVIonRangeTable::kEmax : solution above energy of maximum energy loss (default)
+   //      = KVIonRangeTable::kEmin : solution below energy of maximum energy loss
+
+   Double_t e1 = 0., e2 = TMath::Exp(fLogE.back());
+   switch (type) {
+      case KVIonRangeTable::kEmin:
+         e2 = GetEIncOfMaxDeltaE(e);
+         break;
+      case KVIonRangeTable::kEmax:
+         e1 = GetEIncOfMaxDeltaE(e);
+         break;
+   }
+   KVRET_DeltaEFunc def(this, e, DeltaE);
+   ROOT::Math::BrentRootFinder brf;
+   brf.SetFunction(def, e1, e2);
+   brf.SetNpx(100);
+   brf.Solve(100, 1.e-10, 1.e-10);
+   return brf.Root();
+}
+
+void KVRangeEnergyTable::Print(Option_t*) const
+{
+   printf("KVRangeEnergyTable : Z=%d A=%d  %d points  %g<=E<=%g MeV  accuracy=%g  max.deviation=%g\n",
+          fZ, fA, GetNumberOfPoints(),
+          (GetNumberOfPoints() ? TMath::Exp(fLogE.front()) : 0.),
+          (GetNumberOfPoints() ? TMath::Exp(fLogE.back()) : 0.),
+          fAccuracy, fMaxDeviation);
+}
@@ -0,0 +1,89 @@
+#ifndef __KVRANGEENERGYTABLE_H
+#define __KVRANGEENERGYTABLE_H
+
+#include "TObject.h"
+#include "KVIonRangeTable.h"
+#include <vector>
+
+class KVIonRangeTableMaterial;
+
+class KVRangeEnergyTable : public TObject {
+
+   Int_t fZ;                         // atomic number of ion
+   Int_t fA;                         // mass number of ion
+   Double_t fAccuracy;               // required relative accuracy of interpolation
+   Double_t fMaxDeviation;           // largest relative deviation found when building table
+   Double_t fLogEmin;                // log(E) of first point of grid
+   Double_t fDlogE;                  // (constant) step in log(E) between grid points
+   std::vector<Double_t> fLogE;      // log(E) at each point of grid [E in MeV]
+   std::vector<Double_t> fLogR;      // log(R) at each point of grid [R in g/cm**2]
+   std::vector<Double_t> fSlopeR;    // slopes dlog(R)/dlog(E) for monotone interpolation of range
+   std::vector<Double_t> fSlopeE;    // slopes dlog(E)/dlog(R) for monotone interpolation of energy
+
+   static void MonotoneSlopes(const std::vector<Double_t>& x, const std::vector<Double_t>& y, std::vector<Double_t>& m);
+   static Double_t Hermite(Double_t x, Double_t x0, Double_t x1, Double_t y0, Double_t y1, Double_t m0, Double_t m1);
+   void FillGrid(const KVIonRangeTableMaterial*, Double_t emin, Double_t emax, Int_t npts);
+   Double_t TestGrid(const KVIonRangeTableMaterial*) const;
+
+public:
+   KVRangeEnergyTable();
+   KVRangeEnergyTable(const KVIonRangeTableMaterial* mat, Int_t Z, Int_t A, Double_t emin, Double_t emax, Double_t accuracy);
+   virtual ~KVRangeEnergyTable();
+
+   Int_t GetZ() const
+   {
+      return fZ;
+   }
+   Int_t GetA() const
+   {
+      return fA;
+   }
+   Double_t GetAccuracy() const
+   {
+      // Relative accuracy required when table was built
+      return fAccuracy;
+   }
+   Double_t GetMaxDeviation() const
+   {
+      // Largest relative deviation of interpolated range or energy from
+      // exact calculation, found at mid-points of grid when table was built
+      return fMaxDeviation;
+   }
+   Int_t GetNumberOfPoints() const
+   {
+      return fLogE.size();
+   }
+
+   Double_t GetRange(Double_t E) const;
+   Double_t GetEnergy(Double_t R) const;
+
+   Double_t GetERes(Double_t E, Double_t e) const
+   {
+      // Residual energy (MeV) after thickness e (g/cm**2) for incident energy E (MeV)
+      Double_t R0 = GetRange(E);
+      return (R0 < e ? 0. : GetEnergy(R0 - e));
+   }
+   Double_t GetDeltaE(Double_t E, Double_t e) const
+   {
+      // Energy loss (MeV) in thickness e (g/cm**2) for incident energy E (MeV)
+      return E - GetERes(E, e);
+   }
+   Double_t GetEIncFromERes(Double_t Eres, Double_t e) const
+   {
+      // Incident energy (MeV) corresponding to residual energy Eres (MeV) after thickness e (g/cm**2)
+      return GetEnergy(GetRange(Eres) + e);
+   }
+   Double_t GetPunchThroughEnergy(Double_t e) const
+   {
+      // Incident energy (MeV) for which range is equal to thickness e (g/cm**2)
+      return GetEnergy(e);
+   }
+   Double_t GetEIncOfMaxDeltaE(Double_t e) const;
+   Double_t GetEIncFromDeltaE(Double_t DeltaE, Double_t e, enum KVIonRangeTable::SolType type = KVIonRangeTable::kEmax) const;
+
+   void Print(Option_t* = "") const;
+
+   ClassDef(KVRangeEnergyTable, 1) //Tabulated range-energy relation for an ion in a material with monotone interpolation
+};
+
+#endif
@@ -9,6 +9,8 @@
 #include "TString.h"
 #include "KVNucleus.h"
 #include "KVNumberList.h"
+#include "KVDataFileCache.h"
+#include "TStopwatch.h"
 #include <Riostream.h>
 using namespace std;
 
@@ -167,7 +169,7 @@ void KVRangeYanez::AddElementalMaterial(Int_t z, Int_t a)
                "Nuclear data tables have not been initialised");
          return;
       }
-      KVElementDensity* ed = (KVElementDensity*)gNDTManager->GetData(z, a, "ElementDensity");
+      KVElementDensity* ed = (KVElementDensity*)gNDTManager->GetData(z, a, KVNDTManager::kElementDensity);
       if (!ed) {
          Error("AddElementalMaterial",
                "No element found in ElementDensity NDT-table with Z=%d", z);
@@ -237,7 +239,7 @@ KVIonRangeTableMaterial* KVRangeYanez::MakeNaturallyOccuringElementMixture(Int_t
             "Nuclear data tables have not been initialised");
       return NULL;
    }
-   KVElementDensity* ed = (KVElementDensity*)gNDTManager->GetData(z, z, "ElementDensity");
+   KVElementDensity* ed = (KVElementDensity*)gNDTManager->GetData(z, z, KVNDTManager::kElementDensity);
    if (!ed) {
       Error("AddElementalMaterial",
             "No element found in ElementDensity NDT-table with Z=%d", z);
@@ -265,71 +267,150 @@ KVIonRangeTableMaterial* KVRangeYanez::MakeNaturallyOccuringElementMixture(Int_t
 }
 //____________________________________________________________________________
 
+namespace {
+   // definition of a compound or mixed material read by KVRangeYanez::ReadPredefinedMaterials
+   struct predefined_material {
+      Bool_t compound;
+      KVString name, symbol;
+      Double_t density;
+      Int_t nelem;
+      Int_t natoms[10];
+      Int_t z[10], a[10];
+      Double_t proportion[10];
+   };
+   typedef std::vector<predefined_material> predefined_materials;
+
+   Bool_t read_predefined_materials_file(const TString& DataFilePath, predefined_materials& materials)
+   {
+      ifstream filestream(DataFilePath.Data());
+      if (!filestream.good()) return kFALSE;
+
+      Bool_t compound, mixture;
+      compound = mixture = kFALSE;
+
+      KVString line;
+      while (filestream.good()) {
+         line.ReadLine(filestream);
+         if (filestream.good()) {
+            if (line.BeginsWith("//")) continue;
+            if (line.BeginsWith("COMPOUND")) {
+               compound = kTRUE;
+               mixture = kFALSE;
+            } else if (line.BeginsWith("MIXTURE")) {
+               compound = kFALSE;
+               mixture = kTRUE;
+            }
+            if (compound || mixture) {
+               // new compound or mixed material
+               predefined_material mat;
+               mat.compound = compound;
+               mat.density = -1;
+               mat.nelem = 0;
+               KVString element;
+               line.ReadLine(filestream);
+               while (filestream.good() && !line.IsWhitespace() && line != "\n") {
+                  line.Begin("=");
+                  KVString next = line.Next();
+                  if (next == "name") mat.name = line.Next();
+                  else if (next == "symbol") mat.symbol = line.Next();
+                  else if (next == "density") mat.density = line.Next().Atof();
+                  else if (next == "nelem") {
+                     mat.nelem = line.Next().Atoi();
+                     for (int i = 0; i < mat.nelem; i++) {
+                        line.ReadLine(filestream);
+                        line.Begin(" ");
+                        element = line.Next();
+                        mat.a[i] = KVNucleus::IsMassGiven(element);
+                        KVNucleus n(element);
+                        mat.z[i] = n.GetZ();
+                        if (!mat.a[i]) mat.a[i] = TMath::Nint(n.GetNaturalA());
+                        mat.natoms[i] = line.Next().Atoi();
+                        mat.proportion[i] = (mixture ? line.Next().Atof() : 0.);
+                     }
+                  }
+                  line.ReadLine(filestream, kFALSE); //do not skip 'whitespace'
+               }
+               materials.push_back(mat);
+               compound = mixture = kFALSE;
+            }
+         }
+      }
+      return kTRUE;
+   }
+
+   Bool_t read_predefined_materials_cache(KVDataFileCache& cache, predefined_materials& materials)
+   {
+      if (!cache.Open()) return kFALSE;
+      Int_t nmat = cache.ReadInt();
+      for (int m = 0; m < nmat && cache.IsOK(); m++) {
+         predefined_material mat;
+         mat.compound = cache.ReadInt();
+         mat.name = cache.ReadString();
+         mat.symbol = cache.ReadString();
+         mat.density = cache.ReadDouble();
+         mat.nelem = cache.ReadInt();
+         if (mat.nelem < 0 || mat.nelem > 10) return kFALSE;
+         for (int i = 0; i < mat.nelem; i++) {
+            mat.z[i] = cache.ReadInt();
+            mat.a[i] = cache.ReadInt();
+            mat.natoms[i] = cache.ReadInt();
+            mat.proportion[i] = cache.ReadDouble();
+         }
+         materials.push_back(mat);
+      }
+      return cache.IsOK();
+   }
+
+   void write_predefined_materials_cache(KVDataFileCache& cache, const predefined_materials& materials)
+   {
+      cache.WriteInt(materials.size());
+      for (predefined_materials::const_iterator it = materials.begin(); it != materials.end(); ++it) {
+         cache.WriteInt(it->compound);
+         cache.WriteString(it->name);
+         cache.WriteString(it->symbol);
+         cache.WriteDouble(it->density);
+         cache.WriteInt(it->nelem);
+         for (int i = 0; i < it->nelem; i++) {
+            cache.WriteInt(it->z[i]);
+            cache.WriteInt(it->a[i]);
+            cache.WriteInt(it->natoms[i]);
+            cache.WriteDouble(it->proportion[i]);
+         }
+      }
+      cache.Save();
+   }
+}
+
 void KVRangeYanez::ReadPredefinedMaterials(const Char_t* filename)
 {
    // Read materials from file whose name is given
+   //
+   // The definitions read from the file are kept in a binary cache (see KVDataFileCache)
+   // which is used instead of the file by all following processes.
 
-   TString DataFilePath = filename;
-
-   ifstream filestream;
-   if (!SearchAndOpenKVFile(DataFilePath, filestream, "data")) {
-      Error("ReadPredefinedMaterials", "Cannot open %s for reading", DataFilePath.Data());
+   TString DataFilePath;
+   if (!SearchKVFile(filename, DataFilePath, "data")) {
+      Error("ReadPredefinedMaterials", "Cannot open %s for reading", filename);
       return;
    }
    Info("ReadPredefinedMaterials", "Reading materials in file : %s", filename);
 
-   Bool_t compound, mixture;
-   compound = mixture = kFALSE;
-
-   KVString line;
-   while (filestream.good()) {
-      line.ReadLine(filestream);
-      if (filestream.good()) {
-         if (line.BeginsWith("//")) continue;
-         if (line.BeginsWith("COMPOUND")) {
-            compound = kTRUE;
-            mixture = kFALSE;
-         } else if (line.BeginsWith("MIXTURE")) {
-            compound = kFALSE;
-            mixture = kTRUE;
-         }
-         if (compound || mixture) {
-            // new compound or mixed material
-            KVString name, symbol, state;
-            Double_t density = -1;
-            KVString element[10];
-            Int_t natoms[10];
-            Int_t z[10], a[10];
-            Double_t proportion[10];
-            Int_t nelem = 0;
-            line.ReadLine(filestream);
-            while (filestream.good() && !line.IsWhitespace() && line != "\n") {
-               line.Begin("=");
-               KVString next = line.Next();
-               if (next == "name") name = line.Next();
-               else if (next == "symbol") symbol = line.Next();
-               else if (next == "state") state = line.Next();
-               else if (next == "density") density = line.Next().Atof();
-               else if (next == "nelem") {
-                  nelem = line.Next().Atoi();
-                  for (int i = 0; i < nelem; i++) {
-                     line.ReadLine(filestream);
-                     line.Begin(" ");
-                     element[i] = line.Next();
-                     a[i] = KVNucleus::IsMassGiven(element[i]);
-                     KVNucleus n(element[i]);
-                     z[i] = n.GetZ();
-                     if (!a[i]) a[i] = TMath::Nint(n.GetNaturalA());
-                     natoms[i] = line.Next().Atoi();
-                     if (mixture) proportion[i] = line.Next().Atof();
-                  }
-               }
-               line.ReadLine(filestream, kFALSE); //do not skip 'whitespace'
-            }
-            if (compound) AddCompoundMaterial(name, symbol, nelem, z, a, natoms, density);
-            else if (mixture) AddMixedMaterial(name, symbol, nelem, z, a, natoms, proportion, density);
-            compound = mixture = kFALSE;
-         }
+   TStopwatch timer;
+   KVDataFileCache cache("KVRangeYanez", DataFilePath);
+   predefined_materials materials;
+   Bool_t from_cache = read_predefined_materials_cache(cache, materials);
+   if (!from_cache) {
+      materials.clear();
+      if (!read_predefined_materials_file(DataFilePath, materials)) {
+         Error("ReadPredefinedMaterials", "Cannot open %s for reading", DataFilePath.Data());
+         return;
       }
+      write_predefined_materials_cache(cache, materials);
+   }
+
+   for (predefined_materials::iterator it = materials.begin(); it != materials.end(); ++it) {
+      if (it->compound) AddCompoundMaterial(it->name, it->symbol, it->nelem, it->z, it->a, it->natoms, it->density);
+      else AddMixedMaterial(it->name, it->symbol, it->nelem, it->z, it->a, it->natoms, it->proportion, it->density);
    }
+   KVDataFileCache::AddTiming(GetName(), DataFilePath, from_cache, timer.RealTime());
 }
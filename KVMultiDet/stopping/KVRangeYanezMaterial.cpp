@@ -6,11 +6,32 @@
 #include "TEnv.h"
 #include "KVUnits.h"
 #include "KVNameValueList.h"
+#include "KVRangeEnergyTable.h"
 #include "range.h"
 #include "Riostream.h"
 #include "KVConfig.h"
+#include "Math/IFunction.h"
+#include "Math/BrentMinimizer1D.h"
+#ifdef WITH_CPP11
+#include <mutex>
+#endif
 using namespace std;
 
+#ifdef WITH_CPP11
+namespace {
+   // the Range C library uses global variables (nelem, absorb, ...) for each calculation:
+   // all calls to the library (and the setting of its globals) are serialised with this mutex
+   std::mutex range_lib_mutex;
+   // protects the cache of lower energy limits used by GetCalcEnergyLimits
+   std::mutex calc_emin_mutex;
+}
+#define RANGE_LIB_LOCK std::lock_guard<std::mutex> range_lib_lock(range_lib_mutex)
+#define CALC_EMIN_LOCK std::lock_guard<std::mutex> calc_emin_lock(calc_emin_mutex)
+#else
+#define RANGE_LIB_LOCK
+#define CALC_EMIN_LOCK
+#endif
+
 //Int_t KVRangeYanezMaterial::fTableType = 1;//Hubert-Bimbot-Gauvin, valid for 2.5<E/A<100 MeV
 
 ClassImp(KVRangeYanezMaterial)
@@ -22,6 +43,11 @@ ClassImp(KVRangeYanezMaterial)
 <h4>Description of absorber for the Range dE/dx and range library (Ricardo Yanez)</h4>
 <!-- */
 // --> END_HTML
+// The re-entrant Calc... methods call the Range library directly, without using
+// the TF1 objects of the material. As the library itself keeps the description of
+// the current absorber in global variables, all calls to the library (including
+// those made by the TF1 functions) are serialised (C++11 only): several threads may
+// use the same material, but they will not calculate in parallel.
 ////////////////////////////////////////////////////////////////////////////////
 
 KVRangeYanezMaterial::KVRangeYanezMaterial()
@@ -117,6 +143,8 @@ Double_t KVRangeYanezMaterial::EResFunc(Double_t* E, Double_t*)
    // we return Eres=0 i.e. all particles with E<=1keV are stopped.
 
    if (E[0] < 1.e-3) return 0.0;
+   RANGE_LIB_LOCK;
+   SetRangeLibGlobals();
    return passage(fTableType, Zp, Ap, iabso, fAbsorb[0].z, fAbsorb[0].a, E[0], thickness / KVUnits::mg, &error);
 }
 
@@ -130,27 +158,142 @@ Double_t KVRangeYanezMaterial::RangeFunc(Double_t* E, Double_t*)
    // we return range=0 i.e. all particles with E<=1keV are stopped.
 
    if (E[0] < 1.e-3) return 0.;
+   RANGE_LIB_LOCK;
+   SetRangeLibGlobals();
    Double_t R = rangen(fTableType, Zp, Ap, iabso, fAbsorb[0].z, fAbsorb[0].a, E[0]);
    return (R * KVUnits::mg);
 }
 
 void KVRangeYanezMaterial::PrepareRangeLibVariables(Int_t Z, Int_t A)
 {
+   // Set projectile for the TF1 functions.
+   // The global variables of the Range library describing the absorber are set
+   // (while holding the library lock) by each function call, see SetRangeLibGlobals.
+
+   Zp = Z;
+   Ap = A;
+}
+
+void KVRangeYanezMaterial::SetRangeLibGlobals() const
+{
+   // Set global variables of Range library describing this absorber.
+   // Must be called while holding the library lock, just before calling the library.
+
    nelem = fNelem;
 #ifdef WITH_MODIFIED_RANGE_YANEZ
    is_gas = (int)IsGas(); // special treatment for effective charge in gases (M.F. Rivet, R. Bimbot et al)
 #endif
    if (iabso < 0) {
-      //cout << "nelem="<<nelem<<endl;
-      for (register int k = 0; k < fNelem; k++) {
+      for (int k = 0; k < fNelem; k++) {
          absorb[k].z = fAbsorb[k].z;
          absorb[k].a = fAbsorb[k].a;
          absorb[k].w = fAbsorb[k].w;
-         //cout << k << " " << absorb[k].z << " " << absorb[k].a << " " << absorb[k].w << endl;
       }
    }
-   Zp = Z;
-   Ap = A;
+}
+
+Double_t KVRangeYanezMaterial::CalcRangeOfIon(Int_t Z, Int_t A, Double_t E, Double_t) const
+{
+   // Re-entrant calculation of range (in g/cm**2) of ion (Z,A) with energy E (MeV) in material.
+   // Same as RangeFunc, i.e. an interface to the rangen() function of the Range C library.
+   // isotopic mass isoAmat argument is not used.
+
+   if (E < 1.e-3) return 0.;
+   RANGE_LIB_LOCK;
+   SetRangeLibGlobals();
+   Double_t R = rangen(fTableType, Z, A, iabso, fAbsorb[0].z, fAbsorb[0].a, E);
+   return (R * KVUnits::mg);
+}
+
+Double_t KVRangeYanezMaterial::CalcEResOfIon(Int_t Z, Int_t A, Double_t E, Double_t e, Double_t) const
+{
+   // Re-entrant calculation of residual energy (in MeV) of ion (Z,A) with energy E (MeV) after thickness e (in g/cm**2).
+   // Same as EResFunc, i.e. an interface to the passage() function of the Range C library.
+   // isotopic mass isoAmat argument is not used.
+
+   if (E < 1.e-3) return 0.0;
+   Double_t err;
+   RANGE_LIB_LOCK;
+   SetRangeLibGlobals();
+   return passage(fTableType, Z, A, iabso, fAbsorb[0].z, fAbsorb[0].a, E, e / KVUnits::mg, &err);
+}
+
+Double_t KVRangeYanezMaterial::CalcEIncFromEResOfIon(Int_t Z, Int_t A, Double_t Eres, Double_t e, Double_t) const
+{
+   // Re-entrant calculation of incident energy (in MeV) of an ion (Z,A) with residual energy Eres (MeV)
+   // after thickness e (in g/cm**2), using the egassap() function of the Range C library.
+   // isotopic mass isoAmat argument is not used.
+
+   Double_t err;
+   RANGE_LIB_LOCK;
+   SetRangeLibGlobals();
+   return egassap(fTableType, Z, A, iabso, fAbsorb[0].z, fAbsorb[0].a, e / KVUnits::mg, Eres, &err);
+}
+
+namespace {
+   // range as a function of incident energy, for finding lower limit of validity
+   class KVRYM_RangeFunc : public ROOT::Math::IBaseFunctionOneDim {
+      const KVRangeYanezMaterial* fMat;
+      Int_t fZ, fA;
+      double DoEval(double E) const
+      {
+         return fMat->CalcRangeOfIon(fZ, fA, E);
+      }
+   public:
+      KVRYM_RangeFunc(const KVRangeYanezMaterial* m, Int_t Z, Int_t A)
+         : fMat(m), fZ(Z), fA(A) {}
+      ROOT::Math::IBaseFunctionOneDim* Clone() const
+      {
+         return new KVRYM_RangeFunc(*this);
+      }
+   };
+}
+
+void KVRangeYanezMaterial::GetCalcEnergyLimits(Int_t Z, Int_t A, Double_t, Double_t& emin, Double_t& emax) const
+{
+   // Same energy interval as used for TF1 range function in GetRangeFunction:
+   // from the (negative) minimum of the range function at very low energy (or 1 eV)
+   // up to 400 MeV/nucleon.
+   // The lower limit is only calculated the first time it is needed for each (Z,A).
+
+   emax = 400 * A;
+   Int_t key = 1000 * Z + A;
+   {
+      CALC_EMIN_LOCK;
+      std::map<Int_t, Double_t>::const_iterator it = fCalcEmin.find(key);
+      if (it != fCalcEmin.end()) {
+         emin = it->second;
+         return;
+      }
+   }
+   // the minimisation is performed without holding the cache lock, as each evaluation
+   // of the range takes the Range library lock
+   KVRYM_RangeFunc rf(this, Z, A);
+   ROOT::Math::BrentMinimizer1D bm;
+   bm.SetFunction(rf, 1.e-6, emax);
+   bm.SetNpx(100);
+   bm.Minimize(100, 1.e-10, 1.e-10);
+   emin = TMath::Max(1.e-6, bm.XMinimum());
+   CALC_EMIN_LOCK;
+   fCalcEmin[key] = emin;
+}
+
+void KVRangeYanezMaterial::ClearCalcEnergyLimits()
+{
+   // Clear the cache of lower energy limits used by GetCalcEnergyLimits
+   // (called when the absorber or the type of table is changed)
+
+   CALC_EMIN_LOCK;
+   fCalcEmin.clear();
+}
+
+void KVRangeYanezMaterial::SetTableType(int type)
+{
+   // =0 for Northcliffe-Schilling (<12 MeV/u), =1 for Hubert et al (2.5<E/A<500 MeV),
+   // =2 for interpolated (0<E/A<500 MeV)
+
+   fTableType = type;
+   ClearCalcEnergyLimits();
 }
 
 TF1* KVRangeYanezMaterial::GetDeltaEFunction(Double_t e, Int_t Z, Int_t A, Double_t)
@@ -219,6 +362,7 @@ void KVRangeYanezMaterial::Initialize()
          fNelem++;
       }
    }
+   ClearCalcEnergyLimits();
 }
 
 Double_t KVRangeYanezMaterial::GetEIncFromEResOfIon(Int_t Z, Int_t A, Double_t Eres, Double_t e, Double_t)
@@ -226,6 +370,10 @@ Double_t KVRangeYanezMaterial::GetEIncFromEResOfIon(Int_t Z, Int_t A, Double_t E
    // Overrides KVIonRangeTableMaterial method to use the egassap() function of  the Range C library.
    // Calculates incident energy (in MeV) of an ion (Z,A) with residual energy Eres (MeV) after thickness e (in g/cm**2).
    // isotopic mass isoAmat argument is not used.
+   // In tabulated mode (see KVIonRangeTable::SetTabulatedMode) the tabulated range-energy relation is used.
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A)) return t->GetEIncFromERes(Eres, e);
    PrepareRangeLibVariables(Z, A);
+   RANGE_LIB_LOCK;
+   SetRangeLibGlobals();
    return egassap(fTableType, Zp, Ap, iabso, fAbsorb[0].z, fAbsorb[0].a, e / KVUnits::mg, Eres, &error);
 }
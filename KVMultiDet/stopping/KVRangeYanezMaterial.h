@@ -5,6 +5,7 @@
 #define __KVRANGEYANEZMATERIAL_H
 
 #include "KVIonRangeTableMaterial.h"
+#include <map>
 
 class KVRangeYanezMaterial : public KVIonRangeTableMaterial {
    Int_t fTableType;//=0 for Northcliffe-Schilling (<12 MeV/u), =1 for Hubert et al (2.5<E/A<500 MeV), =2 for interpolated (0<E/A<500 MeV)
@@ -19,6 +20,9 @@ class KVRangeYanezMaterial : public KVIonRangeTableMaterial {
    Double_t thickness;                  //! in g/cm**2
    Int_t Zp, Ap;                             //!Z,A of incident projectile ion
    Double_t error;                        //!calculated error in MeV
+   mutable std::map<Int_t, Double_t> fCalcEmin;//!lower limit of range function for each (Z,A), key=1000*Z+A
+
+   void ClearCalcEnergyLimits();
 
 protected:
    void PrepareRangeLibVariables(Int_t Z, Int_t A);
@@ -28,6 +32,9 @@ protected:
 
    void MakeFunctionObjects();
 
+   void SetRangeLibGlobals() const;
+   virtual void GetCalcEnergyLimits(Int_t Z, Int_t A, Double_t isoAmat, Double_t& emin, Double_t& emax) const;
+
 public:
    KVRangeYanezMaterial();
    KVRangeYanezMaterial(const KVRangeYanezMaterial&) ;
@@ -45,13 +52,14 @@ public:
       Warning("GetStoppingFunction", "Not available for Yanez Range tables");
       return 0;
    };
-   void SetTableType(int type)
-   {
-      fTableType = type;
-   };
+   void SetTableType(int type);
 
    virtual Double_t GetEIncFromEResOfIon(Int_t Z, Int_t A, Double_t Eres, Double_t e, Double_t isoAmat = 0.);
 
+   virtual Double_t CalcRangeOfIon(Int_t Z, Int_t A, Double_t E, Double_t isoAmat = 0.) const;
+   virtual Double_t CalcEResOfIon(Int_t Z, Int_t A, Double_t E, Double_t e, Double_t isoAmat = 0.) const;
+   virtual Double_t CalcEIncFromEResOfIon(Int_t Z, Int_t A, Double_t Eres, Double_t e, Double_t isoAmat = 0.) const;
+
    ClassDef(KVRangeYanezMaterial, 1) //Description of absorber for the Range dE/dx and range library (Ricardo Yanez)
 };
 
@@ -7,6 +7,8 @@
 #include <TSystem.h>
 #include <TEnv.h>
 #include "TGeoMaterial.h"
+#include "TStopwatch.h"
+#include "KVDataFileCache.h"
 
 ClassImp(KVedaLoss)
 
@@ -75,13 +77,11 @@ Bool_t KVedaLoss::init_materials() const
 {
    // PRIVATE method - called to initialize fMaterials list of all known materials
    // properties, read from file given by TEnv variable KVedaLoss.RangeTables
+   //
+   // The parameters read from the file are kept in a binary cache (see KVDataFileCache)
+   // which is used instead of the file by all following processes.
 
    Info("init_materials", "Initialising KVedaLoss...");
-//    printf("\n");
-//    printf("\t*************************************************************************\n");
-//    printf("\t*                VEDALOSS STOPPING POWER & RANGE TABLES                 *\n");
-//    printf("\t*                                                                       *\n");
-   int mat_count = 0;
    fMaterials = new KVHashList;
    fMaterials->SetName("VEDALOSS materials list");
    fMaterials->SetOwner();
@@ -92,6 +92,59 @@ Bool_t KVedaLoss::init_materials() const
       return kFALSE;
    }
 
+   TStopwatch timer;
+   KVDataFileCache cache("KVedaLoss", DataFilePath);
+   Bool_t from_cache = read_materials_cache(cache);
+   if (!from_cache) {
+      fMaterials->Delete();
+      if (!read_materials_file(DataFilePath, cache)) return kFALSE;
+      cache.Save();
+   }
+   KVDataFileCache::AddTiming(GetName(), DataFilePath, from_cache, timer.RealTime());
+   return kTRUE;
+}
+
+void KVedaLoss::add_material(KVedaLossMaterial* mat) const
+{
+   // PRIVATE method - set up material after reading its range table parameters
+
+   mat->MakeRangeFunctions();
+   mat->Initialize();
+   if (mat->IsGas()) mat->SetTemperatureAndPressure(19., 1.*KVUnits::atm);
+}
+
+Bool_t KVedaLoss::read_materials_cache(KVDataFileCache& cache) const
+{
+   // PRIVATE method - read all materials from binary cache, if it is up to date
+
+   if (!cache.Open()) return kFALSE;
+   while (cache.ReadInt() && cache.IsOK()) {
+      TString name = cache.ReadString();
+      TString gtype = cache.ReadString();
+      TString state = cache.ReadString();
+      Double_t Dens = cache.ReadDouble();
+      Double_t Zmat = cache.ReadDouble();
+      Double_t Amat = cache.ReadDouble();
+      Double_t MoleWt = cache.ReadDouble();
+      if (!cache.IsOK()) break;
+      KVedaLossMaterial* tmp_mat = new KVedaLossMaterial(this, name, gtype, state, Dens,
+            Zmat, Amat, MoleWt);
+      fMaterials->Add(tmp_mat);
+      if (!tmp_mat->ReadRangeTableParameters(cache)) break;
+      add_material(tmp_mat);
+   }
+   if (!cache.IsOK()) {
+      Warning("init_materials", "Binary cache %s is corrupted: reading %s", cache.GetCacheFile(), cache.GetSourceFile());
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+Bool_t KVedaLoss::read_materials_file(const TString& DataFilePath, KVDataFileCache& cache) const
+{
+   // PRIVATE method - read all materials from range tables file,
+   // parameters are written in binary cache
+
    Char_t name[25], gtype[25], state[10];
    Float_t Amat = 0.;
    Float_t Dens = 0.;
@@ -126,29 +179,23 @@ Bool_t KVedaLoss::init_materials() const
                KVedaLossMaterial* tmp_mat = new KVedaLossMaterial(this, name, gtype, state, Dens,
                      Zmat, Amat, MoleWt);
                fMaterials->Add(tmp_mat);
-               if (!tmp_mat->ReadRangeTable(fp)) return kFALSE;
-               tmp_mat->Initialize();
-               ++mat_count;
-//               Double_t rho = 0.;
-               if (tmp_mat->IsGas()) tmp_mat->SetTemperatureAndPressure(19., 1.*KVUnits::atm);
-//               rho = tmp_mat->GetDensity();
-//                printf("\t*  %2d.  %-7s %-18s  Z=%2d A=%5.1f  rho=%6.3f g/cm**3    *\n",
-//                       mat_count, tmp_mat->GetType(), tmp_mat->GetName(),
-//                       (int)tmp_mat->GetZ(), tmp_mat->GetMass(),
-//                       rho);
+               if (!tmp_mat->ReadRangeTableParameters(fp)) return kFALSE;
+               cache.WriteInt(1);
+               cache.WriteString(name);
+               cache.WriteString(gtype);
+               cache.WriteString(state);
+               cache.WriteDouble(Dens);
+               cache.WriteDouble(Zmat);
+               cache.WriteDouble(Amat);
+               cache.WriteDouble(MoleWt);
+               tmp_mat->WriteRangeTableParameters(cache);
+               add_material(tmp_mat);
                break;
          }
       }
       fclose(fp);
    }
-//    printf("\t*                                                                       *\n");
-//    printf("\t*     TF1::Range::Npx = %4d            TF1::EnergyLoss::Npx = %4d     *\n",
-//           gEnv->GetValue("KVedaLoss.Range.Npx", 100), gEnv->GetValue("KVedaLoss.EnergyLoss.Npx", 100));
-//    printf("\t*                      TF1::ResidualEnergy::Npx = %4d                  *\n",
-//           gEnv->GetValue("KVedaLoss.ResidualEnergy.Npx", 100));
-//    printf("\t*                                                                       *\n");
-//    printf("\t*                       INITIALISATION COMPLETE                         *\n");
-//    printf("\t*************************************************************************\n");
+   cache.WriteInt(0);
    return kTRUE;
 }
 
@@ -9,11 +9,15 @@
 
 class KVedaLossMaterial;
 class TGeoMaterial;
+class KVDataFileCache;
 
 class KVedaLoss : public KVIonRangeTable {
    static KVHashList* fMaterials;// static list of all known materials
 
    Bool_t init_materials() const;
+   Bool_t read_materials_cache(KVDataFileCache&) const;
+   Bool_t read_materials_file(const TString&, KVDataFileCache&) const;
+   void add_material(KVedaLossMaterial*) const;
    Bool_t CheckMaterialsList() const
    {
       if (!fMaterials) return init_materials();
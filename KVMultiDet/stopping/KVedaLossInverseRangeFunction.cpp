@@ -67,7 +67,7 @@ KVedaLossInverseRangeFunction::~KVedaLossInverseRangeFunction()
    SafeDelete(fInterpol);
 }
 
-Double_t KVedaLossInverseRangeFunction::GetEnergyPerNucleon(Double_t range, Double_t riso)
+Double_t KVedaLossInverseRangeFunction::GetEnergyPerNucleon(Double_t range, Double_t riso) const
 {
    // Given range in g/cm**2 and current value returned by KVedaLossMaterial::get_riso
    // (which takes into account any change in ion mass and/or material mass)
@@ -20,7 +20,7 @@ public:
                                  Int_t ninter = 50);
    virtual ~KVedaLossInverseRangeFunction();
 
-   Double_t GetEnergyPerNucleon(Double_t range, Double_t riso);
+   Double_t GetEnergyPerNucleon(Double_t range, Double_t riso) const;
 
    ClassDef(KVedaLossInverseRangeFunction, 0) //Dedicated optimised inversion of range-energy function
 };
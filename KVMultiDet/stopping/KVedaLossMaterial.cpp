@@ -8,6 +8,9 @@
 #include <TF1.h>
 #include "KVedaLossInverseRangeFunction.h"
 #include "KVedaLoss.h"
+#include "KVRangeEnergyTable.h"
+#include "KVDataFileCache.h"
+#include "KVNameValueList.h"
 
 ClassImp(KVedaLossMaterial)
 
@@ -24,7 +27,7 @@ Bool_t KVedaLossMaterial::fNoLimits = kFALSE;
 KVedaLoss* KVedaLossMaterial::fgTable = nullptr;
 
 KVedaLossMaterial::KVedaLossMaterial()
-   : KVIonRangeTableMaterial(), fInvRange(ZMAX_VEDALOSS, 1),
+   : KVIonRangeTableMaterial(), fInvRange(ZMAX_VEDALOSS, 1), fInvRangeReady(kFALSE),
      fEmin(ZMAX_VEDALOSS), fEmax(ZMAX_VEDALOSS), fCoeff(ZMAX_VEDALOSS, std::vector<Double_t>(14))
 {
    // Default constructor
@@ -37,7 +40,7 @@ KVedaLossMaterial::KVedaLossMaterial()
 
 KVedaLossMaterial::KVedaLossMaterial(const KVIonRangeTable* t, const Char_t* name, const Char_t* type, const Char_t* state,
                                      Double_t density, Double_t Z, Double_t A, Double_t)
-   : KVIonRangeTableMaterial(t, name, type, state, density, Z, A), fInvRange(ZMAX_VEDALOSS, 1),
+   : KVIonRangeTableMaterial(t, name, type, state, density, Z, A), fInvRange(ZMAX_VEDALOSS, 1), fInvRangeReady(kFALSE),
      fEmin(ZMAX_VEDALOSS), fEmax(ZMAX_VEDALOSS), fCoeff(ZMAX_VEDALOSS, std::vector<Double_t>(14))
 {
    // create new material
@@ -56,20 +59,19 @@ KVedaLossMaterial::~KVedaLossMaterial()
 
 Bool_t KVedaLossMaterial::ReadRangeTable(FILE* fp)
 {
-   // Read Z- & A-dependent range parameters for material
-   //
-   // For each material we create 4 TF1 objects:
-   //   KVedaLossMaterial:[type]:Range                -  gives range in g/cm**2 as a function of particle energy
-   //   KVedaLossMaterial:[type]:StoppingPower           -  gives dE/dx in MeV/(g/cm**2) as a function of particle energy
-   //   KVedaLossMaterial:[type]:EnergyLoss           -  gives dE as a function of particle energy
-   //   KVedaLossMaterial:[type]:ResidualEnergy       -  gives energy after material (0 if particle stops)
-   //
-   // The TF1::fNpx parameter for these functions is defined by the environment variables
-   //
-   //   KVedaLoss.Range.Npx:         20      /* also used for StoppingPower */
-   //   KVedaLoss.EnergyLoss.Npx:         50
-   //   KVedaLoss.ResidualEnergy.Npx:         20
-   //
+   // Read Z- & A-dependent range parameters for material (see ReadRangeTableParameters)
+   // and set up range functions (see MakeRangeFunctions)
+
+   if (!ReadRangeTableParameters(fp)) return kFALSE;
+   MakeRangeFunctions();
+   return kTRUE;
+}
+
+Bool_t KVedaLossMaterial::ReadRangeTableParameters(FILE* fp)
+{
+   // Read Z- & A-dependent range parameters for material:
+   // composition of compound/mixture, limits in energy for validity of
+   // calculation, and coefficients of range function for each Z
 
    char line[132];
 
@@ -120,27 +122,6 @@ Bool_t KVedaLossMaterial::ReadRangeTable(FILE* fp)
       }
    }
 
-   // get require Npx value from (user-defined) environment variables
-   Int_t my_npx = gEnv->GetValue("KVedaLoss.Range.Npx", 100);
-
-   fRange = new TF1(Form("KVedaLossMaterial:%s:Range", GetType()), this, &KVedaLossMaterial::RangeFunc,
-                    0., 1.e+03, 0, "KVedaLossMaterial", "RangeFunc");
-   fRange->SetNpx(my_npx);
-
-   fStopping = new TF1(Form("KVedaLossMaterial:%s:StoppingPower", GetType()), this, &KVedaLossMaterial::StoppingFunc,
-                       0., 1.e+03, 0, "KVedaLossMaterial", "StoppingFunc");
-   fStopping->SetNpx(my_npx);
-
-   my_npx = gEnv->GetValue("KVedaLoss.EnergyLoss.Npx", 100);
-   fDeltaE = new TF1(Form("KVedaLossMaterial:%s:EnergyLoss", GetType()), this, &KVedaLossMaterial::DeltaEFunc,
-                     0., 1.e+03, 0, "KVedaLossMaterial", "DeltaEFunc");
-   fDeltaE->SetNpx(my_npx);
-
-   my_npx = gEnv->GetValue("KVedaLoss.ResidualEnergy.Npx", 100);
-   fEres = new TF1(Form("KVedaLossMaterial:%s:ResidualEnergy", GetType()), this, &KVedaLossMaterial::EResFunc,
-                   0., 1.e+03, 0, "KVedaLossMaterial", "EResFunc");
-   fEres->SetNpx(my_npx);
-
    for (int count = 0; count < ZMAX_VEDALOSS; count++) {
 
       if (sscanf(line, "%lf %lf %lf %lf %lf %lf %lf %lf",
@@ -165,32 +146,128 @@ Bool_t KVedaLossMaterial::ReadRangeTable(FILE* fp)
             return kFALSE;
          }
       }
-      if (fNoLimits) {
-         // if we ignore nominal validity limits on incident energy, we must still use energy limits
-         // such that all range functions increase monotonically in the energy interval
-         GetRangeFunction(fCoeff[count][0], fCoeff[count][1])->SetRange(GetEminValid(fCoeff[count][0], fCoeff[count][1]), VERY_BIG_ENERGY);
-         Double_t emax = fRange->GetMaximumX() - 1;
-         emax /= fCoeff[count][1];
-         Double_t original_emax = fEmax[count];
-         // the new emax is only accepted if it is > than the nominal emax (400 or 250 AMeV),
-         // and at most 1 GeV/nucleon
-         fEmax[count] = TMath::Min(TMath::Max(original_emax, emax), 1000.);
-         // we may further reduce the upper limit to correspond to the minimum of stopping,
-         // if one exists
-         GetStoppingFunction(fCoeff[count][0], fCoeff[count][1])->SetRange(GetEminValid(fCoeff[count][0], fCoeff[count][1]), GetEmaxValid(fCoeff[count][0], fCoeff[count][1]));
-         emax = fStopping->GetMinimumX();
-         emax /= fCoeff[count][1];
-         // again, the new emax is only accepted if it is > than the nominal emax (400 or 250 AMeV),
-         // and at most 1 GeV/nucleon
-         fEmax[count] = TMath::Min(TMath::Max(original_emax, emax), 1000.);
-         //if(fEmax[count]!=original_emax) Info("ReadRangeTable", "Max. incident E for Z=%d  ===>  E/A = %f", count+1, fEmax[count]);
-      }
       if (fgets(line, 132, fp)) {}
    }
 
    return kTRUE;
 }
 
+void KVedaLossMaterial::WriteRangeTableParameters(KVDataFileCache& cache) const
+{
+   // Write parameters read by ReadRangeTableParameters(FILE*) in binary cache
+   // (must be called before MakeRangeFunctions, which may change the energy limits)
+
+   Int_t type = (IsCompound() ? 1 : (IsMixture() ? 2 : 0));
+   cache.WriteInt(type);
+   if (type) {
+      cache.WriteInt(GetComposition()->GetEntries());
+      TIter next(GetComposition());
+      KVNameValueList* nvl;
+      while ((nvl = (KVNameValueList*)next())) {
+         cache.WriteInt(nvl->GetIntValue("Z"));
+         cache.WriteInt(nvl->GetIntValue("A"));
+         cache.WriteInt(nvl->GetIntValue("Natoms"));
+         if (type == 2) cache.WriteDouble(nvl->GetDoubleValue("Proportion"));
+      }
+   }
+   cache.WriteArray(&fEmin[0], ZMAX_VEDALOSS);
+   cache.WriteArray(&fEmax[0], ZMAX_VEDALOSS);
+   for (int count = 0; count < ZMAX_VEDALOSS; count++) cache.WriteArray(&fCoeff[count][0], 14);
+}
+
+Bool_t KVedaLossMaterial::ReadRangeTableParameters(KVDataFileCache& cache)
+{
+   // Read parameters written by WriteRangeTableParameters from binary cache.
+   // Returns kFALSE if cache is corrupted.
+
+   Int_t type = cache.ReadInt();
+   if (type) {
+      Int_t nel = cache.ReadInt();
+      for (int el = 0; el < nel && cache.IsOK(); el++) {
+         Int_t z = cache.ReadInt();
+         Int_t a = cache.ReadInt();
+         Int_t nat = cache.ReadInt();
+         if (type == 1) AddCompoundElement(z, a, nat);
+         else AddMixtureElement(z, a, nat, cache.ReadDouble());
+      }
+   }
+   cache.ReadArray(&fEmin[0], ZMAX_VEDALOSS);
+   cache.ReadArray(&fEmax[0], ZMAX_VEDALOSS);
+   for (int count = 0; count < ZMAX_VEDALOSS; count++) cache.ReadArray(&fCoeff[count][0], 14);
+   return cache.IsOK();
+}
+
+void KVedaLossMaterial::MakeRangeFunctions()
+{
+   // For each material we create 4 TF1 objects:
+   //   KVedaLossMaterial:[type]:Range                -  gives range in g/cm**2 as a function of particle energy
+   //   KVedaLossMaterial:[type]:StoppingPower           -  gives dE/dx in MeV/(g/cm**2) as a function of particle energy
+   //   KVedaLossMaterial:[type]:EnergyLoss           -  gives dE as a function of particle energy
+   //   KVedaLossMaterial:[type]:ResidualEnergy       -  gives energy after material (0 if particle stops)
+   //
+   // The TF1::fNpx parameter for these functions is defined by the environment variables
+   //
+   //   KVedaLoss.Range.Npx:         20      /* also used for StoppingPower */
+   //   KVedaLoss.EnergyLoss.Npx:         50
+   //   KVedaLoss.ResidualEnergy.Npx:         20
+   //
+   // If nominal validity limits on incident energy are ignored (see SetNoLimits),
+   // the maximum energies are recalculated here.
+   //
+   // If the new range inversion is used (KVedaLoss::SetUseNewRangeInversion), the
+   // inverse range functions for all Z are also built here, so that they are never
+   // modified afterwards by the re-entrant Calc... methods (see CalcEnergyFromRange).
+
+   // get require Npx value from (user-defined) environment variables
+   Int_t my_npx = gEnv->GetValue("KVedaLoss.Range.Npx", 100);
+
+   fRange = new TF1(Form("KVedaLossMaterial:%s:Range", GetType()), this, &KVedaLossMaterial::RangeFunc,
+                    0., 1.e+03, 0, "KVedaLossMaterial", "RangeFunc");
+   fRange->SetNpx(my_npx);
+
+   fStopping = new TF1(Form("KVedaLossMaterial:%s:StoppingPower", GetType()), this, &KVedaLossMaterial::StoppingFunc,
+                       0., 1.e+03, 0, "KVedaLossMaterial", "StoppingFunc");
+   fStopping->SetNpx(my_npx);
+
+   my_npx = gEnv->GetValue("KVedaLoss.EnergyLoss.Npx", 100);
+   fDeltaE = new TF1(Form("KVedaLossMaterial:%s:EnergyLoss", GetType()), this, &KVedaLossMaterial::DeltaEFunc,
+                     0., 1.e+03, 0, "KVedaLossMaterial", "DeltaEFunc");
+   fDeltaE->SetNpx(my_npx);
+
+   my_npx = gEnv->GetValue("KVedaLoss.ResidualEnergy.Npx", 100);
+   fEres = new TF1(Form("KVedaLossMaterial:%s:ResidualEnergy", GetType()), this, &KVedaLossMaterial::EResFunc,
+                   0., 1.e+03, 0, "KVedaLossMaterial", "EResFunc");
+   fEres->SetNpx(my_npx);
+
+   if (fgTable->IsUseNewRangeInversion()) {
+      for (int count = 0; count < ZMAX_VEDALOSS; count++) GetRangeFunction(fCoeff[count][0], fCoeff[count][1]);
+      fInvRangeReady = kTRUE;
+   }
+
+   if (!fNoLimits) return;
+
+   for (int count = 0; count < ZMAX_VEDALOSS; count++) {
+      // if we ignore nominal validity limits on incident energy, we must still use energy limits
+      // such that all range functions increase monotonically in the energy interval
+      GetRangeFunction(fCoeff[count][0], fCoeff[count][1])->SetRange(GetEminValid(fCoeff[count][0], fCoeff[count][1]), VERY_BIG_ENERGY);
+      Double_t emax = fRange->GetMaximumX() - 1;
+      emax /= fCoeff[count][1];
+      Double_t original_emax = fEmax[count];
+      // the new emax is only accepted if it is > than the nominal emax (400 or 250 AMeV),
+      // and at most 1 GeV/nucleon
+      fEmax[count] = TMath::Min(TMath::Max(original_emax, emax), 1000.);
+      // we may further reduce the upper limit to correspond to the minimum of stopping,
+      // if one exists
+      GetStoppingFunction(fCoeff[count][0], fCoeff[count][1])->SetRange(GetEminValid(fCoeff[count][0], fCoeff[count][1]), GetEmaxValid(fCoeff[count][0], fCoeff[count][1]));
+      emax = fStopping->GetMinimumX();
+      emax /= fCoeff[count][1];
+      // again, the new emax is only accepted if it is > than the nominal emax (400 or 250 AMeV),
+      // and at most 1 GeV/nucleon
+      fEmax[count] = TMath::Min(TMath::Max(original_emax, emax), 1000.);
+      //if(fEmax[count]!=original_emax) Info("ReadRangeTable", "Max. incident E for Z=%d  ===>  E/A = %f", count+1, fEmax[count]);
+   }
+}
+
 Double_t KVedaLossMaterial::DeltaEFunc(Double_t* E, Double_t*)
 {
    // Function parameterising the energy loss of charged particles in this material.
@@ -378,6 +455,7 @@ Double_t KVedaLossMaterial::GetRangeOfIon(Int_t Z, Int_t A, Double_t E, Double_t
       Warning("GetRangeOfIon", "Incident energy of (%d,%d) > limit of validity of KVedaLoss (Emax=%f)",
             Z,A,GetEmaxValid(Z,A));*/
    if (Z == 0) return 0.0; //only charged particles
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return t->GetRange(E);
    TF1* f = GetRangeFunction(Z, A, isoAmat);
    return f->Eval(E);
 }
@@ -391,6 +469,7 @@ Double_t KVedaLossMaterial::GetDeltaEOfIon(Int_t Z, Int_t A, Double_t E, Double_
       Warning("GetDeltaEOfIon", "Incident energy of (%d,%d) > limit of validity of KVedaLoss (Emax=%f)",
             Z,A,GetEmaxValid(Z,A)); */
    if (Z == 0) return 0.0; //only charged particles
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return E - GetTabulatedERes(t, E, e);
    TF1* f = GetDeltaEFunction(e, Z, A, isoAmat);
    return f->Eval(E);
 }
@@ -405,6 +484,7 @@ Double_t KVedaLossMaterial::GetEResOfIon(Int_t Z, Int_t A, Double_t E, Double_t
       Warning("GetEResOfIon", "Incident energy of (%d,%d) %f MeV/A > limit of validity of KVedaLoss (Emax=%f MeV/A)",
             Z,A,E/A,GetEmaxValid(Z,A)/A); */
    if (Z == 0) return 0.0; //only charged particles
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return GetTabulatedERes(t, E, e);
    TF1* f = GetEResFunction(e, Z, A, isoAmat);
    return f->Eval(E);
 }
@@ -417,6 +497,7 @@ Double_t KVedaLossMaterial::GetPunchThroughEnergy(Int_t Z, Int_t A, Double_t e,
    // Give Amat to change default (isotopic) mass of material.
 
    if (Z == 0) return 0.0; //only charged particles
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return t->GetPunchThroughEnergy(e);
    GetRangeFunction(Z, A, isoAmat);
    if (fgTable->IsUseNewRangeInversion()) {
       return static_cast<KVedaLossInverseRangeFunction*>(fInvRange[Z])->GetEnergyPerNucleon(e, riso) * A;
@@ -430,6 +511,7 @@ Double_t KVedaLossMaterial::GetEIncFromEResOfIon(Int_t Z, Int_t A, Double_t Eres
    // Give Amat to change default (isotopic) mass of material.
 
    if (Z == 0) return 0.0; //only charged particles
+   if (const KVRangeEnergyTable* t = GetTabulation(Z, A, isoAmat)) return t->GetEIncFromERes(Eres, e);
    GetRangeFunction(Z, A, isoAmat);
    Double_t R0 = fRange->Eval(Eres) + e;
    if (fgTable->IsUseNewRangeInversion()) {
@@ -438,6 +520,83 @@ Double_t KVedaLossMaterial::GetEIncFromEResOfIon(Int_t Z, Int_t A, Double_t Eres
    return fRange->GetX(R0);
 }
 
+void KVedaLossMaterial::GetRangeParameters(Int_t Z, Int_t A, Double_t isoAmat, RangeParameters& rp) const
+{
+   // Fill rp with the parameters of the range function for ion (Z,A) in this material.
+   // This is the re-entrant equivalent of the set-up performed by GetRangeFunction:
+   // the internal state of the material is not modified.
+
+   rp.par = &fCoeff[Z - 1];
+   rp.A = A;
+   const std::vector<Double_t>& p = *(rp.par);
+   Double_t x1 = TMath::Log(0.1);
+   Double_t x2 = TMath::Log(0.2);
+   Double_t y2 = 0.0;
+   for (int j = 2; j < 7; j++)
+      y2 += p[j + 1] * TMath::Power(x2, (Double_t)(j - 1));
+   y2 += p[2];
+   Double_t y1 = 0.0;
+   for (int jj = 2; jj < 7; jj++)
+      y1 += p[jj + 1] * TMath::Power(x1, (Double_t)(jj - 1));
+   y1 += p[2];
+   rp.adm = (y2 - y1) / (x2 - x1);
+   rp.adn = (y1 - rp.adm * x1);
+   rp.riso = A / p[1];
+   if (isoAmat > 0.0) rp.riso *= (isoAmat / fAmat);
+}
+
+Double_t KVedaLossMaterial::CalcRangeOfIon(Int_t Z, Int_t A, Double_t E, Double_t isoAmat) const
+{
+   // Re-entrant calculation of range (in g/cm**2) of ion (Z,A) with energy E (MeV) in material.
+   // Give isoAmat to change default (isotopic) mass of material.
+   //
+   // Same parameterisation as RangeFunc, but all parameters are kept on the stack.
+   // Returns 0 for ions outside of the range tables (Z=0 or Z>ZMAX_VEDALOSS).
+
+   if (!CheckIon(Z)) return 0.0; //only charged particles included in tables
+   RangeParameters rp;
+   GetRangeParameters(Z, A, isoAmat, rp);
+   const std::vector<Double_t>& p = *(rp.par);
+
+   Double_t epsilon = E / rp.A;
+   Double_t dlepsilon = TMath::Log(epsilon);
+   Double_t rn;
+   if (epsilon < 0.1)
+      rn = rp.adm * dlepsilon + rp.adn;
+   else {
+      Double_t dlep = dlepsilon;
+      rn = p[2] + p[3] * dlep;
+      rn += p[4] * (dlep *= dlepsilon);
+      rn += p[5] * (dlep *= dlepsilon);
+      rn += p[6] * (dlep *= dlepsilon);
+      rn += p[7] * (dlep *= dlepsilon);
+   }
+
+   // range in g/cm**2
+   return rp.riso * TMath::Exp(rn) * KVUnits::mg;
+}
+
+Double_t KVedaLossMaterial::CalcEnergyFromRange(Int_t Z, Int_t A, Double_t R, Double_t isoAmat) const
+{
+   // Re-entrant calculation of incident energy (in MeV) of ion (Z,A) with range R (in g/cm**2).
+   // Give isoAmat to change default (isotopic) mass of material.
+   //
+   // If the new range inversion is used (KVedaLoss::SetUseNewRangeInversion) and the
+   // interpolated inverse range functions were built when the material was set up
+   // (see MakeRangeFunctions), they are used. Otherwise the range function is
+   // inverted numerically. In both cases the result does not depend on any previous
+   // calls to GetRangeFunction, and only const data is read.
+   // Returns 0 for ions outside of the range tables (Z=0 or Z>ZMAX_VEDALOSS).
+
+   if (!CheckIon(Z)) return 0.0; //only charged particles included in tables
+   if (fInvRangeReady && fgTable->IsUseNewRangeInversion()) {
+      RangeParameters rp;
+      GetRangeParameters(Z, A, isoAmat, rp);
+      return static_cast<KVedaLossInverseRangeFunction*>(fInvRange.At(Z))->GetEnergyPerNucleon(R, rp.riso) * A;
+   }
+   return KVIonRangeTableMaterial::CalcEnergyFromRange(Z, A, R, isoAmat);
+}
+
 void KVedaLossMaterial::GetParameters(Int_t Zion, Int_t& Aion, std::vector<Double_t> rangepar)
 {
    // For the given ion atomic number, give the reference mass used and the six
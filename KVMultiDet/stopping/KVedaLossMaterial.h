@@ -11,6 +11,7 @@
 
 class TGeoMaterial;
 class KVedaLoss;
+class KVDataFileCache;
 
 // maximum atomic number included in range tables
 #define ZMAX_VEDALOSS 100
@@ -27,6 +28,17 @@ private:
    Double_t ran, adm, dleps, adn, riso, eps, DLEP, drande;
    Double_t thickness; // in g/cm**2
    TObjArray fInvRange; //KVedaLossInverseRangeFunction objects
+   Bool_t fInvRangeReady;//!kTRUE if fInvRange was filled for all Z by MakeRangeFunctions
+
+   // parameters of range function for a given ion, used by re-entrant Calc... methods
+   struct RangeParameters {
+      const std::vector<Double_t>* par;
+      Double_t A;
+      Double_t riso;
+      Double_t adm;
+      Double_t adn;
+   };
+   void GetRangeParameters(Int_t Z, Int_t A, Double_t isoAmat, RangeParameters&) const;
 
 protected:
    std::vector<Double_t> fEmin;        //Z-dependent minimum energy/nucleon for calculation to be valid
@@ -47,6 +59,10 @@ public:
    virtual ~KVedaLossMaterial();
 
    Bool_t ReadRangeTable(FILE* fp);
+   Bool_t ReadRangeTableParameters(FILE* fp);
+   Bool_t ReadRangeTableParameters(KVDataFileCache&);
+   void WriteRangeTableParameters(KVDataFileCache&) const;
+   void MakeRangeFunctions();
    Float_t GetEmaxValid(Int_t Z, Int_t A) const
    {
       return (CheckIon(Z) ? A * fEmax[Z - 1] : 0.0);
@@ -67,6 +83,9 @@ public:
    virtual Double_t GetPunchThroughEnergy(Int_t Z, Int_t A, Double_t e, Double_t isoAmat = 0.);
    virtual Double_t GetEIncFromEResOfIon(Int_t Z, Int_t A, Double_t Eres, Double_t e, Double_t isoAmat = 0.);
 
+   virtual Double_t CalcRangeOfIon(Int_t Z, Int_t A, Double_t E, Double_t isoAmat = 0.) const;
+   virtual Double_t CalcEnergyFromRange(Int_t Z, Int_t A, Double_t R, Double_t isoAmat = 0.) const;
+
    static void SetNoLimits(Bool_t on = kTRUE)
    {
       // Normally all range, dE, Eres functions are limited to range 0<=E<=Emax,
@@ -14,6 +14,7 @@
 #pragma link C++ class KVedaLoss+;
 #pragma link C++ class KVedaLossRangeFitter+;
 #pragma link C++ class KVedaLossInverseRangeFunction+;
+#pragma link C++ class KVRangeEnergyTable+;
 #ifdef WITH_RANGE_YANEZ
 #pragma link C++ class KVRangeYanez+;
 #pragma link C++ class KVRangeYanezMaterial+;
@@ -3,11 +3,18 @@
 
 #include "MCSampler.h"
 #include "TRandom.h"
+#include "TRandom3.h"
 
 #include <TGraph.h>
 #include <TMultiGraph.h>
 #include "TPad.h"
 #include "TH1.h"
+#include "TMath.h"
+#include "TROOT.h"
+#ifdef WITH_CPP11
+#include <thread>
+#include <atomic>
+#endif
 
 ClassImp(MicroStat::MCSampler)
 
@@ -18,8 +25,62 @@ ClassImp(MicroStat::MCSampler)
 <h4>Monte-Carlo sampling of events with statistical weights</h4>
 <!-- */
 // --> END_HTML
+// The first time that weights are calculated, all partitions are read from the
+// TTree/TChain given to SetEventList() and kept in memory, together with their
+// Q-values. Weights for a new excitation energy are then calculated from these
+// copies, if required by several threads (see SetNumberOfThreads()), and a
+// Walker alias table is built so that PickRandomChannel() takes the same time
+// whatever the number of partitions. Weights & alias table are only calculated
+// again when the excitation energy changes (or if SetModifyMasses() was used).
+//
+// With several threads (or if a seed is given with SetRandomSeed()), GenerateEvents()
+// divides the partitions to pick into tasks of fixed size. Each task has its own
+// random number stream, whose seed depends only on the seed and on the index of the
+// task, and its own buffer of events; each thread uses a copy of the StatWeight
+// object. Events are written in the TTree in the order of the tasks, so that for a
+// given seed the same events are generated whatever the number of threads.
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+   const Long64_t kPartitionsPerTask = 100;
+
+   UInt_t task_seed(ULong64_t seed, Long64_t task)
+   {
+      // seed of random number stream for given task (splitmix64 hash of seed+task)
+      ULong64_t z = seed + (ULong64_t)(task + 1) * 0x9E3779B97F4A7C15ULL;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      z ^= (z >> 31);
+      UInt_t s = (UInt_t)(z ^ (z >> 32));
+      // TRandom3::SetSeed(0) would use the time
+      return (s ? s : 1);
+   }
+
+   struct EventBuffer_t {
+      std::vector<KVEvent*> fEvents;
+      std::vector<Long64_t> fIPart;
+      std::vector<Double_t> fEDisp;
+      Long64_t fN;
+      EventBuffer_t() : fN(0) {}
+      EventBuffer_t(const EventBuffer_t&) = delete;
+      ~EventBuffer_t()
+      {
+         for (auto e : fEvents) delete e;
+      }
+      KVEvent* Next(Long64_t ipart, Double_t edisp)
+      {
+         if (fN == (Long64_t)fEvents.size()) {
+            fEvents.push_back(new KVEvent);
+            fIPart.push_back(0);
+            fEDisp.push_back(0);
+         }
+         fIPart[fN] = ipart;
+         fEDisp[fN] = edisp;
+         return fEvents[fN++];
+      }
+   };
+}
+
 namespace MicroStat {
 
    void MCSampler::init()
@@ -30,6 +91,17 @@ namespace MicroStat {
       fTheLegend = 0;
       fLegendProbaMin = 0;
       fModifyMasses = kFALSE;
+      fPartitions = 0;
+      fBranch = 0;
+      fPartition = 0;
+      fWeight = 0;
+      fSumWeights = 0;
+      fPartitionCache = 0;
+      fWeightsEnergy = 0;
+      fWeightsValid = kFALSE;
+      fChannel = 0;
+      fNThreads = 1;
+      fSeed = 0;
    }
 
    void MCSampler::initialiseWeightList()
@@ -58,16 +130,23 @@ namespace MicroStat {
       // Destructor
 
       SafeDelete(fWeightList);
+      SafeDelete(fPartitionCache);
    }
 
    void MCSampler::SetEventList(TTree* t, const TString& branchname)
    {
       // Define the TTree or TChain containing all possible events (partitions).
 
+      SafeDelete(fPartitionCache);
+      SafeDelete(fWeightList);
+      fWeightsValid = kFALSE;
+      fChannel = 0;
       fPartitions = t->GetEntries();
       fBranch = t->GetBranch(branchname);
       if (!fBranch) {
          Error("SetEventList", "cannot find branch %s", branchname.Data());
+         fPartitions = 0;
+         return;
       }
       fPartition = 0;
       fBranch->SetAddress(&fPartition);
@@ -78,6 +157,8 @@ namespace MicroStat {
       // Set the kind of statistical weight to be used
       // This is the name of a class derived from MicroStat::StatWeight
 
+      SafeDelete(fWeightList);
+      fWeightsValid = kFALSE;
       fWeight = TClass::GetClass(w);
       if (!fWeight) {
          Error("SetStatWeight", "class %s not found", w.Data());
@@ -87,35 +168,162 @@ namespace MicroStat {
    void MCSampler::UpdateMasses()
    {
       // if nuclear masses are modified, we have to update those in the
-      // partition read from file
-      KVNucleus* n;
-      while ((n = fPartition->GetNextParticle())) n->SetA(n->GetA());
+      // partitions read from file (and their Q-values)
+      if (!fPartitionCache) CachePartitions();
+      for (Long64_t i = 0; i < fPartitions; i++) {
+         KVEvent* part = (KVEvent*)fPartitionCache->UncheckedAt(i);
+         KVNucleus* n;
+         while ((n = part->GetNextParticle())) n->SetA(n->GetA());
+         fQValues[i] = part->GetChannelQValue();
+      }
+      fWeightsValid = kFALSE;
+   }
+
+   void MCSampler::CachePartitions()
+   {
+      // read all partitions from the TTree/TChain and keep a copy in memory,
+      // together with the Q-value of each one
+
+      SafeDelete(fPartitionCache);
+      fPartitionCache = new TObjArray(fPartitions);
+      fPartitionCache->SetOwner();
+      fQValues.assign(fPartitions, 0.);
+      for (Long64_t i = 0; i < fPartitions; i++) {
+         fBranch->GetEntry(i);
+         KVEvent* part = (KVEvent*)fPartition->Clone();
+         fPartitionCache->AddAt(part, i);
+         fQValues[i] = part->GetChannelQValue();
+      }
+   }
+
+   void MCSampler::SetNumberOfThreads(Int_t n)
+   {
+      // Set number of threads used to calculate the weights of all partitions
+      // and to generate events with GenerateEvents
+      //
+      //  n = 1 : (default) weights are calculated & events generated one after the other
+      //  n > 1 : work is distributed between n threads (the calling thread is one of them)
+      //  n = 0 : use as many threads as there are cores on the machine
+      //
+      // Parallel calculation requires compilation with C++11; otherwise
+      // n is always set to 1.
+
+#ifdef WITH_CPP11
+      if (n == 0) n = TMath::Max(1, (Int_t)std::thread::hardware_concurrency());
+      fNThreads = TMath::Max(1, n);
+      if (fNThreads > 1) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+         ROOT::EnableThreadSafety();
+#endif
+      }
+#else
+      if (n != 1) Warning("SetNumberOfThreads", "Parallel calculation of weights requires C++11: using 1 thread");
+      fNThreads = 1;
+#endif
+   }
+
+   void MCSampler::ComputeWeights(Double_t excitation_energy)
+   {
+      // calculate weight of each partition from the copies kept in memory.
+      // the weight in each slot of fWeightList is calculated for the partition
+      // with the index it holds, so the list does not need to be rebuilt
+      // after being sorted.
+
+      const Long64_t chunk = 64;
+      const Long64_t nchunks = (fPartitions + chunk - 1) / chunk;
+      auto compute_chunk = [&](Long64_t c) {
+         Long64_t last = TMath::Min(fPartitions, (c + 1) * chunk);
+         for (Long64_t i = c * chunk; i < last; i++) {
+            StatWeight* w = (StatWeight*)fWeightList->UncheckedAt(i);
+            Long64_t index = w->GetIndex();
+            w->SetWeight((KVEvent*)fPartitionCache->UncheckedAt(index), excitation_energy + fQValues[index]);
+         }
+      };
+
+#ifdef WITH_CPP11
+      Int_t nthreads = (Int_t)TMath::Min((Long64_t)fNThreads, nchunks);
+      if (nthreads > 1) {
+         std::atomic<Long64_t> next_chunk(0);
+         auto worker = [&]() {
+            Long64_t c;
+            while ((c = next_chunk++) < nchunks) compute_chunk(c);
+         };
+         std::vector<std::thread> workers;
+         for (int t = 1; t < nthreads; ++t) workers.emplace_back(worker);
+         worker();
+         for (auto& w : workers) w.join();
+         return;
+      }
+#endif
+      for (Long64_t c = 0; c < nchunks; c++) compute_chunk(c);
+   }
+
+   void MCSampler::BuildAliasTable()
+   {
+      // build Walker alias table for the weights in fWeightList (Vose's method).
+      // slot i of fWeightList is kept with probability fAliasProba[i],
+      // otherwise slot fAlias[i] is used.
+
+      Int_t n = fPartitions;
+      fAliasProba.assign(n, 1.);
+      fAlias.resize(n);
+      std::vector<Int_t> small, large;
+      small.reserve(n);
+      large.reserve(n);
+      for (Int_t i = 0; i < n; i++) {
+         fAlias[i] = i;
+         fAliasProba[i] = ((StatWeight*)fWeightList->UncheckedAt(i))->GetWeight() * n / fSumWeights;
+         if (fAliasProba[i] < 1.) small.push_back(i);
+         else large.push_back(i);
+      }
+      while (!small.empty() && !large.empty()) {
+         Int_t s = small.back();
+         small.pop_back();
+         Int_t l = large.back();
+         fAlias[s] = l;
+         fAliasProba[l] -= (1. - fAliasProba[s]);
+         if (fAliasProba[l] < 1.) {
+            large.pop_back();
+            small.push_back(l);
+         }
+      }
+      // remaining slots (rounding errors) are always kept
+      for (auto i : small) fAliasProba[i] = 1.;
+      for (auto i : large) fAliasProba[i] = 1.;
    }
 
    void MCSampler::CalculateWeights(Double_t excitation_energy)
    {
       // calculate weights of all partitions for the given excitation energy
       // (in MeV) of the initial compound nucleus
+      //
+      // nothing is done if the weights were already calculated for the same
+      // excitation energy (unless nuclear masses are modified)
 
       //Info("CalculateWeights","Calculating channel weights for E*=%f",excitation_energy);
 
-      if (!fWeightList) initialiseWeightList();
+      if (fWeightsValid && !fModifyMasses && excitation_energy == fWeightsEnergy) return;
 
-      fSumWeights = 0;
-
-      for (int i = 0; i < fPartitions; i++) {
-         StatWeight* w = (StatWeight*)fWeightList->ConstructedAt(i);
-         GetPartition(i);
-         if (fModifyMasses) UpdateMasses();
-         w->SetWeight(fPartition, excitation_energy + fPartition->GetChannelQValue());
-         w->SetIndex(i);
-         fSumWeights += w->GetWeight();
+      if (!fPartitionCache) CachePartitions();
+      if (fModifyMasses) UpdateMasses();
 
-         //std::cout << i << "   Q=" << fPartition->GetChannelQValue() << "   weight=" << w->GetWeight() << endl;
+      if (!fWeightList) initialiseWeightList();
+      if (fWeightList->GetEntriesFast() != fPartitions) {
+         fWeightList->Clear();
+         for (Long64_t i = 0; i < fPartitions; i++)((StatWeight*)fWeightList->ConstructedAt(i))->SetIndex(i);
       }
 
+      ComputeWeights(excitation_energy);
+
+      fSumWeights = 0;
+      for (Long64_t i = 0; i < fPartitions; i++) fSumWeights += ((StatWeight*)fWeightList->UncheckedAt(i))->GetWeight();
+
       // sort weights in decreasing order
       fWeightList->Sort();
+
+      if (fSumWeights > 0) BuildAliasTable();
+      fWeightsEnergy = excitation_energy;
+      fWeightsValid = kTRUE;
    }
 
    Long64_t MCSampler::PickRandomChannel()
@@ -127,22 +335,24 @@ namespace MicroStat {
       // If no channel is open (i.e. all weights = 0, E* < Q value of first channel),
       // we return -1.
 
-      Double_t x = gRandom->Uniform(fSumWeights);
-
-      int i;
-      for (i = 0; i < fPartitions; i++) {
-         Double_t w = ((StatWeight*)(*fWeightList)[i])->GetWeight();
-         if (x < w) break;
-         x -= w;
-      }
-      if (i == fPartitions) {
+      if (!(fSumWeights > 0) || !fPartitions) {
          fLastPicked = nullptr;
          return -1;
       }
-      fLastPicked = (StatWeight*)(*fWeightList)[i];
+      fLastPicked = (StatWeight*)fWeightList->UncheckedAt(PickSlot(gRandom->Uniform(fPartitions)));
       return fLastPicked->GetIndex();
    }
 
+   Int_t MCSampler::PickSlot(Double_t x) const
+   {
+      // Return slot of fWeightList picked by alias table for 0<=x<fPartitions
+      // uniformly distributed
+
+      Int_t i = TMath::Min((Int_t)x, (Int_t)fPartitions - 1);
+      if (x - i >= fAliasProba[i]) i = fAlias[i];
+      return i;
+   }
+
    void MCSampler::SetBranch(TTree* theTree, const TString& bname, void* variable, const TString& vartype)
    {
       TString leaflist = bname + "/";
@@ -182,6 +392,10 @@ namespace MicroStat {
       //    - picking a channel at random
       //    - generating momenta of all nuclei in chosen channel
       //    - filling the TTree with the new event
+      //
+      // With several threads (see SetNumberOfThreads) or if a seed was given with
+      // SetRandomSeed, events are generated in parallel using independent random
+      // number streams (gRandom is then only used to draw a seed if none was given).
 
       Info("GenerateEvents", "Generating events for E*=%f", Exx);
 
@@ -190,6 +404,11 @@ namespace MicroStat {
          return;
       }
 
+      if (fNThreads > 1 || fSeed) {
+         GenerateEventsParallel(theTree, event, npartitions, nev_part);
+         return;
+      }
+
       // generate events
       while (npartitions--) {
 
@@ -208,6 +427,72 @@ namespace MicroStat {
 
    }
 
+   void MCSampler::GenerateEventsParallel(TTree* theTree, KVEvent* event, Long64_t npartitions, Long64_t nev_part)
+   {
+      // Generate (npartitions*nev_part) events for the current excitation energy.
+      //
+      // Partitions are picked in tasks of kPartitionsPerTask partitions. Tasks are
+      // treated in rounds: in each round, thread k treats task (round*nthreads + k)
+      // with its own copy of the StatWeight object and its own buffer of events,
+      // then the calling thread fills the TTree with the events of each buffer in turn.
+
+      ULong64_t seed = (fSeed ? fSeed : (ULong64_t)gRandom->Integer(kMaxUInt));
+      Long64_t ntasks = (npartitions + kPartitionsPerTask - 1) / kPartitionsPerTask;
+      Int_t nthreads = (Int_t)TMath::Max(1LL, TMath::Min((Long64_t)fNThreads, ntasks));
+
+      std::vector<StatWeight*> weights(nthreads);
+      std::vector<TRandom3> streams(nthreads);
+      std::vector<EventBuffer_t> buffers(nthreads);
+      for (Int_t k = 0; k < nthreads; ++k) {
+         weights[k] = (StatWeight*)fWeight->New();
+         weights[k]->SetRandom(&streams[k]);
+      }
+
+      auto do_task = [&](Int_t k, Long64_t task) {
+         StatWeight* w = weights[k];
+         TRandom3& rndm = streams[k];
+         EventBuffer_t& buf = buffers[k];
+         rndm.SetSeed(task_seed(seed, task));
+         buf.fN = 0;
+         Long64_t npart = TMath::Min(kPartitionsPerTask, npartitions - task * kPartitionsPerTask);
+         for (Long64_t p = 0; p < npart; ++p) {
+            Int_t slot = PickSlot(rndm.Uniform(fPartitions));
+            Long64_t index = ((StatWeight*)fWeightList->UncheckedAt(slot))->GetIndex();
+            KVEvent* partition = (KVEvent*)fPartitionCache->UncheckedAt(index);
+            w->SetWeight(partition, ESTAR + fQValues[index]);
+            w->initGenerateEvent(partition);
+            for (Long64_t iev = 0; iev < nev_part; iev++) {
+               w->GenerateEvent(partition, buf.Next(index, w->GetAvailableEnergy()));
+               w->resetGenerateEvent();
+            }
+         }
+      };
+
+      for (Long64_t first = 0; first < ntasks; first += nthreads) {
+         Int_t ntask = (Int_t)TMath::Min((Long64_t)nthreads, ntasks - first);
+#ifdef WITH_CPP11
+         std::vector<std::thread> workers;
+         for (Int_t k = 1; k < ntask; ++k) workers.emplace_back(do_task, k, first + k);
+         do_task(0, first);
+         for (auto& t : workers) t.join();
+#else
+         for (Int_t k = 0; k < ntask; ++k) do_task(k, first + k);
+#endif
+         for (Int_t k = 0; k < ntask; ++k) {
+            EventBuffer_t& buf = buffers[k];
+            for (Long64_t i = 0; i < buf.fN; ++i) {
+               event->Clear();
+               buf.fEvents[i]->Copy(*event);
+               IPART = buf.fIPart[i];
+               EDISP = buf.fEDisp[i];
+               theTree->Fill();
+            }
+         }
+      }
+
+      for (auto w : weights) delete w;
+   }
+
    Bool_t MCSampler::SetExcitationEnergy(Double_t Exx)
    {
       // Define excitation energy for random event generation
@@ -228,9 +513,9 @@ namespace MicroStat {
       IPART = PickRandomChannel();
       if (IPART < 0) return kFALSE;
 
-      GetPartition(IPART);
+      fChannel = GetPartition(IPART);
 
-      fLastPicked->initGenerateEvent(fPartition);
+      fLastPicked->initGenerateEvent(fChannel);
       EDISP = fLastPicked->GetAvailableEnergy();
 
       return kTRUE;
@@ -247,7 +532,7 @@ namespace MicroStat {
       //  1) picking a new decay channel
       //  2) changing the energy
 
-      fLastPicked->GenerateEvent(fPartition, event);
+      fLastPicked->GenerateEvent(fChannel, event);
 
       theTree->Fill();
 
@@ -9,6 +9,8 @@
 #include "TTree.h"
 #include "TLegend.h"
 #include "StatWeight.h"
+#include "TObjArray.h"
+#include <vector>
 
 namespace MicroStat {
 
@@ -18,6 +20,15 @@ namespace MicroStat {
       StatWeight*              fLastPicked;//! weight of channel picked by call to PickRandomChannel()
       Double_t                 fLegendProbaMin;//!minimum probability for which channels are included in automatically generated TLegend when PlotProbabilities is called
       TLegend*                 fTheLegend;//!automatically generated legend for PlotProbabilities
+      TObjArray*               fPartitionCache;//! copies of all partitions read from TTree/TChain
+      std::vector<Double_t>    fQValues;//! Q-values of all partitions
+      std::vector<Double_t>    fAliasProba;//! alias table: probability to keep each channel
+      std::vector<Int_t>       fAlias;//! alias table: channel picked instead
+      Double_t                 fWeightsEnergy;//! excitation energy used for last calculation of weights
+      Bool_t                   fWeightsValid;//! kTRUE if weights & alias table correspond to fWeightsEnergy
+      KVEvent*                 fChannel;//! partition picked by SetDecayChannel()
+      Int_t                    fNThreads;//! number of threads used to calculate weights & generate events
+      ULong64_t                fSeed;//! seed for independent random number streams used by parallel generation
 
       void SetBranch(TTree* theTree, const TString& name, void* variable, const TString& vartype);
 
@@ -36,6 +47,11 @@ namespace MicroStat {
       Bool_t                   fModifyMasses;//! if nuclear masses are modified
 
       void initialiseWeightList();
+      void CachePartitions();
+      void ComputeWeights(Double_t excitation_energy);
+      void BuildAliasTable();
+      Int_t PickSlot(Double_t x) const;
+      void GenerateEventsParallel(TTree*, KVEvent* event, Long64_t npartitions, Long64_t nev_part);
 
    public:
       MCSampler();
@@ -48,16 +64,38 @@ namespace MicroStat {
       KVEvent* GetPartition(Long64_t i)
       {
          // Return pointer to partition with index i in the TTree/TChain fPartitionList
+         // Once weights have been calculated, partitions are read from memory.
 
+         if (fPartitionCache) return (KVEvent*)fPartitionCache->UncheckedAt(i);
          fBranch->GetEntry(i);
          return fPartition;
       }
       void SetModifyMasses(Bool_t yes = kTRUE)
       {
          fModifyMasses = yes;
+         fWeightsValid = kFALSE;
       }
       void UpdateMasses();
 
+      void SetNumberOfThreads(Int_t n);
+      Int_t GetNumberOfThreads() const
+      {
+         // Number of threads used to calculate weights & generate events (1 = serial)
+         return fNThreads;
+      }
+      void SetRandomSeed(ULong64_t seed)
+      {
+         // Set seed for the random number streams used to generate events in parallel.
+         // With seed>0, GenerateEvents always produces the same events whatever the
+         // number of threads. With seed=0 (default), the seed is drawn from gRandom
+         // each time GenerateEvents is called with several threads.
+         fSeed = seed;
+      }
+      ULong64_t GetRandomSeed() const
+      {
+         return fSeed;
+      }
+
       void CalculateWeights(Double_t excitation_energy);
       TClonesArray* GetWeights() const
       {
@@ -21,6 +21,9 @@ namespace MicroStat {
       // Default initialisations
 
       fWeight = 0;
+      fIndex = 0;
+      fEDisp = 0;
+      fRandom = 0;
    }
 
    StatWeight::StatWeight()
@@ -59,15 +62,19 @@ namespace MicroStat {
       // Before calling this method, either call
       //    initGenerateEvent(...)  // the first time, or
       //    resetGenerateEvent(...) // on subsequent calls
+      //
+      // The partition is only read (it is not iterated over with GetNextParticle),
+      // so the same partition can be used at the same time by several threads,
+      // each with its own StatWeight object.
 
       // initialise the event
       event->Clear();
-      Int_t mult = 0;
-      KVNucleus* part;
-      while ((part = partition->GetNextParticle())) {
+      Int_t mult = partition->GetMult();
+      for (Int_t i = 1; i <= mult; i++) {
+         KVNucleus* part = partition->GetParticle(i);
          event->AddParticle()->SetZandA(part->GetZ(), part->GetA());
-         ++mult;
       }
+      KVNucleus* part;
 
       // generate momenta
       while ((part = event->GetNextParticle())) {
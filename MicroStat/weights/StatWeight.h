@@ -5,6 +5,7 @@
 #define __STATWEIGHT_H
 
 #include "KVEvent.h"
+#include "TRandom.h"
 
 namespace MicroStat {
 
@@ -15,6 +16,7 @@ namespace MicroStat {
       Double_t fWeight; //calculated weight
       Long64_t fIndex;  //index of corresponding partition
       Double_t fEDisp;  //available kinetic energy - set by SetWeight(KVEvent*, Double_t)
+      TRandom* fRandom; //! random number generator used to generate events (default: gRandom)
 
    protected:
       void setWeight(Double_t w)
@@ -49,6 +51,18 @@ namespace MicroStat {
          return fIndex;
       }
 
+      void SetRandom(TRandom* r)
+      {
+         // Set random number generator used to generate events.
+         // By default (r=0), gRandom is used.
+         fRandom = r;
+      }
+      TRandom* GetRandom() const
+      {
+         // Random number generator used to generate events
+         return (fRandom ? fRandom : gRandom);
+      }
+
       void ls(Option_t* = "") const;
       Bool_t IsSortable() const
       {
@@ -3,6 +3,8 @@
 
 #include "mdweight.h"
 #include "TMath.h"
+#include "Math/QuantFuncMathCore.h"
+#include <iostream>
 
 ClassImp(MicroStat::mdweight)
 
@@ -34,27 +36,49 @@ namespace MicroStat {
       return val;
    }
 
-   TF1* mdweight::getKEdist(Int_t N, Double_t R)
+   const std::vector<Double_t>& mdweight::getKEtable(Int_t N)
    {
-      // find/create energy distribution for given number of particles
-      // N and mass ratio R.
-
-      TString fn = Form("fKE_N%d_R%f", N, R);
-      TF1* f = (TF1*)fKEDist.FindObject(fn);
-      if (!f) {
-         f = new TF1("mdweight::SPKEDist", mdweight::edist, 0, 1, 2);
-         f->SetRange(0, 1.);
-         f->SetParameters((Double_t)N, R);
-         f->SetNpx(100);
-         f->SetName(fn);
-         fKEDist.Add(f);
+      // find/create inverse cumulative energy distribution for given number
+      // of particles N.
+      //
+      // With x = e*massRat, the distribution edist is a beta distribution,
+      //    x^(1/2) * (1-x)^((3N-8)/2)
+      // whose shape only depends on N: we tabulate its quantiles for
+      // kKETableSize+1 equally-spaced values of the cumulative probability.
+
+      if (N >= (Int_t)fKETables.size()) fKETables.resize(N + 1);
+      std::vector<Double_t>& table = fKETables[N];
+      if (table.empty()) {
+         table.resize(kKETableSize + 1);
+         Double_t b = (3.*N - 6.) / 2.;
+         for (Int_t i = 0; i <= kKETableSize; i++)
+            table[i] = ROOT::Math::beta_quantile((Double_t)i / kKETableSize, 1.5, b);
       }
-      return f;
+      return table;
+   }
+
+   Double_t mdweight::randomKE(Int_t N)
+   {
+      // random value of e*massRat (see edist) for N particles, by linear
+      // interpolation in the tabulated inverse cumulative distribution
+
+      const std::vector<Double_t>& table = getKEtable(N);
+      Double_t u = GetRandom()->Rndm() * kKETableSize;
+      Int_t i = TMath::Min((Int_t)u, kKETableSize - 1);
+      return table[i] + (u - i) * (table[i + 1] - table[i]);
+   }
+
+   void mdweight::printKElist() const
+   {
+      // print numbers of particles for which KE distributions are tabulated
+
+      std::cout << "KE distributions tabulated for N =";
+      for (UInt_t N = 0; N < fKETables.size(); N++) if (!fKETables[N].empty()) std::cout << " " << N;
+      std::cout << std::endl;
    }
 
    mdweight::mdweight()
    {
-      fKEDist.SetOwner();
       log2pi = TMath::Log(TMath::TwoPi());
       log10twelve = TMath::Log(1e+12);
       eDisp = 0.0;
@@ -84,9 +108,8 @@ namespace MicroStat {
       Double_t N = e->GetMult();
       Double_t logmass_sum, mass_sum;
       logmass_sum = mass_sum = 0.;
-      KVNucleus* n;
-      while ((n = e->GetNextParticle())) {
-         Double_t m = n->GetMass();
+      for (Int_t i = 1; i <= N; i++) {
+         Double_t m = e->GetParticle(i)->GetMass();
          logmass_sum += TMath::Log(m);
          mass_sum += m;
       }
@@ -103,7 +126,9 @@ namespace MicroStat {
       // Call before generating an event with StatWeight::GenerateEvent
       // using the given partition and available energy
 
-      massTot0 = partition->GetSum("GetMass");
+      massTot0 = 0.;
+      Int_t N = partition->GetMult();
+      for (Int_t i = 1; i <= N; i++) massTot0 += partition->GetParticle(i)->GetMass();
       resetGenerateEvent();
    }
 
@@ -135,16 +160,16 @@ namespace MicroStat {
          Double_t p = 0.; //momentum to give particle
          if (N > 2) {
             // draw random KE from 1-particle distribution for given N & ratio
-            ec = eDisp * getKEdist(N, ratio)->GetRandom();
+            ec = eDisp * randomKE(N) / ratio;
             p = sqrt(2.*mPart * ec);
          } else {
             // last 2 particles: share remaining available energy
             p = sqrt(2.*(massTot - mPart) * mPart * eDisp / massTot);
             ec = p * p / 2. / mPart;
          }
-         Double_t ct = 1. - 2.*gRandom->Rndm();
+         Double_t ct = 1. - 2.*GetRandom()->Rndm();
          Double_t st = TMath::Sqrt(1. - ct * ct);
-         Double_t phi = gRandom->Rndm() * 2.*TMath::Pi();
+         Double_t phi = GetRandom()->Rndm() * 2.*TMath::Pi();
          ppz = ct * p;
          ppx = st * TMath::Cos(phi) * p;
          ppy = st * TMath::Sin(phi) * p;
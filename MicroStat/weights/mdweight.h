@@ -5,20 +5,21 @@
 #define __MDWEIGHT_H
 
 #include "StatWeight.h"
-#include "TF1.h"
-#include "KVHashList.h"
+#include <vector>
 
 namespace MicroStat {
 
    class mdweight : public StatWeight {
    private:
+      enum { kKETableSize = 1024 };
       Double_t log2pi, log10twelve;
       Double_t eDisp, massTot, massTot0, px, py, pz;
-      KVHashList fKEDist;//!
+      std::vector<std::vector<Double_t> > fKETables;//! inverse cumulative KE distributions for each number of particles
       Double_t A, B;
       static Double_t edist(Double_t*, Double_t*);
 
-      TF1* getKEdist(Int_t, Double_t);
+      const std::vector<Double_t>& getKEtable(Int_t);
+      Double_t randomKE(Int_t);
 
    protected:
 
@@ -32,12 +33,9 @@ namespace MicroStat {
       void resetGenerateEvent();
       virtual void nextparticleGenerateEvent(Int_t, KVNucleus*);
 
-      void printKElist() const
-      {
-         fKEDist.Print();
-      }
+      void printKElist() const;
 
-      ClassDef(mdweight, 1) //Calculate molecular dynamics ensemble weights for events
+      ClassDef(mdweight, 2) //Calculate molecular dynamics ensemble weights for events
    };
 
 }/*  namespace MicroStat */
@@ -28,6 +28,8 @@ void KVIVRawDataReconstructor::postInitRun()
 {
    KVINDRARawDataReconstructor::postInitRun(); // initialise event counters
    ((KVGANILDataReader*)fRunFile)->GetGanTapeInterface()->SetUserTree(tree);
+   // compression of branches added since KVINDRARawDataReconstructor::InitRun
+   tree_output.SetTreeCompression(tree);
 }
 
 KVIVRawDataReconstructor::KVIVRawDataReconstructor()
@@ -56,12 +56,14 @@ GTGanilDataVAMOS::GTGanilDataVAMOS(): GTGanilData()
 {
    //Default constructor
    Par = new Parameters;
+   fHasUserTree = kFALSE;
 }
 
 GTGanilDataVAMOS::GTGanilDataVAMOS(const TString filename): GTGanilData(filename)
 {
    //Open file "filename" for reading
    Par = new Parameters;
+   fHasUserTree = kFALSE;
 }
 
 GTGanilDataVAMOS::~GTGanilDataVAMOS()
@@ -90,11 +92,7 @@ void GTGanilDataVAMOS::ReadParameters(void)
       }
    } while (strcmp(fHeader, PARAM_Id) == 0);
 
-   fDataArray = new UShort_t[fDataArraySize + 1]; // Data buffer is allocated
-   for (Int_t i = 1; i <= fDataArraySize; i++) {
-      fDataArray[i] = (Short_t) - 1;
-   }
-
+   InitDataArray();
 }
 
 //______________________________________________________________________________
@@ -115,9 +113,7 @@ bool GTGanilDataVAMOS::EventUnravelling(CTRL_EVENT* pCtrlEvent)
    Short_t* brutData     = &(pCtrlEvent->ct_par);
    Int_t eventLength = pCtrlEvent->ct_len;
 
-   for (Int_t i = 1; i <= fDataArraySize; i++) {
-      fDataArray[i] = (Short_t) - 1;
-   }
+   ClearDataArray();
    Par->Clear();
 
    bool fOK;
@@ -136,7 +132,7 @@ bool GTGanilDataVAMOS::EventUnravelling(CTRL_EVENT* pCtrlEvent)
    for (Int_t i = 0; i < eventLength; i += 2) {
       //normal GTGanilData/INDRA treatment
       if (brutData[i] <= fDataArraySize && brutData[i] >= 1) {
-         fDataArray[brutData[i]] = brutData[i + 1];
+         SetDataArrayValue(brutData[i], brutData[i + 1]);
       }
       //VAMOS treatment
       if ((i < (eventLength - 6)) && fOK) {
@@ -155,4 +151,5 @@ void GTGanilDataVAMOS::SetUserTree(TTree* theTree)
 {
    //Creates VAMOS vectorised data branches in the (existing) TTree
    Par->Set(theTree);
+   fHasUserTree = kTRUE;
 }
@@ -17,6 +17,7 @@ class GTGanilDataVAMOS : public GTGanilData {
 protected:
 
    Parameters* Par;//->list of acquisition parameters
+   Bool_t fHasUserTree;//!kTRUE if SetUserTree was called
    virtual bool EventUnravelling(CTRL_EVENT*);
    virtual void ReadParameters(void);
 
@@ -26,6 +27,10 @@ public:
    GTGanilDataVAMOS(const TString filename);
    virtual ~GTGanilDataVAMOS();
    virtual void SetUserTree(TTree*);
+   virtual Bool_t HasUserTree() const
+   {
+      return fHasUserTree;
+   }
 
    ClassDef(GTGanilDataVAMOS, 1) //Reads and formats raw data from INDRA-VAMOS experiments
 };
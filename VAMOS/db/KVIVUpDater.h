@@ -8,6 +8,13 @@
 
 class KVIVUpDater : public KVINDRAUpDater {
 
+protected:
+   virtual Bool_t CanUseRunParameterSnapshots() const
+   {
+      // VAMOS calibration & configuration parameters are not stored in snapshots
+      return kFALSE;
+   }
+
 public:
    KVIVUpDater();
    virtual ~KVIVUpDater();
@@ -84,12 +84,9 @@ Bool_t KVIDSiCsIVamos::Identify(KVIdentificationResult* idr, Double_t csi, Doubl
    idr->SetIDType(GetType());
    idr->IDattempted = kTRUE;
 
-   KVIDGrid* theIdentifyingGrid = 0;
-
    fgrid->Identify(csi, si, idr);
-   theIdentifyingGrid = (KVIDGrid*)fgrid;
 
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE8) {
+   if (idr->IDquality == KVIDZAGrid::kICODE8) {
       // only if the final quality code is kICODE8 do we consider that it is
       // worthwhile looking elsewhere. In all other cases, the particle has been
       // "identified", even if we still don't know its Z and/or A (in this case
@@ -97,7 +94,7 @@ Bool_t KVIDSiCsIVamos::Identify(KVIdentificationResult* idr, Double_t csi, Doubl
       return kFALSE;
    }
 
-   if (theIdentifyingGrid->GetQualityCode() == KVIDZAGrid::kICODE7) {
+   if (idr->IDquality == KVIDZAGrid::kICODE7) {
       // if the final quality code is kICODE7 (above last line in grid) then the estimated
       // Z is only a minimum value (Zmin)
       idr->IDcode = 5;
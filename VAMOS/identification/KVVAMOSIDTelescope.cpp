@@ -80,7 +80,6 @@ Bool_t KVVAMOSIDTelescope::Identify(KVIdentificationResult* IDR, Double_t x, Dou
 
    if (fGrid && fGrid->IsIdentifiable(e, de)) {
       fGrid->Identify(e, de, IDR);
-      IDR->IDquality = fGrid->GetQualityCode();
    }
 
    // set general ID code for correct identification